@@ -0,0 +1,344 @@
+// SPDX-FileCopyrightText: © 2022 Alexandros Theodotou <alex@zrythm.org>
+// SPDX-License-Identifier: LicenseRef-ZrythmLicense
+
+/**
+ * \file
+ *
+ * Anticipative rendering of tracks that do not
+ * receive live input.
+ */
+
+#ifndef __AUDIO_ANTICIPATIVE_RENDERER_H__
+#define __AUDIO_ANTICIPATIVE_RENDERER_H__
+
+#include <stdbool.h>
+
+#include "audio/position.h"
+#include "utils/types.h"
+
+#include <glib.h>
+
+#include "zix/sem.h"
+
+typedef struct Graph                 Graph;
+typedef struct GraphNode             GraphNode;
+typedef struct Port                  Port;
+typedef struct Track                 Track;
+typedef struct EngineProcessTimeInfo EngineProcessTimeInfo;
+
+/**
+ * @addtogroup audio
+ *
+ * @{
+ */
+
+#define ANTICIPATIVE_RENDERER \
+  (ROUTER->anticipative_renderer)
+
+/** Max number of renderer threads. */
+#define ANTICIPATIVE_RENDERER_MAX_THREADS 8
+
+/**
+ * Who processes the pre-fader part of an
+ * AnticipativeTrack.
+ */
+typedef enum AnticipativeTrackState
+{
+  /** Processed by the realtime graph. */
+  ANTICIPATIVE_TRACK_STATE_RT,
+
+  /** Rendered ahead of time, not currently held
+   * by a renderer thread. */
+  ANTICIPATIVE_TRACK_STATE_RENDER,
+
+  /** Being rendered by a renderer thread. */
+  ANTICIPATIVE_TRACK_STATE_RENDERING,
+} AnticipativeTrackState;
+
+/**
+ * Role of a graph node belonging to an
+ * AnticipativeTrack.
+ */
+typedef enum AnticipativeNodeRole
+{
+  ANTICIPATIVE_NODE_ROLE_NONE,
+
+  /** Pre-fader node, processed by the renderer
+   * while the track is anticipated. */
+  ANTICIPATIVE_NODE_ROLE_PRE_FADER,
+
+  /** Left fader input, filled from the rendered
+   * output while the track is anticipated. */
+  ANTICIPATIVE_NODE_ROLE_FADER_IN_L,
+
+  /** Right fader input. */
+  ANTICIPATIVE_NODE_ROLE_FADER_IN_R,
+
+  /** Input of a pre-fader send, skipped while the
+   * track is anticipated (the send is disabled). */
+  ANTICIPATIVE_NODE_ROLE_SEND_IN,
+} AnticipativeNodeRole;
+
+/**
+ * The pre-fader part of a track that can be
+ * rendered ahead of the playhead.
+ *
+ * The rendered pre-fader output is written to a
+ * ring buffer that the realtime graph reads into
+ * the fader inputs, so the fader, the post-fader
+ * sends and everything downstream stay live.
+ */
+typedef struct AnticipativeTrack
+{
+  Track * track;
+
+  /** Pre-fader nodes in processing order. */
+  GraphNode ** nodes;
+
+  /** Latency compensation offset of each node
+   * from the pre-fader, in frames. */
+  nframes_t * offsets;
+
+  int num_nodes;
+
+  /** Pre-fader node. */
+  GraphNode * prefader_node;
+
+  /** Ring buffers with the rendered pre-fader
+   * output (left and right). */
+  float * bufs[2];
+
+  /** Size of the ring buffers (a power of 2). */
+  nframes_t buf_size;
+
+  /** Number of frames written to the ring buffers
+   * since playback started. */
+  volatile gint write_frame;
+
+  /** Number of frames read from each ring buffer
+   * since playback started. */
+  volatile gint read_frames[2];
+
+  /** Whether each fader input read anything since
+   * playback started (realtime thread only). */
+  bool started_reading[2];
+
+  /** AnticipativeTrackState. */
+  volatile gint state;
+
+  /** Set when the realtime graph should take the
+   * track back, cleared when handed over. */
+  volatile gint reclaim_requested;
+
+  /**
+   * Whether the realtime graph reads the rendered
+   * output instead of processing the pre-fader
+   * nodes in the current cycle.
+   *
+   * Set at the start of each cycle.
+   */
+  bool anticipated;
+
+  /**
+   * Frames rendered since playback started.
+   *
+   * Negative while priming the nodes with
+   * latency compensation offsets.
+   */
+  signed_frame_t render_frame;
+
+  /** Position of the pre-fader at \ref
+   * AnticipativeTrack.render_frame (or the
+   * playback start position while priming). */
+  Position render_pos;
+
+  /** Number of cycles with missing frames. */
+  volatile gint num_underruns;
+} AnticipativeTrack;
+
+/**
+ * Renders tracks that do not receive live input
+ * ahead of the playhead on spare cores.
+ *
+ * Eligible tracks are decided when the graph is
+ * set up (audio and instrument tracks whose
+ * pre-fader part only depends on itself) and
+ * checked again at the start of each cycle (eg,
+ * not armed, not shown in the editor, no enabled
+ * pre-fader sends). They are handed over to the
+ * renderer threads when playback starts and
+ * reclaimed by the realtime graph when they stop
+ * being eligible, when the playhead or the loop
+ * points change, or when the project changes.
+ * Reclaimed tracks are processed by the realtime
+ * graph until playback is restarted.
+ */
+typedef struct AnticipativeRenderer
+{
+  /** Whether anticipative rendering is
+   * enabled. */
+  bool enabled;
+
+  /** Lookahead in milliseconds. */
+  int lookahead_ms;
+
+  /** Lookahead in frames (set on setup). */
+  nframes_t lookahead;
+
+  /** Frames to delay playback by when tracks are
+   * handed over, so the renderer can get ahead
+   * (set on setup). */
+  nframes_t prime_frames;
+
+  AnticipativeTrack ** tracks;
+  int                  num_tracks;
+
+  /**
+   * Held for reading by the renderer threads while
+   * they go through the tracks, and for writing
+   * when the tracks are changed.
+   */
+  GRWLock tracks_lock;
+
+  GThread * threads[ANTICIPATIVE_RENDERER_MAX_THREADS];
+  int       num_threads;
+
+  /** Posted at the start of each cycle to wake up
+   * the renderer threads. */
+  ZixSem wake;
+
+  volatile gint stop_threads;
+
+  /** Set when the project changed, to reclaim all
+   * the tracks at the start of the next cycle. */
+  volatile gint invalidated;
+
+  /** Playhead position expected at the start of
+   * the next cycle. */
+  signed_frame_t expected_playhead;
+
+  /** Loop settings when playback started. */
+  bool           loop;
+  signed_frame_t loop_start;
+  signed_frame_t loop_end;
+} AnticipativeRenderer;
+
+AnticipativeRenderer *
+anticipative_renderer_new (void);
+
+/**
+ * Finds the eligible tracks in the given graph and
+ * starts the renderer threads if needed.
+ *
+ * Must be called without the engine running,
+ * after anticipative_renderer_clear().
+ */
+NONNULL void
+anticipative_renderer_setup (
+  AnticipativeRenderer * self,
+  Graph *                graph);
+
+/**
+ * Hands all the tracks back to the realtime graph,
+ * waiting for the renderer threads to finish their
+ * current work.
+ *
+ * Must be called without the engine running.
+ */
+NONNULL void
+anticipative_renderer_reclaim_all (
+  AnticipativeRenderer * self);
+
+/**
+ * Reclaims and forgets all the tracks (eg, before
+ * the graph is rebuilt).
+ *
+ * Must be called without the engine running.
+ */
+NONNULL void
+anticipative_renderer_clear (AnticipativeRenderer * self);
+
+/**
+ * Requests all the tracks to be reclaimed at the
+ * start of the next cycle.
+ *
+ * To be called when the project changes.
+ */
+NONNULL void
+anticipative_renderer_invalidate (
+  AnticipativeRenderer * self);
+
+/**
+ * Hands the eligible tracks over to the renderer
+ * threads when playback starts.
+ *
+ * To be called from the realtime thread.
+ *
+ * @return The number of frames to delay playback
+ *   by so the renderer can get ahead, or 0 if no
+ *   tracks were handed over.
+ */
+NONNULL nframes_t
+anticipative_renderer_start (AnticipativeRenderer * self);
+
+/**
+ * Reclaims the tracks that stopped being eligible,
+ * decides which tracks are anticipated in this
+ * cycle and wakes up the renderer threads.
+ *
+ * To be called from the realtime thread before the
+ * channels are prepared.
+ */
+NONNULL void
+anticipative_renderer_prepare_process (
+  AnticipativeRenderer * self);
+
+/**
+ * To be called from the realtime thread after the
+ * playhead was moved at the end of a cycle.
+ */
+NONNULL void
+anticipative_renderer_post_process (
+  AnticipativeRenderer * self);
+
+/**
+ * Returns whether the current thread is a renderer
+ * thread.
+ */
+bool
+anticipative_renderer_is_renderer_thread (void);
+
+void
+anticipative_renderer_free (AnticipativeRenderer * self);
+
+/**
+ * Reads the rendered output of the given channel
+ * into the given fader input port.
+ *
+ * Missing frames are left silent.
+ *
+ * @param channel 0 for left, 1 for right.
+ * @param route_latency Route playback latency of
+ *   the fader input node.
+ */
+HOT NONNULL void
+anticipative_track_read (
+  AnticipativeTrack *           self,
+  int                           channel,
+  Port *                        port,
+  const EngineProcessTimeInfo * time_nfo,
+  nframes_t                     route_latency);
+
+/**
+ * Returns the number of rendered frames that were
+ * not read yet by both fader inputs.
+ */
+NONNULL nframes_t
+anticipative_track_get_num_frames_ahead (
+  AnticipativeTrack * self);
+
+/**
+ * @}
+ */
+
+#endif
@@ -39,6 +39,8 @@ typedef struct _AutomationPointWidget AutomationPointWidget;
 typedef struct AutomationPointDrawSettings
 {
   float        fvalue;
+  /** Value of the next point (end of the curve). */
+  float        next_fvalue;
   CurveOptions curve_opts;
   GdkRectangle draw_rect;
 } AutomationPointDrawSettings;
@@ -78,6 +80,19 @@ typedef struct AutomationPoint
    * timeline. */
   GskRenderNode * cairo_node_tl;
 
+  /** Cached curve samples, see
+   * automation_point_get_curve_samples(). */
+  double * curve_samples;
+  int      num_curve_samples;
+  size_t   curve_samples_size;
+
+  /** Curve options the samples were taken with. */
+  CurveOptions curve_samples_opts;
+
+  /** Curve direction the samples were taken
+   * with. */
+  bool curve_samples_start_higher;
+
   /** Temporary string used with StringEntryDialogWidget. */
   char * tmp_str;
 } AutomationPoint;
@@ -161,6 +176,35 @@ automation_point_get_normalized_value_in_curve (
   AutomationPoint * ap,
   double            x);
 
+/**
+ * Returns @p num_samples + 1 normalized values on
+ * the curve from this point to @p next_ap, taken at
+ * evenly spaced normalized x values from 0 to 1.
+ *
+ * These are the same values as
+ * automation_point_get_normalized_value_in_curve()
+ * but they are cached and only recalculated when
+ * the curve options, the direction of the curve
+ * (ie, an edit to this or the next point) or the
+ * number of samples change.
+ */
+NONNULL const double *
+automation_point_get_curve_samples (
+  AutomationPoint *       self,
+  const AutomationPoint * next_ap,
+  int                     num_samples);
+
+/**
+ * Returns a number of curve samples suitable for
+ * drawing a curve that is @p width pixels wide.
+ *
+ * This is rounded up to a power of 2 so that the
+ * samples are reused across small zoom changes.
+ */
+CONST int
+automation_point_get_num_curve_samples_for_width (
+  double width);
+
 /**
  * Sets the curviness of the AutomationPoint.
  */
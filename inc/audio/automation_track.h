@@ -203,6 +203,15 @@ NONNULL
 AutomationTrack *
 automation_track_new (Port * port);
 
+/**
+ * Creates an automation track for the port with the
+ * given identifier, which may not be created yet.
+ */
+NONNULL
+AutomationTrack *
+automation_track_new_from_port_id (
+  const PortIdentifier * port_id);
+
 NONNULL
 bool
 automation_track_validate (AutomationTrack * self);
@@ -464,12 +473,19 @@ automation_track_get_y_px_from_normalized_val (
   AutomationTrack * self,
   float             normalized_val);
 
-#if 0
+/**
+ * Returns the port of the automation track.
+ *
+ * @param create Whether to create the port if it is
+ *   a MIDI control port that was not used yet (see
+ *   track_processor_get_midi_control_port()). This
+ *   must only be true on the main thread.
+ */
 NONNULL
 Port *
 automation_track_get_port (
-  const AutomationTrack * const self);
-#endif
+  AutomationTrack * self,
+  bool              create);
 
 /**
  * Gets the last ZRegion in the AutomationTrack.
@@ -361,6 +361,18 @@ NONNULL
 void
 channel_prepare_process (Channel * channel);
 
+/**
+ * Prepares the pre-fader part of the channel for
+ * processing.
+ *
+ * Called by channel_prepare_process(), or by the
+ * anticipative renderer for tracks rendered ahead
+ * of time.
+ */
+NONNULL
+void
+channel_prepare_process_pre_fader (Channel * channel);
+
 /**
  * Creates a channel of the given type with the
  * given label.
@@ -24,6 +24,14 @@
 
 #define AUDIO_CLIP_SCHEMA_VERSION 1
 
+/**
+ * Number of frames summarized by each entry in
+ * @ref AudioClip.peaks.
+ */
+#define AUDIO_CLIP_PEAK_BLOCK_FRAMES 256
+
+typedef struct AudioClipImportJob AudioClipImportJob;
+
 /**
  * Audio clips for the pool.
  *
@@ -96,6 +104,48 @@ typedef struct AudioClip
    * @see AudioClip.frames_written.
    */
   gint64 last_write;
+
+  /**
+   * Waveform overview: min and max sample value
+   * across all channels for each block of
+   * @ref AUDIO_CLIP_PEAK_BLOCK_FRAMES frames,
+   * interleaved (min, max, min, max, ...).
+   *
+   * Updated along with the channel caches.
+   */
+  float * peaks;
+
+  /** Number of blocks in @ref AudioClip.peaks. */
+  size_t num_peaks;
+
+  /**
+   * Content hash of the data in the clip's file in
+   * the main project's pool, or 0 if unknown.
+   *
+   * Along with the file's size and modification
+   * time at the time it was set, this is used to
+   * skip re-writing (and re-reading) unchanged files
+   * and to share files with identical contents.
+   */
+  uint64_t pool_file_content_hash;
+
+  /** Size of the pool file when
+   * @ref AudioClip.pool_file_content_hash was set. */
+  goffset pool_file_size;
+
+  /** Modification time of the pool file when
+   * @ref AudioClip.pool_file_content_hash was set. */
+  gint64 pool_file_mtime;
+
+  /**
+   * Pending background import, or NULL.
+   *
+   * While this is set, the frames are silent
+   * placeholders.
+   *
+   * @see audio_clip_import_async().
+   */
+  AudioClipImportJob * import_job;
 } AudioClip;
 
 static const cyaml_schema_field_t audio_clip_fields_schema[] = {
@@ -121,6 +171,26 @@ static const cyaml_schema_value_t audio_clip_schema = {
 COLD NONNULL void
 audio_clip_init_loaded (AudioClip * self);
 
+/**
+ * Loads the clip's frames from its file in the
+ * pool, or from the decoded clip cache if it has an
+ * up-to-date entry.
+ *
+ * This does not access any global state other than
+ * the engine's samplerate, so it can be called from
+ * worker threads (one per clip).
+ *
+ * @param pool_path Path of the clip in the pool.
+ * @param cache_path Path of the cache entry, or NULL
+ *   to not use the cache.
+ */
+NONNULL_ARGS (1, 2)
+void
+audio_clip_load_from_pool (
+  AudioClip *  self,
+  const char * pool_path,
+  const char * cache_path);
+
 /**
  * Creates an audio clip from a file.
  *
@@ -129,6 +199,48 @@ audio_clip_init_loaded (AudioClip * self);
 NONNULL AudioClip *
 audio_clip_new_from_file (const char * full_path);
 
+/**
+ * Creates a silent placeholder clip for the given
+ * file, using only the file's header.
+ *
+ * The clip has the length the file will have in the
+ * project's samplerate. Its contents should be
+ * filled in with audio_clip_import_async() after
+ * adding it to the pool.
+ *
+ * @return The new clip, or NULL if the file could
+ *   not be opened.
+ */
+AudioClip *
+audio_clip_new_placeholder_from_file (
+  const char * full_path,
+  GError **    error);
+
+/**
+ * Decodes, resamples and hashes the given file on a
+ * worker thread and fills in the clip's frames when
+ * done.
+ *
+ * If the project's pool directory exists, the clip
+ * is also written to the pool on the worker thread.
+ *
+ * @note Must be called after the clip is added to
+ *   the pool, so that its name is final.
+ */
+NONNULL void
+audio_clip_import_async (
+  AudioClip *  self,
+  const char * full_path);
+
+/**
+ * Blocks until the clip's background import (if
+ * any) finishes, and applies its results.
+ *
+ * To be called from the GTK thread.
+ */
+NONNULL void
+audio_clip_wait_for_import (AudioClip * self);
+
 /**
  * Creates an audio clip by copying the given float
  * array.
@@ -174,6 +286,47 @@ audio_clip_update_channel_caches (
   AudioClip * self,
   size_t      start_from);
 
+/**
+ * Returns a hash of the clip's frames and of the
+ * format it is written in.
+ *
+ * Clips with equal content hashes produce identical
+ * files in the pool.
+ */
+NONNULL PURE uint64_t
+audio_clip_get_content_hash (const AudioClip * self);
+
+/**
+ * Returns whether the clip's file in the main
+ * project's pool is known to contain the given
+ * content.
+ *
+ * @param content_hash Content hash to check, or 0
+ *   to check for the clip's current content.
+ */
+NONNULL bool
+audio_clip_pool_file_is_in_sync (
+  const AudioClip * self,
+  uint64_t          content_hash);
+
+/**
+ * Gets the min and max sample value across all
+ * channels in the given range of frames.
+ *
+ * Uses @ref AudioClip.peaks where possible, so this
+ * is cheap even for large ranges.
+ *
+ * @param start_frame First frame (inclusive).
+ * @param end_frame Last frame (exclusive).
+ */
+NONNULL void
+audio_clip_get_min_max (
+  const AudioClip * self,
+  signed_frame_t    start_frame,
+  signed_frame_t    end_frame,
+  float *           min,
+  float *           max);
+
 /**
  * Shows a dialog with info on how to edit a file,
  * with an option to open an app launcher.
@@ -0,0 +1,92 @@
+// SPDX-FileCopyrightText: © 2022 Alexandros Theodotou <alex@zrythm.org>
+// SPDX-License-Identifier: LicenseRef-ZrythmLicense
+
+/**
+ * \file
+ *
+ * Persistent cache of decoded audio clips.
+ */
+
+#ifndef __AUDIO_CLIP_CACHE_H__
+#define __AUDIO_CLIP_CACHE_H__
+
+#include <stdbool.h>
+
+#include "audio/clip.h"
+
+/**
+ * @addtogroup audio
+ *
+ * @{
+ */
+
+/**
+ * Maximum total size of the cache in bytes.
+ *
+ * The least recently used entries are removed when
+ * this is exceeded.
+ */
+#define CLIP_CACHE_MAX_SIZE \
+  ((goffset) 4 * 1024 * 1024 * 1024)
+
+/**
+ * Returns the path of the cache entry for the given
+ * clip decoded at the given samplerate, or NULL if
+ * the clip cannot be cached.
+ *
+ * Entries are keyed by the hash of the clip's pool
+ * file and the samplerate.
+ *
+ * To be called from the GTK thread.
+ */
+NONNULL char *
+clip_cache_get_path (
+  const AudioClip * clip,
+  unsigned int      samplerate);
+
+/**
+ * Fills in the clip's frames from the given cache
+ * entry.
+ *
+ * The entry is only used if it was created from the
+ * current version of the pool file.
+ *
+ * This is thread-safe as long as nothing else
+ * accesses the clip.
+ *
+ * @param samplerate Samplerate to load the clip in.
+ *
+ * @return Whether successful.
+ */
+NONNULL bool
+clip_cache_load (
+  AudioClip *  clip,
+  const char * cache_path,
+  const char * pool_path,
+  unsigned int samplerate);
+
+/**
+ * Stores the clip's frames in the given cache
+ * entry.
+ *
+ * This is thread-safe as long as nothing else
+ * modifies the clip.
+ */
+NONNULL void
+clip_cache_store (
+  const AudioClip * clip,
+  const char *      cache_path,
+  const char *      pool_path);
+
+/**
+ * Removes the least recently used entries until the
+ * cache is smaller than @ref CLIP_CACHE_MAX_SIZE.
+ */
+void
+clip_cache_trim (void);
+
+/**
+ * @}
+ */
+
+#endif
@@ -38,7 +38,8 @@ typedef struct Port Port;
  * processing.
  *
  * Used only for non-plugin ports such as BPM and
- * time signature.
+ * time signature. Other control ports are queued
+ * with router_queue_control_value().
  */
 typedef struct ControlPortChange
 {
@@ -180,6 +181,32 @@ control_port_set_real_val (Port * self, float val);
 void
 control_port_set_real_val_w_events (Port * self, float val);
 
+/**
+ * Queues the real value to be applied at the start
+ * of the next cycle and sends UI events once
+ * applied.
+ *
+ * To be used by widgets that change values
+ * continuously, so changes are coalesced per
+ * cycle.
+ *
+ * @see router_queue_control_value().
+ */
+void
+control_port_queue_real_val (Port * self, float val);
+
+/**
+ * Returns the value queued with
+ * control_port_queue_real_val() if not applied
+ * yet, or the current unsnapped value.
+ *
+ * Widgets that queue their changes should use
+ * this as their getter so that relative drags
+ * don't lose increments.
+ */
+float
+control_port_get_queued_val (Port * self);
+
 /**
  * Wrapper over port_set_control_value() for toggles.
  */
@@ -63,6 +63,7 @@ typedef struct Project           Project;
 typedef struct HardwareProcessor HardwareProcessor;
 typedef struct ObjectPool        ObjectPool;
 typedef struct MPMCQueue         MPMCQueue;
+typedef struct TempoMap          TempoMap;
 
 /**
  * @addtogroup audio Audio
@@ -136,6 +137,10 @@ typedef enum AudioEngineEventType
 {
   AUDIO_ENGINE_EVENT_BUFFER_SIZE_CHANGE,
   AUDIO_ENGINE_EVENT_SAMPLE_RATE_CHANGE,
+
+  /** MIDI events did not fit in a port's buffers
+   * in a processing thread. */
+  AUDIO_ENGINE_EVENT_MIDI_EVENTS_DROPPED,
 } AudioEngineEventType;
 
 /**
@@ -381,6 +386,29 @@ typedef struct AudioEngine
    */
   double ticks_per_frame;
 
+  /**
+   * Tempo map used to convert global positions
+   * when the BPM is automated.
+   *
+   * Replaced atomically with a new map on the GTK
+   * thread (see engine_update_tempo_map()), so it
+   * must be read with g_atomic_pointer_get() and not
+   * cached across cycles.
+   */
+  TempoMap * tempo_map;
+
+  /**
+   * Previous tempo map, freed once the cycle that
+   * was running when it got replaced (if any) has
+   * finished.
+   */
+  TempoMap *    retired_tempo_map;
+  uint_fast64_t retired_tempo_map_cycle;
+
+  /** Set when the tempo map must be rebuilt on the
+   * GTK thread (see engine_update_tempo_map()). */
+  volatile gint tempo_map_update_requested;
+
   /** True iff buffer size callback fired. */
   int buf_size_set;
 
@@ -625,6 +653,15 @@ typedef struct AudioEngine
   /** Pan algorithm */
   PanAlgorithm pan_algo;
 
+  /**
+   * Minimum number of frames to process plugins for
+   * when splitting the cycle at automation changes,
+   * or 0 to process each plugin once per cycle.
+   *
+   * @see plugin_process().
+   */
+  nframes_t plugin_sub_block_size;
+
   /** Time taken to process in the last cycle */
   gint64 last_time_taken;
 
@@ -919,6 +956,24 @@ engine_update_frames_per_tick (
   bool                update_from_ticks,
   bool                bpm_change);
 
+/**
+ * Rebuilds the tempo map from the BPM automation
+ * and, only if the map changed, publishes it and
+ * updates the frames of the transport positions
+ * from their ticks.
+ *
+ * The frames of arranger objects are updated
+ * lazily when next read (see
+ * arranger_object_update_frames_if_stale()).
+ *
+ * To be called after the BPM automation may have
+ * changed. When called from another thread, the
+ * map is rebuilt in the next
+ * engine_process_events() instead.
+ */
+void
+engine_update_tempo_map (AudioEngine * self);
+
 /**
  * GSourceFunc to be added using idle add.
  *
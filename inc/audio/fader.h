@@ -213,8 +213,9 @@ typedef struct Fader
 
   bool is_project;
 
-  /* TODO Caches to be set when recalculating the
-   * graph. */
+  /** Solo state caches, refreshed by
+   * tracklist_update_solo_caches() at the start of
+   * each cycle when dirty. */
   bool implied_soloed;
   bool soloed;
 
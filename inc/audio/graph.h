@@ -31,6 +31,7 @@
 #define __AUDIO_GRAPH_H__
 
 #include "audio/graph_node.h"
+#include "utils/cpu_topology.h"
 #include "utils/types.h"
 
 #include "zix/sem.h"
@@ -145,6 +146,10 @@ typedef struct Graph
   GraphThread * main_thread;
   gint          num_threads;
 
+  /** How the threads are pinned to CPUs (set when
+   * the graph is started). */
+  CpuAffinity affinity;
+
   /**
    * An array of pointers to ports that are exposed
    * to the backend and are outputs.
@@ -37,6 +37,7 @@
 
 #include <stdbool.h>
 
+#include "audio/anticipative_renderer.h"
 #include "utils/types.h"
 
 #include <gtk/gtk.h>
@@ -162,6 +163,12 @@ typedef struct GraphNode
   nframes_t route_playback_latency;
 
   GraphNodeType type;
+
+  /** Track rendered ahead of time this node
+   * belongs to or reads from, if any. */
+  AnticipativeTrack * anticipative_track;
+
+  AnticipativeNodeRole anticipative_role;
 } GraphNode;
 
 /**
@@ -192,6 +199,17 @@ graph_node_process (
   GraphNode *           node,
   EngineProcessTimeInfo time_nfo);
 
+/**
+ * Processes the GraphNode for the anticipative
+ * renderer at the given (already latency
+ * compensated) position, without triggering the
+ * downstream nodes.
+ */
+HOT void
+graph_node_process_anticipated (
+  GraphNode *           node,
+  EngineProcessTimeInfo time_nfo);
+
 /**
  * Returns the latency of only the given port, without adding
  * the previous/next latencies.
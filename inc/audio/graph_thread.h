@@ -58,7 +58,8 @@
 #  include <lsp-plug.in/dsp/dsp.h>
 #endif
 
-typedef struct Graph Graph;
+typedef struct Graph     Graph;
+typedef struct GraphNode GraphNode;
 
 /**
  * @addtogroup audio
@@ -81,10 +82,45 @@ typedef struct GraphThread
   /** Pointer back to the graph. */
   Graph * graph;
 
+  /** CPU the thread is pinned to, or -1. */
+  int cpu;
+
+  /**
+   * Node triggered by the last node processed by
+   * this thread, to be processed next by this
+   * thread instead of going through the trigger
+   * queue.
+   *
+   * Only used with CPU_AFFINITY_CACHE_GROUPS, to
+   * keep chains of nodes (eg, a track's plugins) on
+   * the same core.
+   */
+  GraphNode * next_node;
+
 #ifdef HAVE_LSP_DSP
   /** LSP DSP context. */
   lsp_dsp_context_t lsp_ctx;
 #endif
+
+  /**
+   * Partial sum of the listened channels processed
+   * by this thread (L/R), mixed into the monitor
+   * output by the monitor fader.
+   *
+   * Only the range of the current router cycle is
+   * valid, and only if @ref
+   * GraphThread.listen_cycle matches the router
+   * cycle.
+   */
+  float * listen_bufs[2];
+
+  /** Size of each of @ref GraphThread.listen_bufs
+   * in frames. */
+  nframes_t listen_buf_size;
+
+  /** Router cycle @ref GraphThread.listen_bufs was
+   * last written to in. */
+  unsigned long listen_cycle;
 } GraphThread;
 
 /**
@@ -93,13 +129,42 @@ typedef struct GraphThread
  * @param id The index of the thread.
  * @param graph The graph to set to the thread.
  * @param is_main 1 if main thread.
+ * @param cpu CPU to pin the thread to, or -1.
  */
 GraphThread *
 graph_thread_new (
   const int  id,
   const bool is_main,
+  const int  cpu,
   Graph *    graph);
 
+/**
+ * Returns the graph thread the caller is running
+ * in, or NULL if not called from a graph thread.
+ */
+HOT GraphThread *
+graph_thread_get_current (void);
+
+/**
+ * Makes sure the listen bus buffers can hold
+ * @p nframes frames.
+ *
+ * Must not be called while the graph is
+ * processing.
+ */
+NONNULL void
+graph_thread_ensure_listen_bufs (
+  GraphThread * self,
+  nframes_t     nframes);
+
+/**
+ * Frees the thread's resources.
+ *
+ * The thread must have been joined beforehand.
+ */
+NONNULL void
+graph_thread_free (GraphThread * self);
+
 /**
  * @}
  */
@@ -51,11 +51,14 @@ typedef struct ChordDescriptor ChordDescriptor;
  * @{
  */
 
-/** Max events to hold in queues. */
-#define MAX_MIDI_EVENTS 2560
+/** Initial size of the event buffers. */
+#define MIDI_EVENTS_INITIAL_SIZE 256
 
 /**
  * Timed MIDI event.
+ *
+ * This is kept small (8 bytes) so that many events
+ * fit in a cache line.
  */
 typedef struct MidiEvent
 {
@@ -63,13 +66,11 @@ typedef struct MidiEvent
    * start of the current cycle. */
   midi_time_t time;
 
-  /** Time using g_get_monotonic_time (). */
-  gint64 systime;
-
   /** Raw MIDI data. */
   midi_byte_t raw_buffer[3];
 
-  size_t raw_buffer_sz;
+  /** Size of the raw MIDI data (up to 3). */
+  uint8_t raw_buffer_sz;
 
 } MidiEvent;
 
@@ -79,6 +80,14 @@ typedef struct Port       Port;
 /**
  * Container for passing midi events through ports.
  * This should be passed in the data field of MIDI Ports
+ *
+ * The event buffers start small and only grow
+ * outside the processing threads. When they are full
+ * in a processing thread, new events are dropped and
+ * counted, and an engine event is pushed to grow the
+ * buffers to the peak usage from the GTK thread
+ * while the engine is paused (see
+ * midi_events_grow_to_peak()).
  */
 typedef struct MidiEvents
 {
@@ -86,7 +95,8 @@ typedef struct MidiEvents
   volatile int num_events;
 
   /** Events to use in this cycle. */
-  MidiEvent events[MAX_MIDI_EVENTS];
+  MidiEvent * events;
+  int         events_size;
 
   /**
    * For queueing events from the GUI or from ALSA
@@ -98,8 +108,21 @@ typedef struct MidiEvents
    *
    * Also has other uses.
    */
-  MidiEvent    queued_events[MAX_MIDI_EVENTS];
+  MidiEvent *  queued_events;
   volatile int num_queued_events;
+  int          queued_events_size;
+
+  /** Scratch buffer used when sorting. */
+  MidiEvent * merge_buf;
+  int         merge_buf_size;
+
+  /** Max number of events held in either buffer
+   * since allocation. */
+  int max_num_events;
+
+  /** Number of events dropped because the buffers
+   * were full and could not grow. */
+  volatile int num_dropped;
 
   /** Semaphore for exclusive read/write. */
   ZixSem access_sem;
@@ -128,6 +151,28 @@ midi_events_init (MidiEvents * self);
 MidiEvents *
 midi_events_new (void);
 
+/**
+ * Allocates a MidiEvents struct with buffers large
+ * enough for the peak usage of @p prev (including
+ * dropped events), or the default size if @p prev
+ * is NULL.
+ *
+ * To be used when reallocating port buffers.
+ */
+MidiEvents *
+midi_events_new_with_size_of (const MidiEvents * prev);
+
+/**
+ * Grows the buffers to fit the peak usage
+ * (including dropped events) and resets the dropped
+ * event count.
+ *
+ * Must not be called while the buffers are being
+ * processed.
+ */
+void
+midi_events_grow_to_peak (MidiEvents * self);
+
 /**
  * Copies the members from one MidiEvent to another.
  */
@@ -161,6 +206,10 @@ midi_events_print (MidiEvents * self, const int queued);
 /**
  * Appends the events from src to dest.
  *
+ * The events are merged in time order and duplicates
+ * are removed, which takes linear time if both src
+ * and dest are sorted.
+ *
  * @param queued Append queued events instead of
  *   main events.
  * @param local_offset The start frame offset from
@@ -416,10 +465,25 @@ midi_events_copy_to_jack (MidiEvents * self, void * buff);
 
 /**
  * Sorts the MidiEvents by time.
+ *
+ * The sort is stable and merges the already sorted
+ * runs in the events (eg, the events of each region
+ * or source port), so it takes O(n log k) for k
+ * runs and O(n) if the events are already sorted.
  */
 void
 midi_events_sort (MidiEvents * self, const bool queued);
 
+/**
+ * Sorts the MidiEvents by time like
+ * midi_events_sort() and removes duplicates while
+ * merging.
+ */
+void
+midi_events_sort_and_clear_duplicates (
+  MidiEvents * self,
+  const bool   queued);
+
 /**
  * Sets the given MIDI channel on all applicable
  * MIDI events.
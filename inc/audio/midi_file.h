@@ -27,6 +27,8 @@
 #define __AUDIO_MIDI_FILE_H__
 
 #include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
 
 #include "ext/midilib/src/midifile.h"
 
@@ -36,6 +38,43 @@
  * @{
  */
 
+/**
+ * A note read from a MIDI file.
+ *
+ * Positions are in ticks relative to the start of
+ * the track.
+ */
+typedef struct MidiFileNote
+{
+  double  start_ticks;
+  double  end_ticks;
+  uint8_t pitch;
+  uint8_t velocity;
+} MidiFileNote;
+
+/**
+ * The contents of a MIDI file track that are used
+ * when importing.
+ */
+typedef struct MidiFileTrack
+{
+  /** Notes, sorted by start position. */
+  MidiFileNote * notes;
+  size_t         num_notes;
+  size_t         notes_size;
+
+  /** Track name, if any. */
+  char * name;
+
+  /** Position of the end of track event, in
+   * ticks. */
+  double end_ticks;
+
+  /** Whether the track has any MIDI data (see
+   * midi_file_track_has_data()). */
+  bool has_data;
+} MidiFileTrack;
+
 /**
  * Returns whether the given track in the midi file
  * has data.
@@ -51,6 +90,49 @@ midi_file_get_num_tracks (
   const char * abs_path,
   bool         non_empty_only);
 
+/**
+ * Reads all tracks of the MIDI file.
+ *
+ * Each track is parsed in a separate thread.
+ *
+ * @param ppqn PPQN to convert positions to (see
+ *   transport_get_ppqn()).
+ * @param[out] num_tracks Number of tracks read.
+ *
+ * @return A newly allocated array of tracks to be
+ *   freed with midi_file_tracks_free(), or NULL if
+ *   the file could not be read.
+ */
+MidiFileTrack *
+midi_file_read_tracks (
+  const char * abs_path,
+  double       ppqn,
+  int *        num_tracks);
+
+/**
+ * Returns the number of tracks with data (see
+ * MidiFileTrack.has_data).
+ */
+int
+midi_file_tracks_get_num_with_data (
+  const MidiFileTrack * tracks,
+  int                   num_tracks);
+
+/**
+ * Returns the track at the given index, counting
+ * only tracks with data, or NULL if not found.
+ */
+const MidiFileTrack *
+midi_file_tracks_get_nth_with_data (
+  const MidiFileTrack * tracks,
+  int                   num_tracks,
+  int                   idx);
+
+void
+midi_file_tracks_free (
+  MidiFileTrack * tracks,
+  int             num_tracks);
+
 /**
  * @}
  */
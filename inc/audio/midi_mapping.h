@@ -192,20 +192,6 @@ midi_mapping_clone (const MidiMapping * src);
 void
 midi_mapping_free (MidiMapping * self);
 
-/**
- * Applies the events to the appropriate mapping.
- *
- * This is used only for TrackProcessor.cc_mappings.
- *
- * @note Must only be called while transport is
- *   recording.
- */
-void
-midi_mappings_apply_from_cc_events (
-  MidiMappings * self,
-  MidiEvents *   events,
-  bool           queued);
-
 /**
  * Applies the given buffer to the matching ports.
  */
@@ -23,6 +23,7 @@ typedef struct ZRegion         ZRegion;
 typedef struct MidiEvents      MidiEvents;
 typedef struct ChordDescriptor ChordDescriptor;
 typedef struct Velocity        Velocity;
+typedef struct MidiFileTrack   MidiFileTrack;
 typedef ZRegion                MidiRegion;
 typedef void                   MIDI_FILE;
 
@@ -61,6 +62,22 @@ midi_region_new_from_midi_file (
   int              idx_inside_lane,
   int              idx);
 
+/**
+ * Creates a MIDI region from a track read with
+ * midi_file_read_tracks(), starting at the given
+ * Position.
+ *
+ * @return The region, or NULL if the track has
+ *   no notes.
+ */
+ZRegion *
+midi_region_new_from_midi_file_track (
+  const Position *      start_pos,
+  const MidiFileTrack * mf_track,
+  unsigned int          track_name_hash,
+  int                   lane_pos,
+  int                   idx_inside_lane);
+
 /**
  * Create a region from the chord descriptor.
  *
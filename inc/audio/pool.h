@@ -34,6 +34,15 @@ typedef struct Track Track;
  * all audio files (and their edited counterparts
  * after some hard editing like stretching) are saved
  * in the pool.
+ *
+ * Each clip is stored as a whole WAV/FLAC file.
+ * Clips with identical contents (see
+ * audio_clip_get_content_hash()) share the same data
+ * on disk through hard links (or reflinks), also
+ * with backups. Clips that only share some of their
+ * frames (eg, the parts of a split region) are
+ * stored separately - there is no chunk-level
+ * storage.
  */
 typedef struct AudioPool
 {
@@ -76,6 +85,10 @@ static const cyaml_schema_value_t audio_pool_schema = {
 
 /**
  * Inits after loading a project.
+ *
+ * Decodes all the clips in parallel in the engine's
+ * current samplerate, so this must be called once
+ * the final samplerate is known.
  */
 void
 audio_pool_init_loaded (AudioPool * self);
@@ -131,10 +144,27 @@ audio_pool_remove_clip (
   bool        free_and_remove_file,
   bool        backup);
 
+/**
+ * Returns a clip other than \ref except whose file
+ * in the main pool has the given content, if any.
+ *
+ * Used to share files between clips with identical
+ * contents.
+ */
+AudioClip *
+audio_pool_find_clip_with_pool_file (
+  AudioPool *       self,
+  uint64_t          content_hash,
+  const AudioClip * except);
+
 /**
  * Removes and frees (and removes the files for) all
  * clips not used by the project or undo stacks.
  *
+ * Files shared between clips (or with backups) are
+ * hard links, so removing a clip's file only frees
+ * the data on disk once nothing else references it.
+ *
  * @param backup Whether to remove from backup
  *   directory.
  */
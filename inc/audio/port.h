@@ -168,6 +168,55 @@ typedef struct Port
    */
   float * buf;
 
+  /**
+   * Buffer owned by the port while @ref Port.buf
+   * aliases the buffer of its source, NULL
+   * otherwise.
+   *
+   * Audio ports whose only source is connected
+   * with unity gain point @ref Port.buf to the
+   * source's buffer during processing instead of
+   * copying it (see port_process()). Clearing the
+   * port gives it back its own buffer.
+   */
+  float * own_buf;
+
+  /**
+   * Whether the port used its own buffer in an
+   * earlier range of this cycle, so it must not
+   * alias its source for the rest of the cycle.
+   *
+   * Reset by port_clear_audio_cv_buffer().
+   */
+  bool own_buf_in_cycle;
+
+  /**
+   * Whether the own buffer was not cleared at the
+   * start of this cycle because the port aliased
+   * its source in the previous cycle and will most
+   * likely alias it again.
+   *
+   * The buffer is cleared when the port ends up
+   * using it (see port_use_own_buf()).
+   */
+  bool own_buf_clear_pending;
+
+  /**
+   * Whether @ref Port.buf is known to only contain
+   * silence (audio/CV ports only).
+   *
+   * This is a hint: false means "unknown". It is
+   * set by producers via port_update_silence() and
+   * only valid during the router cycle in @ref
+   * Port.silent_cycle. Consumers (summing, faders,
+   * sends, meters) check it with port_is_silent()
+   * to skip work.
+   */
+  bool silent;
+
+  /** Router cycle @ref Port.silent was set in. */
+  unsigned long silent_cycle;
+
   /**
    * Contains raw MIDI data (MIDI ports only)
    */
@@ -332,6 +381,26 @@ typedef struct Port
    */
   gint64 last_change;
 
+  /**
+   * Real value queued with
+   * router_queue_control_value(), stored as the
+   * bits of a float so it can be accessed
+   * atomically.
+   */
+  volatile gint queued_control;
+
+  /** Whether the port is in
+   * Router.ctrl_value_queue. */
+  volatile gint control_queued;
+
+  /** Whether the queued value should be forwarded
+   * (plugin/UI events) once applied. */
+  volatile gint queued_forward_event;
+
+  /** Whether the port is in
+   * Router.ctrl_notify_queue. */
+  volatile gint control_notify_queued;
+
   /** Pointer to owner plugin, if any. */
   Plugin * plugin;
 
@@ -439,7 +508,9 @@ typedef struct Port
    * used in the UI instead of directly accessing
    * the events.
    *
-   * This should keep pushing MidiEvent's whenever
+   * This should keep pushing MidiEvent's (each
+   * preceded by a MidiEventHeader holding the
+   * monotonic time it was processed at) whenever
    * they occur and the reader should empty it
    * after checking if there are any events.
    *
@@ -924,6 +995,26 @@ port_set_control_value (
   const bool  is_normalized,
   const bool  forward_event);
 
+/**
+ * Forwards a control change to the DSP side of
+ * the owner (eg, Carla parameters, fader volume
+ * caches).
+ *
+ * This part of the control change event is safe
+ * to call from the processing threads.
+ */
+NONNULL
+void
+port_forward_control_change_to_dsp (Port * self);
+
+/**
+ * Forwards a control change to the UI (plugin UI
+ * and Zrythm UI events).
+ */
+NONNULL
+void
+port_forward_control_change_to_ui (Port * self);
+
 /**
  * Gets the given control value from the
  * corresponding underlying structure in the Port.
@@ -1004,6 +1095,33 @@ port_apply_fader (
     }
 }
 
+/**
+ * Gets the normalized value of the automation track
+ * of the given automatable control port at the
+ * given global frame, if the automation track
+ * should be read.
+ *
+ * Realtime-safe.
+ *
+ * @return Whether there is a value.
+ */
+HOT NONNULL bool
+port_get_automation_val (
+  Port *           self,
+  unsigned_frame_t g_frame,
+  float *          val);
+
+/**
+ * Applies the value from port_get_automation_val()
+ * to the port.
+ *
+ * @return Whether a value was read.
+ */
+HOT NONNULL bool
+port_read_automation (
+  Port *           self,
+  unsigned_frame_t g_frame);
+
 /**
  * First sets port buf to 0, then sums the given
  * port signal from its inputs.
@@ -1082,6 +1200,28 @@ port_restore_from_non_project (Port * self, Port * non_project);
 HOT NONNULL OPTIMIZE_O3 void
 port_clear_audio_cv_buffer (Port * port);
 
+/**
+ * Points @ref Port.buf back to the port's own
+ * buffer if it aliases the buffer of its source.
+ *
+ * The contents of the own buffer are left as
+ * they were.
+ */
+HOT NONNULL void
+port_unalias_buf (Port * self);
+
+/**
+ * Points @ref Port.buf back to the port's own
+ * buffer (if it aliases the buffer of its source)
+ * and clears it if the clear at the start of the
+ * cycle was skipped.
+ *
+ * To be called before writing to the buffer during
+ * processing.
+ */
+HOT NONNULL void
+port_use_own_buf (Port * self);
+
 /**
  * Clears the MIDI port buffer.
  */
@@ -1094,6 +1234,30 @@ port_clear_midi_buffer (Port * port);
 HOT NONNULL OPTIMIZE_O3 void
 port_clear_buffer (Port * port);
 
+/**
+ * Updates the silence hint after a producer
+ * processed a range of the current router cycle.
+ *
+ * The port is only considered silent if every
+ * range processed during the current router cycle
+ * (the cycle may be split at loop points) was
+ * silent.
+ *
+ * @param silent Whether the processed range is
+ *   silent.
+ */
+HOT NONNULL void
+port_update_silence (Port * self, bool silent);
+
+/**
+ * Returns whether the buffer is known to be silent
+ * in the current router cycle.
+ *
+ * False means either sound or unknown.
+ */
+HOT NONNULL PURE bool
+port_is_silent (const Port * self);
+
 /**
  * Disconnects all srcs and dests from port.
  */
@@ -319,7 +319,8 @@ position_set_min_size (
  * Updates ticks.
  *
  * @param ticks_per_frame If zero, AudioEngine.ticks_per_frame
- *   will be used instead.
+ *   will be used instead (or the tempo map if the BPM
+ *   is automated).
  */
 HOT NONNULL void
 position_update_ticks_from_frames (
@@ -341,7 +342,8 @@ position_get_frames_from_ticks (
  * Updates frames.
  *
  * @param frames_per_tick If zero, AudioEngine.frames_per_tick
- *   will be used instead.
+ *   will be used instead (or the tempo map if the BPM
+ *   is automated).
  */
 HOT NONNULL void
 position_update_frames_from_ticks (
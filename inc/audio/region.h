@@ -67,6 +67,25 @@ static const cyaml_strval_t region_musical_mode_strings[] = {
   { __ ("On"),     REGION_MUSICAL_MODE_ON     },
 };
 
+/**
+ * Parameters the cached region contents were drawn
+ * with.
+ *
+ * @see ZRegion.contents_tiles.
+ */
+typedef struct RegionContentsCacheKey
+{
+  int    full_width;
+  int    full_height;
+  int    detail;
+  guint  generation;
+  guint  version;
+  guint  tempo_map_version;
+  double px_per_tick;
+  double frames_per_tick;
+  double bpm;
+} RegionContentsCacheKey;
+
 /**
  * A region (clip) is an object on the timeline that
  * contains either MidiNote's or AudioClip's.
@@ -271,6 +290,28 @@ typedef struct ZRegion
    * are used). */
   ArrangerObject last_positions_obj;
 
+  /**
+   * Cached render nodes of the region contents
+   * (MIDI notes, waveform, automation curves,
+   * chords) for the main and lane counterparts.
+   *
+   * The contents are split in tiles along the x
+   * axis, drawn relative to the full rect, so that
+   * they can be reused when the region moves on
+   * screen or the arranger scrolls. Tiles not drawn
+   * yet are NULL.
+   */
+  GskRenderNode ** contents_tiles[2];
+  int              num_contents_tiles[2];
+
+  /** Parameters @ref ZRegion.contents_tiles were
+   * drawn with. */
+  RegionContentsCacheKey contents_key[2];
+
+  /** Incremented when anything drawn inside the
+   * region changes (see region_contents_changed()). */
+  volatile guint contents_version;
+
   /* --- drawing caches end --- */
 
   int magic;
@@ -352,6 +393,23 @@ region_init (
 HOT NONNULL ZRegion *
 region_find (const RegionIdentifier * const id);
 
+/**
+ * Returns the ZRegion matching the identifier, or
+ * NULL without warning if there is none (eg, for
+ * identifiers of clones of removed regions).
+ */
+ZRegion *
+region_find_if_exists (const RegionIdentifier * const id);
+
+/**
+ * To be called when anything drawn inside the
+ * region (its children, loop points, clip start,
+ * fades, etc.) changes, so that its cached contents
+ * are redrawn.
+ */
+void
+region_contents_changed (ZRegion * self);
+
 #if 0
 static inline void
 region_set_track_name_hash (
@@ -582,7 +640,7 @@ region_copy (ZRegion * src, ZRegion * dest);
  *   be counted as part of the region.
  */
 NONNULL
-PURE int
+int
 region_is_hit (
   const ZRegion *      region,
   const signed_frame_t gframes,
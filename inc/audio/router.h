@@ -66,6 +66,7 @@ typedef struct Plugin                Plugin;
 typedef struct Position              Position;
 typedef struct ControlPortChange     ControlPortChange;
 typedef struct EngineProcessTimeInfo EngineProcessTimeInfo;
+typedef struct AnticipativeRenderer  AnticipativeRenderer;
 
 #ifdef HAVE_JACK
 #  include "weak_libjack.h"
@@ -86,6 +87,14 @@ typedef struct Router
   /** Time info for this processing cycle. */
   EngineProcessTimeInfo time_nfo;
 
+  /**
+   * Incremented on every router_start_cycle().
+   *
+   * Used to tell whether per-thread listen bus
+   * partial sums belong to the current cycle.
+   */
+  unsigned long cycle;
+
   /** Stored for the currently processing cycle */
   nframes_t max_route_playback_latency;
 
@@ -106,6 +115,29 @@ typedef struct Router
    * for BPM/time signature changes. */
   ZixRing * ctrl_port_change_queue;
 
+  /**
+   * Ports with a value queued with
+   * router_queue_control_value().
+   *
+   * Each port is in the queue at most once (see
+   * Port.control_queued) and the value applied is
+   * the last one queued before the cycle started.
+   */
+  MPMCQueue * ctrl_value_queue;
+
+  /**
+   * Ports changed from the queue above that still
+   * need to forward their change to the UI.
+   *
+   * Drained on the GTK thread by
+   * router_dispatch_control_notifications().
+   */
+  MPMCQueue * ctrl_notify_queue;
+
+  /** Renders tracks that do not receive live
+   * input ahead of the playhead. */
+  AnticipativeRenderer * anticipative_renderer;
+
 } Router;
 
 Router *
@@ -166,6 +198,53 @@ router_queue_control_port_change (
   Router *                  self,
   const ControlPortChange * change);
 
+/**
+ * Queues a value for a control port, to be applied
+ * at the start of the next cycle.
+ *
+ * Values queued for the same port before the cycle
+ * starts are coalesced (the last value wins), and
+ * the UI is notified once per cycle for all ports
+ * changed. Safe to call from any thread.
+ *
+ * If the engine is not running the value is
+ * applied immediately.
+ *
+ * @param real_val Real (not normalized) value.
+ * @param forward_event Whether to forward the
+ *   change to the plugin/UI once applied (see
+ *   port_set_control_value()).
+ */
+NONNULL
+void
+router_queue_control_value (
+  Router * self,
+  Port *   port,
+  float    real_val,
+  bool     forward_event);
+
+/**
+ * Applies the values queued with
+ * router_queue_control_value().
+ *
+ * Called at the start of each cycle and when the
+ * engine is paused.
+ */
+NONNULL
+void
+router_apply_queued_control_values (Router * self);
+
+/**
+ * Forwards the control changes applied from the
+ * queue to the UI.
+ *
+ * To be called from the GTK thread on
+ * ET_CONTROL_PORTS_CHANGED.
+ */
+NONNULL
+void
+router_dispatch_control_notifications (Router * self);
+
 void
 router_free (Router * self);
 
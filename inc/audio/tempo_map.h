@@ -0,0 +1,141 @@
+// SPDX-FileCopyrightText: © 2022 Alexandros Theodotou <alex@zrythm.org>
+// SPDX-License-Identifier: LicenseRef-ZrythmLicense
+
+/**
+ * \file
+ *
+ * Tempo map.
+ */
+
+#ifndef __AUDIO_TEMPO_MAP_H__
+#define __AUDIO_TEMPO_MAP_H__
+
+#include <stdbool.h>
+
+#include "utils/types.h"
+
+#include <glib.h>
+
+typedef struct Track Track;
+
+/**
+ * @addtogroup audio
+ *
+ * @{
+ */
+
+/**
+ * A segment of the tempo map where the BPM changes
+ * linearly (in ticks) from \ref
+ * TempoMapSegment.start_bpm to \ref
+ * TempoMapSegment.end_bpm.
+ */
+typedef struct TempoMapSegment
+{
+  /** Start position in ticks. */
+  double start_ticks;
+
+  /** Start position in frames (cumulative frames of
+   * all previous segments). */
+  double start_frames;
+
+  /** BPM at the start of the segment. */
+  double start_bpm;
+
+  /** BPM change per tick. */
+  double bpm_per_tick;
+
+  /** Frames per tick at the start of the
+   * segment. */
+  double frames_per_tick;
+} TempoMapSegment;
+
+/**
+ * Piecewise tempo map built from the BPM automation
+ * of the tempo track, used to convert between
+ * global ticks and frames in O(log n).
+ *
+ * The first segment starts at 0 and the last
+ * segment extends to infinity. Without BPM
+ * automation there is a single constant segment,
+ * which gives the same results as
+ * AudioEngine.frames_per_tick.
+ *
+ * Maps are immutable once built, so that the audio
+ * threads can keep reading the current one while a
+ * new one is built and published (see
+ * engine_update_tempo_map()).
+ */
+typedef struct TempoMap
+{
+  TempoMapSegment * segments;
+  int               num_segments;
+
+  /** Whether the map was built from BPM
+   * automation. */
+  bool has_automation;
+
+  /** Incremented every time a different map is
+   * published. */
+  guint version;
+} TempoMap;
+
+/**
+ * Builds a tempo map from the BPM automation of the
+ * given tempo track, or the given BPM if the BPM is
+ * not automated.
+ *
+ * This costs O(automation points).
+ *
+ * @param tempo_track Tempo track, or NULL to only
+ *   use @p bpm.
+ */
+TempoMap *
+tempo_map_new (
+  Track *       tempo_track,
+  bpm_t         bpm,
+  int           beats_per_bar,
+  int           ticks_per_bar,
+  sample_rate_t sample_rate);
+
+/**
+ * Returns whether the given maps have the same
+ * segments (ignoring their versions).
+ */
+NONNULL PURE bool
+tempo_map_is_equal (
+  const TempoMap * self,
+  const TempoMap * other);
+
+/**
+ * Returns the BPM at the given global ticks.
+ */
+NONNULL PURE double
+tempo_map_get_bpm_at_ticks (
+  const TempoMap * self,
+  double           ticks);
+
+/**
+ * Converts global ticks to frames.
+ */
+NONNULL PURE double
+tempo_map_ticks_to_frames (
+  const TempoMap * self,
+  double           ticks);
+
+/**
+ * Converts global frames to ticks.
+ */
+NONNULL PURE double
+tempo_map_frames_to_ticks (
+  const TempoMap * self,
+  double           frames);
+
+NONNULL void
+tempo_map_free (TempoMap * self);
+
+/**
+ * @}
+ */
+
+#endif
@@ -45,6 +45,7 @@ typedef struct PluginDescriptor       PluginDescriptor;
 typedef struct Tracklist              Tracklist;
 typedef struct SupportedFile          SupportedFile;
 typedef struct TracklistSelections    TracklistSelections;
+typedef struct AnticipativeTrack      AnticipativeTrack;
 typedef enum PassthroughProcessorType PassthroughProcessorType;
 typedef enum FaderType                FaderType;
 typedef void                          MIDI_FILE;
@@ -329,6 +330,15 @@ typedef struct Track
    */
   bool recording_stop_sent;
 
+  /**
+   * Pre-fader part of the track if it can be
+   * rendered ahead of time by the
+   * AnticipativeRenderer.
+   *
+   * Runtime only, set when the graph is set up.
+   */
+  AnticipativeTrack * anticipative;
+
   /**
    * This must only be set by the RecordingManager
    * when temporarily pausing recording, eg when
@@ -1017,8 +1027,11 @@ track_remove_region (
  * @param stereo_ports StereoPorts to fill.
  * @param midi_events MidiEvents to fill (from
  *   Piano Roll Port for example).
+ *
+ * @return Whether any region contributed to the
+ *   given range (if false, nothing was written).
  */
-void
+bool
 track_fill_events (
   const Track *                       self,
   const EngineProcessTimeInfo * const time_nfo,
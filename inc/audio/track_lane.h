@@ -16,6 +16,7 @@
 typedef struct _TrackLaneWidget   TrackLaneWidget;
 typedef struct Tracklist          Tracklist;
 typedef struct CustomButtonWidget CustomButtonWidget;
+typedef struct ArrangerObjectIndex ArrangerObjectIndex;
 typedef void                      MIDI_FILE;
 
 /**
@@ -84,6 +85,12 @@ typedef struct TrackLane
   /** Owner track. */
   Track * track;
 
+  /**
+   * Interval index over @ref TrackLane.regions
+   * used for hit-testing, created on first use.
+   */
+  ArrangerObjectIndex * region_index;
+
 } TrackLane;
 
 static const cyaml_schema_field_t track_lane_fields_schema[] = {
@@ -18,7 +18,6 @@
 typedef struct StereoPorts           StereoPorts;
 typedef struct Port                  Port;
 typedef struct Track                 Track;
-typedef struct MidiMappings          MidiMappings;
 typedef struct EngineProcessTimeInfo EngineProcessTimeInfo;
 
 /**
@@ -36,6 +35,28 @@ typedef struct EngineProcessTimeInfo EngineProcessTimeInfo;
 #define track_processor_is_in_active_project(self) \
   (self->track && track_is_in_active_project (self->track))
 
+/**
+ * Offsets of each kind of MIDI control in the
+ * MIDI control index space (see
+ * track_processor_init_midi_control_port_id()).
+ *
+ * CCs come first (channel * 128 + controller),
+ * followed by one port per channel for each of the
+ * others.
+ */
+#define TRACK_PROCESSOR_MIDI_PITCH_BEND_OFFSET (128 * 16)
+#define TRACK_PROCESSOR_MIDI_POLY_KEY_PRESSURE_OFFSET \
+  (TRACK_PROCESSOR_MIDI_PITCH_BEND_OFFSET + 16)
+#define TRACK_PROCESSOR_MIDI_CHANNEL_PRESSURE_OFFSET \
+  (TRACK_PROCESSOR_MIDI_POLY_KEY_PRESSURE_OFFSET + 16)
+#define TRACK_PROCESSOR_NUM_MIDI_CONTROLS \
+  (TRACK_PROCESSOR_MIDI_CHANNEL_PRESSURE_OFFSET + 16)
+
+/** Number of words in
+ * TrackProcessor.midi_controls_changed. */
+#define TRACK_PROCESSOR_MIDI_CONTROLS_CHANGED_WORDS \
+  ((TRACK_PROCESSOR_NUM_MIDI_CONTROLS + 31) / 32)
+
 /**
  * A TrackProcessor is a processor that is used as
  * the first entry point when processing a track.
@@ -111,8 +132,12 @@ typedef struct TrackProcessor
 
   /* --- MIDI controls --- */
 
-  /** Mappings to each CC port. */
-  MidiMappings * cc_mappings;
+  /*
+   * The MIDI control ports below are only created
+   * on first use (see
+   * track_processor_get_midi_control_port()), so
+   * any of them may be NULL.
+   */
 
   /** MIDI CC control ports, 16 channels. */
   Port * midi_cc[128 * 16];
@@ -138,6 +163,17 @@ typedef struct TrackProcessor
    */
   Port * channel_pressure[16];
 
+  /**
+   * Bitmap of MIDI controls whose value changed
+   * since they were last sent to the MIDI out
+   * port, indexed by MIDI control index.
+   *
+   * Bits are set atomically by
+   * track_processor_mark_midi_control_changed()
+   * and cleared during processing.
+   */
+  guint * midi_controls_changed;
+
   /* --- end MIDI controls --- */
 
   /**
@@ -249,6 +285,46 @@ track_processor_copy_values (
   TrackProcessor * dest,
   TrackProcessor * src);
 
+/**
+ * Fills in the identifier of the MIDI control port
+ * at the given MIDI control index, without
+ * creating the port.
+ *
+ * @param idx MIDI control index (see
+ *   TRACK_PROCESSOR_MIDI_PITCH_BEND_OFFSET, etc.).
+ */
+NONNULL void
+track_processor_init_midi_control_port_id (
+  TrackProcessor * self,
+  PortIdentifier * id,
+  int              idx);
+
+/**
+ * Returns the MIDI control port matching the given
+ * identifier, or NULL if it was not used yet.
+ *
+ * @param create Whether to create the port if it
+ *   was not used yet. Ports must only be created
+ *   from the main thread.
+ */
+NONNULL Port *
+track_processor_get_midi_control_port (
+  TrackProcessor *       self,
+  const PortIdentifier * id,
+  bool                   create);
+
+/**
+ * Marks the value of the given MIDI control port
+ * as changed so that it is sent to the MIDI out
+ * port in the next cycle.
+ *
+ * This is realtime-safe.
+ */
+NONNULL void
+track_processor_mark_midi_control_changed (
+  const TrackProcessor * self,
+  const Port *           port);
+
 /**
  * Clears all buffers.
  */
@@ -129,6 +129,23 @@ typedef struct Tracklist
 
   /** Pointer to owner project, if any. */
   Project * project;
+
+  /**
+   * Whether the solo/listen caches below (and the
+   * ones in each channel fader) need to be
+   * refreshed.
+   *
+   * Set when a solo/listen port changes or when the
+   * routing changes, and consumed at the start of
+   * the next processing cycle.
+   */
+  volatile gint solo_caches_dirty;
+
+  /** Cache of tracklist_has_soloed(). */
+  bool has_soloed_cached;
+
+  /** Cache of tracklist_has_listened(). */
+  bool has_listened_cached;
 } Tracklist;
 
 static const cyaml_schema_field_t tracklist_fields_schema[] = {
@@ -493,6 +510,30 @@ NONNULL
 bool
 tracklist_has_listened (const Tracklist * self);
 
+/**
+ * Marks the solo/listen caches as dirty so that
+ * they get refreshed at the start of the next
+ * cycle.
+ */
+NONNULL
+void
+tracklist_mark_solo_caches_dirty (Tracklist * self);
+
+/**
+ * Refreshes the solo/listen caches if dirty.
+ *
+ * This updates @ref Tracklist.has_soloed_cached,
+ * @ref Tracklist.has_listened_cached and the
+ * soloed/implied soloed caches of each channel
+ * fader so that fader_process() does not need to
+ * walk the tracklist on every cycle.
+ *
+ * To be called at the start of each cycle.
+ */
+NONNULL
+HOT void
+tracklist_update_solo_caches (Tracklist * self);
+
 NONNULL
 int
 tracklist_get_num_muted_tracks (const Tracklist * self);
@@ -253,6 +253,17 @@ typedef struct ArrangerObject
    */
   bool deleted_temporarily;
 
+  /**
+   * Version of the tempo map (see TempoMap.version)
+   * the frames of the positions were calculated
+   * with.
+   *
+   * The frames are recalculated from the ticks
+   * lazily when the tempo map changes (see
+   * arranger_object_update_frames_if_stale()).
+   */
+  guint frames_tempo_map_version;
+
   /** 1 when hovering over the object. */
   //int                hover;
 
@@ -441,6 +452,17 @@ arranger_object_set_magic (ArrangerObject * self);
 HOT ZRegion *
 arranger_object_get_region (const ArrangerObject * const self);
 
+/**
+ * Marks the contents of the region drawn with the
+ * object as changed (the region itself if @ref self
+ * is a region, otherwise the region it is part of).
+ *
+ * Does nothing if the region does not exist in the
+ * project (eg, if @ref self is a clone).
+ */
+void
+arranger_object_contents_changed (ArrangerObject * self);
+
 /**
  * Returns a pointer to the name of the object,
  * if the object can have names.
@@ -845,6 +867,20 @@ arranger_object_get_loop_length_in_frames (
   return self->loop_end_pos.frames - self->loop_start_pos.frames;
 }
 
+/**
+ * Recalculates the frames of the positions of the
+ * object and its children from their ticks if they
+ * were calculated with an older tempo map.
+ *
+ * Only the frames are written, so this may be
+ * called from the processing threads. Readers of
+ * the frames of regions are expected to call this
+ * first (region_is_hit() etc. already do).
+ */
+HOT NONNULL void
+arranger_object_update_frames_if_stale (
+  ArrangerObject * self);
+
 /**
  * Updates the positions in each child recursively.
  *
@@ -0,0 +1,142 @@
+// SPDX-FileCopyrightText: © 2022 Alexandros Theodotou <alex@zrythm.org>
+// SPDX-License-Identifier: LicenseRef-ZrythmLicense
+
+/**
+ * \file
+ *
+ * Interval index over arranger objects, used for
+ * hit-testing.
+ */
+
+#ifndef __GUI_BACKEND_ARRANGER_OBJECT_INDEX_H__
+#define __GUI_BACKEND_ARRANGER_OBJECT_INDEX_H__
+
+#include <stdbool.h>
+
+#include "utils/types.h"
+
+#include <glib.h>
+
+typedef struct ArrangerObject ArrangerObject;
+
+/**
+ * @addtogroup gui_backend
+ *
+ * @{
+ */
+
+/**
+ * Max number of moved objects to reinsert
+ * incrementally before falling back to a full
+ * rebuild.
+ */
+#define ARRANGER_OBJECT_INDEX_MAX_MOVED 32
+
+/**
+ * Interval index over a list of arranger objects
+ * with global positions (eg, the regions in a
+ * TrackLane).
+ *
+ * The objects are kept sorted by start position
+ * and the array is treated as an implicit balanced
+ * binary tree (the middle element of each range is
+ * the root of that range), with the max end
+ * position of each subtree cached, so that range
+ * queries take O(log n + k).
+ *
+ * The index is updated lazily on the next query:
+ * - fully (with a sort) when objects were added or
+ *   removed (see arranger_object_index_invalidate()),
+ * - by removing and reinserting only the objects
+ *   that moved (see
+ *   arranger_object_index_object_moved()).
+ *
+ * Each index (eg, each lane) is only updated for
+ * its own changes.
+ */
+typedef struct ArrangerObjectIndex
+{
+  /** Objects, sorted by start position. */
+  ArrangerObject ** objs;
+  int               num_objs;
+  size_t            objs_size;
+
+  /** Start ticks of each object at build time. */
+  double * starts;
+
+  /** End ticks of each object at build time. */
+  double * ends;
+
+  /** Max end ticks in the subtree rooted at each
+   * index. */
+  double * max_ends;
+
+  /** Objects whose positions changed since the
+   * index was updated. */
+  ArrangerObject * moved[ARRANGER_OBJECT_INDEX_MAX_MOVED];
+  int              num_moved;
+
+  /** Whether objects were added/removed since the
+   * index was built. */
+  bool members_dirty;
+} ArrangerObjectIndex;
+
+ArrangerObjectIndex *
+arranger_object_index_new (void);
+
+/**
+ * Marks the object list as changed.
+ *
+ * To be called when objects are added or removed
+ * from the list the index is built from.
+ */
+NONNULL void
+arranger_object_index_invalidate (
+  ArrangerObjectIndex * self);
+
+/**
+ * Marks the position of the given indexed object
+ * as changed.
+ *
+ * The object is reinserted at its new position on
+ * the next update. This is cheap enough to call
+ * from position setters.
+ */
+NONNULL void
+arranger_object_index_object_moved (
+  ArrangerObjectIndex * self,
+  ArrangerObject *      obj);
+
+/**
+ * Rebuilds the index from the given objects if
+ * needed.
+ */
+NONNULL void
+arranger_object_index_update (
+  ArrangerObjectIndex * self,
+  ArrangerObject **     objs,
+  int                   num_objs);
+
+/**
+ * Appends the objects that overlap the given range
+ * (inclusive) to @p arr.
+ *
+ * The objects are appended in no particular order.
+ * arranger_object_index_update() must be called
+ * before this.
+ */
+NONNULL void
+arranger_object_index_query (
+  ArrangerObjectIndex * self,
+  double                start_ticks,
+  double                end_ticks,
+  GPtrArray *           arr);
+
+NONNULL void
+arranger_object_index_free (ArrangerObjectIndex * self);
+
+/**
+ * @}
+ */
+
+#endif
@@ -109,6 +109,12 @@ typedef enum EventType
 
   ET_PLUGIN_STATE_CHANGED,
 
+  /** Control port values queued with
+   * router_queue_control_value() were applied;
+   * the changed ports are in
+   * Router.ctrl_notify_queue. */
+  ET_CONTROL_PORTS_CHANGED,
+
   ET_TRACKS_ADDED,
   ET_TRACKS_REMOVED,
   ET_TRACKS_MOVED,
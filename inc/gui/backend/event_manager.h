@@ -26,6 +26,39 @@ typedef struct ZEvent ZEvent;
  * @{
  */
 
+/**
+ * Widget refreshes requested by event handlers.
+ *
+ * These are collected while processing a batch of
+ * events and performed once at the end, so that
+ * many events affecting the same widget only cause
+ * one refresh.
+ */
+typedef enum EventManagerRefreshFlags
+{
+  EM_REFRESH_LEFT_DOCK_EDGE = 1 << 0,
+  EM_REFRESH_TIMELINE_TOOLBAR = 1 << 1,
+  EM_REFRESH_MIXER = 1 << 2,
+  EM_REFRESH_TRACKLIST = 1 << 3,
+  EM_REFRESH_TIMELINE_RULER = 1 << 4,
+  EM_REFRESH_EDITOR_RULER = 1 << 5,
+  EM_REFRESH_TIMELINE_MINIMAP = 1 << 6,
+  EM_REFRESH_TIMELINE_EVENT_VIEWER = 1 << 7,
+  EM_REFRESH_MIDI_EVENT_VIEWER = 1 << 8,
+  EM_REFRESH_CHORD_EVENT_VIEWER = 1 << 9,
+  EM_REFRESH_AUTOMATION_EVENT_VIEWER = 1 << 10,
+  EM_REFRESH_AUDIO_EVENT_VIEWER = 1 << 11,
+} EventManagerRefreshFlags;
+
+/**
+ * Time budget in microseconds for processing
+ * low-priority events in each cycle.
+ *
+ * Low-priority events that don't fit in the budget
+ * are deferred to the next cycle.
+ */
+#define EVENT_MANAGER_LOW_PRIORITY_BUDGET_USEC 4000
+
 /**
  * Event manager.
  */
@@ -51,6 +84,23 @@ typedef struct EventManager
 
   /** Events array to use during processing. */
   GPtrArray * events_arr;
+
+  /** Set of (type, arg) pairs in \ref events_arr,
+   * used to coalesce events. */
+  GHashTable * events_set;
+
+  /** Low-priority events deferred to the next
+   * cycle because the time budget was exceeded. */
+  GPtrArray * deferred_events;
+
+  /** Refreshes to perform after the current batch
+   * of events. */
+  EventManagerRefreshFlags queued_refreshes;
+
+  /** Whether a batch of events is being processed
+   * (refreshes are then performed at the end of the
+   * batch). */
+  bool processing_batch;
 } EventManager;
 
 #define EVENT_MANAGER (ZRYTHM->event_manager)
@@ -117,13 +117,12 @@ typedef struct _AutomatableSelectorPopoverWidget
   int                     selected_slot;
 
   /**
-   * The selected Port will be stored here
-   * and passed to the button when closing so that
-   * it can hide the current AutomationTrack and
-   * create/show the one corresponding to this
-   * Automatable.
+   * The selected AutomationTrack will be stored
+   * here and passed to the button when closing so
+   * that it can hide the current AutomationTrack
+   * and create/show this one.
    */
-  Port * selected_port;
+  AutomationTrack * selected_at;
 } AutomatableSelectorPopoverWidget;
 
 /**
@@ -79,10 +79,14 @@ automation_point_is_curve_hit (
 /**
  * Returns whether the cached render node for @ref
  * self needs to be invalidated.
+ *
+ * @param next_ap The point the curve ends at, if
+ *   any.
  */
 bool
 automation_point_settings_changed (
   const AutomationPoint * self,
+  const AutomationPoint * next_ap,
   const GdkRectangle *    draw_rect,
   bool                    timeline);
 
@@ -28,6 +28,8 @@
 
 #include "zrythm-config.h"
 
+#include <stdbool.h>
+
 #include <gtk/gtk.h>
 
 #pragma GCC diagnostic push
@@ -60,6 +62,8 @@ typedef struct _LogViewerWidget
   GtkBox *            source_view_box;
   GtkSourceView *     src_view;
 
+  /** Whether the log file finished loading. */
+  bool loaded;
 } LogViewerWidget;
 
 /**
@@ -68,6 +72,15 @@ typedef struct _LogViewerWidget
 LogViewerWidget *
 log_viewer_widget_new (void);
 
+/**
+ * Appends a line logged after the log file was
+ * loaded.
+ */
+void
+log_viewer_widget_append (
+  LogViewerWidget * self,
+  const char *      str);
+
 /**
  * @}
  */
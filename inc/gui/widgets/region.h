@@ -38,6 +38,19 @@
 void
 region_get_lane_full_rect (ZRegion * self, GdkRectangle * rect);
 
+/**
+ * Marks the cached contents of all regions as
+ * stale, so they get redrawn on the next frame.
+ */
+void
+region_invalidate_contents_caches (void);
+
+/**
+ * Frees the cached contents of the region.
+ */
+void
+region_free_contents_cache (ZRegion * self);
+
 /**
  * Draws the ZRegion in the given cairo context in
  * relative coordinates.
@@ -77,6 +77,11 @@ typedef struct CarlaNativePlugin
   //uint32_t                 num_midi_events;
   //NativeMidiEvent          midi_events[200];
   NativeTimeInfo time_info;
+
+  /** Offset of the block being processed in the
+   * cycle, added to the times of the MIDI events
+   * the plugin outputs. */
+  nframes_t local_offset;
 #  endif
 
   /** Pointer back to Plugin. */
@@ -136,6 +141,20 @@ typedef struct CarlaNativePlugin
   unsigned int max_variant_midi_ins;
   unsigned int max_variant_midi_outs;
 
+  /**
+   * PID of the bridge process hosting the plugin
+   * when fully bridged, or 0 if unknown or not
+   * bridged.
+   */
+  int bridge_pid;
+
+  /** CPU time used by the bridge process at the
+   * last load update, in microseconds. */
+  int64_t bridge_cpu_time;
+
+  /** Monotonic time of the last load update. */
+  gint64 bridge_cpu_time_updated;
+
 } CarlaNativePlugin;
 
 #  ifdef HAVE_CARLA
@@ -308,6 +327,20 @@ NONNULL
 nframes_t
 carla_native_plugin_get_latency (CarlaNativePlugin * self);
 
+/**
+ * Returns the CPU load (0-1 of one core) of the
+ * bridge process hosting the plugin since the last
+ * call, as reported by the process itself, or a
+ * negative value if the plugin is not fully bridged
+ * or the load is unknown.
+ *
+ * To be called periodically from the GTK thread.
+ */
+NONNULL
+float
+carla_native_plugin_get_bridge_cpu_load (
+  CarlaNativePlugin * self);
+
 /**
  * Deactivates, cleanups and frees the instance.
  */
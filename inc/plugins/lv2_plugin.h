@@ -258,6 +258,21 @@ typedef struct Lv2Plugin
    */
   bool has_default_state;
 
+  /**
+   * Whether lv2_plugin_instantiate() should leave
+   * applying the state to
+   * lv2_plugin_apply_deferred_state().
+   *
+   * Set by plugin_instantiate_batch().
+   */
+  bool defer_state_restore;
+
+  /**
+   * State to be applied by
+   * lv2_plugin_apply_deferred_state(), if any.
+   */
+  LilvState * deferred_state;
+
   /**
    * Index of control input port, or -1 if no port
    * with "control" designation found.
@@ -409,6 +424,18 @@ lv2_plugin_instantiate (
   LilvState * state,
   GError **   error);
 
+/**
+ * Applies the state that was left out during
+ * instantiation because of
+ * Lv2Plugin.defer_state_restore.
+ *
+ * This may be called from a non-GTK thread, as long
+ * as the plugin is not activated yet and nothing
+ * else accesses it.
+ */
+NONNULL void
+lv2_plugin_apply_deferred_state (Lv2Plugin * self);
+
 /**
  * Creates a new LV2 plugin using the given Plugin
  * instance.
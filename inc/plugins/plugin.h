@@ -56,6 +56,21 @@ typedef struct _WrappedObjectWithChangeSignal
 #define PLUGIN_MIN_SCALE_FACTOR 0.5f
 #define PLUGIN_MAX_SCALE_FACTOR 4.f
 
+/**
+ * Number of consecutive blocks (of
+ * AudioEngine.block_length frames) with silent
+ * input after which a plugin with auto-sleep
+ * enabled may go to sleep.
+ */
+#define PLUGIN_AUTO_SLEEP_SILENT_BLOCKS 16
+
+/**
+ * Output amplitude (-90 dBFS) below which the tail
+ * of a plugin with silent input is considered
+ * finished.
+ */
+#define PLUGIN_AUTO_SLEEP_TAIL_THRESHOLD 0.0000316f
+
 #define plugin_is_in_active_project(self) \
   (self->track && track_is_in_active_project (self->track))
 
@@ -271,6 +286,41 @@ typedef struct Plugin
   /** Whether the plugin is used for functions. */
   bool is_function;
 
+  /**
+   * Whether to skip processing the plugin while its
+   * input is silent and its output has decayed.
+   *
+   * See plugin_set_auto_sleep().
+   */
+  bool auto_sleep;
+
+  /** Whether the plugin is currently sleeping
+   * (auto-sleep). */
+  bool sleeping;
+
+  /** Number of consecutive frames with silent
+   * input (auto-sleep). */
+  uint64_t silent_input_frames;
+
+  /**
+   * Set by plugin_set_auto_sleep() to have the
+   * processing thread reset the auto-sleep state
+   * and statistics (atomic).
+   */
+  volatile gint auto_sleep_reset_requested;
+
+  /** Frames processed while auto-sleep was
+   * enabled (statistics). */
+  uint64_t awake_frames;
+
+  /** Frames skipped while sleeping
+   * (statistics). */
+  uint64_t sleep_frames;
+
+  /** Number of times the plugin woke up
+   * (statistics). */
+  unsigned int num_wakeups;
+
   /** Pointer to owner track, if any. */
   Track * track;
 
@@ -313,6 +363,7 @@ static const cyaml_schema_field_t plugin_fields_schema[] = {
     plugin_preset_identifier_fields_schema),
   YAML_FIELD_INT (Plugin, visible),
   YAML_FIELD_STRING_PTR_OPTIONAL (Plugin, state_dir),
+  YAML_FIELD_INT_OPT (Plugin, auto_sleep),
 
   CYAML_FIELD_END
 };
@@ -645,6 +696,33 @@ plugin_generate_automation_tracks (
   Plugin * plugin,
   Track *  track);
 
+/**
+ * Enables or disables auto-sleep.
+ *
+ * When enabled, the plugin is not processed (and
+ * its outputs are silent) after its audio, CV and
+ * MIDI inputs have been silent for
+ * @ref PLUGIN_AUTO_SLEEP_SILENT_BLOCKS blocks and
+ * its output has decayed below
+ * @ref PLUGIN_AUTO_SLEEP_TAIL_THRESHOLD. It wakes up
+ * as soon as any input is not silent.
+ *
+ * Plugins without audio, CV or MIDI inputs never
+ * sleep.
+ *
+ * This also resets the statistics on the next
+ * processing cycle.
+ */
+NONNULL void
+plugin_set_auto_sleep (Plugin * self, bool auto_sleep);
+
+/**
+ * Returns the fraction of frames (0-1) skipped by
+ * auto-sleep since it was enabled.
+ */
+NONNULL float
+plugin_get_auto_sleep_ratio (const Plugin * self);
+
 /**
  * Prepare plugin for processing.
  */
@@ -662,6 +740,28 @@ plugin_instantiate (
   LilvState * state,
   GError **   error);
 
+/**
+ * Instantiates the given plugins.
+ *
+ * The plugins are instantiated one by one since
+ * the LV2 world and Carla are not thread-safe, but
+ * the states of LV2 plugins (usually the slow part,
+ * e.g. for sample-based instruments) are restored
+ * in parallel. The plugins are only activated once
+ * all of them are ready.
+ *
+ * Plugins that are already instantiated or failed
+ * to instantiate are skipped.
+ *
+ * @param activate Whether to activate the plugins
+ *   and restore their enabled state.
+ */
+void
+plugin_instantiate_batch (
+  Plugin ** plugins,
+  int       num_plugins,
+  bool      activate);
+
 /**
  * Sets the track name hash on the plugin.
  */
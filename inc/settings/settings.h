@@ -43,6 +43,11 @@ typedef struct UserShortcuts  UserShortcuts;
 
 /* ---- Preferences ---- */
 #define S_P_DSP_PAN SETTINGS->preferences_dsp_pan
+#define S_P_DSP_AUTOMATION \
+  SETTINGS->preferences_dsp_automation
+#define S_P_DSP_ANTICIPATIVE \
+  SETTINGS->preferences_dsp_anticipative
+#define S_P_DSP_THREADS SETTINGS->preferences_dsp_threads
 #define S_P_EDITING_AUDIO SETTINGS->preferences_editing_audio
 #define S_P_EDITING_AUTOMATION \
   SETTINGS->preferences_editing_automation
@@ -88,6 +93,9 @@ typedef struct Settings
   /** All preferences_* settings are to be shown in
    * the preferences dialog. */
   GSettings * preferences_dsp_pan;
+  GSettings * preferences_dsp_automation;
+  GSettings * preferences_dsp_anticipative;
+  GSettings * preferences_dsp_threads;
   GSettings * preferences_editing_audio;
   GSettings * preferences_editing_automation;
   GSettings * preferences_editing_undo;
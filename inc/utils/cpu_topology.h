@@ -0,0 +1,140 @@
+// SPDX-FileCopyrightText: © 2022 Alexandros Theodotou <alex@zrythm.org>
+// SPDX-License-Identifier: LicenseRef-ZrythmLicense
+
+/**
+ * \file
+ *
+ * CPU topology, used to pin the processing threads
+ * to CPUs.
+ */
+
+#ifndef __UTILS_CPU_TOPOLOGY_H__
+#define __UTILS_CPU_TOPOLOGY_H__
+
+#include "zrythm-config.h"
+
+#include <stdbool.h>
+
+/**
+ * @addtogroup utils
+ *
+ * @{
+ */
+
+/** Max number of CPUs considered. */
+#define CPU_TOPOLOGY_MAX_CPUS 1024
+
+/**
+ * How to pin the processing threads to CPUs.
+ */
+typedef enum CpuAffinity
+{
+  /** Let the scheduler move the threads around. */
+  CPU_AFFINITY_NONE,
+
+  /** Pin each thread to a CPU, in CPU order. */
+  CPU_AFFINITY_CORES,
+
+  /** Pin each thread to a CPU, filling one group of
+   * CPUs sharing the last level cache (and NUMA
+   * node) before moving to the next. */
+  CPU_AFFINITY_CACHE_GROUPS,
+} CpuAffinity;
+
+static const char * cpu_affinity_str[] = {
+  __ ("None"),
+  __ ("Cores"),
+  __ ("Cache Groups"),
+};
+
+typedef struct CpuTopologyCpu
+{
+  int id;
+
+  /** Lowest CPU ID sharing the last level cache
+   * with this CPU. */
+  int cache_group;
+
+  int numa_node;
+
+  /** Whether the CPU is isolated from the
+   * scheduler (isolcpus). */
+  bool isolated;
+
+  /** Whether the process may run on the CPU by
+   * default. */
+  bool allowed;
+} CpuTopologyCpu;
+
+/**
+ * Online CPUs of the system.
+ */
+typedef struct CpuTopology
+{
+  /** CPUs sorted by ID. */
+  CpuTopologyCpu * cpus;
+  int              num_cpus;
+} CpuTopology;
+
+/**
+ * Returns a topology with @p num_cpus allowed CPUs
+ * sharing a cache, with IDs starting from 0.
+ */
+CpuTopology *
+cpu_topology_new (int num_cpus);
+
+/**
+ * Reads the topology of the system.
+ *
+ * Only Linux is supported; elsewhere this returns
+ * the same as cpu_topology_new().
+ */
+CpuTopology *
+cpu_topology_new_from_system (void);
+
+/**
+ * Parses a CPU list in the kernel's format (eg,
+ * "0-3,8,10-11").
+ *
+ * @param[out] cpus Array of @p max_cpus flags set
+ *   for the CPUs in the list.
+ *
+ * @return The number of CPUs in the list, or -1 if
+ *   the list is invalid.
+ */
+int
+cpu_topology_parse_cpu_list (
+  const char * str,
+  bool *       cpus,
+  int          max_cpus);
+
+/**
+ * Decides the CPU each thread should be pinned to.
+ *
+ * Only isolated CPUs are used if @p use_isolated is
+ * true and there are any, otherwise only allowed
+ * CPUs that are not isolated. Threads wrap around
+ * if there are more threads than CPUs.
+ *
+ * @param[out] cpus Array of @p num_threads CPU IDs,
+ *   or -1 for threads that should not be pinned.
+ *
+ * @return The number of CPUs the threads are pinned
+ *   to, or 0 if they are not pinned.
+ */
+int
+cpu_topology_get_thread_cpus (
+  const CpuTopology * self,
+  CpuAffinity         affinity,
+  bool                use_isolated,
+  int                 num_threads,
+  int *               cpus);
+
+void
+cpu_topology_free (CpuTopology * self);
+
+/**
+ * @}
+ */
+
+#endif
@@ -6,6 +6,9 @@
  *
  * Optimized DSP functions.
  *
+ * Each function dispatches to the backend selected
+ * by dsp_init() (see @ref DspBackend).
+ *
  * @note More at https://github.com/DISTRHO/DPF-Max-Gen/blob/master/plugins/common/gen_dsp/genlib_ops.h#L313
  */
 
@@ -22,9 +25,75 @@
 
 #include <glib.h>
 
-#ifdef HAVE_LSP_DSP
-#  include <lsp-plug.in/dsp/dsp.h>
-#endif
+/**
+ * DSP implementation to use.
+ */
+typedef enum DspBackend
+{
+  /** Plain C loops. */
+  DSP_BACKEND_SCALAR,
+
+  /** In-tree SSE2 kernels. */
+  DSP_BACKEND_SSE2,
+
+  /** In-tree AVX2 kernels. */
+  DSP_BACKEND_AVX2,
+
+  /** In-tree AVX-512 kernels. */
+  DSP_BACKEND_AVX512,
+
+  /** In-tree NEON kernels. */
+  DSP_BACKEND_NEON,
+
+  /** lsp-dsp-lib (if available). */
+  DSP_BACKEND_LSP,
+
+  NUM_DSP_BACKENDS,
+} DspBackend;
+
+/**
+ * Selects the DSP backend to use based on the
+ * features of the running CPU.
+ *
+ * Must be called once at startup, before any dsp_*()
+ * function is called from more than one thread.
+ *
+ * @param optimized Whether to use optimized
+ *   routines. If false, the scalar backend is used.
+ */
+void
+dsp_init (bool optimized);
+
+/**
+ * Returns whether the given backend can be used on
+ * this machine.
+ */
+bool
+dsp_backend_is_supported (DspBackend backend);
+
+/**
+ * Returns a human-readable name for the backend.
+ */
+const char *
+dsp_backend_get_name (DspBackend backend);
+
+/**
+ * Returns the backend currently in use.
+ */
+PURE DspBackend
+dsp_get_backend (void);
+
+/**
+ * Forces the given backend.
+ *
+ * @note Not realtime-safe - only to be used at
+ *   startup and by tests/benchmarks.
+ *
+ * @return Whether the backend was set (false if not
+ *   supported on this machine).
+ */
+bool
+dsp_set_backend (DspBackend backend);
 
 /**
  * Fill the buffer with the given value.
@@ -35,26 +104,8 @@ dsp_fill (float * buf, float val, size_t size);
 /**
  * Clamp the buffer to min/max.
  */
-NONNULL
-HOT static inline void
-dsp_limit1 (float * buf, float minf, float maxf, size_t size)
-{
-#ifdef HAVE_LSP_DSP
-  if (ZRYTHM_USE_OPTIMIZED_DSP)
-    {
-      lsp_dsp_limit1 (buf, minf, maxf, size);
-    }
-  else
-    {
-#endif
-      for (size_t i = 0; i < size; i++)
-        {
-          buf[i] = CLAMP (buf[i], minf, maxf);
-        }
-#ifdef HAVE_LSP_DSP
-    }
-#endif
-}
+HOT NONNULL void
+dsp_limit1 (float * buf, float minf, float maxf, size_t size);
 
 NONNULL
 HOT void
@@ -73,69 +124,19 @@ dsp_mul_k2 (float * dest, float k, size_t size);
  */
 NONNULL
 WARN_UNUSED_RESULT
-static inline float
-dsp_abs_max (float * buf, size_t size)
-{
-#ifdef HAVE_LSP_DSP
-  if (ZRYTHM_USE_OPTIMIZED_DSP)
-    {
-      return lsp_dsp_abs_max (buf, size);
-    }
-  else
-    {
-#endif
-      float ret = 1e-20f;
-      for (size_t i = 0; i < size; i++)
-        {
-          if (fabsf (buf[i]) > ret)
-            {
-              ret = fabsf (buf[i]);
-            }
-        }
-      return ret;
-#ifdef HAVE_LSP_DSP
-    }
-#endif
-}
+float
+dsp_abs_max (float * buf, size_t size);
 
 /**
  * Gets the absolute max of the buffer.
  *
  * @return Whether the peak changed.
  */
-HOT NONNULL static inline bool
+HOT NONNULL bool
 dsp_abs_max_with_existing_peak (
   float * buf,
   float * cur_peak,
-  size_t  size)
-{
-  float new_peak = *cur_peak;
-
-#ifdef HAVE_LSP_DSP
-  if (ZRYTHM_USE_OPTIMIZED_DSP)
-    {
-      new_peak = lsp_dsp_abs_max (buf, size);
-    }
-  else
-    {
-#endif
-      for (size_t i = 0; i < size; i++)
-        {
-          float val = fabsf (buf[i]);
-          if (val > new_peak)
-            {
-              new_peak = val;
-            }
-        }
-#ifdef HAVE_LSP_DSP
-    }
-#endif
-
-  bool changed = !math_floats_equal (new_peak, *cur_peak);
-  *cur_peak = new_peak;
-
-  return changed;
-}
+  size_t  size);
 
 /**
  * Gets the minimum of the buffer.
@@ -162,30 +163,13 @@ dsp_add2 (float * dest, const float * src, size_t count);
  * Calculate dest[i] = dest[i] * k1 + src[i] * k2.
  */
 NONNULL
-HOT static inline void
+HOT void
 dsp_mix2 (
   float *       dest,
   const float * src,
   float         k1,
   float         k2,
-  size_t        size)
-{
-#ifdef HAVE_LSP_DSP
-  if (ZRYTHM_USE_OPTIMIZED_DSP)
-    {
-      lsp_dsp_mix2 (dest, src, k1, k2, size);
-    }
-  else
-    {
-#endif
-      for (size_t i = 0; i < size; i++)
-        {
-          dest[i] = dest[i] * k1 + src[i] * k2;
-        }
-#ifdef HAVE_LSP_DSP
-    }
-#endif
-}
+  size_t        size);
 
 /**
  * Calculate
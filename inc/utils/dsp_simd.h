@@ -0,0 +1,99 @@
+// SPDX-FileCopyrightText: © 2022 Alexandros Theodotou <alex@zrythm.org>
+// SPDX-License-Identifier: LicenseRef-ZrythmLicense
+
+/**
+ * @file
+ *
+ * In-tree SIMD kernels backing the functions in
+ * dsp.h.
+ *
+ * @note This is an internal header used by dsp.c and
+ *   the DSP tests. Other code should use dsp.h.
+ */
+
+#ifndef __UTILS_DSP_SIMD_H__
+#define __UTILS_DSP_SIMD_H__
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * @addtogroup utils
+ *
+ * @{
+ */
+
+/**
+ * Table of DSP kernels for a specific instruction
+ * set.
+ *
+ * Each kernel has the same semantics as the
+ * corresponding dsp_*() function, except for
+ * @ref DspKernels.abs_max, which does not apply the
+ * 1e-20 floor.
+ */
+typedef struct DspKernels
+{
+  /** Human-readable name (for logging). */
+  const char * name;
+
+  void (*fill) (float * buf, float val, size_t size);
+  void (*limit1) (
+    float * buf,
+    float   minf,
+    float   maxf,
+    size_t  size);
+  void (*copy) (float * dest, const float * src, size_t size);
+  void (*mul_k2) (float * dest, float k, size_t size);
+  float (*abs_max) (const float * buf, size_t size);
+  float (*min) (const float * buf, size_t size);
+  float (*max) (const float * buf, size_t size);
+  void (*add2) (float * dest, const float * src, size_t size);
+  void (*mix2) (
+    float *       dest,
+    const float * src,
+    float         k1,
+    float         k2,
+    size_t        size);
+  void (*mix_add2) (
+    float *       dest,
+    const float * src1,
+    const float * src2,
+    float         k1,
+    float         k2,
+    size_t        size);
+  void (*linear_fade_in_from) (
+    float * dest,
+    int32_t start_offset,
+    int32_t total_frames_to_fade,
+    size_t  size,
+    float   fade_from_multiplier);
+  void (*linear_fade_out_to) (
+    float * dest,
+    int32_t start_offset,
+    int32_t total_frames_to_fade,
+    size_t  size,
+    float   fade_to_multiplier);
+} DspKernels;
+
+/** Plain C reference implementation. */
+extern const DspKernels dsp_kernels_scalar;
+
+#if defined(__x86_64__) || defined(__i386__)
+#  define DSP_SIMD_HAVE_X86 1
+extern const DspKernels dsp_kernels_sse2;
+extern const DspKernels dsp_kernels_avx2;
+extern const DspKernels dsp_kernels_avx512;
+#endif
+
+#if defined(__aarch64__)
+#  define DSP_SIMD_HAVE_NEON 1
+extern const DspKernels dsp_kernels_neon;
+#endif
+
+/**
+ * @}
+ */
+
+#endif
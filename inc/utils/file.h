@@ -26,8 +26,11 @@
 #ifndef __UTILS_FILE_H__
 #define __UTILS_FILE_H__
 
+#include <stdbool.h>
 #include <stdio.h>
 
+#include <glib.h>
+
 /**
  * @addtogroup utils
  *
@@ -54,6 +57,25 @@ file_symlink (const char * old_path, const char * new_path);
 int
 file_reflink (const char * dest, const char * src);
 
+/**
+ * Makes \ref dest a file with the same contents as
+ * \ref src, sharing the data on disk if possible.
+ *
+ * Tries a hard link first, then a reflink and falls
+ * back to copying.
+ *
+ * @note Hard-linked files share their data, so the
+ *   files must never be modified in place (remove
+ *   them before writing to the path instead).
+ *
+ * @return Whether successful.
+ */
+bool
+file_link_or_copy (
+  const char * dest,
+  const char * src,
+  GError **    error);
+
 /**
  * @}
  */
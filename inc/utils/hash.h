@@ -47,6 +47,16 @@ hash_get_for_struct_full (
 uint32_t
 hash_get_for_struct (const void * const obj, size_t size);
 
+/**
+ * Returns a 64-bit hash of the given data (XXH3 if
+ * available).
+ */
+uint64_t
+hash_get_for_data_64 (
+  const void * data,
+  size_t       size,
+  uint64_t     seed);
+
 /**
  * @}
  */
@@ -20,6 +20,44 @@ typedef struct ObjectPool       ObjectPool;
 
 #define LOG (zlog)
 
+/** Number of records each thread can queue with
+ * log_record(). */
+#define LOG_RECORD_RING_SIZE 256
+
+/** Max number of threads that can use log_record()
+ * at the same time. */
+#define LOG_MAX_RECORD_RINGS 32
+
+/** Max number of arguments in a record. */
+#define LOG_RECORD_MAX_ARGS 8
+
+/** Space for the string arguments of a record
+ * (longer strings are truncated). */
+#define LOG_RECORD_STRS_SIZE 96
+
+/**
+ * Logs a message from a realtime thread.
+ *
+ * The message is stored as a fixed-size record
+ * (the format string pointer and the arguments)
+ * and is formatted and written by a background
+ * thread, so this does not allocate, lock or do
+ * any I/O.
+ *
+ * The format must be a string literal. Only the
+ * standard conversions without \c * width or
+ * precision are supported.
+ */
+#define z_rt_log(log_level, ...) \
+  log_record (LOG, log_level, __func__, __LINE__, __VA_ARGS__)
+
+#define z_rt_debug(...) \
+  z_rt_log (G_LOG_LEVEL_DEBUG, __VA_ARGS__)
+#define z_rt_message(...) \
+  z_rt_log (G_LOG_LEVEL_MESSAGE, __VA_ARGS__)
+#define z_rt_warning(...) \
+  z_rt_log (G_LOG_LEVEL_WARNING, __VA_ARGS__)
+
 typedef struct Log
 {
   FILE * logfile;
@@ -75,6 +113,18 @@ typedef struct Log
    * popups at once.
    */
   gint64 last_bt_time;
+
+  /** Thread that formats and writes the records
+   * from log_record(). */
+  GThread * record_thread;
+
+  /** Whether the record thread should keep
+   * running. */
+  volatile gint record_thread_running;
+
+  /** Lines formatted by the record thread, to be
+   * appended to the log viewer. */
+  MPMCQueue * viewer_queue;
 } Log;
 
 /** Global variable, available to all files. */
@@ -137,6 +187,34 @@ log_generate_compressed_file (
 void
 log_init_with_file (Log * self, const char * filepath);
 
+/**
+ * Queues a log record in the ring of the calling
+ * thread.
+ *
+ * If the ring is full the record is dropped and
+ * counted (see log_get_num_dropped_records()).
+ * Falls back to g_logv() if logging to a file is
+ * not initialized.
+ *
+ * Use z_rt_log() and friends instead of calling
+ * this directly.
+ */
+void
+log_record (
+  Log *          self,
+  GLogLevelFlags log_level,
+  const char *   func,
+  int            line,
+  const char *   format,
+  ...) G_GNUC_PRINTF (5, 6);
+
+/**
+ * Returns the number of records dropped because
+ * the ring of the calling thread was full.
+ */
+int
+log_get_num_dropped_records (void);
+
 /**
  * Returns a pointer to the global zlog.
  */
@@ -0,0 +1,126 @@
+// SPDX-FileCopyrightText: © 2022 Alexandros Theodotou <alex@zrythm.org>
+// SPDX-License-Identifier: LicenseRef-ZrythmLicense
+
+/**
+ * \file
+ *
+ * Realtime-safety audit for the processing threads.
+ *
+ * When built with the \c rt_audit option, calls to
+ * malloc/calloc/realloc/free, blocking mutex locks
+ * and log messages made while a thread is inside an
+ * audited section (see rt_audit_enter()) are
+ * recorded with their backtraces. Without the
+ * option all the functions here are no-ops.
+ */
+
+#ifndef __UTILS_RT_AUDIT_H__
+#define __UTILS_RT_AUDIT_H__
+
+#include "zrythm-config.h"
+
+#include <stdbool.h>
+
+#include <glib.h>
+
+/**
+ * @addtogroup utils
+ *
+ * @{
+ */
+
+/** Max number of violations with backtraces kept;
+ * further violations are only counted. */
+#define RT_AUDIT_MAX_VIOLATIONS 1024
+
+/** Max number of stack frames kept per
+ * violation. */
+#define RT_AUDIT_MAX_FRAMES 32
+
+typedef enum RtAuditViolationType
+{
+  RT_AUDIT_VIOLATION_ALLOC,
+  RT_AUDIT_VIOLATION_FREE,
+  RT_AUDIT_VIOLATION_LOCK,
+  RT_AUDIT_VIOLATION_LOG,
+} RtAuditViolationType;
+
+#ifdef HAVE_RT_AUDIT
+
+/**
+ * Marks the current thread as processing.
+ *
+ * Sections may be nested.
+ */
+void
+rt_audit_enter (void);
+
+/**
+ * Ends a section started with rt_audit_enter().
+ */
+void
+rt_audit_leave (void);
+
+/**
+ * Records a violation of the given type if the
+ * current thread is processing.
+ *
+ * Violations caused by the offending call itself
+ * (eg, allocations made while formatting a log
+ * message) are ignored until
+ * rt_audit_violation_end() is called.
+ */
+void
+rt_audit_violation_begin (RtAuditViolationType type);
+
+void
+rt_audit_violation_end (void);
+
+/**
+ * Returns the number of violations recorded since
+ * the last rt_audit_reset().
+ */
+int
+rt_audit_get_num_violations (void);
+
+/**
+ * Returns a newly allocated report of the recorded
+ * violations, grouped by call site, with the most
+ * frequent first.
+ *
+ * Must not be called from a processing thread.
+ */
+char *
+rt_audit_get_report (void);
+
+/**
+ * Writes the report from rt_audit_get_report() to
+ * the given file.
+ */
+bool
+rt_audit_write_report (
+  const char * filepath,
+  GError **    error);
+
+/**
+ * Clears the recorded violations.
+ */
+void
+rt_audit_reset (void);
+
+#else /* !HAVE_RT_AUDIT */
+
+#  define rt_audit_enter()
+#  define rt_audit_leave()
+#  define rt_audit_violation_begin(type)
+#  define rt_audit_violation_end()
+#  define rt_audit_get_num_violations() 0
+#  define rt_audit_reset()
+
+#endif /* HAVE_RT_AUDIT */
+
+/**
+ * @}
+ */
+
+#endif
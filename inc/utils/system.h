@@ -27,6 +27,7 @@
 #define __UTILS_SYSTEM_H__
 
 #include <stdbool.h>
+#include <stdint.h>
 
 /**
  * @addtogroup utils
@@ -85,6 +86,41 @@ system_run_cmd_w_args (
   char **       out_stderr,
   bool          warn_if_fail);
 
+/**
+ * Fills in the PIDs of the direct child processes
+ * of this process.
+ *
+ * @note Only implemented on Linux (returns 0
+ *   elsewhere).
+ *
+ * @return The number of PIDs written.
+ */
+int
+system_get_child_pids (int * pids, int max_pids);
+
+/**
+ * Returns the command line arguments of the given
+ * process as a NULL-terminated array, or NULL if
+ * unknown.
+ *
+ * @note Only implemented on Linux.
+ *
+ * @return A newly allocated array to be freed with
+ *   g_strfreev().
+ */
+char **
+system_get_process_cmdline (int pid);
+
+/**
+ * Returns the CPU time (user + system) used so far
+ * by the given process in microseconds, or -1 if
+ * unknown (e.g., the process exited).
+ *
+ * @note Only implemented on Linux.
+ */
+int64_t
+system_get_process_cpu_time (int pid);
+
 /**
  * @}
  */
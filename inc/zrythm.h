@@ -173,6 +173,9 @@ typedef enum ZrythmDirType
   /** Backtraces. */
   ZRYTHM_DIR_USER_BACKTRACE,
 
+  /** Decoded audio clip cache. */
+  ZRYTHM_DIR_USER_CLIP_CACHE,
+
 } ZrythmDirType;
 
 /**
@@ -3169,6 +3169,17 @@ DEFINE_SIMPLE (activate_plugin_toggle_enabled)
     pl, !plugin_is_enabled (pl, false), true);
 }
 
+DEFINE_SIMPLE (activate_plugin_toggle_auto_sleep)
+{
+  gsize        size;
+  const char * str = g_variant_get_string (variant, &size);
+  Plugin *     pl = NULL;
+  sscanf (str, "%p", &pl);
+  g_return_if_fail (IS_PLUGIN_AND_NONNULL (pl));
+
+  plugin_set_auto_sleep (pl, !pl->auto_sleep);
+}
+
 DEFINE_SIMPLE (activate_plugin_inspect)
 {
   left_dock_edge_widget_refresh_with_page (
@@ -2886,7 +2886,12 @@ arranger_selections_action_do (
   ArrangerSelectionsAction * self,
   GError **                  error)
 {
-  return do_or_undo (self, true, error);
+  int ret = do_or_undo (self, true, error);
+
+  /* BPM automation may have changed */
+  engine_update_tempo_map (AUDIO_ENGINE);
+
+  return ret;
 }
 
 int
@@ -2894,7 +2899,12 @@ arranger_selections_action_undo (
   ArrangerSelectionsAction * self,
   GError **                  error)
 {
-  return do_or_undo (self, false, error);
+  int ret = do_or_undo (self, false, error);
+
+  /* BPM automation may have changed */
+  engine_update_tempo_map (AUDIO_ENGINE);
+
+  return ret;
 }
 
 bool
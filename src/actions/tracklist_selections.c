@@ -6,10 +6,12 @@
 #include "audio/foldable_track.h"
 #include "audio/group_target_track.h"
 #include "audio/midi_file.h"
+#include "audio/midi_region.h"
 #include "audio/router.h"
 #include "audio/supported_file.h"
 #include "audio/track.h"
 #include "audio/tracklist.h"
+#include "audio/transport.h"
 #include "gui/backend/event.h"
 #include "gui/backend/event_manager.h"
 #include "gui/widgets/main_window.h"
@@ -300,10 +302,38 @@ tracklist_selections_action_new (
         }
       else if (track_type == TRACK_TYPE_AUDIO)
         {
-          AudioClip * clip =
-            audio_clip_new_from_file (file_descr->abs_path);
+          /* when interactive, only read the header
+           * here and decode in the background so that
+           * importing many files does not block the
+           * UI */
+          bool import_async =
+            ZRYTHM_HAVE_UI && !ZRYTHM_TESTING;
+          AudioClip * clip = NULL;
+          if (import_async)
+            {
+              GError * err = NULL;
+              clip = audio_clip_new_placeholder_from_file (
+                file_descr->abs_path, &err);
+              if (!clip)
+                {
+                  PROPAGATE_PREFIXED_ERROR (
+                    error, err, _ ("Failed to import %s"),
+                    file_descr->abs_path);
+                  return NULL;
+                }
+            }
+          else
+            {
+              clip =
+                audio_clip_new_from_file (file_descr->abs_path);
+            }
           self->pool_id =
             audio_pool_add_clip (AUDIO_POOL, clip);
+          if (import_async)
+            {
+              audio_clip_import_async (
+                clip, file_descr->abs_path);
+            }
         }
       else
         {
@@ -687,10 +717,77 @@ tracklist_selections_action_perform_set_direct_out (
     }
 }
 
+/**
+ * Reads all tracks of the MIDI file stored in the
+ * action.
+ *
+ * @param[out] num_tracks Number of tracks read.
+ *
+ * @return The tracks (see midi_file_read_tracks())
+ *   or NULL if an error occurred.
+ */
+static MidiFileTrack *
+read_midi_file_tracks (
+  TracklistSelectionsAction * self,
+  int *                       num_tracks,
+  GError **                   error)
+{
+  /* create a temporary midi file */
+  GError * err = NULL;
+  char *   dir =
+    g_dir_make_tmp ("zrythm_tmp_midi_XXXXXX", &err);
+  if (!dir)
+    {
+      PROPAGATE_PREFIXED_ERROR (
+        error, err, "%s", _ ("Failed creating tmpdir"));
+      return NULL;
+    }
+  char *    full_path =
+    g_build_filename (dir, "data.MID", NULL);
+  size_t    len;
+  uint8_t * data = g_base64_decode (self->base64_midi, &len);
+
+  MidiFileTrack * tracks = NULL;
+  err = NULL;
+  if (g_file_set_contents (
+        full_path, (const gchar *) data, (gssize) len, &err))
+    {
+      /* parse all tracks at once (in parallel)
+       * instead of once per track created */
+      tracks = midi_file_read_tracks (
+        full_path, transport_get_ppqn (TRANSPORT),
+        num_tracks);
+      if (!tracks)
+        {
+          g_set_error (
+            error, Z_ACTIONS_TRACKLIST_SELECTIONS_ERROR,
+            Z_ACTIONS_TRACKLIST_SELECTIONS_ERROR_FAILED,
+            _ ("Failed reading MIDI file %s"),
+            self->file_basename);
+        }
+    }
+  else
+    {
+      PROPAGATE_PREFIXED_ERROR (
+        error, err, _ ("Failed saving file %s"), full_path);
+    }
+
+  /* remove temporary data */
+  io_remove (full_path);
+  io_rmdir (dir, Z_F_NO_FORCE);
+  g_free (dir);
+  g_free (full_path);
+  g_free (data);
+
+  return tracks;
+}
+
 /**
  * @param add_to_project Used when the track to
  *   create is meant to be used in the project (ie
  *   not one of the tracks in the action).
+ * @param midi_tracks Tracks read from the MIDI file
+ *   of the action, if any.
  *
  * @return Non-zero if error.
  */
@@ -698,6 +795,8 @@ static int
 create_track (
   TracklistSelectionsAction * self,
   int                         idx,
+  const MidiFileTrack *       midi_tracks,
+  int                         num_midi_tracks,
   GError **                   error)
 {
   Track * track;
@@ -815,37 +914,17 @@ create_track (
         self->track_type == TRACK_TYPE_MIDI
         && self->base64_midi && self->file_basename)
         {
-          /* create a temporary midi file */
-          GError * err = NULL;
-          char *   dir =
-            g_dir_make_tmp ("zrythm_tmp_midi_XXXXXX", &err);
-          if (!dir)
-            {
-              g_critical (
-                "failed creating tmpdir: %s", err->message);
-              return -1;
-            }
-          char * full_path =
-            g_build_filename (dir, "data.MID", NULL);
-          size_t    len;
-          uint8_t * data =
-            g_base64_decode (self->base64_midi, &len);
-          err = NULL;
-          if (!g_file_set_contents (
-                full_path, (const gchar *) data, (gssize) len,
-                &err))
-            {
-              PROPAGATE_PREFIXED_ERROR (
-                error, err, _ ("Failed saving file %s"),
-                full_path);
-              return -1;
-            }
-
           /* create a MIDI region from the MIDI
            * file & add to track */
-          ZRegion * mr = midi_region_new_from_midi_file (
-            &start_pos, full_path,
-            track_get_name_hash (track), 0, 0, idx);
+          const MidiFileTrack * mf_track =
+            midi_file_tracks_get_nth_with_data (
+              midi_tracks, num_midi_tracks, idx);
+          ZRegion * mr =
+            mf_track
+              ? midi_region_new_from_midi_file_track (
+                &start_pos, mf_track,
+                track_get_name_hash (track), 0, 0)
+              : NULL;
           if (mr)
             {
               track_add_region (
@@ -861,16 +940,9 @@ create_track (
             {
               g_message (
                 "Failed to create MIDI region from "
-                "file %s",
-                full_path);
+                "track %d of %s",
+                idx, self->file_basename);
             }
-
-          /* remove temporary data */
-          io_remove (full_path);
-          io_rmdir (dir, Z_F_NO_FORCE);
-          g_free (dir);
-          g_free (full_path);
-          g_free (data);
         }
 
       if (pl)
@@ -917,10 +989,30 @@ do_or_undo_create_or_delete (
     {
       if (create)
         {
+          MidiFileTrack * midi_tracks = NULL;
+          int             num_midi_tracks = 0;
+          if (
+            !self->is_empty
+            && self->track_type == TRACK_TYPE_MIDI
+            && self->base64_midi && self->file_basename)
+            {
+              GError * err = NULL;
+              midi_tracks = read_midi_file_tracks (
+                self, &num_midi_tracks, &err);
+              if (!midi_tracks)
+                {
+                  PROPAGATE_PREFIXED_ERROR (
+                    error, err, "%s",
+                    _ ("Failed to read MIDI file"));
+                  return -1;
+                }
+            }
+
           for (int i = 0; i < self->num_tracks; i++)
             {
               GError * err = NULL;
-              int      ret = create_track (self, i, &err);
+              int      ret = create_track (
+                self, i, midi_tracks, num_midi_tracks, &err);
               if (ret != 0)
                 {
                   PROPAGATE_PREFIXED_ERROR (
@@ -928,6 +1020,11 @@ do_or_undo_create_or_delete (
                     _ ("Failed to create track "
                        "at %d"),
                     i);
+                  if (midi_tracks)
+                    {
+                      midi_file_tracks_free (
+                        midi_tracks, num_midi_tracks);
+                    }
                   return ret;
                 }
 
@@ -935,6 +1032,12 @@ do_or_undo_create_or_delete (
                * selected */
             }
 
+          if (midi_tracks)
+            {
+              midi_file_tracks_free (
+                midi_tracks, num_midi_tracks);
+            }
+
           /* disable given track, if any (eg when
            * bouncing) */
           if (self->ival_after > -1)
@@ -4,6 +4,8 @@
 #include "actions/undo_manager.h"
 #include "actions/undo_stack.h"
 #include "actions/undoable_action.h"
+#include "audio/anticipative_renderer.h"
+#include "audio/router.h"
 #include "gui/backend/event.h"
 #include "gui/backend/event_manager.h"
 #include "gui/widgets/header.h"
@@ -128,6 +130,14 @@ do_or_undo_action (
       undo_stack_pop (main_stack);
     }
 
+  /* tracks rendered ahead of time must be
+   * processed again from the changed project */
+  if (AUDIO_ENGINE && ROUTER)
+    {
+      anticipative_renderer_invalidate (
+        ANTICIPATIVE_RENDERER);
+    }
+
   /* if redo stack is locked don't alter it */
   if (self->redo_stack_locked && opposite_stack == self->redo_stack)
     return 0;
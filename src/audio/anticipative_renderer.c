@@ -0,0 +1,941 @@
+// SPDX-FileCopyrightText: © 2022 Alexandros Theodotou <alex@zrythm.org>
+// SPDX-License-Identifier: LicenseRef-ZrythmLicense
+
+#include "audio/anticipative_renderer.h"
+#include "audio/channel.h"
+#include "audio/channel_send.h"
+#include "audio/engine.h"
+#include "audio/fader.h"
+#include "audio/graph.h"
+#include "audio/graph_node.h"
+#include "audio/port.h"
+#include "audio/router.h"
+#include "audio/track.h"
+#include "audio/tracklist.h"
+#include "audio/transport.h"
+#include "gui/backend/clip_editor.h"
+#include "plugins/plugin.h"
+#include "project.h"
+#include "settings/settings.h"
+#include "utils/audio.h"
+#include "utils/dsp.h"
+#include "utils/objects.h"
+#include "zrythm.h"
+
+#include <glib.h>
+
+/** Whether the current thread is a renderer
+ * thread. */
+static __thread bool is_renderer_thread = false;
+
+AnticipativeRenderer *
+anticipative_renderer_new (void)
+{
+  AnticipativeRenderer * self =
+    object_new (AnticipativeRenderer);
+
+  self->enabled =
+    ZRYTHM_TESTING
+      ? false
+      : g_settings_get_boolean (
+        S_P_DSP_ANTICIPATIVE, "enabled");
+  self->lookahead_ms =
+    ZRYTHM_TESTING
+      ? 200
+      : g_settings_get_int (
+        S_P_DSP_ANTICIPATIVE, "lookahead");
+
+  g_rw_lock_init (&self->tracks_lock);
+  zix_sem_init (&self->wake, 0);
+
+  return self;
+}
+
+/**
+ * Returns whether the given node is part of the
+ * pre-fader processing of the given track.
+ */
+static bool
+is_pre_fader_node (GraphNode * node, Track * tr)
+{
+  switch (node->type)
+    {
+    case ROUTE_NODE_TYPE_TRACK:
+      return node->track == tr;
+    case ROUTE_NODE_TYPE_PLUGIN:
+      return node->pl->track == tr;
+    case ROUTE_NODE_TYPE_PREFADER:
+      return node->prefader == tr->channel->prefader;
+    case ROUTE_NODE_TYPE_PORT:
+      {
+        const PortIdentifier * id = &node->port->id;
+        if (id->track_name_hash != track_get_name_hash (tr))
+          return false;
+
+        return id->owner_type
+                 == PORT_OWNER_TYPE_TRACK_PROCESSOR
+               || id->owner_type == PORT_OWNER_TYPE_PLUGIN
+               || (id->owner_type == PORT_OWNER_TYPE_FADER
+                   && id->flags2 & PORT_FLAG2_PREFADER);
+      }
+    default:
+      return false;
+    }
+}
+
+/**
+ * Returns whether the given node outside the
+ * pre-fader part may depend on it.
+ */
+static AnticipativeNodeRole
+get_downstream_role (GraphNode * node, Track * tr)
+{
+  if (node->type != ROUTE_NODE_TYPE_PORT)
+    return ANTICIPATIVE_NODE_ROLE_NONE;
+
+  Channel * ch = tr->channel;
+  if (node->port == ch->fader->stereo_in->l)
+    return ANTICIPATIVE_NODE_ROLE_FADER_IN_L;
+  if (node->port == ch->fader->stereo_in->r)
+    return ANTICIPATIVE_NODE_ROLE_FADER_IN_R;
+
+  for (int i = 0; i < CHANNEL_SEND_POST_FADER_START_SLOT;
+       i++)
+    {
+      ChannelSend * send = ch->sends[i];
+      if (
+        send->stereo_in
+        && (node->port == send->stereo_in->l
+            || node->port == send->stereo_in->r))
+        return ANTICIPATIVE_NODE_ROLE_SEND_IN;
+    }
+
+  return ANTICIPATIVE_NODE_ROLE_NONE;
+}
+
+/**
+ * Returns whether all the dependencies of the
+ * given node are in the pre-fader part, the
+ * initial processor or hardware inputs.
+ */
+static bool
+has_only_pre_fader_deps (
+  GraphNode *  node,
+  GHashTable * pre_fader_nodes)
+{
+  for (int i = 0; i < node->init_refcount; i++)
+    {
+      GraphNode * parent = node->parentnodes[i];
+      if (
+        g_hash_table_contains (pre_fader_nodes, parent)
+        || parent->type == ROUTE_NODE_TYPE_INITIAL_PROCESSOR
+        || (parent->type == ROUTE_NODE_TYPE_PORT
+            && parent->port->id.owner_type
+                 == PORT_OWNER_TYPE_HW))
+        continue;
+
+      return false;
+    }
+
+  return true;
+}
+
+/**
+ * Sorts the given pre-fader nodes in processing
+ * order.
+ *
+ * @return A newly allocated array.
+ */
+static GraphNode **
+sort_nodes (GHashTable * pre_fader_nodes)
+{
+  guint num_nodes = g_hash_table_size (pre_fader_nodes);
+  GraphNode ** nodes =
+    object_new_n (num_nodes, GraphNode *);
+  GHashTable * sorted =
+    g_hash_table_new (g_direct_hash, g_direct_equal);
+
+  guint num_sorted = 0;
+  while (num_sorted < num_nodes)
+    {
+      guint          prev_num_sorted = num_sorted;
+      GHashTableIter iter;
+      gpointer       key;
+      g_hash_table_iter_init (&iter, pre_fader_nodes);
+      while (g_hash_table_iter_next (&iter, &key, NULL))
+        {
+          GraphNode * node = (GraphNode *) key;
+          if (g_hash_table_contains (sorted, node))
+            continue;
+
+          bool ready = true;
+          for (int i = 0; i < node->init_refcount; i++)
+            {
+              GraphNode * parent = node->parentnodes[i];
+              if (
+                g_hash_table_contains (
+                  pre_fader_nodes, parent)
+                && !g_hash_table_contains (sorted, parent))
+                {
+                  ready = false;
+                  break;
+                }
+            }
+          if (!ready)
+            continue;
+
+          nodes[num_sorted++] = node;
+          g_hash_table_add (sorted, node);
+        }
+
+      /* the graph is acyclic so this should never
+       * happen */
+      if (num_sorted == prev_num_sorted)
+        {
+          g_hash_table_destroy (sorted);
+          object_zero_and_free (nodes);
+          g_return_val_if_reached (NULL);
+        }
+    }
+  g_hash_table_destroy (sorted);
+
+  return nodes;
+}
+
+/**
+ * Removes the references to the given
+ * AnticipativeTrack from its track and nodes.
+ */
+static void
+anticipative_track_detach (AnticipativeTrack * self)
+{
+  for (int i = 0; i < self->num_nodes; i++)
+    {
+      GraphNode * node = self->nodes[i];
+      for (int j = 0; j < node->n_childnodes; j++)
+        {
+          GraphNode * child = node->childnodes[j];
+          child->anticipative_track = NULL;
+          child->anticipative_role =
+            ANTICIPATIVE_NODE_ROLE_NONE;
+        }
+      node->anticipative_track = NULL;
+      node->anticipative_role = ANTICIPATIVE_NODE_ROLE_NONE;
+    }
+  self->track->anticipative = NULL;
+}
+
+static void
+anticipative_track_free (AnticipativeTrack * self)
+{
+  object_zero_and_free_if_nonnull (self->nodes);
+  object_zero_and_free_if_nonnull (self->offsets);
+  object_zero_and_free_if_nonnull (self->bufs[0]);
+  object_zero_and_free_if_nonnull (self->bufs[1]);
+
+  object_zero_and_free (self);
+}
+
+/**
+ * Returns a new AnticipativeTrack for the given
+ * track if its pre-fader part only depends on
+ * itself and only feeds the fader and the
+ * pre-fader sends, or NULL.
+ */
+static AnticipativeTrack *
+anticipative_track_new (
+  Graph *   graph,
+  Track *   tr,
+  nframes_t buf_size)
+{
+  if (
+    (tr->type != TRACK_TYPE_AUDIO
+     && tr->type != TRACK_TYPE_INSTRUMENT)
+    || !tr->channel
+    || tr->channel->prefader->type
+         != FADER_TYPE_AUDIO_CHANNEL)
+    return NULL;
+
+  GHashTable * pre_fader_nodes =
+    g_hash_table_new (g_direct_hash, g_direct_equal);
+  GraphNode *    prefader_node = NULL;
+  GHashTableIter iter;
+  gpointer       key, value;
+  g_hash_table_iter_init (&iter, graph->graph_nodes);
+  while (g_hash_table_iter_next (&iter, &key, &value))
+    {
+      GraphNode * node = (GraphNode *) value;
+      if (!is_pre_fader_node (node, tr))
+        continue;
+
+      g_hash_table_add (pre_fader_nodes, node);
+      if (node->type == ROUTE_NODE_TYPE_PREFADER)
+        prefader_node = node;
+    }
+
+  bool valid = prefader_node != NULL;
+  int num_fader_ins = 0;
+
+  g_hash_table_iter_init (&iter, pre_fader_nodes);
+  while (valid && g_hash_table_iter_next (&iter, &key, NULL))
+    {
+      GraphNode * node = (GraphNode *) key;
+      if (!has_only_pre_fader_deps (node, pre_fader_nodes))
+        {
+          valid = false;
+          break;
+        }
+
+      for (int i = 0; i < node->n_childnodes; i++)
+        {
+          GraphNode * child = node->childnodes[i];
+          if (g_hash_table_contains (pre_fader_nodes, child))
+            continue;
+
+          AnticipativeNodeRole role =
+            get_downstream_role (child, tr);
+          if (
+            role == ANTICIPATIVE_NODE_ROLE_NONE
+            || !has_only_pre_fader_deps (
+              child, pre_fader_nodes))
+            {
+              valid = false;
+              break;
+            }
+          if (
+            role == ANTICIPATIVE_NODE_ROLE_FADER_IN_L
+            || role == ANTICIPATIVE_NODE_ROLE_FADER_IN_R)
+            {
+              num_fader_ins++;
+            }
+        }
+    }
+
+  /* the pre-fader outputs must feed the fader */
+  valid = valid && num_fader_ins == 2;
+
+  GraphNode ** nodes = NULL;
+  if (valid)
+    nodes = sort_nodes (pre_fader_nodes);
+  if (!nodes)
+    {
+      g_hash_table_destroy (pre_fader_nodes);
+      return NULL;
+    }
+
+  AnticipativeTrack * self =
+    object_new (AnticipativeTrack);
+  self->track = tr;
+  self->nodes = nodes;
+  self->num_nodes = (int) g_hash_table_size (pre_fader_nodes);
+  self->offsets =
+    object_new_n ((size_t) self->num_nodes, nframes_t);
+  self->prefader_node = prefader_node;
+  self->buf_size = buf_size;
+  for (int i = 0; i < 2; i++)
+    {
+      self->bufs[i] = object_new_n (buf_size, float);
+    }
+  g_hash_table_destroy (pre_fader_nodes);
+
+  for (int i = 0; i < self->num_nodes; i++)
+    {
+      GraphNode * node = self->nodes[i];
+      node->anticipative_track = self;
+      node->anticipative_role =
+        ANTICIPATIVE_NODE_ROLE_PRE_FADER;
+      for (int j = 0; j < node->n_childnodes; j++)
+        {
+          GraphNode * child = node->childnodes[j];
+          if (child->anticipative_track)
+            continue;
+
+          child->anticipative_track = self;
+          child->anticipative_role =
+            get_downstream_role (child, tr);
+        }
+    }
+  tr->anticipative = self;
+
+  return self;
+}
+
+/**
+ * Returns whether the given track can stay
+ * anticipated in this cycle.
+ */
+static bool
+is_track_eligible (AnticipativeTrack * self)
+{
+  Track * tr = self->track;
+
+  /* live input */
+  if (track_get_recording (tr) || tr->recording_region)
+    return false;
+  if (
+    tr->in_signal_type == TYPE_EVENT
+    && CLIP_EDITOR->has_region
+    && clip_editor_get_track (CLIP_EDITOR) == tr)
+    return false;
+  if (tr->automation_tracklist.num_ats_in_record_mode > 0)
+    return false;
+
+  /* the pre-fader output is used by a send */
+  Channel * ch = tr->channel;
+  for (int i = 0; i < CHANNEL_SEND_POST_FADER_START_SLOT;
+       i++)
+    {
+      if (channel_send_is_enabled (ch->sends[i]))
+        return false;
+    }
+
+  return true;
+}
+
+/**
+ * Returns whether the tracks handed over when
+ * playback started can stay anticipated.
+ */
+static bool
+can_continue (AnticipativeRenderer * self)
+{
+  return self->enabled && !AUDIO_ENGINE->exporting
+         && TRANSPORT->play_state == PLAYSTATE_ROLLING
+         && PLAYHEAD->frames == self->expected_playhead
+         && TRANSPORT->loop == self->loop
+         && TRANSPORT->loop_start_pos.frames
+              == self->loop_start
+         && TRANSPORT->loop_end_pos.frames
+              == self->loop_end;
+}
+
+/**
+ * Adds the given frames to the given position,
+ * wrapping around the loop points as many times as
+ * needed.
+ */
+static void
+add_frames (Position * pos, nframes_t frames)
+{
+  nframes_t step = AUDIO_ENGINE->block_length;
+  while (frames > 0)
+    {
+      nframes_t num_frames = MIN (frames, step);
+      transport_position_add_frames (
+        TRANSPORT, pos, (signed_frame_t) num_frames);
+      frames -= num_frames;
+    }
+}
+
+/**
+ * Writes the pre-fader output of the last rendered
+ * block to the ring buffers.
+ */
+static void
+write_output (AnticipativeTrack * self, nframes_t nframes)
+{
+  Fader * prefader = self->track->channel->prefader;
+  Port *  ports[2] = {
+    prefader->stereo_out->l, prefader->stereo_out->r
+  };
+  guint write_frame =
+    (guint) g_atomic_int_get (&self->write_frame);
+  nframes_t start = write_frame & (self->buf_size - 1);
+  nframes_t first_part =
+    MIN (nframes, self->buf_size - start);
+  for (int i = 0; i < 2; i++)
+    {
+      dsp_copy (
+        &self->bufs[i][start], ports[i]->buf, first_part);
+      if (first_part < nframes)
+        {
+          dsp_copy (
+            self->bufs[i], &ports[i]->buf[first_part],
+            nframes - first_part);
+        }
+    }
+
+  g_atomic_int_set (
+    &self->write_frame, (gint) (write_frame + nframes));
+}
+
+/**
+ * Renders the given number of frames of the
+ * pre-fader part.
+ *
+ * Nodes with latency compensation offsets are
+ * processed ahead the same way the realtime graph
+ * would, and nodes not reached yet while priming
+ * are skipped (no-roll).
+ */
+static void
+render_block (AnticipativeTrack * self, nframes_t nframes)
+{
+  channel_prepare_process_pre_fader (self->track->channel);
+
+  signed_frame_t priming_offset =
+    MIN (self->render_frame, 0);
+  for (int i = 0; i < self->num_nodes; i++)
+    {
+      signed_frame_t offset =
+        priming_offset + (signed_frame_t) self->offsets[i];
+      if (offset < 0)
+        continue;
+
+      Position pos = self->render_pos;
+      add_frames (&pos, (nframes_t) offset);
+      EngineProcessTimeInfo time_nfo = {
+        .g_start_frame = (unsigned_frame_t) pos.frames,
+        .local_offset = 0,
+        .nframes = nframes,
+      };
+      graph_node_process_anticipated (
+        self->nodes[i], time_nfo);
+    }
+
+  if (self->render_frame >= 0)
+    {
+      write_output (self, nframes);
+      add_frames (&self->render_pos, nframes);
+    }
+  self->render_frame += nframes;
+}
+
+/**
+ * Skips rendering up to the frames already read by
+ * the realtime graph after an underrun.
+ */
+static void
+skip_frames (AnticipativeTrack * self, nframes_t nframes)
+{
+  /* the skipped frames start at the playback
+   * start position */
+  if (self->render_frame < 0)
+    {
+      self->render_frame = 0;
+    }
+  add_frames (&self->render_pos, nframes);
+  self->render_frame += nframes;
+  g_atomic_int_add (&self->write_frame, (gint) nframes);
+}
+
+/**
+ * Renders the given track until the lookahead is
+ * filled or the track is reclaimed.
+ */
+static void
+render_track (
+  AnticipativeRenderer * self,
+  AnticipativeTrack *    at)
+{
+  while (!g_atomic_int_get (&at->reclaim_requested))
+    {
+      guint write_frame =
+        (guint) g_atomic_int_get (&at->write_frame);
+      guint read_frame = MIN (
+        (guint) g_atomic_int_get (&at->read_frames[0]),
+        (guint) g_atomic_int_get (&at->read_frames[1]));
+      gint ahead = (gint) (write_frame - read_frame);
+      if (ahead < 0)
+        {
+          skip_frames (at, (nframes_t) -ahead);
+          continue;
+        }
+      if ((nframes_t) ahead >= self->lookahead)
+        break;
+
+      /* plugins were instantiated for the engine
+       * block length so never render more */
+      nframes_t nframes = MIN (
+        AUDIO_ENGINE->block_length,
+        self->lookahead - (nframes_t) ahead);
+
+      /* split where nodes start rolling */
+      if (at->render_frame < 0)
+        {
+          for (int i = 0; i < at->num_nodes; i++)
+            {
+              signed_frame_t start =
+                -(signed_frame_t) at->offsets[i];
+              if (start > at->render_frame)
+                {
+                  nframes = (nframes_t) MIN (
+                    (signed_frame_t) nframes,
+                    start - at->render_frame);
+                }
+            }
+        }
+
+      render_block (at, nframes);
+    }
+}
+
+static gpointer
+renderer_thread_func (gpointer data)
+{
+  AnticipativeRenderer * self =
+    (AnticipativeRenderer *) data;
+  is_renderer_thread = true;
+
+  while (true)
+    {
+      zix_sem_wait (&self->wake);
+      if (g_atomic_int_get (&self->stop_threads))
+        break;
+
+      g_rw_lock_reader_lock (&self->tracks_lock);
+      for (int i = 0; i < self->num_tracks; i++)
+        {
+          AnticipativeTrack * at = self->tracks[i];
+          if (!g_atomic_int_compare_and_exchange (
+                &at->state,
+                ANTICIPATIVE_TRACK_STATE_RENDER,
+                ANTICIPATIVE_TRACK_STATE_RENDERING))
+            continue;
+
+          render_track (self, at);
+
+          g_atomic_int_set (
+            &at->state,
+            g_atomic_int_get (&at->reclaim_requested)
+              ? ANTICIPATIVE_TRACK_STATE_RT
+              : ANTICIPATIVE_TRACK_STATE_RENDER);
+        }
+      g_rw_lock_reader_unlock (&self->tracks_lock);
+    }
+
+  return NULL;
+}
+
+static void
+start_threads (AnticipativeRenderer * self)
+{
+  /* leave the other cores to the realtime graph */
+  int num_threads = CLAMP (
+    audio_get_num_cores () / 2, 1,
+    ANTICIPATIVE_RENDERER_MAX_THREADS);
+
+  g_atomic_int_set (&self->stop_threads, 0);
+  for (int i = 0; i < num_threads; i++)
+    {
+      char * name =
+        g_strdup_printf ("anticipative_renderer_%d", i);
+      self->threads[i] =
+        g_thread_new (name, renderer_thread_func, self);
+      g_free (name);
+    }
+  self->num_threads = num_threads;
+}
+
+static void
+stop_threads (AnticipativeRenderer * self)
+{
+  g_atomic_int_set (&self->stop_threads, 1);
+  for (int i = 0; i < self->num_threads; i++)
+    {
+      zix_sem_post (&self->wake);
+    }
+  for (int i = 0; i < self->num_threads; i++)
+    {
+      g_thread_join (self->threads[i]);
+      self->threads[i] = NULL;
+    }
+  self->num_threads = 0;
+}
+
+void
+anticipative_renderer_setup (
+  AnticipativeRenderer * self,
+  Graph *                graph)
+{
+  g_return_if_fail (self->num_tracks == 0);
+
+  if (!self->enabled)
+    return;
+
+  self->lookahead = (nframes_t) (
+    ((gint64) AUDIO_ENGINE->sample_rate
+     * self->lookahead_ms)
+    / 1000);
+  self->lookahead =
+    MAX (self->lookahead, AUDIO_ENGINE->block_length);
+  self->prime_frames = MAX (self->lookahead / 4, 1);
+  nframes_t buf_size =
+    1u << g_bit_storage (
+      self->lookahead + AUDIO_ENGINE->block_length - 1);
+
+  if (self->num_threads == 0)
+    start_threads (self);
+
+  g_rw_lock_writer_lock (&self->tracks_lock);
+  self->tracks = object_new_n (
+    (size_t) MAX (TRACKLIST->num_tracks, 1),
+    AnticipativeTrack *);
+  for (int i = 0; i < TRACKLIST->num_tracks; i++)
+    {
+      AnticipativeTrack * at = anticipative_track_new (
+        graph, TRACKLIST->tracks[i], buf_size);
+      if (at)
+        self->tracks[self->num_tracks++] = at;
+    }
+  g_rw_lock_writer_unlock (&self->tracks_lock);
+
+  g_message (
+    "%d tracks can be rendered ahead", self->num_tracks);
+}
+
+void
+anticipative_renderer_reclaim_all (
+  AnticipativeRenderer * self)
+{
+  for (int i = 0; i < self->num_tracks; i++)
+    {
+      g_atomic_int_set (
+        &self->tracks[i]->reclaim_requested, 1);
+    }
+
+  /* wait for the renderer threads to finish */
+  g_rw_lock_writer_lock (&self->tracks_lock);
+  for (int i = 0; i < self->num_tracks; i++)
+    {
+      AnticipativeTrack * at = self->tracks[i];
+      g_atomic_int_set (
+        &at->state, ANTICIPATIVE_TRACK_STATE_RT);
+      at->anticipated = false;
+    }
+  g_rw_lock_writer_unlock (&self->tracks_lock);
+}
+
+/**
+ * Frees the tracks without touching the graph or
+ * the project tracks.
+ */
+static void
+free_tracks (AnticipativeRenderer * self)
+{
+  g_rw_lock_writer_lock (&self->tracks_lock);
+  for (int i = 0; i < self->num_tracks; i++)
+    {
+      anticipative_track_free (self->tracks[i]);
+    }
+  object_zero_and_free_if_nonnull (self->tracks);
+  self->num_tracks = 0;
+  g_rw_lock_writer_unlock (&self->tracks_lock);
+}
+
+void
+anticipative_renderer_clear (AnticipativeRenderer * self)
+{
+  anticipative_renderer_reclaim_all (self);
+
+  for (int i = 0; i < self->num_tracks; i++)
+    {
+      anticipative_track_detach (self->tracks[i]);
+    }
+  free_tracks (self);
+}
+
+void
+anticipative_renderer_invalidate (
+  AnticipativeRenderer * self)
+{
+  g_atomic_int_set (&self->invalidated, 1);
+}
+
+nframes_t
+anticipative_renderer_start (AnticipativeRenderer * self)
+{
+  if (
+    !self->enabled || self->num_tracks == 0
+    || AUDIO_ENGINE->exporting)
+    return 0;
+
+  g_atomic_int_set (&self->invalidated, 0);
+  self->expected_playhead = PLAYHEAD->frames;
+  self->loop = TRANSPORT->loop;
+  self->loop_start = TRANSPORT->loop_start_pos.frames;
+  self->loop_end = TRANSPORT->loop_end_pos.frames;
+
+  bool handed_over = false;
+  for (int i = 0; i < self->num_tracks; i++)
+    {
+      AnticipativeTrack * at = self->tracks[i];
+      if (
+        g_atomic_int_get (&at->state)
+          != ANTICIPATIVE_TRACK_STATE_RT
+        || !is_track_eligible (at))
+        continue;
+
+      nframes_t prefader_latency =
+        at->prefader_node->route_playback_latency;
+      nframes_t max_offset = 0;
+      for (int j = 0; j < at->num_nodes; j++)
+        {
+          nframes_t latency =
+            at->nodes[j]->route_playback_latency;
+          at->offsets[j] =
+            latency > prefader_latency
+              ? latency - prefader_latency
+              : 0;
+          max_offset = MAX (max_offset, at->offsets[j]);
+        }
+
+      at->render_frame = -(signed_frame_t) max_offset;
+      at->render_pos = *PLAYHEAD;
+      g_atomic_int_set (&at->write_frame, 0);
+      for (int j = 0; j < 2; j++)
+        {
+          g_atomic_int_set (&at->read_frames[j], 0);
+          at->started_reading[j] = false;
+        }
+      g_atomic_int_set (&at->reclaim_requested, 0);
+      g_atomic_int_set (
+        &at->state, ANTICIPATIVE_TRACK_STATE_RENDER);
+      handed_over = true;
+    }
+
+  /* give the renderer a head start */
+  return handed_over ? self->prime_frames : 0;
+}
+
+void
+anticipative_renderer_prepare_process (
+  AnticipativeRenderer * self)
+{
+  if (self->num_tracks == 0)
+    return;
+
+  bool invalidated = g_atomic_int_compare_and_exchange (
+    &self->invalidated, 1, 0);
+  bool reclaim = invalidated || !can_continue (self);
+
+  bool any_anticipated = false;
+  for (int i = 0; i < self->num_tracks; i++)
+    {
+      AnticipativeTrack * at = self->tracks[i];
+      gint state = g_atomic_int_get (&at->state);
+      if (
+        state != ANTICIPATIVE_TRACK_STATE_RT
+        && (reclaim || !is_track_eligible (at)))
+        {
+          /* if the track is being rendered, the
+           * renderer hands it back when done */
+          g_atomic_int_set (&at->reclaim_requested, 1);
+          g_atomic_int_compare_and_exchange (
+            &at->state, ANTICIPATIVE_TRACK_STATE_RENDER,
+            ANTICIPATIVE_TRACK_STATE_RT);
+          state = g_atomic_int_get (&at->state);
+        }
+
+      at->anticipated =
+        state != ANTICIPATIVE_TRACK_STATE_RT;
+      any_anticipated = any_anticipated || at->anticipated;
+    }
+
+  if (any_anticipated)
+    {
+      for (int i = 0; i < self->num_threads; i++)
+        {
+          zix_sem_post (&self->wake);
+        }
+    }
+}
+
+void
+anticipative_renderer_post_process (
+  AnticipativeRenderer * self)
+{
+  self->expected_playhead = PLAYHEAD->frames;
+}
+
+bool
+anticipative_renderer_is_renderer_thread (void)
+{
+  return is_renderer_thread;
+}
+
+void
+anticipative_renderer_free (AnticipativeRenderer * self)
+{
+  /* the graph and the tracks may already be
+   * gone */
+  anticipative_renderer_reclaim_all (self);
+  free_tracks (self);
+  if (self->num_threads > 0)
+    stop_threads (self);
+
+  g_rw_lock_clear (&self->tracks_lock);
+  zix_sem_destroy (&self->wake);
+
+  object_zero_and_free (self);
+}
+
+void
+anticipative_track_read (
+  AnticipativeTrack *           self,
+  int                           channel,
+  Port *                        port,
+  const EngineProcessTimeInfo * time_nfo,
+  nframes_t                     route_latency)
+{
+  guint read_frame =
+    (guint) g_atomic_int_get (&self->read_frames[channel]);
+
+  /* the realtime graph would have started
+   * processing this node after the latency
+   * preroll, skipping the frames before it */
+  if (G_UNLIKELY (!self->started_reading[channel]))
+    {
+      read_frame +=
+        route_latency
+        - AUDIO_ENGINE->remaining_latency_preroll;
+      self->started_reading[channel] = true;
+    }
+
+  guint write_frame =
+    (guint) g_atomic_int_get (&self->write_frame);
+  gint      available = (gint) (write_frame - read_frame);
+  nframes_t num_frames = (nframes_t) CLAMP (
+    available, 0, (gint) time_nfo->nframes);
+  nframes_t start = read_frame & (self->buf_size - 1);
+  nframes_t first_part =
+    MIN (num_frames, self->buf_size - start);
+  /* never write into the pre-fader buffer, the
+   * renderer may be using it */
+  port_use_own_buf (port);
+  float * buf = &port->buf[time_nfo->local_offset];
+  dsp_copy (buf, &self->bufs[channel][start], first_part);
+  if (first_part < num_frames)
+    {
+      dsp_copy (
+        &buf[first_part], self->bufs[channel],
+        num_frames - first_part);
+    }
+
+  if (G_UNLIKELY (num_frames < time_nfo->nframes))
+    {
+      dsp_fill (
+        &buf[num_frames], DENORMAL_PREVENTION_VAL,
+        time_nfo->nframes - num_frames);
+      if (channel == 0)
+        g_atomic_int_inc (&self->num_underruns);
+    }
+  port_update_silence (port, num_frames == 0);
+
+  g_atomic_int_set (
+    &self->read_frames[channel],
+    (gint) (read_frame + time_nfo->nframes));
+}
+
+nframes_t
+anticipative_track_get_num_frames_ahead (
+  AnticipativeTrack * self)
+{
+  guint write_frame =
+    (guint) g_atomic_int_get (&self->write_frame);
+  guint read_frame = MAX (
+    (guint) g_atomic_int_get (&self->read_frames[0]),
+    (guint) g_atomic_int_get (&self->read_frames[1]));
+  gint ahead = (gint) (write_frame - read_frame);
+  return (nframes_t) MAX (ahead, 0);
+}
@@ -23,6 +23,7 @@
 #include "utils/dsp.h"
 #include "utils/flags.h"
 #include "utils/io.h"
+#include "utils/log.h"
 #include "utils/math.h"
 #include "utils/objects.h"
 #include "zrythm_app.h"
@@ -247,7 +248,7 @@ timestretch_buf (
     self->rt_stretcher, 1.0 / timestretch_ratio);
   unsigned_frame_t in_frames_to_process =
     (unsigned_frame_t) (frames_to_process * timestretch_ratio);
-  g_message (
+  z_rt_message (
     "%s: in frame offset %" PRIu64
     ", "
     "out frame offset %" PRIu64
@@ -324,7 +325,7 @@ audio_region_fill_stereo_ports (
       needs_rt_timestretch = true;
       timestretch_ratio =
         (double) cur_bpm / (double) clip->bpm;
-      g_message (
+      z_rt_message (
         "timestretching: "
         "(cur bpm %f clip bpm %f) %f",
         (double) cur_bpm, (double) clip->bpm,
@@ -412,7 +413,7 @@ audio_region_fill_stereo_ports (
             (ssize_t) (buff_index * timestretch_ratio);
           if (buff_index < (ssize_t) buff_index_start)
             {
-              g_message (
+              z_rt_message (
                 "buff index (%zd) < "
                 "buff index start (%zd)",
                 buff_index, buff_index_start);
@@ -425,7 +426,8 @@ audio_region_fill_stereo_ports (
                * up to this point */
               if (buff_size > 0)
                 {
-                  g_message ("buff size (%zd) > 0", buff_size);
+                  z_rt_message (
+                    "buff size (%zd) > 0", buff_size);
                   STRETCH;
                   prev_offset = current_local_frame;
                 }
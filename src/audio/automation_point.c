@@ -206,6 +206,8 @@ automation_point_set_fvalue (
     port, self->normalized_val, Z_F_AUTOMATING);
 #endif
 
+  region_contents_changed (region);
+
   if (pub_events)
     {
       EVENTS_PUSH (ET_ARRANGER_OBJECT_CHANGED, self);
@@ -285,6 +287,58 @@ automation_point_get_normalized_value_in_curve (
   return dy;
 }
 
+const double *
+automation_point_get_curve_samples (
+  AutomationPoint *       self,
+  const AutomationPoint * next_ap,
+  int                     num_samples)
+{
+  g_return_val_if_fail (num_samples > 0, NULL);
+
+  bool start_higher =
+    next_ap->normalized_val < self->normalized_val;
+  if (
+    self->curve_samples
+    && self->num_curve_samples == num_samples
+    && self->curve_samples_start_higher == start_higher
+    && curve_options_are_equal (
+      &self->curve_samples_opts, &self->curve_opts))
+    {
+      return self->curve_samples;
+    }
+
+  size_t size = (size_t) num_samples + 1;
+  if (size > self->curve_samples_size)
+    {
+      self->curve_samples = object_realloc_n (
+        self->curve_samples, self->curve_samples_size, size,
+        double);
+      self->curve_samples_size = size;
+    }
+  for (int i = 0; i <= num_samples; i++)
+    {
+      self->curve_samples[i] = curve_get_normalized_y (
+        (double) i / (double) num_samples, &self->curve_opts,
+        start_higher);
+    }
+  self->num_curve_samples = num_samples;
+  self->curve_samples_start_higher = start_higher;
+  self->curve_samples_opts = self->curve_opts;
+
+  return self->curve_samples;
+}
+
+int
+automation_point_get_num_curve_samples_for_width (
+  double width)
+{
+  int num_samples = 1;
+  while (num_samples < width && num_samples < 4096)
+    num_samples *= 2;
+
+  return num_samples;
+}
+
 /**
  * Sets the curviness of the AutomationPoint.
  */
@@ -120,6 +120,8 @@ automation_region_add_ap (
   /* re-sort */
   automation_region_force_sort (self);
 
+  region_contents_changed (self);
+
   if (pub_events)
     {
       EVENTS_PUSH (ET_ARRANGER_OBJECT_CREATED, ap);
@@ -249,6 +251,7 @@ automation_region_remove_ap (
           automation_point_set_region_and_index (
             self->aps[i], self, i);
         }
+      region_contents_changed (self);
     }
 
   if (free)
@@ -61,6 +61,23 @@ automation_track_init_loaded (
 AutomationTrack *
 automation_track_new (Port * port)
 {
+  AutomationTrack * self =
+    automation_track_new_from_port_id (&port->id);
+  g_return_val_if_fail (self, NULL);
+
+  port->at = self;
+
+  return self;
+}
+
+AutomationTrack *
+automation_track_new_from_port_id (
+  const PortIdentifier * port_id)
+{
+  g_return_val_if_fail (
+    port_identifier_validate ((PortIdentifier *) port_id),
+    NULL);
+
   AutomationTrack * self = _at_create ();
 
   self->regions_size = 1;
@@ -68,11 +85,7 @@ automation_track_new (Port * port)
 
   self->height = TRACK_DEF_HEIGHT;
 
-  g_return_val_if_fail (
-    port_identifier_validate (&port->id), NULL);
-  port_identifier_copy (&self->port_id, &port->id);
-
-  port->at = self;
+  port_identifier_copy (&self->port_id, port_id);
 
   self->automation_mode = AUTOMATION_MODE_READ;
 
@@ -106,6 +119,19 @@ automation_track_validate (AutomationTrack * self)
           == track_name_hash,
         false);
     }
+
+  /* MIDI control ports are only created on first
+   * use */
+  Port * port = automation_track_get_port (self, false);
+  if (!port)
+    {
+      g_return_val_if_fail (
+        self->port_id.flags & PORT_FLAG_MIDI_AUTOMATABLE
+          && !self->created && self->num_regions == 0,
+        false);
+      return true;
+    }
+
   AutomationTrack * found_at =
     automation_track_find_from_port_id (&self->port_id, false);
   if (found_at != self)
@@ -230,7 +256,6 @@ automation_track_insert_region (
   g_return_if_fail (idx >= 0);
   g_return_if_fail (
     region->name && region->id.type == REGION_TYPE_AUTOMATION);
-
   array_double_size_if_full (
     self->regions, self->num_regions, self->regions_size,
     ZRegion *);
@@ -293,7 +318,8 @@ automation_track_get_region_before_pos (
         {
           ZRegion *        region = self->regions[i];
           ArrangerObject * r_obj = (ArrangerObject *) region;
-          long             distance_from_r_end =
+          arranger_object_update_frames_if_stale (r_obj);
+          long distance_from_r_end =
             r_obj->end_pos.frames - pos->frames;
           if (
             position_is_before_or_equal (&r_obj->pos, pos)
@@ -494,6 +520,9 @@ automation_track_set_automation_mode (
   /* add to atl cache if recording */
   if (mode == AUTOMATION_MODE_RECORD)
     {
+      /* recording reads the port value */
+      automation_track_get_port (self, true);
+
       bool already_added = false;
       for (int i = 0; i < atl->num_ats_in_record_mode; i++)
         {
@@ -516,6 +545,13 @@ automation_track_set_automation_mode (
 
   self->automation_mode = mode;
 
+  /* the tempo map only uses BPM automation in read
+   * mode */
+  if (self->port_id.flags & PORT_FLAG_BPM)
+    {
+      engine_update_tempo_map (AUDIO_ENGINE);
+    }
+
   if (fire_events)
     {
       EVENTS_PUSH (ET_AUTOMATION_TRACK_CHANGED, self);
@@ -711,13 +747,13 @@ automation_track_get_val_at_pos (
     self, pos, ends_after);
   ArrangerObject * ap_obj = (ArrangerObject *) ap;
 
-  Port * port = port_find_from_identifier (&self->port_id);
-  g_return_val_if_fail (port, 0.f);
-
   /* no automation points yet, return negative
    * (no change) */
   if (!ap)
     {
+      Port * port =
+        port_find_from_identifier (&self->port_id);
+      g_return_val_if_fail (port, 0.f);
       return port_get_control_value (port, normalized);
     }
 
@@ -766,8 +802,12 @@ automation_track_get_val_at_pos (
     / (double) (next_ap_frames - ap_frames);
   g_return_val_if_fail (ratio >= 0, 0.f);
 
-  float result = (float)
-    automation_point_get_normalized_value_in_curve (ap, ratio);
+  /* the next point is already known, so avoid
+   * automation_point_get_normalized_value_in_curve()
+   * which looks it up again */
+  float result = (float) curve_get_normalized_y (
+    MIN (ratio, 1.0), &ap->curve_opts,
+    next_ap->normalized_val < ap->normalized_val);
   result = result * cur_next_diff;
   if (prev_ap_lower)
     result += ap->normalized_val;
@@ -780,6 +820,9 @@ automation_track_get_val_at_pos (
     }
   else
     {
+      Port * port =
+        port_find_from_identifier (&self->port_id);
+      g_return_val_if_fail (port, 0.f);
       return control_port_normalized_val_to_real (
         port, result);
     }
@@ -882,7 +925,29 @@ automation_track_verify (AutomationTrack * self)
 void
 automation_track_set_caches (AutomationTrack * self)
 {
-  self->port = port_find_from_identifier (&self->port_id);
+  self->port = automation_track_get_port (self, false);
+}
+
+Port *
+automation_track_get_port (
+  AutomationTrack * self,
+  bool              create)
+{
+  Port * port = port_find_from_identifier (&self->port_id);
+  if (
+    port || !create
+    || !(self->port_id.flags & PORT_FLAG_MIDI_AUTOMATABLE))
+    return port;
+
+  Track * track = automation_track_get_track (self);
+  g_return_val_if_fail (IS_TRACK_AND_NONNULL (track), NULL);
+  port = track_processor_get_midi_control_port (
+    track->processor, &self->port_id, true);
+  g_return_val_if_fail (IS_PORT_AND_NONNULL (port), NULL);
+  port->at = self;
+  self->port = port;
+
+  return port;
 }
 
 bool
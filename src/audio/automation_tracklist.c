@@ -463,6 +463,9 @@ automation_tracklist_get_first_invisible_at (
       at = self->ats[i];
       if (!at->created)
         {
+          /* the port of the automation track about
+           * to be created may not exist yet */
+          automation_track_get_port (at, true);
           return at;
         }
     }
@@ -8,6 +8,7 @@
 #include <math.h>
 #include <stdlib.h>
 
+#include "audio/anticipative_renderer.h"
 #include "audio/audio_track.h"
 #include "audio/automation_track.h"
 #include "audio/automation_tracklist.h"
@@ -336,33 +337,19 @@ disconnect_prev_next (
 }
 
 /**
- * Prepares the channel for processing.
- *
- * To be called before the main cycle each time on
- * all channels.
+ * Prepares the pre-fader part of the channel for
+ * processing.
  */
 void
-channel_prepare_process (Channel * self)
+channel_prepare_process_pre_fader (Channel * self)
 {
   Plugin * plugin;
   int      j;
   Track *  tr = channel_get_track (self);
-  PortType out_type = tr->out_signal_type;
 
   /* clear buffers */
   track_processor_clear_buffers (tr->processor);
   fader_clear_buffers (self->prefader);
-  fader_clear_buffers (self->fader);
-
-  if (out_type == TYPE_AUDIO)
-    {
-      port_clear_buffer (self->stereo_out->l);
-      port_clear_buffer (self->stereo_out->r);
-    }
-  else if (out_type == TYPE_EVENT)
-    {
-      port_clear_buffer (self->midi_out);
-    }
 
   for (j = 0; j < STRIP_SIZE; j++)
     {
@@ -376,11 +363,6 @@ channel_prepare_process (Channel * self)
   if (self->instrument)
     plugin_prepare_process (self->instrument);
 
-  for (int i = 0; i < STRIP_SIZE; i++)
-    {
-      channel_send_prepare_process (self->sends[i]);
-    }
-
   if (tr->in_signal_type == TYPE_EVENT)
     {
 #ifdef HAVE_RTMIDI
@@ -399,6 +381,44 @@ channel_prepare_process (Channel * self)
     }
 }
 
+/**
+ * Prepares the channel for processing.
+ *
+ * To be called before the main cycle each time on
+ * all channels.
+ */
+void
+channel_prepare_process (Channel * self)
+{
+  Track *  tr = channel_get_track (self);
+  PortType out_type = tr->out_signal_type;
+
+  /* the pre-fader part of tracks rendered ahead
+   * of time is prepared by the renderer */
+  if (!tr->anticipative || !tr->anticipative->anticipated)
+    {
+      channel_prepare_process_pre_fader (self);
+    }
+
+  /* clear buffers */
+  fader_clear_buffers (self->fader);
+
+  if (out_type == TYPE_AUDIO)
+    {
+      port_clear_buffer (self->stereo_out->l);
+      port_clear_buffer (self->stereo_out->r);
+    }
+  else if (out_type == TYPE_EVENT)
+    {
+      port_clear_buffer (self->midi_out);
+    }
+
+  for (int i = 0; i < STRIP_SIZE; i++)
+    {
+      channel_send_prepare_process (self->sends[i]);
+    }
+}
+
 void
 channel_init_loaded (Channel * self, Track * track)
 {
@@ -750,6 +770,12 @@ channel_connect_plugins (Channel * self)
 {
   g_return_if_fail (channel_is_in_active_project (self));
 
+  /* instantiate all pending plugins together before
+   * connecting anything */
+  Plugin * pls[120];
+  int      num_pls = channel_get_plugins (self, pls);
+  plugin_instantiate_batch (pls, num_pls, false);
+
   /* loop through each slot in each of MIDI FX,
    * instrument, inserts */
   for (int i = 0; i < 3; i++)
@@ -186,6 +186,20 @@ channel_send_process (
   g_return_if_fail (track);
   if (track->out_signal_type == TYPE_AUDIO)
     {
+      /* nothing to send (the output was cleared at
+       * the start of the cycle) */
+      if (
+        port_is_silent (self->stereo_in->l)
+        && port_is_silent (self->stereo_in->r))
+        {
+          port_update_silence (self->stereo_out->l, true);
+          port_update_silence (self->stereo_out->r, true);
+          return;
+        }
+
+      port_update_silence (self->stereo_out->l, false);
+      port_update_silence (self->stereo_out->r, false);
+
       if (math_floats_equal_epsilon (
             self->amount->control, 1.f, 0.00001f))
         {
@@ -6,6 +6,7 @@
 #include "audio/chord_object.h"
 #include "audio/chord_region.h"
 #include "audio/chord_track.h"
+#include "audio/region.h"
 #include "gui/backend/event.h"
 #include "gui/backend/event_manager.h"
 #include "project.h"
@@ -79,6 +80,8 @@ chord_region_insert_chord_object (
       chord_object_set_region_and_index (co, self, i);
     }
 
+  region_contents_changed (self);
+
   if (fire_events)
     {
       EVENTS_PUSH (ET_ARRANGER_OBJECT_CREATED, chord);
@@ -141,6 +144,8 @@ chord_region_remove_chord_object (
         self->chord_objects[i], self, i);
     }
 
+  region_contents_changed (self);
+
   if (free)
     {
       free_later (chord, arranger_object_free);
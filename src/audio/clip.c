@@ -1,12 +1,16 @@
 // SPDX-FileCopyrightText: © 2019-2022 Alexandros Theodotou <alex@zrythm.org>
 // SPDX-License-Identifier: LicenseRef-ZrythmLicense
 
+#include <math.h>
 #include <stdlib.h>
 
 #include "audio/clip.h"
+#include "audio/clip_cache.h"
 #include "audio/encoder.h"
 #include "audio/engine.h"
 #include "audio/tempo_track.h"
+#include "gui/backend/event.h"
+#include "gui/backend/event_manager.h"
 #include "gui/widgets/main_window.h"
 #include "project.h"
 #include "utils/audio.h"
@@ -23,6 +27,7 @@
 #include "zrythm_app.h"
 
 #include <glib/gi18n.h>
+#include <glib/gstdio.h>
 #include <gtk/gtk.h>
 
 static AudioClip *
@@ -34,6 +39,28 @@ _create (void)
   return self;
 }
 
+/**
+ * Records that the clip's file in the main pool
+ * contains the given content.
+ */
+static void
+set_pool_file_content_hash (
+  AudioClip *  self,
+  const char * path,
+  uint64_t     content_hash)
+{
+  GStatBuf st;
+  if (g_stat (path, &st) != 0)
+    {
+      self->pool_file_content_hash = 0;
+      return;
+    }
+
+  self->pool_file_content_hash = content_hash;
+  self->pool_file_size = (goffset) st.st_size;
+  self->pool_file_mtime = (gint64) st.st_mtime;
+}
+
 /**
  * Updates the channel caches.
  *
@@ -50,21 +77,180 @@ audio_clip_update_channel_caches (
   z_return_if_fail_cmp (self->channels, >, 0);
   z_return_if_fail_cmp (self->num_frames, >, 0);
 
-  /* copy the frames to the channel caches */
+  size_t num_frames = (size_t) self->num_frames;
   for (unsigned int i = 0; i < self->channels; i++)
     {
       self->ch_frames[i] = g_realloc (
-        self->ch_frames[i],
-        sizeof (float) * (size_t) self->num_frames);
-      for (size_t j = start_from;
-           j < (size_t) self->num_frames; j++)
+        self->ch_frames[i], sizeof (float) * num_frames);
+    }
+
+  size_t num_peaks =
+    (num_frames + AUDIO_CLIP_PEAK_BLOCK_FRAMES - 1)
+    / AUDIO_CLIP_PEAK_BLOCK_FRAMES;
+  self->peaks =
+    g_realloc_n (self->peaks, num_peaks * 2, sizeof (float));
+  self->num_peaks = num_peaks;
+
+  /* copy the frames to the channel caches and
+   * update the peaks in a single pass, starting from
+   * the block containing start_from */
+  const size_t block_size = AUDIO_CLIP_PEAK_BLOCK_FRAMES;
+  for (size_t block = start_from / block_size;
+       block < num_peaks; block++)
+    {
+      size_t block_start = block * block_size;
+      size_t block_end =
+        MIN (block_start + block_size, num_frames);
+      float min = 0.f;
+      float max = 0.f;
+      for (size_t j = block_start; j < block_end; j++)
         {
-          self->ch_frames[i][j] =
-            self->frames[j * self->channels + i];
+          const float * frame =
+            &self->frames[j * self->channels];
+          for (unsigned int i = 0; i < self->channels; i++)
+            {
+              float val = frame[i];
+              self->ch_frames[i][j] = val;
+              min = MIN (min, val);
+              max = MAX (max, val);
+            }
         }
+      self->peaks[block * 2] = min;
+      self->peaks[block * 2 + 1] = max;
+    }
+}
+
+/**
+ * Returns a hash of the clip's frames and of the
+ * format it is written in.
+ *
+ * Clips with equal content hashes produce identical
+ * files in the pool.
+ */
+uint64_t
+audio_clip_get_content_hash (const AudioClip * self)
+{
+  /* the written file also depends on the format */
+  struct
+  {
+    int32_t  samplerate;
+    int32_t  bit_depth;
+    uint32_t channels;
+    uint32_t use_flac;
+  } format;
+  memset (&format, 0, sizeof (format));
+  format.samplerate = self->samplerate;
+  format.bit_depth = (int32_t) self->bit_depth;
+  format.channels = self->channels;
+  format.use_flac = self->use_flac;
+  uint64_t seed =
+    hash_get_for_data_64 (&format, sizeof (format), 0);
+
+  /* hashed on demand (when loading or saving)
+   * instead of on every edit */
+  return hash_get_for_data_64 (
+    self->frames,
+    (size_t) self->num_frames * self->channels
+      * sizeof (float),
+    seed);
+}
+
+/**
+ * Gets the min and max sample value across all
+ * channels in the given range of frames.
+ *
+ * Uses @ref AudioClip.peaks where possible, so this
+ * is cheap even for large ranges.
+ *
+ * @param start_frame First frame (inclusive).
+ * @param end_frame Last frame (exclusive).
+ */
+void
+audio_clip_get_min_max (
+  const AudioClip * self,
+  signed_frame_t    start_frame,
+  signed_frame_t    end_frame,
+  float *           min,
+  float *           max)
+{
+  *min = 0.f;
+  *max = 0.f;
+
+  if (!self->frames)
+    return;
+
+  size_t start = (size_t) MAX (start_frame, 0);
+  size_t end = (size_t) CLAMP (
+    end_frame, 0, (signed_frame_t) self->num_frames);
+
+  /* only blocks that are complete are up to date
+   * (the last one may still be growing) */
+  size_t num_complete_blocks =
+    self->peaks
+      ? MIN (
+        self->num_peaks,
+        (size_t) self->num_frames
+          / AUDIO_CLIP_PEAK_BLOCK_FRAMES)
+      : 0;
+
+  size_t j = start;
+  while (j < end)
+    {
+      size_t block = j / AUDIO_CLIP_PEAK_BLOCK_FRAMES;
+      if (
+        j % AUDIO_CLIP_PEAK_BLOCK_FRAMES == 0
+        && block < num_complete_blocks
+        && j + AUDIO_CLIP_PEAK_BLOCK_FRAMES <= end)
+        {
+          *min = MIN (*min, self->peaks[block * 2]);
+          *max = MAX (*max, self->peaks[block * 2 + 1]);
+          j += AUDIO_CLIP_PEAK_BLOCK_FRAMES;
+          continue;
+        }
+
+      const float * frame = &self->frames[j * self->channels];
+      for (unsigned int i = 0; i < self->channels; i++)
+        {
+          *min = MIN (*min, frame[i]);
+          *max = MAX (*max, frame[i]);
+        }
+      j++;
     }
 }
 
+static void
+set_bit_depth_from_file (AudioClip * self, int bit_depth)
+{
+  switch (bit_depth)
+    {
+    case 16:
+      self->bit_depth = BIT_DEPTH_16;
+      self->use_flac = true;
+      break;
+    case 24:
+      self->bit_depth = BIT_DEPTH_24;
+      self->use_flac = true;
+      break;
+    case 32:
+      self->bit_depth = BIT_DEPTH_32;
+      self->use_flac = false;
+      break;
+    default:
+      g_debug ("unknown bit depth: %d", bit_depth);
+      self->bit_depth = BIT_DEPTH_32;
+      self->use_flac = false;
+    }
+}
+
+static void
+set_name_from_file (AudioClip * self, const char * full_path)
+{
+  g_free_and_null (self->name);
+  char * basename = g_path_get_basename (full_path);
+  self->name = io_file_strip_ext (basename);
+  g_free (basename);
+}
+
 static void
 audio_clip_init_from_file (
   AudioClip *  self,
@@ -87,31 +273,9 @@ audio_clip_init_from_file (
     g_realloc (self->frames, arr_size * sizeof (float));
   self->num_frames = enc->num_out_frames;
   dsp_copy (self->frames, enc->out_frames, arr_size);
-  g_free_and_null (self->name);
-  char * basename = g_path_get_basename (full_path);
-  self->name = io_file_strip_ext (basename);
-  g_free (basename);
+  set_name_from_file (self, full_path);
   self->channels = enc->nfo.channels;
-  self->bpm = tempo_track_get_current_bpm (P_TEMPO_TRACK);
-  switch (enc->nfo.bit_depth)
-    {
-    case 16:
-      self->bit_depth = BIT_DEPTH_16;
-      self->use_flac = true;
-      break;
-    case 24:
-      self->bit_depth = BIT_DEPTH_24;
-      self->use_flac = true;
-      break;
-    case 32:
-      self->bit_depth = BIT_DEPTH_32;
-      self->use_flac = false;
-      break;
-    default:
-      g_debug ("unknown bit depth: %d", enc->nfo.bit_depth);
-      self->bit_depth = BIT_DEPTH_32;
-      self->use_flac = false;
-    }
+  set_bit_depth_from_file (self, (int) enc->nfo.bit_depth);
   /*g_message (*/
   /*"\n\n num frames %ld \n\n", self->num_frames);*/
   audio_clip_update_channel_caches (self, 0);
@@ -120,21 +284,62 @@ audio_clip_init_from_file (
 }
 
 /**
- * Inits after loading a Project.
+ * Loads the clip's frames from its file in the
+ * pool, or from the decoded clip cache if it has an
+ * up-to-date entry.
+ *
+ * This does not access any global state other than
+ * the engine's samplerate, so it can be called from
+ * worker threads (one per clip).
+ *
+ * @param pool_path Path of the clip in the pool.
+ * @param cache_path Path of the cache entry, or NULL
+ *   to not use the cache.
  */
 void
-audio_clip_init_loaded (AudioClip * self)
+audio_clip_load_from_pool (
+  AudioClip *  self,
+  const char * pool_path,
+  const char * cache_path)
 {
   g_debug ("%s: %p", __func__, self);
 
-  char * filepath = audio_clip_get_path_in_pool_from_name (
+  unsigned int samplerate = AUDIO_ENGINE->sample_rate;
+  if (
+    !cache_path
+    || !clip_cache_load (
+      self, cache_path, pool_path, samplerate))
+    {
+      audio_clip_init_from_file (self, pool_path);
+
+      if (cache_path)
+        {
+          clip_cache_store (self, cache_path, pool_path);
+        }
+    }
+
+  /* the file has the contents that were just
+   * loaded */
+  set_pool_file_content_hash (
+    self, pool_path, audio_clip_get_content_hash (self));
+}
+
+/**
+ * Inits after loading a Project.
+ */
+void
+audio_clip_init_loaded (AudioClip * self)
+{
+  char * pool_path = audio_clip_get_path_in_pool_from_name (
     self->name, self->use_flac, F_NOT_BACKUP);
+  g_return_if_fail (pool_path);
+  char * cache_path =
+    clip_cache_get_path (self, AUDIO_ENGINE->sample_rate);
 
-  bpm_t bpm = self->bpm;
-  audio_clip_init_from_file (self, filepath);
-  self->bpm = bpm;
+  audio_clip_load_from_pool (self, pool_path, cache_path);
 
-  g_free (filepath);
+  g_free (pool_path);
+  g_free (cache_path);
 }
 
 /**
@@ -155,6 +360,360 @@ audio_clip_new_from_file (const char * full_path)
   return self;
 }
 
+/**
+ * Background import of a file into a placeholder
+ * clip.
+ *
+ * Only the worker touches the result fields until
+ * @ref AudioClipImportJob.done is posted, and only
+ * the GTK thread touches the clip.
+ */
+typedef struct AudioClipImportJob
+{
+  /** Placeholder clip, or NULL if it was free'd
+   * before the import finished. */
+  AudioClip * clip;
+
+  /** File to import. */
+  char * full_path;
+
+  /** Path to write the clip to in the pool, or NULL
+   * if the pool directory does not exist yet. */
+  char * pool_path;
+
+  int      samplerate;
+  bool     use_flac;
+  BitDepth bit_depth;
+
+  /** Decoded frames and caches. */
+  AudioClip * result;
+
+  /** Hash of the file written in the pool. */
+  char * file_hash;
+
+  /** Set when the placeholder is free'd. */
+  volatile gint cancelled;
+
+  /** Whether the results were applied. */
+  bool finished;
+
+  /** Posted by the worker when done. */
+  ZixSem done;
+} AudioClipImportJob;
+
+/** Worker pool for background imports. */
+static GThreadPool * import_thread_pool = NULL;
+
+static void
+import_job_free (AudioClipImportJob * self)
+{
+  g_free_and_null (self->full_path);
+  g_free_and_null (self->pool_path);
+  g_free_and_null (self->file_hash);
+  object_free_w_func_and_null (audio_clip_free, self->result);
+  zix_sem_destroy (&self->done);
+
+  object_zero_and_free (self);
+}
+
+/**
+ * Applies the results of the job to the
+ * placeholder clip.
+ *
+ * To be called from the GTK thread after the job
+ * is done.
+ */
+static void
+import_job_finish (AudioClipImportJob * job)
+{
+  if (job->finished)
+    return;
+
+  job->finished = true;
+
+  AudioClip * self = job->clip;
+  if (!self)
+    return;
+
+  self->import_job = NULL;
+  job->clip = NULL;
+
+  AudioClip * result = job->result;
+  if (!result || result->channels != self->channels)
+    {
+      g_warning (
+        "failed to import %s, keeping silent clip",
+        job->full_path);
+      return;
+    }
+
+  /* regions were created with the length estimated
+   * from the header, so never shrink the clip */
+  bool padded = result->num_frames < self->num_frames;
+  if (padded)
+    {
+      size_t prev_num_frames = (size_t) result->num_frames;
+      result->frames = g_realloc_n (
+        result->frames,
+        (size_t) self->num_frames * self->channels,
+        sizeof (sample_t));
+      memset (
+        &result->frames[prev_num_frames * self->channels], 0,
+        ((size_t) self->num_frames - prev_num_frames)
+          * self->channels * sizeof (sample_t));
+      result->num_frames = self->num_frames;
+      audio_clip_update_channel_caches (
+        result, prev_num_frames);
+    }
+
+  /* swap the buffers while the engine is not
+   * reading them */
+#define SWAP_MEMBER(x) \
+  { \
+    typeof (self->x) tmp = self->x; \
+    self->x = result->x; \
+    result->x = tmp; \
+  }
+
+  zix_sem_wait (&AUDIO_ENGINE->port_operation_lock);
+  SWAP_MEMBER (frames);
+  SWAP_MEMBER (num_frames);
+  for (unsigned int i = 0; i < self->channels; i++)
+    {
+      SWAP_MEMBER (ch_frames[i]);
+    }
+  SWAP_MEMBER (peaks);
+  SWAP_MEMBER (num_peaks);
+  zix_sem_post (&AUDIO_ENGINE->port_operation_lock);
+
+#undef SWAP_MEMBER
+
+  if (job->file_hash)
+    {
+      g_free_and_null (self->file_hash);
+      self->file_hash = job->file_hash;
+      job->file_hash = NULL;
+
+      /* the file has the decoded frames (without
+       * any padding) */
+      if (!padded)
+        {
+          set_pool_file_content_hash (
+            self, job->pool_path,
+            audio_clip_get_content_hash (self));
+        }
+    }
+
+  g_debug (
+    "imported %s into clip %s (%d)", job->full_path,
+    self->name, self->pool_id);
+
+  /* redraw the regions using the clip */
+  if (ZRYTHM_HAVE_UI)
+    {
+      for (int i = 0; i < TRACKLIST->num_tracks; i++)
+        {
+          Track * track = TRACKLIST->tracks[i];
+          if (track->type != TRACK_TYPE_AUDIO)
+            continue;
+
+          for (int j = 0; j < track->num_lanes; j++)
+            {
+              TrackLane * lane = track->lanes[j];
+              for (int k = 0; k < lane->num_regions; k++)
+                {
+                  ZRegion * r = lane->regions[k];
+                  if (r->pool_id == self->pool_id)
+                    {
+                      EVENTS_PUSH (
+                        ET_ARRANGER_OBJECT_CHANGED, r);
+                    }
+                }
+            }
+        }
+    }
+}
+
+static int
+import_job_finish_source_func (gpointer user_data)
+{
+  AudioClipImportJob * job =
+    (AudioClipImportJob *) user_data;
+  import_job_finish (job);
+  import_job_free (job);
+
+  return G_SOURCE_REMOVE;
+}
+
+/**
+ * Worker thread function.
+ */
+static void
+import_job_run (gpointer data, gpointer user_data)
+{
+  AudioClipImportJob * job = (AudioClipImportJob *) data;
+
+  AudioEncoder * enc = NULL;
+  if (!g_atomic_int_get (&job->cancelled))
+    {
+      enc =
+        audio_encoder_new_from_file (job->full_path, NULL);
+    }
+  if (enc)
+    {
+      audio_encoder_decode (
+        enc, job->samplerate, F_NO_SHOW_PROGRESS);
+      if (enc->num_out_frames > 0 && enc->nfo.channels > 0)
+        {
+          /* take over the decoded frames and build
+           * the channel caches and peaks */
+          AudioClip * result = _create ();
+          result->channels = enc->nfo.channels;
+          result->num_frames = enc->num_out_frames;
+          result->frames = enc->out_frames;
+          enc->out_frames = NULL;
+          audio_clip_update_channel_caches (result, 0);
+          job->result = result;
+        }
+      audio_encoder_free (enc);
+    }
+
+  if (
+    job->result && job->pool_path
+    && !g_atomic_int_get (&job->cancelled))
+    {
+      int ret = audio_write_raw_file (
+        job->result->frames, 0,
+        (size_t) job->result->num_frames,
+        (uint32_t) job->samplerate, job->use_flac,
+        job->bit_depth, job->result->channels,
+        job->pool_path);
+      if (ret == 0)
+        {
+          job->file_hash = hash_get_from_file (
+            job->pool_path, HASH_ALGORITHM_XXH3_64);
+        }
+    }
+
+  zix_sem_post (&job->done);
+  g_idle_add (import_job_finish_source_func, job);
+}
+
+/**
+ * Creates a silent placeholder clip for the given
+ * file, using only the file's header.
+ *
+ * The clip has the length the file will have in the
+ * project's samplerate. Its contents should be
+ * filled in with audio_clip_import_async() after
+ * adding it to the pool.
+ *
+ * @return The new clip, or NULL if the file could
+ *   not be opened.
+ */
+AudioClip *
+audio_clip_new_placeholder_from_file (
+  const char * full_path,
+  GError **    error)
+{
+  AudioEncoder * enc =
+    audio_encoder_new_from_file (full_path, error);
+  if (!enc)
+    return NULL;
+
+  AudioClip * self = _create ();
+  self->samplerate = (int) AUDIO_ENGINE->sample_rate;
+  self->channels = enc->nfo.channels;
+  self->pool_id = -1;
+  self->bpm = tempo_track_get_current_bpm (P_TEMPO_TRACK);
+  set_name_from_file (self, full_path);
+  set_bit_depth_from_file (self, (int) enc->nfo.bit_depth);
+
+  /* the length in the header is in ms */
+  self->num_frames = (unsigned_frame_t) ceil (
+    ((double) enc->nfo.length * (double) self->samplerate)
+    / 1000.0);
+  self->num_frames = MAX (self->num_frames, 1);
+
+  audec_close (enc->audec_handle);
+  audio_encoder_free (enc);
+
+  g_return_val_if_fail (
+    self->samplerate > 0 && self->channels > 0, NULL);
+
+  self->frames = object_new_n (
+    (size_t) self->num_frames * self->channels, sample_t);
+  audio_clip_update_channel_caches (self, 0);
+
+  return self;
+}
+
+/**
+ * Decodes, resamples and hashes the given file on a
+ * worker thread and fills in the clip's frames when
+ * done.
+ *
+ * If the project's pool directory exists, the clip
+ * is also written to the pool on the worker thread.
+ *
+ * @note Must be called after the clip is added to
+ *   the pool, so that its name is final.
+ */
+void
+audio_clip_import_async (
+  AudioClip *  self,
+  const char * full_path)
+{
+  g_return_if_fail (!self->import_job);
+
+  AudioClipImportJob * job = object_new (AudioClipImportJob);
+  job->clip = self;
+  job->full_path = g_strdup (full_path);
+  job->samplerate = self->samplerate;
+  job->use_flac = self->use_flac;
+  job->bit_depth = self->bit_depth;
+  zix_sem_init (&job->done, 0);
+
+  char * prj_pool_dir = project_get_path (
+    PROJECT, PROJECT_PATH_POOL, F_NOT_BACKUP);
+  if (prj_pool_dir && file_exists (prj_pool_dir))
+    {
+      job->pool_path =
+        audio_clip_get_path_in_pool (self, F_NOT_BACKUP);
+    }
+  g_free (prj_pool_dir);
+
+  if (!import_thread_pool)
+    {
+      import_thread_pool = g_thread_pool_new (
+        import_job_run, NULL, (int) g_get_num_processors (),
+        false, NULL);
+    }
+
+  self->import_job = job;
+  g_thread_pool_push (import_thread_pool, job, NULL);
+}
+
+/**
+ * Blocks until the clip's background import (if
+ * any) finishes, and applies its results.
+ *
+ * To be called from the GTK thread.
+ */
+void
+audio_clip_wait_for_import (AudioClip * self)
+{
+  AudioClipImportJob * job = self->import_job;
+  if (!job)
+    return;
+
+  g_message ("waiting for import of %s...", self->name);
+  zix_sem_wait (&job->done);
+
+  /* the job is free'd by the idle callback */
+  import_job_finish (job);
+}
+
 /**
  * Creates an audio clip by copying the given float
  * array.
@@ -273,9 +832,49 @@ audio_clip_get_path_in_pool (AudioClip * self, bool is_backup)
     self->name, self->use_flac, is_backup);
 }
 
+/**
+ * Returns whether the clip's file in the main
+ * project's pool is known to contain the given
+ * content.
+ *
+ * @param content_hash Content hash to check, or 0
+ *   to check for the clip's current content.
+ */
+bool
+audio_clip_pool_file_is_in_sync (
+  const AudioClip * self,
+  uint64_t          content_hash)
+{
+  if (self->pool_file_content_hash == 0)
+    return false;
+
+  if (content_hash == 0)
+    content_hash = audio_clip_get_content_hash (self);
+  if (content_hash != self->pool_file_content_hash)
+    return false;
+
+  char * path = audio_clip_get_path_in_pool_from_name (
+    self->name, self->use_flac, F_NOT_BACKUP);
+  if (!path)
+    return false;
+
+  GStatBuf st;
+  bool     in_sync =
+    g_stat (path, &st) == 0
+    && (goffset) st.st_size == self->pool_file_size
+    && (gint64) st.st_mtime == self->pool_file_mtime;
+  g_free (path);
+
+  return in_sync;
+}
+
 /**
  * Writes the clip to the pool as a wav file.
  *
+ * Files with identical contents (in the pool of the
+ * main project or, for backups, in the main project)
+ * are shared instead of being written again.
+ *
  * @param parts If true, only write new data. @see
  *   AudioClip.frames_written.
  * @param is_backup Whether writing to a backup
@@ -292,6 +891,24 @@ audio_clip_write_to_pool (
   g_return_if_fail (pool_clip);
   g_return_if_fail (pool_clip == self);
 
+  if (self->import_job)
+    {
+      /* the import job writes the clip to the main
+       * pool itself */
+      if (
+        !parts && !is_backup
+        && self->import_job->pool_path)
+        {
+          g_debug (
+            "clip %s will be written to the pool after "
+            "importing",
+            self->name);
+          return;
+        }
+
+      audio_clip_wait_for_import (self);
+    }
+
   audio_pool_print (AUDIO_POOL);
   g_message (
     "attempting to write clip %s (%d) to pool...", self->name,
@@ -309,90 +926,96 @@ audio_clip_write_to_pool (
   /* whether a new write is needed */
   bool need_new_write = true;
 
-  /* skip if file with same hash already exists */
-  if (file_exists (new_path) && !parts)
+  /* frames not loaded (clip not in use) - the file
+   * in the main pool is the only copy */
+  bool frames_loaded =
+    self->frames && self->num_frames > 0;
+
+  uint64_t content_hash =
+    frames_loaded ? audio_clip_get_content_hash (self)
+                  : self->pool_file_content_hash;
+
+  /* skip if the file already has the same
+   * contents */
+  if (
+    !parts && !is_backup
+    && (audio_clip_pool_file_is_in_sync (self, content_hash)
+        || (!frames_loaded && file_exists (new_path))))
     {
-      char * existing_file_hash =
-        hash_get_from_file (new_path, HASH_ALGORITHM_XXH3_64);
-      bool same_hash =
-        self->file_hash
-        && string_is_equal (
-          self->file_hash, existing_file_hash);
-      g_free (existing_file_hash);
-
-      if (same_hash)
-        {
-          g_debug (
-            "skipping writing to existing clip %s "
-            "in pool",
-            new_path);
-          need_new_write = false;
-        }
-#if 0
-      else
-        {
-          g_critical (
-            "attempted to overwrite %s with a "
-            "different clip",
-            new_path);
-          return;
-        }
-#endif
+      g_debug (
+        "skipping writing to existing clip %s in pool",
+        new_path);
+      need_new_write = false;
     }
 
-  /* if writing to backup and same file exists in
-   * main project dir, copy (first try reflink) */
-  if (need_new_write && self->file_hash && is_backup)
+  /* otherwise share a file with the same contents
+   * if one exists: the same clip in the main project
+   * when writing a backup, or another clip in the
+   * main pool */
+  if (need_new_write && !parts)
     {
-      bool exists_in_main_project = false;
-      if (file_exists (path_in_main_project))
+      const AudioClip * src_clip = NULL;
+      if (
+        is_backup
+        && (!frames_loaded
+            || audio_clip_pool_file_is_in_sync (
+              self, content_hash)))
         {
-          char * existing_file_hash = hash_get_from_file (
-            path_in_main_project, HASH_ALGORITHM_XXH3_64);
-          exists_in_main_project = string_is_equal (
-            self->file_hash, existing_file_hash);
-          g_free (existing_file_hash);
+          src_clip = self;
+        }
+      else if (frames_loaded)
+        {
+          src_clip = audio_pool_find_clip_with_pool_file (
+            AUDIO_POOL, content_hash, self);
         }
 
-      if (exists_in_main_project)
+      char * src_path =
+        src_clip
+          ? audio_clip_get_path_in_pool (
+            (AudioClip *) src_clip, F_NOT_BACKUP)
+          : NULL;
+      if (src_path && file_exists (src_path))
         {
-          /* try reflink */
           g_debug (
-            "reflinking clip from main project "
-            "('%s' to '%s')",
-            path_in_main_project, new_path);
-
-          if (file_reflink (path_in_main_project, new_path) != 0)
+            "sharing clip file '%s' as '%s'", src_path,
+            new_path);
+          GError * err = NULL;
+          if (file_link_or_copy (new_path, src_path, &err))
             {
-              g_message (
-                "failed to reflink, copying "
-                "instead");
-
-              /* copy */
-              GFile * src_file =
-                g_file_new_for_path (path_in_main_project);
-              GFile * dest_file =
-                g_file_new_for_path (new_path);
-              GError * err = NULL;
-              g_debug (
-                "copying clip from main project "
-                "('%s' to '%s')",
-                path_in_main_project, new_path);
-              if (g_file_copy (
-                    src_file, dest_file, 0, NULL, NULL, NULL,
-                    &err))
+              need_new_write = false;
+              if (src_clip != self)
                 {
-                  need_new_write = false;
+                  g_free_and_null (self->file_hash);
+                  self->file_hash =
+                    src_clip->file_hash
+                      ? g_strdup (src_clip->file_hash)
+                      : hash_get_from_file (
+                        new_path, HASH_ALGORITHM_XXH3_64);
                 }
-              else /* else if failed */
+              if (!is_backup)
                 {
-                  g_warning (
-                    "Failed to copy '%s' to '%s': %s",
-                    path_in_main_project, new_path,
-                    err->message);
+                  set_pool_file_content_hash (
+                    self, new_path, content_hash);
                 }
-            } /* endif reflink fail */
+            }
+          else
+            {
+              g_warning (
+                "Failed to copy '%s' to '%s': %s", src_path,
+                new_path, err->message);
+              g_error_free (err);
+            }
         }
+      g_free (src_path);
+    }
+
+  if (need_new_write && !frames_loaded)
+    {
+      g_warning (
+        "clip %s is not loaded and has no file to "
+        "share, skipping",
+        self->name);
+      need_new_write = false;
     }
 
   if (need_new_write)
@@ -401,6 +1024,14 @@ audio_clip_write_to_pool (
         "writing clip %s to pool "
         "(parts %d, is backup  %d): '%s'",
         self->name, parts, is_backup, new_path);
+
+      /* the file may be shared with other clips or
+       * backups, so never overwrite it in place */
+      if (!parts && file_exists (new_path))
+        {
+          io_remove (new_path);
+        }
+
       audio_clip_write_to_file (self, new_path, parts);
 
       if (!parts)
@@ -409,6 +1040,17 @@ audio_clip_write_to_pool (
           g_free_and_null (self->file_hash);
           self->file_hash = hash_get_from_file (
             new_path, HASH_ALGORITHM_XXH3_64);
+
+          if (!is_backup)
+            {
+              set_pool_file_content_hash (
+                self, new_path, content_hash);
+            }
+        }
+      else if (!is_backup)
+        {
+          /* the file is being appended to */
+          self->pool_file_content_hash = 0;
         }
     }
 
@@ -700,11 +1342,18 @@ audio_clip_clone (AudioClip * src)
 void
 audio_clip_free (AudioClip * self)
 {
+  if (self->import_job)
+    {
+      self->import_job->clip = NULL;
+      g_atomic_int_set (&self->import_job->cancelled, 1);
+    }
+
   object_zero_and_free (self->frames);
   for (unsigned int i = 0; i < self->channels; i++)
     {
       object_zero_and_free_if_nonnull (self->ch_frames[i]);
     }
+  g_free_and_null (self->peaks);
   g_free_and_null (self->name);
   g_free_and_null (self->file_hash);
 
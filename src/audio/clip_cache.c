@@ -0,0 +1,280 @@
+// SPDX-FileCopyrightText: © 2022 Alexandros Theodotou <alex@zrythm.org>
+// SPDX-License-Identifier: LicenseRef-ZrythmLicense
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "audio/clip_cache.h"
+#include "utils/io.h"
+#include "utils/objects.h"
+#include "zrythm.h"
+
+#include <glib.h>
+#include <glib/gstdio.h>
+
+#define CLIP_CACHE_MAGIC "ZCLC"
+#define CLIP_CACHE_VERSION 1
+
+/**
+ * Header of each cache entry, followed by the
+ * interleaved frames.
+ */
+typedef struct ClipCacheHeader
+{
+  char     magic[4];
+  uint32_t version;
+  uint32_t channels;
+  uint32_t samplerate;
+  uint64_t num_frames;
+
+  /** Size of the pool file the entry was created
+   * from. */
+  int64_t src_size;
+
+  /** Modification time of the pool file the entry
+   * was created from. */
+  int64_t src_mtime;
+} ClipCacheHeader;
+
+/**
+ * Returns the path of the cache entry for the given
+ * clip decoded at the given samplerate, or NULL if
+ * the clip cannot be cached.
+ *
+ * Entries are keyed by the hash of the clip's pool
+ * file and the samplerate.
+ *
+ * To be called from the GTK thread.
+ */
+char *
+clip_cache_get_path (
+  const AudioClip * clip,
+  unsigned int      samplerate)
+{
+  if (!clip->file_hash || !ZRYTHM)
+    return NULL;
+
+  char * dir = zrythm_get_dir (ZRYTHM_DIR_USER_CLIP_CACHE);
+  char * basename = g_strdup_printf (
+    "%s-%u.f32", clip->file_hash, samplerate);
+  char * path = g_build_filename (dir, basename, NULL);
+  g_free (dir);
+  g_free (basename);
+
+  return path;
+}
+
+static bool
+get_src_stat (
+  const char * pool_path,
+  int64_t *    size,
+  int64_t *    mtime)
+{
+  GStatBuf st;
+  if (g_stat (pool_path, &st) != 0)
+    return false;
+
+  *size = (int64_t) st.st_size;
+  *mtime = (int64_t) st.st_mtime;
+  return true;
+}
+
+/**
+ * Fills in the clip's frames from the given cache
+ * entry.
+ *
+ * The entry is only used if it was created from the
+ * current version of the pool file.
+ *
+ * This is thread-safe as long as nothing else
+ * accesses the clip.
+ *
+ * @param samplerate Samplerate to load the clip in.
+ *
+ * @return Whether successful.
+ */
+bool
+clip_cache_load (
+  AudioClip *  clip,
+  const char * cache_path,
+  const char * pool_path,
+  unsigned int samplerate)
+{
+  int64_t src_size, src_mtime;
+  if (!get_src_stat (pool_path, &src_size, &src_mtime))
+    return false;
+
+  FILE * f = g_fopen (cache_path, "rb");
+  if (!f)
+    return false;
+
+  ClipCacheHeader header;
+  bool            valid =
+    fread (&header, sizeof (header), 1, f) == 1
+    && memcmp (header.magic, CLIP_CACHE_MAGIC, 4) == 0
+    && header.version == CLIP_CACHE_VERSION
+    && header.channels > 0 && header.channels <= 16
+    && header.samplerate == samplerate
+    && header.num_frames > 0 && header.src_size == src_size
+    && header.src_mtime == src_mtime;
+  if (!valid)
+    {
+      fclose (f);
+      return false;
+    }
+
+  size_t num_samples =
+    (size_t) header.num_frames * header.channels;
+  sample_t * frames =
+    g_try_malloc_n (num_samples, sizeof (sample_t));
+  if (
+    !frames
+    || fread (frames, sizeof (sample_t), num_samples, f)
+         != num_samples)
+    {
+      g_free (frames);
+      fclose (f);
+      return false;
+    }
+  fclose (f);
+
+  /* mark as recently used */
+  g_utime (cache_path, NULL);
+
+  g_free (clip->frames);
+  clip->frames = frames;
+  clip->num_frames = header.num_frames;
+  clip->channels = header.channels;
+  clip->samplerate = (int) samplerate;
+  audio_clip_update_channel_caches (clip, 0);
+
+  g_debug ("loaded clip %s from cache", clip->name);
+
+  return true;
+}
+
+/**
+ * Stores the clip's frames in the given cache
+ * entry.
+ *
+ * This is thread-safe as long as nothing else
+ * modifies the clip.
+ */
+void
+clip_cache_store (
+  const AudioClip * clip,
+  const char *      cache_path,
+  const char *      pool_path)
+{
+  if (!clip->frames || clip->num_frames == 0)
+    return;
+
+  ClipCacheHeader header;
+  memset (&header, 0, sizeof (header));
+  memcpy (header.magic, CLIP_CACHE_MAGIC, 4);
+  header.version = CLIP_CACHE_VERSION;
+  header.channels = clip->channels;
+  header.samplerate = (uint32_t) clip->samplerate;
+  header.num_frames = (uint64_t) clip->num_frames;
+  if (!get_src_stat (
+        pool_path, &header.src_size, &header.src_mtime))
+    return;
+
+  char * dir = g_path_get_dirname (cache_path);
+  g_mkdir_with_parents (dir, 0700);
+  g_free (dir);
+
+  /* write to a temporary file first so that
+   * partially written entries are never used */
+  char * tmp_path =
+    g_strdup_printf ("%s.%p.tmp", cache_path, (void *) clip);
+  FILE * f = g_fopen (tmp_path, "wb");
+  if (!f)
+    {
+      g_free (tmp_path);
+      return;
+    }
+
+  size_t num_samples =
+    (size_t) clip->num_frames * clip->channels;
+  bool success =
+    fwrite (&header, sizeof (header), 1, f) == 1
+    && fwrite (
+         clip->frames, sizeof (sample_t), num_samples, f)
+         == num_samples;
+  success = fclose (f) == 0 && success;
+
+  if (!success || g_rename (tmp_path, cache_path) != 0)
+    {
+      g_message ("failed to cache clip %s", clip->name);
+      g_unlink (tmp_path);
+    }
+  g_free (tmp_path);
+}
+
+typedef struct CacheEntry
+{
+  char *  path;
+  goffset size;
+  gint64  mtime;
+} CacheEntry;
+
+static int
+cmp_entries_by_mtime (const void * a, const void * b)
+{
+  const CacheEntry * ea = (const CacheEntry *) a;
+  const CacheEntry * eb = (const CacheEntry *) b;
+  return (ea->mtime > eb->mtime) - (ea->mtime < eb->mtime);
+}
+
+/**
+ * Removes the least recently used entries until the
+ * cache is smaller than @ref CLIP_CACHE_MAX_SIZE.
+ */
+void
+clip_cache_trim (void)
+{
+  if (!ZRYTHM)
+    return;
+
+  char * dir = zrythm_get_dir (ZRYTHM_DIR_USER_CLIP_CACHE);
+  char ** files = io_get_files_in_dir (dir, true);
+  g_free (dir);
+  if (!files)
+    return;
+
+  size_t num_files = g_strv_length (files);
+  CacheEntry * entries =
+    object_new_n (MAX (num_files, 1), CacheEntry);
+  size_t  num_entries = 0;
+  goffset total_size = 0;
+  for (size_t i = 0; i < num_files; i++)
+    {
+      GStatBuf st;
+      if (g_stat (files[i], &st) != 0)
+        continue;
+
+      CacheEntry * entry = &entries[num_entries++];
+      entry->path = files[i];
+      entry->size = (goffset) st.st_size;
+      entry->mtime = (gint64) st.st_mtime;
+      total_size += entry->size;
+    }
+
+  /* remove the oldest entries first */
+  qsort (
+    entries, num_entries, sizeof (CacheEntry),
+    cmp_entries_by_mtime);
+  for (size_t i = 0;
+       i < num_entries && total_size > CLIP_CACHE_MAX_SIZE;
+       i++)
+    {
+      g_debug ("removing cached clip %s", entries[i].path);
+      g_unlink (entries[i].path);
+      total_size -= entries[i].size;
+    }
+
+  free (entries);
+  g_strfreev (files);
+}
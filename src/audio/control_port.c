@@ -4,10 +4,12 @@
  */
 
 #include <math.h>
+#include <string.h>
 
 #include "audio/control_port.h"
 #include "audio/engine.h"
 #include "audio/port.h"
+#include "audio/router.h"
 #include "audio/track.h"
 #include "gui/backend/event.h"
 #include "gui/backend/event_manager.h"
@@ -79,6 +81,28 @@ control_port_set_real_val_w_events (Port * self, float val)
     self, val, F_NOT_NORMALIZED, F_PUBLISH_EVENTS);
 }
 
+void
+control_port_queue_real_val (Port * self, float val)
+{
+  g_return_if_fail (IS_PORT (self));
+  router_queue_control_value (
+    ROUTER, self, val, F_PUBLISH_EVENTS);
+}
+
+float
+control_port_get_queued_val (Port * self)
+{
+  if (g_atomic_int_get (&self->control_queued))
+    {
+      gint  bits = g_atomic_int_get (&self->queued_control);
+      float val;
+      memcpy (&val, &bits, sizeof (val));
+      return val;
+    }
+
+  return self->unsnapped_control;
+}
+
 void
 control_port_set_toggled (
   Port * self,
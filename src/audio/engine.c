@@ -36,6 +36,7 @@
 #include <signal.h>
 #include <stdlib.h>
 
+#include "audio/anticipative_renderer.h"
 #include "audio/automation_track.h"
 #include "audio/automation_tracklist.h"
 #include "audio/channel.h"
@@ -61,6 +62,7 @@
 #include "audio/router.h"
 #include "audio/sample_playback.h"
 #include "audio/sample_processor.h"
+#include "audio/tempo_map.h"
 #include "audio/tempo_track.h"
 #include "audio/transport.h"
 #include "gui/backend/event.h"
@@ -78,6 +80,7 @@
 #include "utils/mpmc_queue.h"
 #include "utils/object_pool.h"
 #include "utils/objects.h"
+#include "utils/rt_audit.h"
 #include "utils/string.h"
 #include "utils/ui.h"
 #include "zrythm.h"
@@ -125,6 +128,82 @@ engine_set_buffer_size (AudioEngine * self, uint32_t buf_size)
 #endif
 }
 
+/**
+ * Frees the retired tempo map if no cycle can be
+ * using it anymore.
+ *
+ * @param wait Whether to wait for the cycle that was
+ *   running when the map got retired to finish,
+ *   otherwise the map is kept if it is still
+ *   running.
+ */
+static void
+free_retired_tempo_map (AudioEngine * self, bool wait)
+{
+  if (!self->retired_tempo_map)
+    return;
+
+  while (
+    g_atomic_int_get (&self->cycle_running)
+    && self->cycle == self->retired_tempo_map_cycle)
+    {
+      if (!wait)
+        return;
+
+      g_usleep (100);
+    }
+
+  object_free_w_func_and_null (
+    tempo_map_free, self->retired_tempo_map);
+}
+
+/**
+ * Builds a new tempo map and, if it differs from the
+ * current one, replaces the current one with it.
+ *
+ * The current map is not modified in place since the
+ * audio threads may be reading it. It is retired
+ * instead and freed after the cycle running during
+ * the swap (if any) has finished.
+ *
+ * Must only be called from the GTK thread.
+ *
+ * @return Whether the map changed.
+ */
+static bool
+publish_tempo_map (
+  AudioEngine * self,
+  Track *       tempo_track,
+  bpm_t         bpm,
+  int           beats_per_bar,
+  sample_rate_t sample_rate)
+{
+  TempoMap * map = tempo_map_new (
+    tempo_track, bpm, beats_per_bar,
+    self->transport->ticks_per_bar, sample_rate);
+  g_return_val_if_fail (map, false);
+
+  TempoMap * prev_map = self->tempo_map;
+  if (prev_map && tempo_map_is_equal (map, prev_map))
+    {
+      tempo_map_free (map);
+      return false;
+    }
+
+  /* there can only be one retired map at a time */
+  free_retired_tempo_map (self, true);
+
+  map->version = prev_map ? prev_map->version + 1 : 1;
+  g_atomic_pointer_set (&self->tempo_map, map);
+
+  /* cycles starting from now see the new map */
+  self->retired_tempo_map = prev_map;
+  self->retired_tempo_map_cycle = self->cycle;
+  free_retired_tempo_map (self, false);
+
+  return true;
+}
+
 /**
  * Updates frames per tick based on the time sig,
  * the BPM, and the sample rate
@@ -184,6 +263,20 @@ engine_update_frames_per_tick (
     "ticks per frame after: %f",
     self->frames_per_tick, self->ticks_per_frame);
 
+  /* the tempo map also depends on the time
+   * signature and sample rate */
+  if (g_thread_self () == zrythm_app->gtk_thread)
+    {
+      publish_tempo_map (
+        self, P_TEMPO_TRACK, bpm, beats_per_bar,
+        sample_rate);
+    }
+  else
+    {
+      g_atomic_int_set (
+        &self->tempo_map_update_requested, 1);
+    }
+
   /* update positions */
   transport_update_positions (
     self->transport, update_from_ticks);
@@ -197,6 +290,53 @@ engine_update_frames_per_tick (
   self->updating_frames_per_tick = false;
 }
 
+/**
+ * Rebuilds the tempo map from the BPM automation
+ * and, only if the map changed, publishes it and
+ * updates the frames of the transport positions
+ * from their ticks.
+ *
+ * The frames of arranger objects are updated
+ * lazily when next read (see
+ * arranger_object_update_frames_if_stale()).
+ *
+ * To be called after the BPM automation may have
+ * changed. When called from another thread, the
+ * map is rebuilt in the next
+ * engine_process_events() instead.
+ */
+void
+engine_update_tempo_map (AudioEngine * self)
+{
+  if (!self->tempo_map || !TRACKLIST || !P_TEMPO_TRACK)
+    return;
+
+  /* the audio threads may be reading the map, it
+   * is only replaced on the GTK thread */
+  if (g_thread_self () != zrythm_app->gtk_thread)
+    {
+      g_atomic_int_set (
+        &self->tempo_map_update_requested, 1);
+      return;
+    }
+
+  bool changed = publish_tempo_map (
+    self, P_TEMPO_TRACK,
+    tempo_track_get_current_bpm (P_TEMPO_TRACK),
+    tempo_track_get_beats_per_bar (P_TEMPO_TRACK),
+    self->sample_rate);
+  if (!changed)
+    return;
+
+  g_message (
+    "tempo map changed (%d segments)",
+    self->tempo_map->num_segments);
+
+  self->updating_frames_per_tick = true;
+  transport_update_positions (self->transport, true);
+  self->updating_frames_per_tick = false;
+}
+
 /**
  * Cleans duplicate events and copies the events
  * to the given array.
@@ -240,6 +380,36 @@ clean_duplicates_and_copy (
     }
 }
 
+/**
+ * Grows the MIDI event buffers that dropped events
+ * in the processing threads.
+ *
+ * Must be called while the engine is paused.
+ */
+static void
+grow_dropped_midi_events (AudioEngine * self)
+{
+  GPtrArray * ports = g_ptr_array_new ();
+  port_get_all (ports);
+  for (size_t i = 0; i < ports->len; i++)
+    {
+      Port * port = g_ptr_array_index (ports, i);
+      if (port->id.type == TYPE_EVENT && port->midi_events)
+        {
+          midi_events_grow_to_peak (port->midi_events);
+        }
+    }
+  g_ptr_array_unref (ports);
+
+  if (
+    self->sample_processor
+    && self->sample_processor->midi_events)
+    {
+      midi_events_grow_to_peak (
+        self->sample_processor->midi_events);
+    }
+}
+
 /**
  * GSourceFunc to be added using idle add.
  *
@@ -257,6 +427,14 @@ engine_process_events (AudioEngine * self)
       return G_SOURCE_CONTINUE;
     }
 
+  /* rebuild the tempo map if requested from
+   * another thread */
+  if (g_atomic_int_compare_and_exchange (
+        &self->tempo_map_update_requested, 1, 0))
+    {
+      engine_update_tempo_map (self);
+    }
+
   self->last_events_process_started = g_get_monotonic_time ();
 
   /*g_debug ("PROCESS EVENTS");*/
@@ -314,6 +492,9 @@ engine_process_events (AudioEngine * self)
 #endif
           EVENTS_PUSH (ET_ENGINE_SAMPLE_RATE_CHANGED, NULL);
           break;
+        case AUDIO_ENGINE_EVENT_MIDI_EVENTS_DROPPED:
+          grow_dropped_midi_events (self);
+          break;
         default:
           g_warning ("event %d not implemented yet", ev->type);
           break;
@@ -824,6 +1005,11 @@ init_common (AudioEngine * self)
       ? PAN_ALGORITHM_SINE_LAW
       : (PanAlgorithm) g_settings_get_enum (
         S_P_DSP_PAN, "pan-algorithm");
+  self->plugin_sub_block_size =
+    ZRYTHM_TESTING
+      ? 0
+      : (nframes_t) g_settings_get_int (
+        S_P_DSP_AUTOMATION, "plugin-sub-block-size");
 
   /* set a temporary buffer sizes */
   if (self->block_length == 0)
@@ -851,7 +1037,8 @@ engine_init_loaded (AudioEngine * self, Project * project)
 
   self->project = project;
 
-  audio_pool_init_loaded (self->pool);
+  /* the pool is loaded by the project once the
+   * final samplerate is known */
 
   Track * tempo_track = NULL;
   if (project)
@@ -1033,6 +1220,13 @@ engine_wait_for_pause (
 
   g_message ("cycle finished");
 
+  /* the project may change while paused */
+  if (self->router)
+    {
+      anticipative_renderer_reclaim_all (
+        self->router->anticipative_renderer);
+    }
+
   g_atomic_int_set (&MONITOR_FADER->fading_out, 0);
 
   if (PROJECT->loaded)
@@ -1058,6 +1252,20 @@ engine_wait_for_pause (
       router_start_cycle (ROUTER, time_nfo);
       engine_post_process (self, 0, 1);
     }
+
+  /* don't keep queued control changes around
+   * while paused since ports may get removed */
+  if (self->router)
+    {
+      router_apply_queued_control_values (self->router);
+      if (
+        ZRYTHM_HAVE_UI
+        && g_thread_self () == zrythm_app->gtk_thread)
+        {
+          router_dispatch_control_notifications (
+            self->router);
+        }
+    }
 }
 
 void
@@ -1384,7 +1592,9 @@ engine_process_prepare (AudioEngine * self, nframes_t nframes)
     {
       self->transport->play_state = PLAYSTATE_ROLLING;
       self->remaining_latency_preroll =
-        router_get_max_route_playback_latency (self->router);
+        router_get_max_route_playback_latency (self->router)
+        + anticipative_renderer_start (
+          self->router->anticipative_renderer);
 #if 0
       g_message (
         "starting playback, remaining latency "
@@ -1443,6 +1653,11 @@ engine_process_prepare (AudioEngine * self, nframes_t nframes)
   sample_processor_prepare_process (
     self->sample_processor, nframes);
 
+  /* decide which tracks are rendered ahead in
+   * this cycle */
+  anticipative_renderer_prepare_process (
+    self->router->anticipative_renderer);
+
   /* prepare channels for this cycle */
   Channel * ch;
   for (int i = 0; i < TRACKLIST->num_tracks; i++)
@@ -1505,6 +1720,8 @@ engine_process (
 
   g_return_val_if_fail (total_frames_to_process > 0, -1);
 
+  rt_audit_enter ();
+
   /*g_message ("processing...");*/
   g_atomic_int_set (&self->cycle_running, 1);
 
@@ -1521,6 +1738,7 @@ engine_process (
       /*g_message ("skipping processing...");*/
       clear_output_buffers (self, total_frames_to_process);
       g_atomic_int_set (&self->cycle_running, 0);
+      rt_audit_leave ();
       return 0;
     }
 
@@ -1535,6 +1753,7 @@ engine_process (
     {
       clear_output_buffers (self, total_frames_to_process);
       g_atomic_int_set (&self->cycle_running, 0);
+      rt_audit_leave ();
       return 0;
     }
 
@@ -1730,6 +1949,8 @@ finalize_processing:
   self->last_timestamp_start = self->timestamp_start;
   self->last_timestamp_end = g_get_monotonic_time ();
 
+  rt_audit_leave ();
+
   /*
    * processing finished, return 0 (OK)
    */
@@ -1775,6 +1996,8 @@ engine_post_process (
         }
 #endif
     }
+  anticipative_renderer_post_process (
+    self->router->anticipative_renderer);
 
   /* update max time taken (for calculating DSP
    * %) */
@@ -2179,6 +2402,11 @@ engine_free (AudioEngine * self)
   object_free_w_func_and_null (
     hardware_processor_free, self->hw_out_processor);
 
+  object_free_w_func_and_null (
+    tempo_map_free, self->tempo_map);
+  object_free_w_func_and_null (
+    tempo_map_free, self->retired_tempo_map);
+
   object_zero_and_free (self);
 
   g_debug ("finished freeing engine");
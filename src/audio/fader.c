@@ -8,10 +8,14 @@
 #include "audio/control_room.h"
 #include "audio/engine.h"
 #include "audio/fader.h"
+#include "audio/graph.h"
+#include "audio/graph_thread.h"
 #include "audio/group_target_track.h"
 #include "audio/master_track.h"
 #include "audio/midi_event.h"
+#include "audio/router.h"
 #include "audio/track.h"
+#include "audio/tracklist.h"
 #include "gui/backend/event.h"
 #include "gui/backend/event_manager.h"
 #include "project.h"
@@ -881,6 +885,146 @@ fader_update_track_pos (
 }
 #endif
 
+/**
+ * Adds the output of a listened fader to the listen
+ * bus partial sum of the current graph thread.
+ *
+ * Each graph thread has its own partial sum so no
+ * locking is needed. The monitor fader (which runs
+ * after all channel faders) mixes the partial sums
+ * into its output.
+ */
+static void
+add_to_listen_bus (
+  Fader *                             self,
+  const EngineProcessTimeInfo * const time_nfo)
+{
+  GraphThread * thread = graph_thread_get_current ();
+  if (G_UNLIKELY (!thread))
+    {
+      /* processed outside the graph (e.g., forced
+       * processing from the GTK thread) - there is
+       * no monitor pass to mix into */
+      return;
+    }
+
+  const EngineProcessTimeInfo * cycle_nfo =
+    &ROUTER->time_nfo;
+  if (G_UNLIKELY (
+        cycle_nfo->local_offset + cycle_nfo->nframes
+        > thread->listen_buf_size))
+    return;
+
+  /* first listened fader on this thread for this
+   * cycle: clear the stale partial sum */
+  if (thread->listen_cycle != ROUTER->cycle)
+    {
+      for (int i = 0; i < 2; i++)
+        {
+          dsp_fill (
+            &thread->listen_bufs[i][cycle_nfo->local_offset],
+            0.f, cycle_nfo->nframes);
+        }
+      thread->listen_cycle = ROUTER->cycle;
+    }
+
+  float listen_amp =
+    fader_get_amp (CONTROL_ROOM->listen_fader);
+  dsp_mix2 (
+    &thread->listen_bufs[0][time_nfo->local_offset],
+    &self->stereo_out->l->buf[time_nfo->local_offset], 1.f,
+    listen_amp, time_nfo->nframes);
+  dsp_mix2 (
+    &thread->listen_bufs[1][time_nfo->local_offset],
+    &self->stereo_out->r->buf[time_nfo->local_offset], 1.f,
+    listen_amp, time_nfo->nframes);
+}
+
+/**
+ * Mixes the listen bus partial sums of all graph
+ * threads into the (monitor) fader's output.
+ */
+static void
+add_listen_bus_to_output (
+  Fader *                             self,
+  const EngineProcessTimeInfo * const time_nfo)
+{
+  Graph * graph = ROUTER->graph;
+  for (int i = -1; i < graph->num_threads; i++)
+    {
+      GraphThread * thread =
+        i < 0 ? graph->main_thread : graph->threads[i];
+      if (!thread || thread->listen_cycle != ROUTER->cycle)
+        continue;
+
+      dsp_add2 (
+        &self->stereo_out->l->buf[time_nfo->local_offset],
+        &thread->listen_bufs[0][time_nfo->local_offset],
+        time_nfo->nframes);
+      dsp_add2 (
+        &self->stereo_out->r->buf[time_nfo->local_offset],
+        &thread->listen_bufs[1][time_nfo->local_offset],
+        time_nfo->nframes);
+    }
+}
+
+/**
+ * Called instead of the regular audio processing
+ * when the input is known to be silent.
+ *
+ * The output is left silent and the mute fades are
+ * advanced as if the range was processed.
+ */
+static void
+process_silent_input (
+  Fader *                             self,
+  const EngineProcessTimeInfo * const time_nfo,
+  const bool                          effectively_muted,
+  const int                           default_fade_frames)
+{
+  dsp_fill (
+    &self->stereo_out->l->buf[time_nfo->local_offset],
+    DENORMAL_PREVENTION_VAL, time_nfo->nframes);
+  dsp_fill (
+    &self->stereo_out->r->buf[time_nfo->local_offset],
+    DENORMAL_PREVENTION_VAL, time_nfo->nframes);
+  port_update_silence (self->stereo_out->l, true);
+  port_update_silence (self->stereo_out->r, true);
+
+  if (self->passthrough)
+    return;
+
+  if (effectively_muted && !self->was_effectively_muted)
+    {
+      g_atomic_int_set (
+        &self->fade_out_samples, default_fade_frames);
+      g_atomic_int_set (&self->fading_out, 1);
+    }
+  else if (!effectively_muted && self->was_effectively_muted)
+    {
+      g_atomic_int_set (&self->fading_out, 0);
+      g_atomic_int_set (
+        &self->fade_in_samples, default_fade_frames);
+    }
+
+  int fade_in_samples =
+    g_atomic_int_get (&self->fade_in_samples);
+  if (fade_in_samples > 0)
+    {
+      g_atomic_int_set (
+        &self->fade_in_samples,
+        MAX (fade_in_samples - (int) time_nfo->nframes, 0));
+    }
+  if (g_atomic_int_get (&self->fading_out))
+    {
+      int fade_out_samples =
+        g_atomic_int_get (&self->fade_out_samples);
+      g_atomic_int_set (
+        &self->fade_out_samples,
+        MAX (fade_out_samples - (int) time_nfo->nframes, 0));
+    }
+}
+
 /**
  * Process the Fader.
  */
@@ -926,9 +1070,8 @@ fader_process (
         ((self->type == FADER_TYPE_AUDIO_CHANNEL
           ||
           self->type == FADER_TYPE_MIDI_CHANNEL)
-         && tracklist_has_soloed (TRACKLIST)
-         && !fader_get_soloed (self)
-         && !fader_get_implied_soloed (self)
+         && TRACKLIST->has_soloed_cached
+         && !self->soloed && !self->implied_soloed
          && track != P_MASTER_TRACK)
         ||
         (AUDIO_ENGINE->bounce_mode == BOUNCE_ON
@@ -954,6 +1097,18 @@ fader_process (
     }
 
   if (
+    (self->type == FADER_TYPE_AUDIO_CHANNEL
+     || self->type == FADER_TYPE_SAMPLE_PROCESSOR)
+    && port_is_silent (self->stereo_in->l)
+    && port_is_silent (self->stereo_in->r))
+    {
+      /* silence in, silence out: only keep the fade
+       * state in sync */
+      process_silent_input (
+        self, time_nfo, effectively_muted,
+        default_fade_frames);
+    }
+  else if (
     self->type == FADER_TYPE_AUDIO_CHANNEL
     || self->type == FADER_TYPE_MONITOR
     || self->type == FADER_TYPE_SAMPLE_PROCESSOR)
@@ -968,6 +1123,10 @@ fader_process (
         &self->stereo_in->r->buf[time_nfo->local_offset],
         time_nfo->nframes);
 
+      /* whether the whole output range ends up
+       * silent */
+      bool out_silent = false;
+
       /* if prefader */
       if (self->passthrough)
         {
@@ -1003,7 +1162,7 @@ fader_process (
                 fader_get_amp (CONTROL_ROOM->dim_fader);
 
               /* if have listened tracks */
-              if (tracklist_has_listened (TRACKLIST))
+              if (TRACKLIST->has_listened_cached)
                 {
                   /* dim signal */
                   dsp_mul_k2 (
@@ -1016,41 +1175,7 @@ fader_process (
                     dim_amp, time_nfo->nframes);
 
                   /* add listened signal */
-                  /* TODO add "listen" buffer
-                   * on fader struct and add
-                   * listened tracks to it during
-                   * processing instead of looping
-                   * here */
-                  float listen_amp = fader_get_amp (
-                    CONTROL_ROOM->listen_fader);
-                  for (int i = 0; i < TRACKLIST->num_tracks;
-                       i++)
-                    {
-                      Track * t = TRACKLIST->tracks[i];
-
-                      if (
-                        track_type_has_channel (t->type)
-                        && t->out_signal_type == TYPE_AUDIO
-                        && track_get_listened (t))
-                        {
-                          Fader * f =
-                            track_get_fader (t, true);
-                          dsp_mix2 (
-                            &self->stereo_out->l
-                               ->buf[time_nfo->local_offset],
-                            &f->stereo_out->l
-                               ->buf[time_nfo->local_offset],
-                            1.f, listen_amp,
-                            time_nfo->nframes);
-                          dsp_mix2 (
-                            &self->stereo_out->r
-                               ->buf[time_nfo->local_offset],
-                            &f->stereo_out->r
-                               ->buf[time_nfo->local_offset],
-                            1.f, listen_amp,
-                            time_nfo->nframes);
-                        }
-                    }
+                  add_listen_bus_to_output (self, time_nfo);
                 } /* endif have listened tracks */
 
               /* apply dim if enabled */
@@ -1186,6 +1311,13 @@ fader_process (
                 }
             }
 
+          /* fully faded out and muted for the whole
+           * range */
+          out_silent =
+            faded_out_frames == 0 && effectively_muted
+            && g_atomic_int_get (&self->fade_out_samples) == 0
+            && mute_amp < 0.00001f;
+
           float pan =
             port_get_control_value (self->balance, 0);
           float amp = port_get_control_value (self->amp, 0);
@@ -1283,8 +1415,20 @@ fader_process (
                    ->buf[time_nfo->local_offset],
                 -2.f, 2.f, time_nfo->nframes);
             }
+
+          /* if listened, add to the listen bus */
+          if (
+            self->type == FADER_TYPE_AUDIO_CHANNEL
+            && TRACKLIST->has_listened_cached
+            && fader_get_listened (self))
+            {
+              add_to_listen_bus (self, time_nfo);
+            }
         } /* fi not prefader */
-    }     /* fi monitor/audio fader */
+
+      port_update_silence (self->stereo_out->l, out_silent);
+      port_update_silence (self->stereo_out->r, out_silent);
+    } /* fi monitor/audio fader */
   else if (self->type == FADER_TYPE_MIDI_CHANNEL)
     {
       if (!effectively_muted)
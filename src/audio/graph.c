@@ -38,6 +38,7 @@
 #include "audio/tracklist.h"
 #include "plugins/plugin.h"
 #include "project.h"
+#include "settings/settings.h"
 #include "utils/arrays.h"
 #include "utils/audio.h"
 #include "utils/env.h"
@@ -48,6 +49,7 @@
 #include "utils/objects.h"
 #include "utils/stoat.h"
 #include "utils/string.h"
+#include "zrythm.h"
 
 /* called from a terminal node (from the Graph
  * worked-thread) to indicate it has completed
@@ -879,9 +881,13 @@ graph_setup (
         {
           for (int j = 0; j < 16; j++)
             {
+              /* MIDI control ports are only created
+               * on first use */
               for (int k = 0; k < 128; k++)
                 {
                   port = tr->processor->midi_cc[j * 128 + k];
+                  if (!port)
+                    continue;
                   node2 =
                     graph_find_node_from_port (self, port);
                   if (node2)
@@ -892,21 +898,21 @@ graph_setup (
 
               port = tr->processor->pitch_bend[j];
               node2 = graph_find_node_from_port (self, port);
-              if (node2 || !drop_unnecessary_ports)
+              if (node2 || (port && !drop_unnecessary_ports))
                 {
                   graph_node_connect (node2, node);
                 }
 
               port = tr->processor->poly_key_pressure[j];
               node2 = graph_find_node_from_port (self, port);
-              if (node2 || !drop_unnecessary_ports)
+              if (node2 || (port && !drop_unnecessary_ports))
                 {
                   graph_node_connect (node2, node);
                 }
 
               port = tr->processor->channel_pressure[j];
               node2 = graph_find_node_from_port (self, port);
-              if (node2 || !drop_unnecessary_ports)
+              if (node2 || (port && !drop_unnecessary_ports))
                 {
                   graph_node_connect (node2, node);
                 }
@@ -1026,6 +1032,13 @@ graph_setup (
           port = fader->stereo_out->r;
           node2 = graph_find_node_from_port (self, port);
           graph_node_connect (node, node2);
+
+          /* the monitor fader mixes in the listen
+           * bus written by this fader so it must run
+           * after it */
+          node2 = graph_find_node_from_monitor_fader (
+            self, MONITOR_FADER);
+          graph_node_connect (node, node2);
         }
       else if (fader->type == FADER_TYPE_MIDI_CHANNEL)
         {
@@ -1220,6 +1233,25 @@ graph_setup (
   tracklist_set_caches (TRACKLIST);
   tracklist_set_caches (SAMPLE_PROCESSOR->tracklist);
 
+  /* routing affects implied solo state */
+  tracklist_mark_solo_caches_dirty (TRACKLIST);
+
+  /* make room for the listen bus in case the block
+   * length changed */
+  for (int i = 0; i < self->num_threads; i++)
+    {
+      if (self->threads[i])
+        {
+          graph_thread_ensure_listen_bufs (
+            self->threads[i], AUDIO_ENGINE->block_length);
+        }
+    }
+  if (self->main_thread)
+    {
+      graph_thread_ensure_listen_bufs (
+        self->main_thread, AUDIO_ENGINE->block_length);
+    }
+
   /*graph_print (self);*/
 
   g_ptr_array_unref (ports);
@@ -1278,6 +1310,60 @@ graph_validate_with_connection (
   return valid;
 }
 
+/**
+ * Decides the CPU each thread is pinned to, the main
+ * thread first, limiting the number of threads to
+ * the number of CPUs used.
+ */
+static void
+get_thread_cpus (Graph * graph, int * cpus)
+{
+  CpuAffinity default_affinity = CPU_AFFINITY_NONE;
+  bool        use_isolated = false;
+  if (!ZRYTHM_TESTING)
+    {
+      default_affinity = (CpuAffinity) g_settings_get_enum (
+        S_P_DSP_THREADS, "affinity");
+      use_isolated = g_settings_get_boolean (
+        S_P_DSP_THREADS, "use-isolated-cpus");
+    }
+  graph->affinity = (CpuAffinity) env_get_int (
+    "ZRYTHM_DSP_THREAD_AFFINITY", (int) default_affinity);
+  if (
+    graph->affinity < CPU_AFFINITY_NONE
+    || graph->affinity > CPU_AFFINITY_CACHE_GROUPS)
+    {
+      g_warning ("invalid affinity %d", graph->affinity);
+      graph->affinity = CPU_AFFINITY_NONE;
+    }
+
+  int num_threads = graph->num_threads + 1;
+  for (int i = 0; i < num_threads; i++)
+    {
+      cpus[i] = -1;
+    }
+  if (graph->affinity == CPU_AFFINITY_NONE)
+    return;
+
+  CpuTopology * topology = cpu_topology_new_from_system ();
+  int           num_cpus = cpu_topology_get_thread_cpus (
+    topology, graph->affinity, use_isolated, num_threads,
+    cpus);
+  cpu_topology_free (topology);
+
+  if (num_cpus == 0)
+    {
+      g_warning ("no CPUs to pin the graph threads to");
+      return;
+    }
+
+  /* one thread per CPU */
+  graph->num_threads = MIN (graph->num_threads, num_cpus - 1);
+  g_message (
+    "pinning %d graph threads to %d CPUs",
+    graph->num_threads + 1, num_cpus);
+}
+
 /**
  * Starts as many threads as there are cores.
  *
@@ -1292,14 +1378,21 @@ graph_start (Graph * graph)
     env_get_int ("ZRYTHM_DSP_THREADS", num_cores - 2);
   g_warn_if_fail (graph->num_threads >= 0);
 
-  graph->num_threads = MAX (graph->num_threads, 0);
+  graph->num_threads =
+    CLAMP (graph->num_threads, 0, MAX_GRAPH_THREADS);
+
+  /* CPU of the main thread first, then the worker
+   * threads */
+  int cpus[MAX_GRAPH_THREADS + 1];
+  get_thread_cpus (graph, cpus);
 
   /* create worker threads (num cores - 2 because
    * the main thread will become a worker too, so
    * in total N_CORES - 1 threads */
   for (int i = 0; i < graph->num_threads; i++)
     {
-      graph->threads[i] = graph_thread_new (i, 0, graph);
+      graph->threads[i] =
+        graph_thread_new (i, 0, cpus[i + 1], graph);
       if (!graph->threads[i])
         {
           g_error ("thread new failed");
@@ -1309,7 +1402,8 @@ graph_start (Graph * graph)
     }
 
   /* and the main thread */
-  graph->main_thread = graph_thread_new (-1, 1, graph);
+  graph->main_thread =
+    graph_thread_new (-1, 1, cpus[0], graph);
   if (!graph->main_thread)
     {
       g_error ("thread new failed");
@@ -1410,12 +1504,14 @@ graph_terminate (Graph * self)
       g_return_if_fail (self->threads[i]);
       void * status;
       pthread_join (self->threads[i]->pthread, &status);
-      self->threads[i] = NULL;
+      object_free_w_func_and_null (
+        graph_thread_free, self->threads[i]);
     }
   g_return_if_fail (self->main_thread);
   void * status;
   pthread_join (self->main_thread->pthread, &status);
-  self->main_thread = NULL;
+  object_free_w_func_and_null (
+    graph_thread_free, self->main_thread);
 
   g_message ("graph terminated");
 }
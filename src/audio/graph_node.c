@@ -8,6 +8,7 @@
 #include "audio/fader.h"
 #include "audio/graph.h"
 #include "audio/graph_node.h"
+#include "audio/graph_thread.h"
 #include "audio/master_track.h"
 #include "audio/midi_event.h"
 #include "audio/port.h"
@@ -281,6 +282,57 @@ process_node (
     }
 }
 
+/**
+ * Processes the node, splitting the range at loop
+ * points.
+ */
+HOT static void
+process_split_at_loop_points (
+  const GraphNode *     node,
+  EngineProcessTimeInfo time_nfo)
+{
+  /* split at loop points */
+  for (
+    nframes_t num_processable_frames = 0;
+    (num_processable_frames = MIN (
+       transport_is_loop_point_met (
+         TRANSPORT, (signed_frame_t) time_nfo.g_start_frame,
+         time_nfo.nframes),
+       time_nfo.nframes))
+    != 0;)
+    {
+#if 0
+      g_message (
+        "splitting from %ld "
+        "(num processable frames %"
+        PRIu32 ")",
+        g_start_frames, num_processable_frames);
+#endif
+
+      /* temporarily change the nframes to avoid
+       * having to declare a separate
+       * EngineProcessTimeInfo */
+      nframes_t orig_nframes = time_nfo.nframes;
+      time_nfo.nframes = num_processable_frames;
+      process_node (node, time_nfo);
+
+      /* calculate the remaining frames */
+      time_nfo.nframes = orig_nframes - num_processable_frames;
+
+      /* loop back to loop start */
+      time_nfo.g_start_frame =
+        (time_nfo.g_start_frame + num_processable_frames
+         + (unsigned_frame_t) TRANSPORT->loop_start_pos.frames)
+        - (unsigned_frame_t) TRANSPORT->loop_end_pos.frames;
+      time_nfo.local_offset += num_processable_frames;
+    }
+
+  if (time_nfo.nframes > 0)
+    {
+      process_node (node, time_nfo);
+    }
+}
+
 /**
  * Processes the GraphNode.
  */
@@ -330,6 +382,31 @@ graph_node_process (
       /*}*/
     }
 
+  /* the pre-fader part of tracks rendered ahead of
+   * time is processed by the anticipative
+   * renderer, only read its output into the
+   * fader */
+  AnticipativeTrack * at = node->anticipative_track;
+  if (at && at->anticipated)
+    {
+      if (
+        node->anticipative_role
+          == ANTICIPATIVE_NODE_ROLE_FADER_IN_L
+        || node->anticipative_role
+             == ANTICIPATIVE_NODE_ROLE_FADER_IN_R)
+        {
+          anticipative_track_read (
+            at,
+            node->anticipative_role
+                == ANTICIPATIVE_NODE_ROLE_FADER_IN_L
+              ? 0
+              : 1,
+            node->port, &time_nfo,
+            node->route_playback_latency);
+        }
+      goto node_process_finish;
+    }
+
   /* only compensate latency when rolling */
   if (TRANSPORT->play_state == PLAYSTATE_ROLLING)
     {
@@ -355,46 +432,7 @@ graph_node_process (
         (unsigned_frame_t) playhead_copy.frames;
     }
 
-  /* split at loop points */
-  for (
-    nframes_t num_processable_frames = 0;
-    (num_processable_frames = MIN (
-       transport_is_loop_point_met (
-         TRANSPORT, (signed_frame_t) time_nfo.g_start_frame,
-         time_nfo.nframes),
-       time_nfo.nframes))
-    != 0;)
-    {
-#if 0
-      g_message (
-        "splitting from %ld "
-        "(num processable frames %"
-        PRIu32 ")",
-        g_start_frames, num_processable_frames);
-#endif
-
-      /* temporarily change the nframes to avoid
-       * having to declare a separate
-       * EngineProcessTimeInfo */
-      nframes_t orig_nframes = time_nfo.nframes;
-      time_nfo.nframes = num_processable_frames;
-      process_node (node, time_nfo);
-
-      /* calculate the remaining frames */
-      time_nfo.nframes = orig_nframes - num_processable_frames;
-
-      /* loop back to loop start */
-      time_nfo.g_start_frame =
-        (time_nfo.g_start_frame + num_processable_frames
-         + (unsigned_frame_t) TRANSPORT->loop_start_pos.frames)
-        - (unsigned_frame_t) TRANSPORT->loop_end_pos.frames;
-      time_nfo.local_offset += num_processable_frames;
-    }
-
-  if (time_nfo.nframes > 0)
-    {
-      process_node (node, time_nfo);
-    }
+  process_split_at_loop_points (node, time_nfo);
 
 node_process_finish:
   if (node->graph->router->callback_in_progress)
@@ -403,6 +441,17 @@ node_process_finish:
     }
 }
 
+OPTIMIZE_O3
+void
+graph_node_process_anticipated (
+  GraphNode *           node,
+  EngineProcessTimeInfo time_nfo)
+{
+  g_return_if_fail (node);
+
+  process_split_at_loop_points (node, time_nfo);
+}
+
 /**
  * Called by an upstream node when it has completed
  * processing.
@@ -420,6 +469,19 @@ graph_node_trigger (GraphNode * self)
       /* all nodes that feed this node have
        * completed, so this node be processed
        * now. */
+
+      /* keep the chain on this thread so its
+       * buffers stay in this core's cache */
+      if (self->graph->affinity == CPU_AFFINITY_CACHE_GROUPS)
+        {
+          GraphThread * thread = graph_thread_get_current ();
+          if (thread && !thread->next_node)
+            {
+              thread->next_node = self;
+              return;
+            }
+        }
+
       g_atomic_int_inc (&self->graph->trigger_queue_size);
       /*g_message ("triggering node, pushing back");*/
       mpmc_queue_push_back_node (
@@ -51,6 +51,9 @@
  * ---
  */
 
+/* for pthread_attr_setaffinity_np() */
+#define _GNU_SOURCE
+
 #include "zrythm-config.h"
 
 #ifndef _WOE32
@@ -75,6 +78,7 @@
 #include "project.h"
 #include "utils/mpmc_queue.h"
 #include "utils/objects.h"
+#include "utils/rt_audit.h"
 #include "utils/ui.h"
 #include "zrythm_app.h"
 
@@ -87,6 +91,42 @@
 /* uncomment to show debug messages */
 /*#define DEBUG_THREADS 1*/
 
+/** Graph thread the current thread belongs to. */
+static __thread GraphThread * current_thread = NULL;
+
+/**
+ * Wakes up idle threads, but at most as many as
+ * there's work in the trigger queue that can be
+ * processed by other threads.
+ *
+ * @param own_work Number of nodes in the trigger
+ *   queue size that this thread is about to
+ *   process (1 if it dequeued a node and has not
+ *   decreased the trigger queue size yet).
+ */
+static inline void
+wake_up_idle_threads (
+  GraphThread * thread,
+  Graph *       graph,
+  guint         own_work)
+{
+  guint idle_cnt =
+    (guint) g_atomic_int_get (&graph->idle_thread_cnt);
+  guint work_avail =
+    (guint) g_atomic_int_get (&graph->trigger_queue_size);
+  guint wakeup = MIN (idle_cnt + own_work, work_avail);
+#ifdef DEBUG_THREADS
+  g_message (
+    "[%d]: Waking up %u idle threads (idle count %u), work available -> %u",
+    thread->id, wakeup - own_work, idle_cnt, work_avail);
+#endif
+
+  for (guint i = own_work; i < wakeup; ++i)
+    {
+      zix_sem_post (&graph->trigger);
+    }
+}
+
 OPTIMIZE (O3)
 static void *
 worker_thread (void * arg)
@@ -99,9 +139,11 @@ worker_thread (void * arg)
    * allocation is done later on */
   g_thread_self ();
 
+  current_thread = thread;
+
   g_message (
-    "WORKER THREAD %d created (num threads %d)", thread->id,
-    graph->num_threads);
+    "WORKER THREAD %d created (num threads %d, CPU %d)",
+    thread->id, graph->num_threads, thread->cpu);
 
   /* wait for all threads to get created */
   if (thread->id < graph->num_threads - 1)
@@ -118,7 +160,11 @@ worker_thread (void * arg)
 
   for (;;)
     {
-      to_run = NULL;
+      /* continue the chain of the last node, if
+       * any */
+      to_run = thread->next_node;
+      thread->next_node = NULL;
+      bool from_queue = false;
 
       if (g_atomic_int_get (&graph->terminate))
         {
@@ -134,37 +180,26 @@ worker_thread (void * arg)
           goto terminate_thread;
         }
 
-      if (mpmc_queue_dequeue_node (
-            graph->trigger_queue, &to_run))
+      if (to_run)
+        {
+          /* the other children of the last node may
+           * be waiting in the queue */
+          wake_up_idle_threads (thread, graph, 0);
+        }
+      else if (mpmc_queue_dequeue_node (
+                 graph->trigger_queue, &to_run))
         {
           g_warn_if_fail (to_run);
+          from_queue = true;
 #ifdef DEBUG_THREADS
           g_message (
             "[%d]: dequeued node (nodes left %d)", thread->id,
             g_atomic_int_get (&graph->trigger_queue_size));
           graph_node_print (to_run);
 #endif
-          /* Wake up idle threads, but at most as
-           * many as there's work in the trigger
-           * queue that can be processed by other
-           * threads.
-           * This thread as not yet decreased
-           * _trigger_queue_size. */
-          guint idle_cnt = (guint) g_atomic_int_get (
-            &graph->idle_thread_cnt);
-          guint work_avail = (guint) g_atomic_int_get (
-            &graph->trigger_queue_size);
-          guint wakeup = MIN (idle_cnt + 1, work_avail);
-#ifdef DEBUG_THREADS
-          g_message (
-            "[%d]: Waking up %u idle threads (idle count %u), work available -> %u",
-            thread->id, wakeup - 1, idle_cnt, work_avail);
-#endif
-
-          for (guint i = 1; i < wakeup; ++i)
-            {
-              zix_sem_post (&graph->trigger);
-            }
+          /* this thread has not yet decreased
+           * trigger_queue_size */
+          wake_up_idle_threads (thread, graph, 1);
         }
 
       while (!to_run)
@@ -209,16 +244,22 @@ worker_thread (void * arg)
 #endif
 
           /* try to find some work to do */
-          mpmc_queue_dequeue_node (
+          from_queue = mpmc_queue_dequeue_node (
             graph->trigger_queue, &to_run);
         }
 
       /* process graph-node */
-      g_atomic_int_dec_and_test (&graph->trigger_queue_size);
+      if (from_queue)
+        {
+          g_atomic_int_dec_and_test (
+            &graph->trigger_queue_size);
+        }
 #ifdef DEBUG_THREADS
       g_message ("[%d]: running node", thread->id);
 #endif
+      rt_audit_enter ();
       graph_node_process (to_run, graph->router->time_nfo);
+      rt_audit_leave ();
     }
 
 terminate_thread:
@@ -230,6 +271,8 @@ terminate_thread:
     }
 #endif
 
+  current_thread = NULL;
+
   return 0;
 }
 
@@ -386,9 +429,14 @@ get_absolute_rt_priority (int priority)
  * @param id The index of the thread.
  * @param graph The graph to set to the thread.
  * @param is_main 1 if main thread.
+ * @param cpu CPU to pin the thread to, or -1.
  */
 GraphThread *
-graph_thread_new (const int id, const bool is_main, Graph * graph)
+graph_thread_new (
+  const int  id,
+  const bool is_main,
+  const int  cpu,
+  Graph *    graph)
 {
   g_return_val_if_fail (graph, NULL);
 
@@ -396,6 +444,10 @@ graph_thread_new (const int id, const bool is_main, Graph * graph)
 
   self->id = id;
   self->graph = graph;
+  self->cpu = cpu;
+
+  graph_thread_ensure_listen_bufs (
+    self, AUDIO_ENGINE->block_length);
 
   pthread_attr_t attributes;
   pthread_attr_init (&attributes);
@@ -607,6 +659,26 @@ dbus_fail_handling:
       return NULL;
     }
 
+#if defined(__linux__) && defined(__GLIBC__)
+  if (cpu >= 0)
+    {
+      cpu_set_t cpuset;
+      CPU_ZERO (&cpuset);
+      CPU_SET (cpu, &cpuset);
+      res = pthread_attr_setaffinity_np (
+        &attributes, sizeof (cpuset), &cpuset);
+      if (res)
+        {
+          /* not fatal, the thread will just move
+           * around */
+          g_warning (
+            "Cannot pin thread %d to CPU %d res = %d (%s)",
+            id, cpu, res, strerror (res));
+          self->cpu = -1;
+        }
+    }
+#endif
+
   res = pthread_create (
     &self->pthread, &attributes,
     is_main ? &main_thread : &worker_thread, self);
@@ -622,3 +694,55 @@ dbus_fail_handling:
 
   return self;
 }
+
+/**
+ * Returns the graph thread the caller is running
+ * in, or NULL if not called from a graph thread.
+ */
+GraphThread *
+graph_thread_get_current (void)
+{
+  return current_thread;
+}
+
+/**
+ * Makes sure the listen bus buffers can hold
+ * @p nframes frames.
+ *
+ * Must not be called while the graph is
+ * processing.
+ */
+void
+graph_thread_ensure_listen_bufs (
+  GraphThread * self,
+  nframes_t     nframes)
+{
+  if (self->listen_buf_size >= nframes)
+    return;
+
+  for (int i = 0; i < 2; i++)
+    {
+      self->listen_bufs[i] = g_realloc_n (
+        self->listen_bufs[i], nframes, sizeof (float));
+      memset (
+        self->listen_bufs[i], 0, nframes * sizeof (float));
+    }
+  self->listen_buf_size = nframes;
+
+  /* invalidate any partial sum */
+  self->listen_cycle = 0;
+}
+
+/**
+ * Frees the thread's resources.
+ *
+ * The thread must have been joined beforehand.
+ */
+void
+graph_thread_free (GraphThread * self)
+{
+  object_free_w_func_and_null (g_free, self->listen_bufs[0]);
+  object_free_w_func_and_null (g_free, self->listen_bufs[1]);
+
+  object_zero_and_free (self);
+}
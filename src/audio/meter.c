@@ -110,17 +110,18 @@ meter_get_value (
       bool on = false;
       if (port->write_ring_buffers)
         {
-          MidiEvent event;
+          MidiEventHeader h;
           while (
-            zix_ring_peek (
-              port->midi_ring, &event, sizeof (MidiEvent))
+            zix_ring_read (port->midi_ring, &h, sizeof (h))
             > 0)
             {
-              if (event.systime > self->last_midi_trigger_time)
+              zix_ring_skip (
+                port->midi_ring, (uint32_t) h.size);
+              gint64 systime = (gint64) h.time;
+              if (systime > self->last_midi_trigger_time)
                 {
                   on = true;
-                  self->last_midi_trigger_time = event.systime;
-                  break;
+                  self->last_midi_trigger_time = systime;
                 }
             }
         }
@@ -63,6 +63,107 @@ static const char * midi_event_type_strings[] = {
   "note on",   "all notes off",
 };
 
+/**
+ * Returns whether the event buffers may be
+ * reallocated from the current thread.
+ */
+static bool
+can_grow (void)
+{
+  return !(
+    ZRYTHM && PROJECT && AUDIO_ENGINE && ROUTER
+    && (router_is_processing_kickoff_thread (ROUTER)
+        || router_is_processing_thread (ROUTER)));
+}
+
+/**
+ * Grows the given buffer to at least @p min_size
+ * events if allowed.
+ *
+ * @return Whether the buffer has enough space.
+ */
+static bool
+reserve (
+  MidiEvent ** buf,
+  int *        buf_size,
+  int          min_size,
+  bool         check_thread)
+{
+  if (G_LIKELY (min_size <= *buf_size))
+    return true;
+
+  if (check_thread && !can_grow ())
+    return false;
+
+  int new_size = MAX (*buf_size * 2, min_size);
+  *buf = object_realloc_n (
+    *buf, (size_t) *buf_size, (size_t) new_size, MidiEvent);
+  *buf_size = new_size;
+
+  return true;
+}
+
+/**
+ * Counts the given number of dropped events.
+ *
+ * The first drop since the buffers last grew asks
+ * the engine to grow them outside the processing
+ * threads.
+ */
+static void
+add_dropped (MidiEvents * self, int num_dropped)
+{
+  if (g_atomic_int_add (&self->num_dropped, num_dropped) == 0)
+    {
+      ENGINE_EVENTS_PUSH (
+        AUDIO_ENGINE_EVENT_MIDI_EVENTS_DROPPED, NULL, 0, 0.f);
+    }
+}
+
+/**
+ * Returns the slot for the next event (without
+ * incrementing the event count), or NULL if the
+ * buffer is full and cannot grow.
+ *
+ * Growing requires @ref MidiEvents.access_sem,
+ * since the processing threads may be dequeueing
+ * the buffer at the same time. If it is already
+ * taken (possibly by the caller), the event is
+ * dropped and counted instead, and the buffer is
+ * grown later while the engine is paused (see
+ * midi_events_grow_to_peak()).
+ */
+static inline MidiEvent *
+get_next_event (MidiEvents * self, bool queued)
+{
+  MidiEvent ** buf =
+    queued ? &self->queued_events : &self->events;
+  int * buf_size =
+    queued ? &self->queued_events_size : &self->events_size;
+  int num_events =
+    queued ? self->num_queued_events : self->num_events;
+
+  if (num_events >= self->max_num_events)
+    self->max_num_events = num_events + 1;
+
+  if (G_UNLIKELY (num_events + 1 > *buf_size))
+    {
+      if (
+        !can_grow ()
+        || zix_sem_try_wait (&self->access_sem)
+             != ZIX_STATUS_SUCCESS)
+        {
+          add_dropped (self, 1);
+          return NULL;
+        }
+
+      reserve (buf, buf_size, num_events + 1, false);
+      zix_sem_post (&self->access_sem);
+    }
+
+  return &(*buf)[num_events];
+}
+
 /**
  * Appends the events from src to dest.
  *
@@ -121,10 +222,6 @@ midi_events_transform_chord_and_append (
           continue;
         }
 
-      /* make sure there is enough space */
-      g_return_if_fail (
-        dest->num_events < MAX_MIDI_EVENTS - 6);
-
       const uint8_t * buf = src_ev->raw_buffer;
 
       if (!midi_is_note_on (buf) && !midi_is_note_off (buf))
@@ -151,8 +248,8 @@ midi_events_transform_chord_and_append (
         }
     }
 
-  /* clear duplicates */
-  midi_events_clear_duplicates (dest, queued);
+  /* merge and clear duplicates */
+  midi_events_sort_and_clear_duplicates (dest, queued);
 }
 
 /**
@@ -209,14 +306,16 @@ midi_events_append_w_filter (
             }
         }
 
-      g_return_if_fail (dest->num_events < MAX_MIDI_EVENTS);
+      dest_ev = get_next_event (dest, false);
+      if (G_UNLIKELY (!dest_ev))
+        break;
 
-      dest_ev = &dest->events[dest->num_events++];
       midi_event_copy (dest_ev, src_ev);
+      dest->num_events++;
     }
 
-  /* clear duplicates */
-  midi_events_clear_duplicates (dest, queued);
+  /* merge and clear duplicates */
+  midi_events_sort_and_clear_duplicates (dest, queued);
 }
 
 /**
@@ -389,6 +488,16 @@ midi_events_init (MidiEvents * self)
   self->num_events = 0;
   self->num_queued_events = 0;
 
+  reserve (
+    &self->events, &self->events_size,
+    MIDI_EVENTS_INITIAL_SIZE, false);
+  reserve (
+    &self->queued_events, &self->queued_events_size,
+    MIDI_EVENTS_INITIAL_SIZE, false);
+  reserve (
+    &self->merge_buf, &self->merge_buf_size,
+    MIDI_EVENTS_INITIAL_SIZE, false);
+
   zix_sem_init (&self->access_sem, 1);
 }
 
@@ -405,6 +514,66 @@ midi_events_new (void)
   return self;
 }
 
+/**
+ * Allocates a MidiEvents struct with buffers large
+ * enough for the peak usage of @p prev (including
+ * dropped events), or the default size if @p prev
+ * is NULL.
+ *
+ * To be used when reallocating port buffers.
+ */
+MidiEvents *
+midi_events_new_with_size_of (const MidiEvents * prev)
+{
+  MidiEvents * self = midi_events_new ();
+  if (!prev)
+    return self;
+
+  int size = prev->max_num_events
+             + g_atomic_int_get (&prev->num_dropped);
+  reserve (&self->events, &self->events_size, size, false);
+  reserve (
+    &self->queued_events, &self->queued_events_size, size,
+    false);
+  reserve (
+    &self->merge_buf, &self->merge_buf_size, size, false);
+
+  return self;
+}
+
+/**
+ * Grows the buffers to fit the peak usage
+ * (including dropped events) and resets the dropped
+ * event count.
+ *
+ * Must not be called while the buffers are being
+ * processed.
+ */
+void
+midi_events_grow_to_peak (MidiEvents * self)
+{
+  int num_dropped = g_atomic_int_get (&self->num_dropped);
+  if (num_dropped == 0)
+    return;
+
+  zix_sem_wait (&self->access_sem);
+
+  int size = self->max_num_events + num_dropped;
+  g_message (
+    "%d MIDI events dropped, growing buffers from %d to "
+    "at least %d events",
+    num_dropped, self->events_size, size);
+  reserve (&self->events, &self->events_size, size, false);
+  reserve (
+    &self->queued_events, &self->queued_events_size, size,
+    false);
+  reserve (
+    &self->merge_buf, &self->merge_buf_size, size, false);
+  g_atomic_int_set (&self->num_dropped, 0);
+
+  zix_sem_post (&self->access_sem);
+}
+
 /**
  * Returrns if the MidiEvents have any note on
  * events.
@@ -454,16 +623,20 @@ midi_events_dequeue (MidiEvents * self)
   /*g_message ("waiting dequeue");*/
   zix_sem_wait (&self->access_sem);
 
-  MidiEvent *ev, *q_ev;
-  for (int i = 0; i < self->num_queued_events; i++)
+  int num_events = self->num_queued_events;
+  if (!reserve (
+        &self->events, &self->events_size, num_events,
+        true))
     {
-      q_ev = &self->queued_events[i];
-      ev = &self->events[i];
-
-      midi_event_copy (ev, q_ev);
+      add_dropped (self, num_events - self->events_size);
+      num_events = self->events_size;
     }
 
-  self->num_events = self->num_queued_events;
+  memcpy (
+    self->events, self->queued_events,
+    (size_t) num_events * sizeof (MidiEvent));
+
+  self->num_events = num_events;
   self->num_queued_events = 0;
 
   zix_sem_post (&self->access_sem);
@@ -481,11 +654,9 @@ midi_events_add_all_notes_off (
   bool         queued)
 {
   g_return_if_fail (channel > 0);
-  MidiEvent * ev;
-  if (queued)
-    ev = &self->queued_events[self->num_queued_events];
-  else
-    ev = &self->events[self->num_events];
+  MidiEvent * ev = get_next_event (self, queued);
+  if (G_UNLIKELY (!ev))
+    return;
 
   ev->time = time;
   ev->raw_buffer[0] =
@@ -505,6 +676,23 @@ void
 midi_events_panic (MidiEvents * self, bool queued)
 {
   zix_sem_wait (&self->access_sem);
+
+  /* reserve while holding the lock, since adding
+   * the events below cannot grow the buffer while it
+   * is taken */
+  if (queued)
+    {
+      reserve (
+        &self->queued_events, &self->queued_events_size,
+        self->num_queued_events + 16, true);
+    }
+  else
+    {
+      reserve (
+        &self->events, &self->events_size,
+        self->num_events + 16, true);
+    }
+
   /*g_message ("sending PANIC");*/
   for (midi_byte_t i = 1; i < 17; i++)
     {
@@ -584,11 +772,9 @@ midi_events_add_note_off (
   int          queued)
 {
   g_return_if_fail (channel > 0);
-  MidiEvent * ev;
-  if (queued)
-    ev = &self->queued_events[self->num_queued_events];
-  else
-    ev = &self->events[self->num_events];
+  MidiEvent * ev = get_next_event (self, queued);
+  if (G_UNLIKELY (!ev))
+    return;
 
   ev->time = time;
   ev->raw_buffer[0] =
@@ -618,17 +804,16 @@ midi_events_add_raw (
       g_return_if_reached ();
     }
 
-  MidiEvent * ev;
-  if (queued)
-    ev = &self->queued_events[self->num_queued_events];
-  else
-    ev = &self->events[self->num_events];
+  MidiEvent * ev = get_next_event (self, queued);
+  if (G_UNLIKELY (!ev))
+    return;
 
   ev->time = time;
   for (size_t i = 0; i < buf_sz; i++)
     {
       ev->raw_buffer[i] = buf[i];
     }
+  ev->raw_buffer_sz = (uint8_t) buf_sz;
 
   if (queued)
     self->num_queued_events++;
@@ -651,11 +836,9 @@ midi_events_add_control_change (
   midi_time_t  time,
   int          queued)
 {
-  MidiEvent * ev;
-  if (queued)
-    ev = &self->queued_events[self->num_queued_events];
-  else
-    ev = &self->events[self->num_events];
+  MidiEvent * ev = get_next_event (self, queued);
+  if (G_UNLIKELY (!ev))
+    return;
 
   ev->time = time;
   ev->raw_buffer[0] =
@@ -685,11 +868,9 @@ midi_events_add_pitchbend (
   midi_time_t  time,
   int          queued)
 {
-  MidiEvent * ev;
-  if (queued)
-    ev = &self->queued_events[self->num_queued_events];
-  else
-    ev = &self->events[self->num_events];
+  MidiEvent * ev = get_next_event (self, queued);
+  if (G_UNLIKELY (!ev))
+    return;
 
   ev->time = time;
   ev->raw_buffer[0] =
@@ -744,26 +925,164 @@ midi_event_cmpfunc (const void * _a, const void * _b)
 }
 
 /**
- * Sorts the MidiEvents by time.
+ * Appends @p ev to @p out, unless an equal event is
+ * already among the events with the same time at the
+ * end of @p out.
  */
-void
-midi_events_sort (MidiEvents * self, const bool queued)
+static inline void
+emit_event (
+  MidiEvent *       out,
+  int *             num_out,
+  const MidiEvent * ev,
+  bool              clear_duplicates)
 {
-  MidiEvent * events;
-  size_t      num_events;
-  if (queued)
+  if (clear_duplicates)
     {
-      events = self->queued_events;
-      num_events = (size_t) self->num_queued_events;
+      for (int i = *num_out - 1;
+           i >= 0 && out[i].time == ev->time; i--)
+        {
+          if (midi_events_are_equal (&out[i], ev))
+            return;
+        }
     }
-  else
+  out[(*num_out)++] = *ev;
+}
+
+/**
+ * Returns the end (exclusive) of the sorted run
+ * starting at @p start.
+ */
+static inline int
+get_run_end (const MidiEvent * evs, int start, int num)
+{
+  int end = start + 1;
+  while (
+    end < num
+    && midi_event_cmpfunc (&evs[end - 1], &evs[end]) <= 0)
+    end++;
+  return end;
+}
+
+/**
+ * Stable natural merge sort.
+ *
+ * Each pass merges pairs of adjacent sorted runs
+ * into the merge buffer and swaps the buffers, until
+ * a pass outputs a single run. Duplicates are removed
+ * while emitting; the last pass outputs sorted
+ * events so all duplicates are caught there.
+ */
+static void
+sort_events (
+  MidiEvents * self,
+  const bool   queued,
+  const bool   clear_duplicates)
+{
+  MidiEvent ** buf =
+    queued ? &self->queued_events : &self->events;
+  int * buf_size =
+    queued ? &self->queued_events_size : &self->events_size;
+  int num =
+    queued ? self->num_queued_events : self->num_events;
+  if (num < 2)
+    return;
+
+  if (!reserve (
+        &self->merge_buf, &self->merge_buf_size, *buf_size,
+        true))
+    {
+      /* cannot allocate in this thread, sort in
+       * place */
+      qsort (
+        *buf, (size_t) num, sizeof (MidiEvent),
+        midi_event_cmpfunc);
+      if (clear_duplicates)
+        midi_events_clear_duplicates (self, queued);
+      return;
+    }
+
+  MidiEvent * src = *buf;
+  MidiEvent * dest = self->merge_buf;
+  int         num_pairs;
+  do
+    {
+      int num_out = 0;
+      int start = 0;
+      num_pairs = 0;
+      while (start < num)
+        {
+          int mid = get_run_end (src, start, num);
+          int end =
+            mid < num ? get_run_end (src, mid, num) : num;
+          int i = start;
+          int j = mid;
+          while (i < mid && j < end)
+            {
+              /* take from the left run on ties to
+               * keep the sort stable */
+              const MidiEvent * ev =
+                midi_event_cmpfunc (&src[j], &src[i]) < 0
+                  ? &src[j++]
+                  : &src[i++];
+              emit_event (
+                dest, &num_out, ev, clear_duplicates);
+            }
+          while (i < mid)
+            emit_event (
+              dest, &num_out, &src[i++], clear_duplicates);
+          while (j < end)
+            emit_event (
+              dest, &num_out, &src[j++], clear_duplicates);
+
+          start = end;
+          num_pairs++;
+        }
+
+      MidiEvent * tmp = src;
+      src = dest;
+      dest = tmp;
+      num = num_out;
+    }
+  while (num_pairs > 1);
+
+  /* the result is in src; swap it in if it is the
+   * merge buffer (both buffers have the same
+   * capacity here) */
+  if (src != *buf)
     {
-      events = self->events;
-      num_events = (size_t) self->num_events;
+      self->merge_buf = *buf;
+      *buf = src;
+      int tmp_size = self->merge_buf_size;
+      self->merge_buf_size = *buf_size;
+      *buf_size = tmp_size;
     }
-  qsort (
-    events, num_events, sizeof (MidiEvent),
-    midi_event_cmpfunc);
+
+  if (queued)
+    self->num_queued_events = num;
+  else
+    self->num_events = num;
+}
+
+/**
+ * Sorts the MidiEvents by time.
+ */
+void
+midi_events_sort (MidiEvents * self, const bool queued)
+{
+  sort_events (self, queued, false);
+}
+
+/**
+ * Sorts the MidiEvents by time like
+ * midi_events_sort() and removes duplicates while
+ * merging.
+ */
+void
+midi_events_sort_and_clear_duplicates (
+  MidiEvents * self,
+  const bool   queued)
+{
+  sort_events (self, queued, true);
 }
 
 /**
@@ -789,11 +1108,9 @@ midi_events_add_note_on (
     __func__, channel, note_pitch, velocity, time);
 #endif
 
-  MidiEvent * ev;
-  if (queued)
-    ev = &self->queued_events[self->num_queued_events];
-  else
-    ev = &self->events[self->num_events];
+  MidiEvent * ev = get_next_event (self, queued);
+  if (G_UNLIKELY (!ev))
+    return;
 
   ev->time = time;
   ev->raw_buffer[0] =
@@ -1055,7 +1372,7 @@ midi_events_clear_duplicates (
               g_message (
                 "removing duplicate MIDI event");
 #endif
-              for (k = j; k < NUM_EVENTS; k++)
+              for (k = j; k < NUM_EVENTS - 1; k++)
                 {
                   midi_event_copy (&arr[k], &arr[k + 1]);
                 }
@@ -1077,5 +1394,9 @@ midi_events_free (MidiEvents * self)
 {
   zix_sem_destroy (&self->access_sem);
 
+  object_zero_and_free_if_nonnull (self->events);
+  object_zero_and_free_if_nonnull (self->queued_events);
+  object_zero_and_free_if_nonnull (self->merge_buf);
+
   object_zero_and_free (self);
 }
@@ -4,6 +4,7 @@
  */
 
 #include "audio/midi_file.h"
+#include "utils/objects.h"
 
 #include <gtk/gtk.h>
 
@@ -99,3 +100,239 @@ midi_file_get_num_tracks (
 
   return actual_num;
 }
+
+/**
+ * Ends the oldest unended note with the given
+ * pitch.
+ */
+static void
+end_note (
+  MidiFileTrack * track,
+  GArray *        unended,
+  int             pitch,
+  double          ticks)
+{
+  for (guint i = 0; i < unended->len; i++)
+    {
+      size_t idx = g_array_index (unended, size_t, i);
+      if (track->notes[idx].pitch == pitch)
+        {
+          track->notes[idx].end_ticks = ticks;
+          g_array_remove_index (unended, i);
+          return;
+        }
+    }
+
+  g_debug (
+    "Found a Note off event without a corresponding "
+    "Note on. Skipping...");
+}
+
+static void
+read_track (
+  MidiFileTrack * track,
+  const char *    abs_path,
+  int             track_idx,
+  double          ppqn)
+{
+  MIDI_FILE * mf = midiFileOpen (abs_path);
+  g_return_if_fail (mf);
+
+  double ratio = ppqn / (double) midiFileGetPPQN (mf);
+
+  MIDI_MSG msg;
+  midiReadInitMessage (&msg);
+
+  /* indices of notes without a note off yet, in
+   * the order they were started */
+  GArray * unended =
+    g_array_sized_new (false, false, sizeof (size_t), 32);
+
+  while (midiReadGetNextMessage (mf, track_idx, &msg))
+    {
+      double ticks = (double) msg.dwAbsPos * ratio;
+      int    ev =
+        msg.bImpliedMsg ? msg.iImpliedMsg : msg.iType;
+      switch (ev)
+        {
+        case msgNoteOff:
+          end_note (
+            track, unended, msg.MsgData.NoteOff.iNote,
+            ticks);
+          break;
+        case msgNoteOn:
+          track->has_data = true;
+
+          /* 0 velocity is a note off */
+          if (msg.MsgData.NoteOn.iVolume == 0)
+            {
+              end_note (
+                track, unended, msg.MsgData.NoteOn.iNote,
+                ticks);
+              break;
+            }
+
+          if (track->num_notes == track->notes_size)
+            {
+              size_t new_size =
+                MAX (track->notes_size * 2, 256);
+              track->notes = object_realloc_n (
+                track->notes, track->notes_size, new_size,
+                MidiFileNote);
+              track->notes_size = new_size;
+            }
+          track->notes[track->num_notes] = (MidiFileNote){
+            .start_ticks = ticks,
+            .end_ticks = ticks + 1,
+            .pitch = (uint8_t) msg.MsgData.NoteOn.iNote,
+            .velocity = (uint8_t) msg.MsgData.NoteOn.iVolume,
+          };
+          g_array_append_val (unended, track->num_notes);
+          track->num_notes++;
+          break;
+        case msgNoteKeyPressure:
+        case msgSetParameter:
+        case msgSetProgram:
+        case msgChangePressure:
+        case msgSetPitchWheel:
+        case msgSysEx1:
+        case msgSysEx2:
+          track->has_data = true;
+          break;
+        case msgMetaEvent:
+          switch (msg.MsgData.MetaEvent.iType)
+            {
+            case metaTrackName:
+              {
+                const char * name = (const char *)
+                  msg.MsgData.MetaEvent.Data.Text.pData;
+                g_free (track->name);
+                track->name =
+                  g_strndup (name, msg.iMsgSize - 3);
+              }
+              break;
+            case metaEndSequence:
+              track->end_ticks = ticks;
+              break;
+            }
+          break;
+        }
+    }
+
+  /* end any unended notes at the end of the
+   * track */
+  if (unended->len > 0)
+    {
+      g_message (
+        "track %d: unended notes found: %u", track_idx,
+        unended->len);
+      for (guint i = 0; i < unended->len; i++)
+        {
+          size_t idx = g_array_index (unended, size_t, i);
+          MidiFileNote * note = &track->notes[idx];
+          note->end_ticks =
+            MAX (track->end_ticks, note->start_ticks);
+        }
+    }
+
+  g_array_free (unended, true);
+  midiReadFreeMessage (&msg);
+  midiFileClose (mf);
+}
+
+typedef struct ReadTrackJob
+{
+  MidiFileTrack * track;
+  const char *    abs_path;
+  int             track_idx;
+  double          ppqn;
+} ReadTrackJob;
+
+static void
+read_track_func (gpointer data, gpointer user_data)
+{
+  ReadTrackJob * job = (ReadTrackJob *) data;
+  read_track (
+    job->track, job->abs_path, job->track_idx, job->ppqn);
+}
+
+MidiFileTrack *
+midi_file_read_tracks (
+  const char * abs_path,
+  double       ppqn,
+  int *        num_tracks)
+{
+  *num_tracks = midi_file_get_num_tracks (abs_path, false);
+  g_return_val_if_fail (*num_tracks >= 0, NULL);
+
+  MidiFileTrack * tracks = object_new_n (
+    (size_t) MAX (*num_tracks, 1), MidiFileTrack);
+  ReadTrackJob * jobs = object_new_n (
+    (size_t) MAX (*num_tracks, 1), ReadTrackJob);
+
+  /* each job opens its own handle to the file so
+   * that the read positions are not shared */
+  GThreadPool * thread_pool = g_thread_pool_new (
+    read_track_func, NULL, (int) g_get_num_processors (),
+    false, NULL);
+  for (int i = 0; i < *num_tracks; i++)
+    {
+      jobs[i].track = &tracks[i];
+      jobs[i].abs_path = abs_path;
+      jobs[i].track_idx = i;
+      jobs[i].ppqn = ppqn;
+      g_thread_pool_push (thread_pool, &jobs[i], NULL);
+    }
+  g_thread_pool_free (thread_pool, false, true);
+  free (jobs);
+
+  return tracks;
+}
+
+int
+midi_file_tracks_get_num_with_data (
+  const MidiFileTrack * tracks,
+  int                   num_tracks)
+{
+  int num = 0;
+  for (int i = 0; i < num_tracks; i++)
+    {
+      if (tracks[i].has_data)
+        num++;
+    }
+
+  return num;
+}
+
+const MidiFileTrack *
+midi_file_tracks_get_nth_with_data (
+  const MidiFileTrack * tracks,
+  int                   num_tracks,
+  int                   idx)
+{
+  for (int i = 0; i < num_tracks; i++)
+    {
+      if (!tracks[i].has_data)
+        continue;
+
+      if (idx == 0)
+        return &tracks[i];
+
+      idx--;
+    }
+
+  return NULL;
+}
+
+void
+midi_file_tracks_free (
+  MidiFileTrack * tracks,
+  int             num_tracks)
+{
+  for (int i = 0; i < num_tracks; i++)
+    {
+      object_zero_and_free_if_nonnull (tracks[i].notes);
+      g_free (tracks[i].name);
+    }
+  object_zero_and_free (tracks);
+}
@@ -4,8 +4,10 @@
  */
 
 #include "audio/control_port.h"
+#include "audio/engine.h"
 #include "audio/midi_event.h"
 #include "audio/midi_mapping.h"
+#include "audio/router.h"
 #include "gui/backend/event.h"
 #include "gui/backend/event_manager.h"
 #include "gui/backend/wrapped_object_with_change_signal.h"
@@ -209,9 +211,13 @@ apply_mapping (MidiMapping * mapping, midi_byte_t * buf)
        * value received */
       else
         {
+          /* coalesce bursts of CC messages - only
+           * the last value per cycle is applied */
           float normalized_val = (float) buf[2] / 127.f;
-          port_set_control_value (
-            dest, normalized_val, F_NORMALIZED,
+          router_queue_control_value (
+            ROUTER, dest,
+            dest->minf
+              + normalized_val * (dest->maxf - dest->minf),
             F_PUBLISH_EVENTS);
         }
     }
@@ -251,41 +257,6 @@ apply_mapping (MidiMapping * mapping, midi_byte_t * buf)
     }
 }
 
-/**
- * Applies the events to the appropriate mapping.
- *
- * This is used only for TrackProcessor.cc_mappings.
- *
- * @note Must only be called while transport is
- *   recording.
- */
-void
-midi_mappings_apply_from_cc_events (
-  MidiMappings * self,
-  MidiEvents *   events,
-  bool           queued)
-{
-  /* queued not implemented yet */
-  g_return_if_fail (!queued);
-
-  for (int i = 0; i < events->num_events; i++)
-    {
-      MidiEvent * ev = &events->events[i];
-      if (
-        ev->raw_buffer[0] >= (midi_byte_t) MIDI_CH1_CTRL_CHANGE
-        && ev->raw_buffer[0]
-             <= (midi_byte_t) (MIDI_CH1_CTRL_CHANGE | 15))
-        {
-          midi_byte_t channel =
-            (midi_byte_t) ((ev->raw_buffer[0] & 0xf) + 1);
-          midi_byte_t   controller = ev->raw_buffer[1];
-          MidiMapping * mapping =
-            self->mappings[(channel - 1) * 128 + controller];
-          apply_mapping (mapping, ev->raw_buffer);
-        }
-    }
-}
-
 /**
  * Applies the given buffer to the matching ports.
  */
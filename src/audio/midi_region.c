@@ -172,6 +172,8 @@ midi_region_insert_midi_note (
       midi_note_set_region_and_index (mn, self, i);
     }
 
+  region_contents_changed (self);
+
   if (pub_events)
     {
       EVENTS_PUSH (ET_ARRANGER_OBJECT_CREATED, midi_note);
@@ -328,6 +330,8 @@ midi_region_remove_midi_note (
         region->midi_notes[i], region, i);
     }
 
+  region_contents_changed (region);
+
   if (free)
     free_later (midi_note, arranger_object_free);
 
@@ -359,333 +363,98 @@ midi_region_new_from_midi_file (
 {
   g_message ("%s: reading from %s...", __func__, abs_path);
 
+  int             num_tracks;
+  MidiFileTrack * tracks = midi_file_read_tracks (
+    abs_path, transport_get_ppqn (TRANSPORT), &num_tracks);
+  g_return_val_if_fail (tracks, NULL);
+
+  ZRegion *             self = NULL;
+  const MidiFileTrack * mf_track =
+    midi_file_tracks_get_nth_with_data (
+      tracks, num_tracks, idx);
+  if (mf_track)
+    {
+      self = midi_region_new_from_midi_file_track (
+        start_pos, mf_track, track_name_hash, lane_pos,
+        idx_inside_lane);
+    }
+  midi_file_tracks_free (tracks, num_tracks);
+
+  return self;
+}
+
+ZRegion *
+midi_region_new_from_midi_file_track (
+  const Position *      start_pos,
+  const MidiFileTrack * mf_track,
+  unsigned int          track_name_hash,
+  int                   lane_pos,
+  int                   idx_inside_lane)
+{
+  /* this is an empty track */
+  size_t num_notes = mf_track->num_notes;
+  if (num_notes == 0)
+    return NULL;
+
+  /* the end of track event may be missing (or
+   * misplaced), so also cover all the notes */
+  double end_ticks = mf_track->end_ticks;
+  for (size_t i = 0; i < num_notes; i++)
+    {
+      end_ticks =
+        MAX (end_ticks, mf_track->notes[i].end_ticks);
+    }
+
   ZRegion *        self = object_new (ZRegion);
   ArrangerObject * r_obj = (ArrangerObject *) self;
 
   self->id.type = REGION_TYPE_MIDI;
 
-  MIDI_FILE * mf = midiFileOpen (abs_path);
-  g_return_val_if_fail (mf, NULL);
-
-  char         str[128];
-  char         txt[60000];
-  int          ev;
-  MIDI_MSG     msg;
-  unsigned int j;
-  Position     pos, global_pos;
-  MidiNote *   mn;
-  double       ticks;
-
   Position end_pos;
-  position_from_ticks (&end_pos, start_pos->ticks + 1);
+  position_from_ticks (
+    &end_pos, start_pos->ticks + end_ticks);
   region_init (
     self, start_pos, &end_pos, track_name_hash, lane_pos,
     idx_inside_lane);
 
-  midiReadInitMessage (&msg);
-  int    num_tracks = midiReadGetNumTracks (mf);
-  double ppqn = (double) midiFileGetPPQN (mf);
-  double transport_ppqn = transport_get_ppqn (TRANSPORT);
-
-  int actual_iter = 0;
-
-  for (int i = 0; i < num_tracks; i++)
+  if (mf_track->name)
     {
-      if (!midi_file_track_has_data (abs_path, i))
-        {
-          continue;
-        }
-
-      if (actual_iter != idx)
-        {
-          actual_iter++;
-          continue;
-        }
-
-      g_message ("%s: reading MIDI Track %d", __func__, i);
-      g_return_val_if_fail (i < 1000, NULL);
-      while (midiReadGetNextMessage (mf, i, &msg))
-        {
-          /* convert time to zrythm time */
-          ticks =
-            ((double) msg.dwAbsPos * transport_ppqn) / ppqn;
-          position_from_ticks (&pos, ticks);
-          position_from_ticks (
-            &global_pos, r_obj->pos.ticks + ticks);
-          g_debug ("dwAbsPos: %d ", msg.dwAbsPos);
-
-          int bars = position_get_bars (&pos, true);
-          if (ZRYTHM_HAVE_UI && bars > TRANSPORT->total_bars - 8)
-            {
-              transport_update_total_bars (
-                TRANSPORT, bars + 8, F_PUBLISH_EVENTS);
-            }
-
-          if (msg.bImpliedMsg)
-            {
-              ev = msg.iImpliedMsg;
-            }
-          else
-            {
-              ev = msg.iType;
-            }
-
-          if (muGetMIDIMsgName (str, ev))
-            {
-              g_debug ("MIDI msg name: %s", str);
-            }
-          switch (ev)
-            {
-            case msgNoteOff:
-handle_note_off:
-              g_debug (
-                "Note off at %d "
-                "[ch %d pitch %d]",
-                msg.dwAbsPos, msg.MsgData.NoteOff.iChannel,
-                msg.MsgData.NoteOff.iNote);
-              mn = midi_region_pop_unended_note (
-                self, msg.MsgData.NoteOff.iNote);
-              if (mn)
-                {
-                  arranger_object_end_pos_setter (
-                    (ArrangerObject *) mn, &pos);
-                }
-              else
-                {
-                  g_message (
-                    "Found a Note off event without "
-                    "a corresponding Note on. "
-                    "Skipping...");
-                }
-              break;
-            case msgNoteOn:
-              /* 0 velocity is a note off */
-              if (msg.MsgData.NoteOn.iVolume == 0)
-                {
-                  msg.MsgData.NoteOff.iChannel =
-                    msg.MsgData.NoteOn.iChannel;
-                  msg.MsgData.NoteOff.iNote =
-                    msg.MsgData.NoteOn.iNote;
-                  goto handle_note_off;
-                }
-
-              g_debug (
-                "Note on at %d "
-                "[ch %d pitch %d vel %d]",
-                msg.dwAbsPos, msg.MsgData.NoteOn.iChannel,
-                msg.MsgData.NoteOn.iNote,
-                msg.MsgData.NoteOn.iVolume);
-              midi_region_start_unended_note (
-                self, &pos, NULL, msg.MsgData.NoteOn.iNote,
-                msg.MsgData.NoteOn.iVolume, 0);
-              break;
-            case msgNoteKeyPressure:
-              muGetNameFromNote (
-                str, msg.MsgData.NoteKeyPressure.iNote);
-              g_debug (
-                "(%.2d) %s %d",
-                msg.MsgData.NoteKeyPressure.iChannel, str,
-                msg.MsgData.NoteKeyPressure.iPressure);
-              break;
-            case msgSetParameter:
-              muGetControlName (
-                str, msg.MsgData.NoteParameter.iControl);
-              g_debug (
-                "(%.2d) %s -> %d",
-                msg.MsgData.NoteParameter.iChannel, str,
-                msg.MsgData.NoteParameter.iParam);
-              break;
-            case msgSetProgram:
-              muGetInstrumentName (
-                str, msg.MsgData.ChangeProgram.iProgram);
-              g_debug (
-                "(%.2d) %s",
-                msg.MsgData.ChangeProgram.iChannel, str);
-              break;
-            case msgChangePressure:
-              muGetControlName (
-                str, msg.MsgData.ChangePressure.iPressure);
-              g_debug (
-                "(%.2d) %s",
-                msg.MsgData.ChangePressure.iChannel, str);
-              break;
-            case msgSetPitchWheel:
-              g_debug (
-                "(%.2d) %d", msg.MsgData.PitchWheel.iChannel,
-                msg.MsgData.PitchWheel.iPitch);
-              break;
-            case msgMetaEvent:
-              g_debug ("---- meta events");
-              switch (msg.MsgData.MetaEvent.iType)
-                {
-                case metaMIDIPort:
-                  g_debug (
-                    "MIDI Port = %d",
-                    msg.MsgData.MetaEvent.Data.iMIDIPort);
-                  break;
-                case metaSequenceNumber:
-                  g_debug (
-                    "Sequence Number = %d",
-                    msg.MsgData.MetaEvent.Data.iSequenceNumber);
-                  break;
-                case metaTextEvent:
-                  g_debug (
-                    "Text = '%s'",
-                    msg.MsgData.MetaEvent.Data.Text.pData);
-                  break;
-                case metaCopyright:
-                  g_debug (
-                    "Copyright = '%s'",
-                    msg.MsgData.MetaEvent.Data.Text.pData);
-                  break;
-                case metaTrackName:
-                  {
-                    char tmp[6000];
-                    strncpy (
-                      tmp,
-                      (char *)
-                        msg.MsgData.MetaEvent.Data.Text.pData,
-                      msg.iMsgSize - 3);
-                    tmp[msg.iMsgSize - 3] = '\0';
-                    arranger_object_set_name (
-                      (ArrangerObject *) self, tmp,
-                      F_NO_PUBLISH_EVENTS);
-                    g_warn_if_fail (self->name);
-                    g_message (
-                      "[data sz %d] Track name = '%s'",
-                      msg.iMsgSize - 3, self->name);
-                  }
-                  break;
-                case metaInstrument:
-                  g_message (
-                    "Instrument = '%s'",
-                    msg.MsgData.MetaEvent.Data.Text.pData);
-                  break;
-                case metaLyric:
-                  g_message (
-                    "Lyric = '%s'",
-                    msg.MsgData.MetaEvent.Data.Text.pData);
-                  break;
-                case metaMarker:
-                  g_message (
-                    "Marker = '%s'",
-                    msg.MsgData.MetaEvent.Data.Text.pData);
-                  break;
-                case metaCuePoint:
-                  g_message (
-                    "Cue point = '%s'",
-                    msg.MsgData.MetaEvent.Data.Text.pData);
-                  break;
-                case metaEndSequence:
-                  g_message ("End Sequence");
-                  if (position_is_equal (&pos, start_pos))
-                    {
-                      /* this is an empty track,
-                        * so return NULL
-                       * instead */
-                      return NULL;
-                    }
-                  arranger_object_end_pos_setter (
-                    r_obj, &global_pos);
-                  arranger_object_loop_end_pos_setter (
-                    r_obj, &global_pos);
-                  break;
-                case metaSetTempo:
-                  g_message (
-                    "tempo %d",
-                    msg.MsgData.MetaEvent.Data.Tempo.iBPM);
-                  break;
-                case metaSMPTEOffset:
-                  g_message (
-                    "SMPTE offset = %d:%d:%d.%d %d",
-                    msg.MsgData.MetaEvent.Data.SMPTE.iHours,
-                    msg.MsgData.MetaEvent.Data.SMPTE.iMins,
-                    msg.MsgData.MetaEvent.Data.SMPTE.iSecs,
-                    msg.MsgData.MetaEvent.Data.SMPTE.iFrames,
-                    msg.MsgData.MetaEvent.Data.SMPTE.iFF);
-                  break;
-                case metaTimeSig:
-                  g_message (
-                    "Time sig = %d/%d",
-                    msg.MsgData.MetaEvent.Data.TimeSig.iNom,
-                    msg.MsgData.MetaEvent.Data.TimeSig.iDenom
-                      / MIDI_NOTE_CROCHET);
-                  break;
-                case metaKeySig:
-                  if (muGetKeySigName (
-                        str,
-                        msg.MsgData.MetaEvent.Data.KeySig.iKey))
-                    g_message ("Key sig = %s", str);
-                  break;
-                case metaSequencerSpecific:
-                  g_message ("Sequencer specific = ");
-                  /*HexList(msg.MsgData.MetaEvent.Data.Sequencer.pData, msg.MsgData.MetaEvent.Data.Sequencer.iSize);*/
-                  break;
-                }
-              break;
-
-            case msgSysEx1:
-            case msgSysEx2:
-              g_message ("Sysex = ");
-              /*HexList(msg.MsgData.SysEx.pData, msg.MsgData.SysEx.iSize);*/
-              break;
-            }
-
-          /* print the hex */
-          if (
-            ev == msgSysEx1
-            || (ev == msgMetaEvent && msg.MsgData.MetaEvent.iType == metaSequencerSpecific))
-            {
-              /* Already done a hex dump */
-            }
-          else
-            {
-              char tmp[100];
-              strcpy (txt, "[");
-              if (msg.bImpliedMsg)
-                {
-                  sprintf (tmp, "%.2x!", msg.iImpliedMsg);
-                  strcat (txt, tmp);
-                }
-              for (j = 0; j < msg.iMsgSize; j++)
-                {
-                  sprintf (tmp, " %.2x ", msg.data[j]);
-                  strcat (txt, tmp);
-                }
-              strcat (txt, "]");
-              g_debug ("%s", txt);
-            }
-        }
-
-      if (actual_iter == idx)
-        {
-          break;
-        }
+      arranger_object_set_name (
+        r_obj, mf_track->name, F_NO_PUBLISH_EVENTS);
     }
 
-  midiReadFreeMessage (&msg);
-  midiFileClose (mf);
-
-  if (self->num_unended_notes != 0)
+  /* the notes are already sorted, so add them
+   * all at once instead of inserting them one by
+   * one */
+  if (num_notes > self->midi_notes_size)
     {
-      g_warning (
-        "unended notes found: %d", self->num_unended_notes);
-
-      double length = arranger_object_get_length_in_ticks (
-        (ArrangerObject *) self);
-      position_from_ticks (&end_pos, length);
-
-      while (self->num_unended_notes > 0)
-        {
-          mn = midi_region_pop_unended_note (self, -1);
-          arranger_object_end_pos_setter (
-            (ArrangerObject *) mn, &end_pos);
-        }
+      self->midi_notes = object_realloc_n (
+        self->midi_notes, self->midi_notes_size,
+        num_notes, MidiNote *);
+      self->midi_notes_size = num_notes;
+    }
+  for (size_t i = 0; i < num_notes; i++)
+    {
+      const MidiFileNote * note = &mf_track->notes[i];
+      Position             pos, note_end_pos;
+      position_from_ticks (&pos, note->start_ticks);
+      position_from_ticks (&note_end_pos, note->end_ticks);
+      MidiNote * mn = midi_note_new (
+        &self->id, &pos, &note_end_pos, note->pitch,
+        note->velocity);
+      midi_note_set_region_and_index (mn, self, (int) i);
+      self->midi_notes[i] = mn;
     }
+  self->num_midi_notes = (int) num_notes;
 
-  g_return_val_if_fail (
-    position_is_before (&self->base.pos, &self->base.end_pos),
-    NULL);
+  Position local_end_pos;
+  position_from_ticks (&local_end_pos, end_ticks);
+  int bars = position_get_bars (&local_end_pos, true);
+  if (ZRYTHM_HAVE_UI && bars > TRANSPORT->total_bars - 8)
+    {
+      transport_update_total_bars (
+        TRANSPORT, bars + 8, F_PUBLISH_EVENTS);
+    }
 
   g_message (
     "%s: done ~ %d MIDI notes read", __func__,
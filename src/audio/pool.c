@@ -5,6 +5,8 @@
 
 #include "actions/undo_manager.h"
 #include "audio/clip.h"
+#include "audio/clip_cache.h"
+#include "audio/engine.h"
 #include "audio/pool.h"
 #include "audio/track.h"
 #include "audio/tracklist.h"
@@ -19,6 +21,22 @@
 
 #include <gtk/gtk.h>
 
+/** Clip to decode on the thread pool. */
+typedef struct ClipLoadJob
+{
+  AudioClip * clip;
+  char *      pool_path;
+  char *      cache_path;
+} ClipLoadJob;
+
+static void
+load_clip_func (gpointer data, gpointer user_data)
+{
+  ClipLoadJob * job = (ClipLoadJob *) data;
+  audio_clip_load_from_pool (
+    job->clip, job->pool_path, job->cache_path);
+}
+
 /**
  * Inits after loading a project.
  */
@@ -27,12 +45,41 @@ audio_pool_init_loaded (AudioPool * self)
 {
   self->clips_size = (size_t) self->num_clips;
 
+  /* decode the clips in parallel (the paths are
+   * resolved here since they need global state) */
+  ClipLoadJob * jobs = object_new_n (
+    (size_t) MAX (self->num_clips, 1), ClipLoadJob);
+  GThreadPool * thread_pool = g_thread_pool_new (
+    load_clip_func, NULL, (int) g_get_num_processors (),
+    false, NULL);
   for (int i = 0; i < self->num_clips; i++)
     {
       AudioClip * clip = self->clips[i];
-      if (clip)
-        audio_clip_init_loaded (clip);
+      if (!clip)
+        continue;
+
+      ClipLoadJob * job = &jobs[i];
+      job->clip = clip;
+      job->pool_path = audio_clip_get_path_in_pool (
+        clip, F_NOT_BACKUP);
+      if (!job->pool_path)
+        continue;
+      job->cache_path = clip_cache_get_path (
+        clip, AUDIO_ENGINE->sample_rate);
+      g_thread_pool_push (thread_pool, job, NULL);
+    }
+
+  /* wait for all clips to be loaded */
+  g_thread_pool_free (thread_pool, false, true);
+
+  for (int i = 0; i < self->num_clips; i++)
+    {
+      g_free (jobs[i].pool_path);
+      g_free (jobs[i].cache_path);
     }
+  free (jobs);
+
+  clip_cache_trim ();
 }
 
 /**
@@ -228,6 +275,8 @@ audio_pool_duplicate_clip (
   AudioClip * clip = audio_pool_get_clip (self, clip_id);
   g_return_val_if_fail (clip, -1);
 
+  audio_clip_wait_for_import (clip);
+
   AudioClip * new_clip = audio_clip_new_from_float_array (
     clip->frames, clip->num_frames, clip->channels,
     clip->bit_depth, clip->name);
@@ -296,10 +345,74 @@ audio_pool_remove_clip (
   self->clips[clip_id] = NULL;
 }
 
+/**
+ * Returns a clip other than \ref except whose file
+ * in the main pool has the given content, if any.
+ *
+ * Used to share files between clips with identical
+ * contents.
+ */
+AudioClip *
+audio_pool_find_clip_with_pool_file (
+  AudioPool *       self,
+  uint64_t          content_hash,
+  const AudioClip * except)
+{
+  for (int i = 0; i < self->num_clips; i++)
+    {
+      AudioClip * clip = self->clips[i];
+      if (
+        !clip || clip == except
+        || clip->pool_file_content_hash != content_hash)
+        continue;
+
+      if (audio_clip_pool_file_is_in_sync (
+            clip, content_hash))
+        return clip;
+    }
+
+  return NULL;
+}
+
+/**
+ * Fills in the number of project regions
+ * referencing each clip, indexed by pool ID.
+ */
+static void
+count_clip_refs (AudioPool * self, int * refs)
+{
+  for (int i = 0; i < TRACKLIST->num_tracks; i++)
+    {
+      Track * track = TRACKLIST->tracks[i];
+      if (track->type != TRACK_TYPE_AUDIO)
+        continue;
+
+      for (int j = 0; j < track->num_lanes; j++)
+        {
+          TrackLane * lane = track->lanes[j];
+          for (int k = 0; k < lane->num_regions; k++)
+            {
+              ZRegion * r = lane->regions[k];
+              if (
+                r->id.type == REGION_TYPE_AUDIO
+                && r->pool_id >= 0
+                && r->pool_id < self->num_clips)
+                {
+                  refs[r->pool_id]++;
+                }
+            }
+        }
+    }
+}
+
 /**
  * Removes and frees (and removes the files for) all
  * clips not used by the project or undo stacks.
  *
+ * Files shared between clips (or with backups) are
+ * hard links, so removing a clip's file only frees
+ * the data on disk once nothing else references it.
+ *
  * @param backup Whether to remove from backup
  *   directory.
  */
@@ -308,6 +421,12 @@ audio_pool_remove_unused (AudioPool * self, bool backup)
 {
   g_message ("--- removing unused files from pool ---");
 
+  /* count the references from the project in a
+   * single pass */
+  int * refs =
+    object_new_n ((size_t) self->num_clips + 1, int);
+  count_clip_refs (self, refs);
+
   /* remove clips from the pool that are not in
    * use */
   int removed_clips = 0;
@@ -315,15 +434,32 @@ audio_pool_remove_unused (AudioPool * self, bool backup)
     {
       AudioClip * clip = self->clips[i];
 
-      if (clip && !audio_clip_is_in_use (clip, true))
+      if (
+        clip && refs[i] == 0
+        && !undo_manager_contains_clip (UNDO_MANAGER, clip))
         {
           g_message ("unused clip [%d]: %s", i, clip->name);
           audio_pool_remove_clip (self, i, F_FREE, backup);
           removed_clips++;
         }
     }
+  free (refs);
 
   /* remove untracked files from pool directory */
+  GHashTable * clip_paths = g_hash_table_new_full (
+    g_str_hash, g_str_equal, g_free, NULL);
+  for (int j = 0; j < self->num_clips; j++)
+    {
+      AudioClip * clip = self->clips[j];
+      if (!clip)
+        continue;
+
+      char * clip_path =
+        audio_clip_get_path_in_pool (clip, backup);
+      if (clip_path)
+        g_hash_table_add (clip_paths, clip_path);
+    }
+
   char * prj_pool_dir =
     project_get_path (PROJECT, PROJECT_PATH_POOL, backup);
   char ** files = io_get_files_in_dir_ending_in (
@@ -334,34 +470,16 @@ audio_pool_remove_unused (AudioPool * self, bool backup)
         {
           const char * path = files[i];
 
-          bool found = false;
-          for (int j = 0; j < self->num_clips; j++)
-            {
-              AudioClip * clip = self->clips[j];
-              if (!clip)
-                continue;
-
-              char * clip_path =
-                audio_clip_get_path_in_pool (clip, backup);
-
-              if (string_is_equal (clip_path, path))
-                {
-                  found = true;
-                  break;
-                }
-
-              g_free (clip_path);
-            }
-
           /* if file not found in pool clips,
            * delete */
-          if (!found)
+          if (!g_hash_table_contains (clip_paths, path))
             {
               io_remove (path);
             }
         }
       g_strfreev (files);
     }
+  g_hash_table_destroy (clip_paths);
   g_free (prj_pool_dir);
 
   g_message (
@@ -385,6 +503,11 @@ audio_pool_reload_clip_frame_bufs (AudioPool * self)
       if (!clip)
         continue;
 
+      /* the frames will be filled in when the
+       * import finishes */
+      if (clip->import_job)
+        continue;
+
       bool in_use = audio_clip_is_in_use (clip, false);
 
       if (in_use && clip->num_frames == 0)
@@ -426,6 +549,9 @@ audio_pool_write_to_disk (AudioPool * self, bool is_backup)
       AudioClip * clip = self->clips[i];
       if (clip)
         {
+          /* the project must not reference files that
+           * are still being imported */
+          audio_clip_wait_for_import (clip);
           audio_clip_write_to_pool (clip, false, is_backup);
         }
     }
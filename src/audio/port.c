@@ -21,7 +21,9 @@
 #include "audio/router.h"
 #include "audio/rtaudio_device.h"
 #include "audio/rtmidi_device.h"
+#include "audio/tempo_map.h"
 #include "audio/tempo_track.h"
+#include "audio/tracklist.h"
 #include "audio/windows_mme_device.h"
 #include "gui/backend/event.h"
 #include "gui/backend/event_manager.h"
@@ -71,14 +73,20 @@ port_allocate_bufs (Port * self)
   switch (self->id.type)
     {
     case TYPE_EVENT:
-      object_free_w_func_and_null (
-        midi_events_free, self->midi_events);
-      self->midi_events = midi_events_new ();
+      {
+        /* size the new buffers to the peak usage of
+         * the previous ones */
+        MidiEvents * prev = self->midi_events;
+        self->midi_events =
+          midi_events_new_with_size_of (prev);
+        object_free_w_func_and_null (midi_events_free, prev);
+      }
       object_free_w_func_and_null (
         zix_ring_free, self->midi_ring);
       self->midi_ring = zix_ring_new (
         zix_default_allocator (),
-        sizeof (MidiEvent) * (size_t) 11);
+        (sizeof (MidiEventHeader) + sizeof (MidiEvent))
+          * (size_t) 11);
       break;
     case TYPE_AUDIO:
     case TYPE_CV:
@@ -88,12 +96,14 @@ port_allocate_bufs (Port * self)
         self->audio_ring = zix_ring_new (
           zix_default_allocator (),
           sizeof (float) * AUDIO_RING_SIZE);
+        port_unalias_buf (self);
         object_zero_and_free (self->buf);
         size_t max = MAX (
           AUDIO_ENGINE->block_length, self->min_buf_size);
         max = MAX (max, 1);
         self->buf = object_new_n (max, float);
         self->last_buf_sz = max;
+        self->own_buf_clear_pending = false;
       }
     default:
       break;
@@ -114,6 +124,7 @@ port_free_bufs (Port * self)
   object_free_w_func_and_null (zix_ring_free, self->midi_ring);
   object_free_w_func_and_null (
     zix_ring_free, self->audio_ring);
+  port_unalias_buf (self);
   object_zero_and_free (self->buf);
 }
 
@@ -151,6 +162,11 @@ port_init_loaded (Port * self, void * owner)
 /**
  * Finds the Port corresponding to the identifier.
  *
+ * MIDI control ports of track processors are only
+ * created on first use, so NULL is returned for
+ * those that were not used yet (see
+ * automation_track_get_port()).
+ *
  * @param id The PortIdentifier to use for
  *   searching.
  */
@@ -857,8 +873,10 @@ send_audio_data_to_jack (
 /**
  * Sums the inputs coming in from JACK, before the
  * port is processed.
+ *
+ * @return Whether audio data was summed.
  */
-static void
+static bool
 sum_data_from_jack (
   Port *          self,
   const nframes_t start_frame,
@@ -868,7 +886,7 @@ sum_data_from_jack (
     self->id.owner_type == PORT_OWNER_TYPE_AUDIO_ENGINE
     || self->internal_type != INTERNAL_JACK_PORT
     || self->id.flow != FLOW_INPUT)
-    return;
+    return false;
 
   /* append events from JACK if any */
   if (AUDIO_ENGINE->midi_backend == MIDI_BACKEND_JACK)
@@ -882,7 +900,10 @@ sum_data_from_jack (
     {
       port_receive_audio_data_from_jack (
         self, start_frame, nframes);
+      return true;
     }
+
+  return false;
 }
 
 /**
@@ -991,8 +1012,10 @@ expose_to_jack (Port * self, bool expose)
 /**
  * Sums the inputs coming in from dummy, before the
  * port is processed.
+ *
+ * @return Whether audio data was summed.
  */
-static void
+static bool
 sum_data_from_dummy (
   Port *          self,
   const nframes_t start_frame,
@@ -1004,7 +1027,7 @@ sum_data_from_dummy (
     || self->id.type != TYPE_AUDIO
     || AUDIO_ENGINE->audio_backend != AUDIO_BACKEND_DUMMY
     || AUDIO_ENGINE->midi_backend != MIDI_BACKEND_DUMMY)
-    return;
+    return false;
 
   if (AUDIO_ENGINE->dummy_input)
     {
@@ -1023,8 +1046,11 @@ sum_data_from_dummy (
           dsp_add2 (
             &self->buf[start_frame], &port->buf[start_frame],
             nframes);
+          return true;
         }
     }
+
+  return false;
 }
 
 /**
@@ -2085,11 +2111,50 @@ send_data_to_windows_mme (
 #endif
 
 /**
- * To be called when a control's value changes
- * so that a message can be sent to the UI.
+ * Forwards a control change to the DSP side of
+ * the owner (eg, Carla parameters, fader volume
+ * caches).
+ *
+ * This part of the control change event is safe
+ * to call from the processing threads.
  */
-static void
-port_forward_control_change_event (Port * self)
+void
+port_forward_control_change_to_dsp (Port * self)
+{
+  if (
+    self->value_type <= 0
+    && self->id.owner_type == PORT_OWNER_TYPE_PLUGIN)
+    {
+#ifdef HAVE_CARLA
+      Plugin * pl = port_get_plugin (self, 1);
+      if (
+        pl && pl->setting->open_with_carla
+        && self->carla_param_id >= 0)
+        {
+          g_return_if_fail (pl->carla);
+          carla_native_plugin_set_param_value (
+            pl->carla, (uint32_t) self->carla_param_id,
+            self->control);
+        }
+#endif
+    }
+  else if (
+    self->id.owner_type == PORT_OWNER_TYPE_FADER
+    && self->id.flags & PORT_FLAG_AMPLITUDE)
+    {
+      Track * track = port_get_track (self, 1);
+      g_return_if_fail (track && track->channel);
+      fader_update_volume_and_fader_val (
+        track->channel->fader);
+    }
+}
+
+/**
+ * Forwards a control change to the UI (plugin UI
+ * and Zrythm UI events).
+ */
+void
+port_forward_control_change_to_ui (Port * self)
 {
   /* if lv2 port/parameter */
   if (self->value_type > 0)
@@ -2102,25 +2167,12 @@ port_forward_control_change_event (Port * self)
   else if (self->id.owner_type == PORT_OWNER_TYPE_PLUGIN)
     {
       Plugin * pl = port_get_plugin (self, 1);
-      if (pl)
+      if (
+        pl
+        && !g_atomic_int_get (&pl->state_changed_event_sent))
         {
-#ifdef HAVE_CARLA
-          if (
-            pl->setting->open_with_carla
-            && self->carla_param_id >= 0)
-            {
-              g_return_if_fail (pl->carla);
-              carla_native_plugin_set_param_value (
-                pl->carla, (uint32_t) self->carla_param_id,
-                self->control);
-            }
-#endif
-          if (!g_atomic_int_get (&pl->state_changed_event_sent))
-            {
-              EVENTS_PUSH (ET_PLUGIN_STATE_CHANGED, pl);
-              g_atomic_int_set (
-                &pl->state_changed_event_sent, 1);
-            }
+          EVENTS_PUSH (ET_PLUGIN_STATE_CHANGED, pl);
+          g_atomic_int_set (&pl->state_changed_event_sent, 1);
         }
     }
   else if (self->id.owner_type == PORT_OWNER_TYPE_FADER)
@@ -2140,8 +2192,6 @@ port_forward_control_change_event (Port * self)
         {
           if (ZRYTHM_HAVE_UI)
             g_return_if_fail (track->channel->widget);
-          fader_update_volume_and_fader_val (
-            track->channel->fader);
           EVENTS_PUSH (
             ET_CHANNEL_FADER_VAL_CHANGED, track->channel);
         }
@@ -2161,6 +2211,36 @@ port_forward_control_change_event (Port * self)
     }
 }
 
+/**
+ * To be called when a control's value changes
+ * so that a message can be sent to the UI.
+ */
+static void
+port_forward_control_change_event (Port * self)
+{
+  port_forward_control_change_to_dsp (self);
+  port_forward_control_change_to_ui (self);
+}
+
+/**
+ * Marks the value of a MIDI control port as
+ * changed on its track processor so that it is
+ * sent in the next cycle.
+ */
+static inline void
+mark_midi_control_changed (Port * self)
+{
+  if (!(self->id.flags & PORT_FLAG_MIDI_AUTOMATABLE))
+    return;
+
+  Track * track = port_get_track (self, false);
+  if (track && track->processor)
+    {
+      track_processor_mark_midi_control_changed (
+        track->processor, self);
+    }
+}
+
 /**
  * Sets the given control value to the
  * corresponding underlying structure in the Port.
@@ -2206,6 +2286,7 @@ port_set_control_value (
   if (!math_floats_equal (self->control, self->base_value))
     {
       self->control = self->base_value;
+      mark_midi_control_changed (self);
 
       /* remember time */
       self->last_change = g_get_monotonic_time ();
@@ -2221,11 +2302,22 @@ port_set_control_value (
             !engine_get_run (AUDIO_ENGINE)
             || router_is_processing_kickoff_thread (ROUTER));
 
-          int beats_per_bar =
-            tempo_track_get_beats_per_bar (P_TEMPO_TRACK);
-          engine_update_frames_per_tick (
-            AUDIO_ENGINE, beats_per_bar, self->control,
-            AUDIO_ENGINE->sample_rate, false, true, true);
+          /* automated BPM changes are already in the
+           * tempo map, so positions don't need to be
+           * updated */
+          const TempoMap * map =
+            g_atomic_pointer_get (&AUDIO_ENGINE->tempo_map);
+          bool             from_automation =
+            map && map->has_automation
+            && router_is_processing_kickoff_thread (ROUTER);
+          if (!from_automation)
+            {
+              int beats_per_bar =
+                tempo_track_get_beats_per_bar (P_TEMPO_TRACK);
+              engine_update_frames_per_tick (
+                AUDIO_ENGINE, beats_per_bar, self->control,
+                AUDIO_ENGINE->sample_rate, false, true, true);
+            }
           EVENTS_PUSH (ET_BPM_CHANGED, NULL);
         }
 
@@ -2259,6 +2351,16 @@ port_set_control_value (
           EVENTS_PUSH (ET_TIME_SIGNATURE_CHANGED, NULL);
         }
 
+      /* if solo/listen, refresh the solo caches
+       * on the next cycle */
+      if (
+        (id->flags2 & PORT_FLAG2_FADER_SOLO
+         || id->flags2 & PORT_FLAG2_FADER_LISTEN)
+        && port_is_in_active_project (self))
+        {
+          tracklist_mark_solo_caches_dirty (TRACKLIST);
+        }
+
       /* if plugin enabled port, also set
        * plugin's own enabled port value and
        * vice versa */
@@ -2410,6 +2512,7 @@ port_restore_from_non_project (Port * self, Port * non_project)
 
   /* set value */
   prj_port->control = non_project->control;
+  mark_midi_control_changed (prj_port);
 
   g_return_if_fail (
     non_project->num_srcs <= (int) non_project->srcs_size);
@@ -2456,6 +2559,138 @@ stereo_ports_new_generic (
   return ports;
 }
 
+bool
+port_get_automation_val (
+  Port *           self,
+  unsigned_frame_t g_frame,
+  float *          val)
+{
+  AutomationTrack * at = self->at;
+  if (
+    !at
+    || !automation_track_should_read_automation (
+      at, AUDIO_ENGINE->timestamp_start))
+    return false;
+
+  Position pos;
+  position_from_frames (&pos, (signed_frame_t) g_frame);
+
+  /* if playhead pos changed manually recently or
+   * transport is rolling, we will force the last
+   * known automation point value regardless of
+   * whether there is a region at current pos */
+  bool can_read_previous_automation =
+    TRANSPORT_IS_ROLLING
+    || (TRANSPORT->last_manual_playhead_change
+          - AUDIO_ENGINE->last_timestamp_start
+        > 0);
+
+  /* if there was an automation event at the
+   * playhead position, return its value */
+  AutomationPoint * ap = automation_track_get_ap_before_pos (
+    at, &pos, !can_read_previous_automation);
+  if (!ap)
+    return false;
+
+  *val = automation_track_get_val_at_pos (
+    at, &pos, true, !can_read_previous_automation);
+
+  return true;
+}
+
+bool
+port_read_automation (
+  Port *           self,
+  unsigned_frame_t g_frame)
+{
+  float val;
+  if (!port_get_automation_val (self, g_frame, &val))
+    return false;
+
+  control_port_set_val_from_normalized (self, val, true);
+  self->value_changed_from_reading = true;
+
+  return true;
+}
+
+/**
+ * Returns whether the backend may sum external
+ * audio into the port (superset of what
+ * sum_data_from_jack() and sum_data_from_dummy()
+ * do).
+ */
+static inline bool
+may_receive_external_audio (const Port * self)
+{
+  switch (AUDIO_ENGINE->audio_backend)
+    {
+#ifdef HAVE_JACK
+    case AUDIO_BACKEND_JACK:
+      return self->internal_type == INTERNAL_JACK_PORT;
+#endif
+    case AUDIO_BACKEND_DUMMY:
+      return AUDIO_ENGINE->dummy_input
+             && (self->id.flags & PORT_FLAG_STEREO_L
+                 || self->id.flags & PORT_FLAG_STEREO_R);
+    default:
+      return false;
+    }
+}
+
+/**
+ * Returns the source whose buffer the given audio
+ * port can alias in the given range instead of
+ * summing it, or NULL if the port must use its own
+ * buffer.
+ *
+ * This is the case when the port is only written
+ * to by summing a single source connected with
+ * unity gain, and the result does not need to be
+ * limited in place.
+ */
+static inline Port *
+get_alias_src (
+  const Port * self,
+  bool         ext_input,
+  nframes_t    local_offset,
+  nframes_t    nframes)
+{
+  const PortIdentifier * id = &self->id;
+  if (
+    id->type != TYPE_AUDIO || self->num_srcs != 1
+    || self->own_buf_in_cycle
+    || (ext_input && may_receive_external_audio (self))
+    || self->exposed_to_backend)
+    return NULL;
+
+  /* ports written to by their owner */
+  if (
+    (id->flow != FLOW_INPUT
+     || id->owner_type == PORT_OWNER_TYPE_AUDIO_ENGINE
+     || id->owner_type == PORT_OWNER_TYPE_HW)
+    && id->owner_type != PORT_OWNER_TYPE_CHANNEL)
+    return NULL;
+
+  const PortConnection * conn = self->src_connections[0];
+  Port *                 src_port = self->srcs[0];
+  if (
+    !conn->enabled || src_port->id.type != TYPE_AUDIO
+    || src_port->last_buf_sz < self->last_buf_sz
+    || !math_floats_equal_epsilon (
+      conn->multiplier, 1.f, 0.00001f))
+    return NULL;
+
+  /* faders limit their input in place */
+  if (
+    id->owner_type == PORT_OWNER_TYPE_FADER
+    && !port_is_silent (src_port)
+    && dsp_abs_max (&src_port->buf[local_offset], nframes)
+         > 2.f)
+    return NULL;
+
+  return src_port;
+}
+
 /**
  * First sets port buf to 0, then sums the given
  * port signal from its inputs.
@@ -2726,20 +2961,27 @@ port_process (
           MidiEvents * events = port->midi_events;
           if (port->write_ring_buffers)
             {
+              const uint32_t entry_sz =
+                sizeof (MidiEventHeader) + sizeof (MidiEvent);
+              MidiEventHeader h = {
+                .time = (uint64_t) g_get_monotonic_time (),
+                .size = sizeof (MidiEvent),
+              };
               for (int i = events->num_events - 1; i >= 0; i--)
                 {
                   if (
                     zix_ring_write_space (port->midi_ring)
-                    < sizeof (MidiEvent))
+                    < entry_sz)
                     {
                       zix_ring_skip (
-                        port->midi_ring, sizeof (MidiEvent));
+                        port->midi_ring, entry_sz);
                     }
 
-                  MidiEvent * ev = &events->events[i];
-                  ev->systime = g_get_monotonic_time ();
                   zix_ring_write (
-                    port->midi_ring, ev, sizeof (MidiEvent));
+                    port->midi_ring, &h, sizeof (h));
+                  zix_ring_write (
+                    port->midi_ring, &events->events[i],
+                    sizeof (MidiEvent));
                 }
             }
           else
@@ -2757,9 +2999,23 @@ port_process (
     case TYPE_CV:
       if (noroll)
         {
+          if (port->own_buf)
+            {
+              /* keep the earlier ranges */
+              float * alias_buf = port->buf;
+              port_use_own_buf (port);
+              dsp_copy (
+                port->buf, alias_buf, local_offset);
+            }
+          else
+            {
+              port_use_own_buf (port);
+            }
+          port->own_buf_in_cycle = true;
           dsp_fill (
             &port->buf[local_offset], DENORMAL_PREVENTION_VAL,
             nframes);
+          port_update_silence (port, true);
           break;
         }
 
@@ -2767,27 +3023,68 @@ port_process (
         id->owner_type != PORT_OWNER_TYPE_TRACK_PROCESSOR
         || IS_TRACK_AND_NONNULL (track));
 
+      /* whether anything non-silent was summed into
+       * the buffer */
+      bool summed_sound = false;
+
       /* only consider incoming external data if
        * armed for recording (if the port is owner
        * by a track), otherwise always consider
        * incoming external data */
-      if ((id->owner_type !=
-             PORT_OWNER_TYPE_TRACK_PROCESSOR
-           || (id->owner_type ==
-                 PORT_OWNER_TYPE_TRACK_PROCESSOR
-               && track_type_can_record (track->type)
-               && track_get_recording (track)))
-          && id->flow == FLOW_INPUT)
+      bool ext_input =
+        (id->owner_type != PORT_OWNER_TYPE_TRACK_PROCESSOR
+         || (id->owner_type
+               == PORT_OWNER_TYPE_TRACK_PROCESSOR
+             && track_type_can_record (track->type)
+             && track_get_recording (track)))
+        && id->flow == FLOW_INPUT;
+
+      /* use the buffer of a single unity source
+       * instead of copying it */
+      Port * alias_src = get_alias_src (
+        port, ext_input, local_offset, nframes);
+      if (alias_src)
+        {
+          if (!port->own_buf)
+            port->own_buf = port->buf;
+          port->buf = alias_src->buf;
+          summed_sound = !port_is_silent (alias_src);
+          ext_input = false;
+        }
+      else
+        {
+          if (port->own_buf)
+            {
+              /* aliased in an earlier range of this
+               * cycle, copy that range on write */
+              float * alias_buf = port->buf;
+              port_use_own_buf (port);
+              dsp_copy (
+                port->buf, alias_buf, local_offset);
+            }
+          else
+            {
+              port_use_own_buf (port);
+            }
+
+          /* the earlier ranges of the own buffer may
+           * differ from the source (e.g. limited), so
+           * keep using it */
+          port->own_buf_in_cycle = true;
+        }
+
+      if (ext_input)
         {
           switch (AUDIO_ENGINE->audio_backend)
             {
 #ifdef HAVE_JACK
             case AUDIO_BACKEND_JACK:
-              sum_data_from_jack (port, local_offset, nframes);
+              summed_sound = sum_data_from_jack (
+                port, local_offset, nframes);
               break;
 #endif
             case AUDIO_BACKEND_DUMMY:
-              sum_data_from_dummy (
+              summed_sound = sum_data_from_dummy (
                 port, local_offset, nframes);
               break;
             default:
@@ -2795,7 +3092,7 @@ port_process (
             }
         }
 
-      for (int k = 0; k < port->num_srcs; k++)
+      for (int k = 0; k < port->num_srcs && !alias_src; k++)
         {
           Port *                 src_port = port->srcs[k];
           const PortConnection * conn =
@@ -2803,6 +3100,12 @@ port_process (
           if (!conn->enabled)
             continue;
 
+          /* nothing to add */
+          if (port_is_silent (src_port))
+            continue;
+
+          summed_sound = true;
+
           float minf = 0.f, maxf = 0.f, depth_range, multiplier;
           if (G_LIKELY (id->type == TYPE_AUDIO))
             {
@@ -2859,6 +3162,23 @@ port_process (
             }
         } /* foreach source */
 
+      /* ports that are only written to by summing
+       * their sources know whether they are silent.
+       * the rest are written to by their owner so
+       * only clear the flag if something was added */
+      if (
+        (id->flow == FLOW_INPUT
+         && id->owner_type != PORT_OWNER_TYPE_AUDIO_ENGINE
+         && id->owner_type != PORT_OWNER_TYPE_HW)
+        || id->owner_type == PORT_OWNER_TYPE_CHANNEL)
+        {
+          port_update_silence (port, !summed_sound);
+        }
+      else if (summed_sound)
+        {
+          port_update_silence (port, false);
+        }
+
       if (id->flow == FLOW_OUTPUT)
         {
           switch (AUDIO_ENGINE->audio_backend)
@@ -2913,9 +3233,21 @@ port_process (
                 > TIME_TO_RESET_PEAK)
                 port->peak = -1.f;
 
-              bool changed = dsp_abs_max_with_existing_peak (
-                &port->buf[local_offset], &port->peak,
-                nframes);
+              bool changed;
+              if (port_is_silent (port))
+                {
+                  /* silence can only replace a reset
+                   * peak */
+                  changed = port->peak < 0.f;
+                  if (changed)
+                    port->peak = DENORMAL_PREVENTION_VAL;
+                }
+              else
+                {
+                  changed = dsp_abs_max_with_existing_peak (
+                    &port->buf[local_offset], &port->peak,
+                    nframes);
+                }
               if (changed)
                 {
                   port->peak_timestamp =
@@ -3070,43 +3402,7 @@ port_process (
             g_return_if_fail (at == found_at);
           }
 
-        if (
-          at && id->flags & PORT_FLAG_AUTOMATABLE
-          && automation_track_should_read_automation (
-            at, AUDIO_ENGINE->timestamp_start))
-          {
-            Position pos;
-            position_from_frames (
-              &pos, (signed_frame_t) time_nfo.g_start_frame);
-
-            /* if playhead pos changed manually
-             * recently or transport is rolling,
-             * we will force the last known
-             * automation point value regardless
-             * of whether there is a region at
-             * current pos */
-            bool can_read_previous_automation =
-              TRANSPORT_IS_ROLLING
-              ||
-              (TRANSPORT->last_manual_playhead_change
-               - AUDIO_ENGINE->last_timestamp_start > 0);
-
-            /* if there was an automation event
-             * at the playhead position, set val
-             * and flag */
-            AutomationPoint * ap =
-              automation_track_get_ap_before_pos (
-                at, &pos, !can_read_previous_automation);
-            if (ap)
-              {
-                float val = automation_track_get_val_at_pos (
-                  at, &pos, true,
-                  !can_read_previous_automation);
-                control_port_set_val_from_normalized (
-                  port, val, true);
-                port->value_changed_from_reading = true;
-              }
-          }
+        port_read_automation (port, time_nfo.g_start_frame);
 
         float maxf, minf, depth_range, val_to_use;
         /* whether this is the first CV processed
@@ -3150,6 +3446,7 @@ port_process (
                         * conn->multiplier,
                   minf, maxf);
                 port->control = result;
+                mark_midi_control_changed (port);
                 port_forward_control_change_event (port);
               }
           }
@@ -3312,6 +3609,8 @@ port_has_sound (Port * self)
     {
     case TYPE_AUDIO:
       g_return_val_if_fail (self->buf, false);
+      if (port_is_silent (self))
+        return false;
       for (nframes_t i = 0; i < AUDIO_ENGINE->block_length; i++)
         {
           if (fabsf (self->buf[i]) > 0.0000001f)
@@ -3418,11 +3717,57 @@ port_print_full_designation (Port * const self)
 void
 port_clear_audio_cv_buffer (Port * port)
 {
-  if (port->buf)
+  bool aliased = port->own_buf != NULL;
+  port_unalias_buf (port);
+  port->own_buf_in_cycle = false;
+
+  /* ports that aliased their source in the last
+   * cycle will most likely alias it again, so only
+   * clear their buffer if they end up using it */
+  if (aliased)
+    {
+      port->own_buf_clear_pending = true;
+    }
+  else if (port->buf)
     {
       dsp_fill (
         port->buf, DENORMAL_PREVENTION_VAL,
         AUDIO_ENGINE->block_length);
+      port->own_buf_clear_pending = false;
+    }
+
+  /* producers must claim silence explicitly */
+  port->silent = false;
+}
+
+/**
+ * Points @ref Port.buf back to the port's own
+ * buffer if it aliases the buffer of its source.
+ *
+ * The contents of the own buffer are left as
+ * they were.
+ */
+void
+port_unalias_buf (Port * self)
+{
+  if (self->own_buf)
+    {
+      self->buf = self->own_buf;
+      self->own_buf = NULL;
+    }
+}
+
+void
+port_use_own_buf (Port * self)
+{
+  port_unalias_buf (self);
+
+  if (G_UNLIKELY (self->own_buf_clear_pending))
+    {
+      dsp_fill (
+        self->buf, DENORMAL_PREVENTION_VAL,
+        AUDIO_ENGINE->block_length);
+      self->own_buf_clear_pending = false;
     }
 }
 
@@ -3436,6 +3781,38 @@ port_clear_midi_buffer (Port * port)
     port->midi_events->num_events = 0;
 }
 
+/**
+ * Updates the silence hint after a producer
+ * processed a range of the current router cycle.
+ */
+void
+port_update_silence (Port * self, bool silent)
+{
+  /* the first range of the cycle decides, later
+   * ranges (after loop splits) can only clear the
+   * flag */
+  if (self->silent_cycle != ROUTER->cycle)
+    {
+      self->silent_cycle = ROUTER->cycle;
+      self->silent = silent;
+    }
+  else
+    {
+      self->silent = self->silent && silent;
+    }
+}
+
+/**
+ * Returns whether the buffer is known to be silent
+ * in the current router cycle.
+ */
+bool
+port_is_silent (const Port * self)
+{
+  return self->silent
+         && self->silent_cycle == ROUTER->cycle;
+}
+
 /**
  * Clears the port buffer.
  */
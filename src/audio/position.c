@@ -7,6 +7,7 @@
 #include "audio/engine.h"
 #include "audio/position.h"
 #include "audio/snap_grid.h"
+#include "audio/tempo_map.h"
 #include "audio/tempo_track.h"
 #include "audio/transport.h"
 #include "gui/widgets/arranger.h"
@@ -41,11 +42,27 @@ position_sort_array (Position * array, const size_t size)
   qsort (array, size, sizeof (Position), position_cmpfunc);
 }
 
+/**
+ * Returns the tempo map to use for default
+ * conversions, if the BPM is automated.
+ */
+static inline const TempoMap *
+get_automated_tempo_map (void)
+{
+  const TempoMap * map =
+    g_atomic_pointer_get (&AUDIO_ENGINE->tempo_map);
+  if (map && map->has_automation)
+    return map;
+
+  return NULL;
+}
+
 /**
  * Updates ticks.
  *
  * @param ticks_per_frame If zero, AudioEngine.ticks_per_frame
- *   will be used instead.
+ *   will be used instead (or the tempo map if the BPM
+ *   is automated).
  */
 void
 position_update_ticks_from_frames (
@@ -54,6 +71,13 @@ position_update_ticks_from_frames (
 {
   if (math_doubles_equal (ticks_per_frame, 0.0))
     {
+      const TempoMap * map = get_automated_tempo_map ();
+      if (map)
+        {
+          self->ticks = tempo_map_frames_to_ticks (
+            map, (double) self->frames);
+          return;
+        }
       ticks_per_frame = AUDIO_ENGINE->ticks_per_frame;
     }
   g_return_if_fail (ticks_per_frame > 0);
@@ -81,13 +105,24 @@ position_get_frames_from_ticks (
  * Updates frames.
  *
  * @param frames_per_tick If zero, AudioEngine.frames_per_tick
- *   will be used instead.
+ *   will be used instead (or the tempo map if the BPM
+ *   is automated).
  */
 void
 position_update_frames_from_ticks (
   Position * self,
   double     frames_per_tick)
 {
+  if (math_doubles_equal (frames_per_tick, 0.0))
+    {
+      const TempoMap * map = get_automated_tempo_map ();
+      if (map)
+        {
+          self->frames = math_round_double_to_signed_frame_t (
+            tempo_map_ticks_to_frames (map, self->ticks));
+          return;
+        }
+    }
   self->frames = position_get_frames_from_ticks (
     self->ticks, frames_per_tick);
 }
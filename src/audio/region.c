@@ -318,6 +318,7 @@ region_stretch (ZRegion * self, double ratio)
         z_return_if_fail_cmp (returned_frames, >, 0);
         new_clip->num_frames =
           (unsigned_frame_t) returned_frames;
+        audio_clip_update_channel_caches (new_clip, 0);
         audio_clip_write_to_pool (
           new_clip, F_NO_PARTS, F_NOT_BACKUP);
         (void) obj;
@@ -745,6 +746,71 @@ region_find (const RegionIdentifier * const id)
   g_return_val_if_reached (NULL);
 }
 
+/**
+ * Returns the ZRegion matching the identifier, or
+ * NULL without warning if there is none (eg, for
+ * identifiers of clones of removed regions).
+ */
+ZRegion *
+region_find_if_exists (const RegionIdentifier * const id)
+{
+  if (!PROJECT || !TRACKLIST || id->idx < 0)
+    return NULL;
+
+  Track * track =
+    id->type == REGION_TYPE_CHORD
+      ? P_CHORD_TRACK
+      : tracklist_find_track_by_name_hash (
+        TRACKLIST, id->track_name_hash);
+  if (!track)
+    return NULL;
+
+  switch (id->type)
+    {
+    case REGION_TYPE_MIDI:
+    case REGION_TYPE_AUDIO:
+      {
+        if (
+          id->lane_pos < 0
+          || id->lane_pos >= track->num_lanes)
+          return NULL;
+        TrackLane * lane = track->lanes[id->lane_pos];
+        return id->idx < lane->num_regions
+                 ? lane->regions[id->idx]
+                 : NULL;
+      }
+    case REGION_TYPE_AUTOMATION:
+      {
+        AutomationTracklist * atl =
+          &track->automation_tracklist;
+        if (id->at_idx < 0 || id->at_idx >= atl->num_ats)
+          return NULL;
+        AutomationTrack * at = atl->ats[id->at_idx];
+        return id->idx < at->num_regions
+                 ? at->regions[id->idx]
+                 : NULL;
+      }
+    case REGION_TYPE_CHORD:
+      return id->idx < track->num_chord_regions
+               ? track->chord_regions[id->idx]
+               : NULL;
+    default:
+      return NULL;
+    }
+}
+
+/**
+ * To be called when anything drawn inside the
+ * region (its children, loop points, clip start,
+ * fades, etc.) changes, so that its cached contents
+ * are redrawn.
+ */
+void
+region_contents_changed (ZRegion * self)
+{
+  g_atomic_int_inc (&self->contents_version);
+}
+
 /**
  * To be called every time the identifier changes
  * to update the region's children.
@@ -1090,6 +1156,10 @@ region_is_hit (
   const signed_frame_t gframes,
   const bool           inclusive)
 {
+  /* the frames are a cache of the ticks */
+  arranger_object_update_frames_if_stale (
+    (ArrangerObject *) region);
+
   const ArrangerObject * r_obj =
     (const ArrangerObject *) region;
   return
@@ -1166,6 +1236,9 @@ region_is_hit_by_range (
   const signed_frame_t gframes_end,
   const bool           end_inclusive)
 {
+  arranger_object_update_frames_if_stale (
+    (ArrangerObject *) region);
+
   const ArrangerObject * obj = (const ArrangerObject *) region;
   /* 4 cases:
    * - region start is inside range
@@ -1276,6 +1349,9 @@ region_timeline_frames_to_local (
 {
   g_return_val_if_fail (IS_REGION (self), 0);
 
+  arranger_object_update_frames_if_stale (
+    (ArrangerObject *) self);
+
   const ArrangerObject * const r_obj =
     (const ArrangerObject * const) self;
 
@@ -1333,6 +1409,7 @@ region_get_frames_till_next_loop_or_end (
   g_return_if_fail (IS_REGION (self));
 
   ArrangerObject * r_obj = (ArrangerObject *) self;
+  arranger_object_update_frames_if_stale (r_obj);
 
   signed_frame_t loop_size =
     arranger_object_get_loop_length_in_frames (r_obj);
@@ -28,6 +28,7 @@
 
 #include "zrythm-config.h"
 
+#include "audio/anticipative_renderer.h"
 #include "audio/audio_track.h"
 #include "audio/control_port.h"
 #include "audio/engine.h"
@@ -49,10 +50,14 @@
 #include "audio/tempo_track.h"
 #include "audio/track.h"
 #include "audio/track_processor.h"
+#include "audio/tracklist.h"
+#include "gui/backend/event.h"
+#include "gui/backend/event_manager.h"
 #include "project.h"
 #include "utils/arrays.h"
 #include "utils/env.h"
 #include "utils/flags.h"
+#include "utils/log.h"
 #include "utils/midi.h"
 #include "utils/mpmc_queue.h"
 #include "utils/object_utils.h"
@@ -64,6 +69,10 @@
 #  include "weak_libjack.h"
 #endif
 
+/** Max number of ports that can have a value
+ * queued (or a notification pending) at once. */
+#define MAX_QUEUED_CONTROLS 8192
+
 /**
  * Returns the max playback latency of the trigger
  * nodes.
@@ -100,7 +109,7 @@ router_start_cycle (
 
   if (zix_sem_try_wait (&self->graph_access) != ZIX_STATUS_SUCCESS)
     {
-      g_message ("graph access is busy, returning...");
+      z_rt_message ("graph access is busy, returning...");
       return;
     }
 
@@ -111,6 +120,13 @@ router_start_cycle (
     &self->time_nfo, &time_nfo,
     sizeof (EngineProcessTimeInfo));
 
+  /* never 0 so that fresh listen buffers are never
+   * considered current */
+  if (++self->cycle == 0)
+    self->cycle = 1;
+
+  tracklist_update_solo_caches (TRACKLIST);
+
   /* read control port change events */
   while (
     zix_ring_read_space (self->ctrl_port_change_queue)
@@ -138,6 +154,8 @@ router_start_cycle (
         }
     }
 
+  router_apply_queued_control_values (self);
+
   /* process tempo track ports first */
   if (self->graph->bpm_node)
     {
@@ -178,6 +196,8 @@ router_recalc_graph (Router * self, bool soft)
     {
       self->graph = graph_new (self);
       graph_setup (self->graph, 1, 1);
+      anticipative_renderer_setup (
+        self->anticipative_renderer, self->graph);
       graph_start (self->graph);
       return;
     }
@@ -187,6 +207,10 @@ router_recalc_graph (Router * self, bool soft)
       zix_sem_wait (&self->graph_access);
       graph_update_latencies (self->graph, false);
       zix_sem_post (&self->graph_access);
+
+      /* the latency compensation offsets changed */
+      anticipative_renderer_invalidate (
+        self->anticipative_renderer);
     }
   else
     {
@@ -196,7 +220,11 @@ router_recalc_graph (Router * self, bool soft)
         {
           g_usleep (100);
         }
+      anticipative_renderer_clear (
+        self->anticipative_renderer);
       graph_setup (self->graph, 1, 1);
+      anticipative_renderer_setup (
+        self->anticipative_renderer, self->graph);
       g_atomic_int_set (&AUDIO_ENGINE->run, (guint) running);
     }
 
@@ -229,6 +257,157 @@ router_queue_control_port_change (
     sizeof (ControlPortChange));
 }
 
+static inline gint
+float_to_bits (float val)
+{
+  gint bits;
+  memcpy (&bits, &val, sizeof (bits));
+  return bits;
+}
+
+static inline float
+bits_to_float (gint bits)
+{
+  float val;
+  memcpy (&val, &bits, sizeof (val));
+  return val;
+}
+
+/**
+ * Queues a value for a control port, to be applied
+ * at the start of the next cycle.
+ *
+ * Values queued for the same port before the cycle
+ * starts are coalesced (the last value wins), and
+ * the UI is notified once per cycle for all ports
+ * changed. Safe to call from any thread.
+ *
+ * If the engine is not running the value is
+ * applied immediately.
+ */
+void
+router_queue_control_value (
+  Router * self,
+  Port *   port,
+  float    real_val,
+  bool     forward_event)
+{
+  g_return_if_fail (port->id.type == TYPE_CONTROL);
+
+  /* BPM/time signature changes go through
+   * router_queue_control_port_change() */
+  g_return_if_fail (
+    !(port->id.flags & PORT_FLAG_BPM)
+    && !(port->id.flags2 & PORT_FLAG2_BEATS_PER_BAR)
+    && !(port->id.flags2 & PORT_FLAG2_BEAT_UNIT));
+
+  if (!engine_get_run (AUDIO_ENGINE))
+    {
+      port_set_control_value (
+        port, real_val, F_NOT_NORMALIZED, forward_event);
+      return;
+    }
+
+  g_atomic_int_set (
+    &port->queued_control, float_to_bits (real_val));
+  if (forward_event)
+    g_atomic_int_set (&port->queued_forward_event, 1);
+
+  /* only enqueue the port if it's not already
+   * queued - the value above will be picked up
+   * when it's dequeued */
+  if (!g_atomic_int_compare_and_exchange (
+        &port->control_queued, 0, 1))
+    return;
+
+  if (!mpmc_queue_push_back (self->ctrl_value_queue, port))
+    {
+      g_atomic_int_set (&port->control_queued, 0);
+      g_warning (
+        "control value queue full, dropping change "
+        "for %s",
+        port->id.label);
+    }
+}
+
+/**
+ * Applies the values queued with
+ * router_queue_control_value().
+ *
+ * Called at the start of each cycle and when the
+ * engine is paused.
+ */
+void
+router_apply_queued_control_values (Router * self)
+{
+  bool   notify = false;
+  Port * port;
+  while (mpmc_queue_dequeue (
+    self->ctrl_value_queue, (void *) &port))
+    {
+      /* clear the flag before reading the value so
+       * that a value queued after this point
+       * re-enqueues the port */
+      g_atomic_int_set (&port->control_queued, 0);
+      float val = bits_to_float (
+        g_atomic_int_get (&port->queued_control));
+      bool forward_event =
+        g_atomic_int_compare_and_exchange (
+          &port->queued_forward_event, 1, 0);
+
+      port_set_control_value (
+        port, val, F_NOT_NORMALIZED, F_NO_PUBLISH_EVENTS);
+
+      if (!forward_event)
+        continue;
+
+      port_forward_control_change_to_dsp (port);
+
+      /* UI events are no-ops without a UI */
+      if (!ZRYTHM_HAVE_UI)
+        continue;
+
+      notify = true;
+      if (!g_atomic_int_compare_and_exchange (
+            &port->control_notify_queued, 0, 1))
+        continue;
+
+      if (!mpmc_queue_push_back (
+            self->ctrl_notify_queue, port))
+        {
+          g_atomic_int_set (
+            &port->control_notify_queued, 0);
+        }
+    }
+
+  /* one notification for all the ports changed in
+   * this cycle (duplicates from previous cycles
+   * are merged by the event manager) */
+  if (notify)
+    {
+      EVENTS_PUSH (ET_CONTROL_PORTS_CHANGED, NULL);
+    }
+}
+
+/**
+ * Forwards the control changes applied from the
+ * queue to the UI.
+ *
+ * To be called from the GTK thread on
+ * ET_CONTROL_PORTS_CHANGED.
+ */
+void
+router_dispatch_control_notifications (Router * self)
+{
+  Port * port;
+  while (mpmc_queue_dequeue (
+    self->ctrl_notify_queue, (void *) &port))
+    {
+      g_atomic_int_set (&port->control_notify_queued, 0);
+      port_forward_control_change_to_ui (port);
+    }
+}
+
 /**
  * Creates a new Router.
  *
@@ -247,6 +426,15 @@ router_new (void)
     zix_default_allocator (),
     sizeof (ControlPortChange) * (size_t) 24);
 
+  self->ctrl_value_queue = mpmc_queue_new ();
+  mpmc_queue_reserve (
+    self->ctrl_value_queue, MAX_QUEUED_CONTROLS);
+  self->ctrl_notify_queue = mpmc_queue_new ();
+  mpmc_queue_reserve (
+    self->ctrl_notify_queue, MAX_QUEUED_CONTROLS);
+
+  self->anticipative_renderer = anticipative_renderer_new ();
+
   g_message ("done");
 
   return self;
@@ -286,6 +474,9 @@ router_is_processing_thread (const Router * const self)
       pthread_self (), self->graph->main_thread->pthread))
     return true;
 
+  if (anticipative_renderer_is_renderer_thread ())
+    return true;
+
   return false;
 }
 
@@ -294,6 +485,9 @@ router_free (Router * self)
 {
   g_debug ("%s: freeing...", __func__);
 
+  object_free_w_func_and_null (
+    anticipative_renderer_free, self->anticipative_renderer);
+
   if (self->graph)
     graph_destroy (self->graph);
   self->graph = NULL;
@@ -303,6 +497,10 @@ router_free (Router * self)
 
   object_free_w_func_and_null (
     zix_ring_free, self->ctrl_port_change_queue);
+  object_free_w_func_and_null (
+    mpmc_queue_free, self->ctrl_value_queue);
+  object_free_w_func_and_null (
+    mpmc_queue_free, self->ctrl_notify_queue);
 
   object_zero_and_free (self);
 
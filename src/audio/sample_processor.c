@@ -579,11 +579,18 @@ queue_file_or_chord_preset (
         F_GEN_AUTOMATABLES, F_NO_RECALC_GRAPH,
         F_NO_PUBLISH_EVENTS);
 
-      int num_tracks = 1;
+      /* parse all tracks once instead of once per
+       * track created */
+      int             num_tracks = 1;
+      int             num_mf_tracks = 0;
+      MidiFileTrack * mf_tracks = NULL;
       if (file)
         {
-          num_tracks =
-            midi_file_get_num_tracks (file->abs_path, true);
+          mf_tracks = midi_file_read_tracks (
+            file->abs_path, transport_get_ppqn (TRANSPORT),
+            &num_mf_tracks);
+          num_tracks = midi_file_tracks_get_num_with_data (
+            mf_tracks, num_mf_tracks);
         }
       g_debug ("creating %d MIDI tracks...", num_tracks);
       for (int i = 0; i < num_tracks; i++)
@@ -606,9 +613,15 @@ queue_file_or_chord_preset (
             {
               /* create a MIDI region from the MIDI
                * file & add to track */
-              ZRegion * mr = midi_region_new_from_midi_file (
-                &start_pos, file->abs_path,
-                track_get_name_hash (track), 0, 0, i);
+              const MidiFileTrack * mf_track =
+                midi_file_tracks_get_nth_with_data (
+                  mf_tracks, num_mf_tracks, i);
+              ZRegion * mr =
+                mf_track
+                  ? midi_region_new_from_midi_file_track (
+                    &start_pos, mf_track,
+                    track_get_name_hash (track), 0, 0)
+                  : NULL;
               if (mr)
                 {
                   track_add_region (
@@ -696,6 +709,11 @@ queue_file_or_chord_preset (
             } /* endif chord preset */
 
         } /* endforeach track */
+
+      if (mf_tracks)
+        {
+          midi_file_tracks_free (mf_tracks, num_mf_tracks);
+        }
     }
 
   self->roll = true;
@@ -0,0 +1,351 @@
+// SPDX-FileCopyrightText: © 2022 Alexandros Theodotou <alex@zrythm.org>
+// SPDX-License-Identifier: LicenseRef-ZrythmLicense
+
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "audio/automation_point.h"
+#include "audio/automation_track.h"
+#include "audio/automation_tracklist.h"
+#include "audio/region.h"
+#include "audio/tempo_map.h"
+#include "audio/track.h"
+#include "utils/objects.h"
+
+/**
+ * Returns the frames per tick at the given BPM,
+ * calculated the same way as
+ * AudioEngine.frames_per_tick.
+ */
+static inline double
+get_frames_per_tick (
+  double        bpm,
+  int           beats_per_bar,
+  int           ticks_per_bar,
+  sample_rate_t sample_rate)
+{
+  return (
+    ((double) sample_rate * 60.0 * (double) beats_per_bar)
+    / (bpm * (double) ticks_per_bar));
+}
+
+static int
+cmp_by_start_ticks (const void * a, const void * b)
+{
+  const TempoMapSegment * seg_a = (const TempoMapSegment *) a;
+  const TempoMapSegment * seg_b = (const TempoMapSegment *) b;
+  double diff = seg_a->start_ticks - seg_b->start_ticks;
+  return (diff > 0) - (diff < 0);
+}
+
+/**
+ * Returns the automation track of the BPM port if
+ * it should be used for the map, or NULL.
+ */
+static AutomationTrack *
+get_bpm_at (Track * tempo_track)
+{
+  if (!tempo_track || !tempo_track->bpm_port)
+    return NULL;
+
+  AutomationTrack * at =
+    automation_tracklist_get_at_from_port (
+      &tempo_track->automation_tracklist,
+      tempo_track->bpm_port);
+  if (
+    !at || at->automation_mode != AUTOMATION_MODE_READ
+    || at->num_regions == 0)
+    return NULL;
+
+  return at;
+}
+
+/**
+ * Returns the number of automation points of the
+ * given BPM automation track.
+ */
+static size_t
+get_num_automation_points (AutomationTrack * at)
+{
+  size_t num_points = 0;
+  for (int i = 0; i < at->num_regions; i++)
+    {
+      num_points += (size_t) at->regions[i]->num_aps;
+    }
+  return num_points;
+}
+
+/**
+ * Adds the automation points of the given BPM
+ * automation track to the given segments (unsorted,
+ * with only the start ticks and BPM set).
+ *
+ * @return The number of points added.
+ */
+static int
+add_automation_points (
+  TempoMapSegment * segs,
+  AutomationTrack * at)
+{
+  int num_segments = 0;
+  for (int i = 0; i < at->num_regions; i++)
+    {
+      ZRegion *        r = at->regions[i];
+      ArrangerObject * r_obj = (ArrangerObject *) r;
+      if (arranger_object_get_muted (r_obj, false))
+        continue;
+
+      for (int j = 0; j < r->num_aps; j++)
+        {
+          AutomationPoint * ap = r->aps[j];
+          ArrangerObject *  ap_obj = (ArrangerObject *) ap;
+
+          /* loops are not taken into account */
+          double ticks =
+            r_obj->pos.ticks + ap_obj->pos.ticks;
+          if (ticks > r_obj->end_pos.ticks)
+            break;
+
+          TempoMapSegment * seg = &segs[num_segments++];
+          seg->start_ticks = ticks;
+          seg->start_bpm = (double) ap->fvalue;
+        }
+    }
+
+  return num_segments;
+}
+
+TempoMap *
+tempo_map_new (
+  Track *       tempo_track,
+  bpm_t         bpm,
+  int           beats_per_bar,
+  int           ticks_per_bar,
+  sample_rate_t sample_rate)
+{
+  g_return_val_if_fail (
+    beats_per_bar > 0 && ticks_per_bar > 0
+      && sample_rate > 0,
+    NULL);
+
+  AutomationTrack * at = get_bpm_at (tempo_track);
+
+  /* one more for the segment before the first
+   * point */
+  size_t num_allocated =
+    (at ? get_num_automation_points (at) : 0) + 1;
+  TempoMapSegment * segs =
+    object_new_n (num_allocated, TempoMapSegment);
+
+  int num_points = 0;
+  if (at)
+    {
+      num_points = add_automation_points (segs, at);
+      qsort (
+        segs, (size_t) num_points, sizeof (TempoMapSegment),
+        cmp_by_start_ticks);
+    }
+
+  int num_segments;
+  if (num_points == 0)
+    {
+      segs[0].start_ticks = 0.0;
+      segs[0].start_bpm = (double) bpm;
+      num_segments = 1;
+    }
+  else if (segs[0].start_ticks > 0.0)
+    {
+      /* keep the first value until the first
+       * point */
+      memmove (
+        &segs[1], &segs[0],
+        (size_t) num_points * sizeof (TempoMapSegment));
+      segs[0].start_ticks = 0.0;
+      segs[0].start_bpm = segs[1].start_bpm;
+      num_segments = num_points + 1;
+    }
+  else
+    {
+      num_segments = num_points;
+    }
+
+  /* calculate the ramps and cumulative frames */
+  double frames = 0.0;
+  for (int i = 0; i < num_segments; i++)
+    {
+      TempoMapSegment * seg = &segs[i];
+      seg->start_frames = frames;
+      seg->frames_per_tick = get_frames_per_tick (
+        seg->start_bpm, beats_per_bar, ticks_per_bar,
+        sample_rate);
+
+      /* the last segment is constant */
+      if (i == num_segments - 1)
+        {
+          seg->bpm_per_tick = 0.0;
+          break;
+        }
+
+      TempoMapSegment * next = &segs[i + 1];
+      double            len =
+        next->start_ticks - seg->start_ticks;
+      if (len > 0.0)
+        {
+          seg->bpm_per_tick =
+            (next->start_bpm - seg->start_bpm) / len;
+        }
+      else
+        {
+          seg->bpm_per_tick = 0.0;
+        }
+
+      /* convert the end of the segment using this
+       * segment alone */
+      TempoMap tmp = {
+        .segments = seg,
+        .num_segments = 1,
+      };
+      frames = tempo_map_ticks_to_frames (
+        &tmp, next->start_ticks);
+    }
+
+  TempoMap * self = object_new (TempoMap);
+  self->segments = segs;
+  self->num_segments = num_segments;
+  self->has_automation = num_points > 0;
+
+  return self;
+}
+
+bool
+tempo_map_is_equal (
+  const TempoMap * self,
+  const TempoMap * other)
+{
+  return self->num_segments == other->num_segments
+         && self->has_automation == other->has_automation
+         && memcmp (
+              self->segments, other->segments,
+              (size_t) self->num_segments
+                * sizeof (TempoMapSegment))
+              == 0;
+}
+
+/**
+ * Returns the last segment starting at or before
+ * the given ticks (or the first segment).
+ */
+static inline const TempoMapSegment *
+find_segment_by_ticks (
+  const TempoMap * self,
+  double           ticks)
+{
+  int lo = 0;
+  int hi = self->num_segments - 1;
+  while (lo < hi)
+    {
+      int mid = lo + (hi - lo + 1) / 2;
+      if (self->segments[mid].start_ticks <= ticks)
+        lo = mid;
+      else
+        hi = mid - 1;
+    }
+  return &self->segments[lo];
+}
+
+/**
+ * Returns the last segment starting at or before
+ * the given frames (or the first segment).
+ */
+static inline const TempoMapSegment *
+find_segment_by_frames (
+  const TempoMap * self,
+  double           frames)
+{
+  int lo = 0;
+  int hi = self->num_segments - 1;
+  while (lo < hi)
+    {
+      int mid = lo + (hi - lo + 1) / 2;
+      if (self->segments[mid].start_frames <= frames)
+        lo = mid;
+      else
+        hi = mid - 1;
+    }
+  return &self->segments[lo];
+}
+
+double
+tempo_map_get_bpm_at_ticks (
+  const TempoMap * self,
+  double           ticks)
+{
+  g_return_val_if_fail (self->num_segments > 0, 0.0);
+
+  const TempoMapSegment * seg =
+    find_segment_by_ticks (self, ticks);
+  double dticks = MAX (ticks - seg->start_ticks, 0.0);
+  return seg->start_bpm + seg->bpm_per_tick * dticks;
+}
+
+double
+tempo_map_ticks_to_frames (
+  const TempoMap * self,
+  double           ticks)
+{
+  g_return_val_if_fail (self->num_segments > 0, 0.0);
+
+  const TempoMapSegment * seg =
+    find_segment_by_ticks (self, ticks);
+  double dticks = ticks - seg->start_ticks;
+
+  /* constant tempo (also used before 0) */
+  if (seg->bpm_per_tick == 0.0 || dticks <= 0.0)
+    {
+      return seg->start_frames
+             + dticks * seg->frames_per_tick;
+    }
+
+  /* integral of frames_per_tick * start_bpm / bpm (t)
+   * over the ticks, with a linear bpm (t) */
+  double k = seg->bpm_per_tick;
+  return seg->start_frames
+         + seg->frames_per_tick * seg->start_bpm
+             * log1p (k * dticks / seg->start_bpm) / k;
+}
+
+double
+tempo_map_frames_to_ticks (
+  const TempoMap * self,
+  double           frames)
+{
+  g_return_val_if_fail (self->num_segments > 0, 0.0);
+
+  const TempoMapSegment * seg =
+    find_segment_by_frames (self, frames);
+  double dframes = frames - seg->start_frames;
+
+  if (seg->bpm_per_tick == 0.0 || dframes <= 0.0)
+    {
+      return seg->start_ticks
+             + dframes * (1.0 / seg->frames_per_tick);
+    }
+
+  /* inverse of tempo_map_ticks_to_frames() */
+  double k = seg->bpm_per_tick;
+  return seg->start_ticks
+         + seg->start_bpm
+             * expm1 (
+               k * dframes
+               / (seg->frames_per_tick * seg->start_bpm))
+             / k;
+}
+
+void
+tempo_map_free (TempoMap * self)
+{
+  object_zero_and_free_if_nonnull (self->segments);
+
+  object_zero_and_free (self);
+}
@@ -6,6 +6,7 @@
 #include "audio/automation_track.h"
 #include "audio/port.h"
 #include "audio/router.h"
+#include "audio/tempo_map.h"
 #include "audio/tempo_track.h"
 #include "audio/track.h"
 #include "gui/backend/event.h"
@@ -102,10 +103,15 @@ tempo_track_default (int track_pos)
 bpm_t
 tempo_track_get_bpm_at_pos (Track * self, Position * pos)
 {
-  AutomationTrack * at = automation_track_find_from_port_id (
-    &self->bpm_port->id, false);
-  return automation_track_get_val_at_pos (
-    at, pos, false, false);
+  const TempoMap * map =
+    g_atomic_pointer_get (&AUDIO_ENGINE->tempo_map);
+  if (map && map->has_automation)
+    {
+      return (bpm_t) tempo_map_get_bpm_at_ticks (
+        map, pos->ticks);
+    }
+
+  return tempo_track_get_current_bpm (self);
 }
 
 /**
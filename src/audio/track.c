@@ -1652,29 +1652,35 @@ track_generate_automation_tracks (Track * track)
 
   if (track_type_has_piano_roll (track->type))
     {
-      /* midi automatables */
+      /* midi automatables (the ports are only
+       * created on first use) */
+#define ADD_MIDI_CONTROL_AT(idx) \
+  { \
+    PortIdentifier id; \
+    track_processor_init_midi_control_port_id ( \
+      track->processor, &id, idx); \
+    at = automation_track_new_from_port_id (&id); \
+    port_identifier_free_members (&id); \
+    automation_tracklist_add_at (atl, at); \
+  }
+
       for (int i = 0; i < 16; i++)
         {
-          Port * cc = NULL;
           for (int j = 0; j < 128; j++)
             {
-              cc = track->processor->midi_cc[i * 128 + j];
-              at = automation_track_new (cc);
-              automation_tracklist_add_at (atl, at);
+              ADD_MIDI_CONTROL_AT (i * 128 + j);
             }
-
-          cc = track->processor->pitch_bend[i];
-          at = automation_track_new (cc);
-          automation_tracklist_add_at (atl, at);
-
-          cc = track->processor->poly_key_pressure[i];
-          at = automation_track_new (cc);
-          automation_tracklist_add_at (atl, at);
-
-          cc = track->processor->channel_pressure[i];
-          at = automation_track_new (cc);
-          automation_tracklist_add_at (atl, at);
+          ADD_MIDI_CONTROL_AT (
+            TRACK_PROCESSOR_MIDI_PITCH_BEND_OFFSET + i);
+          ADD_MIDI_CONTROL_AT (
+            TRACK_PROCESSOR_MIDI_POLY_KEY_PRESSURE_OFFSET
+            + i);
+          ADD_MIDI_CONTROL_AT (
+            TRACK_PROCESSOR_MIDI_CHANNEL_PRESSURE_OFFSET
+            + i);
         }
+
+#undef ADD_MIDI_CONTROL_AT
     }
 
   switch (track->type)
@@ -1855,6 +1861,10 @@ track_insert_region (
 
   if (add_at)
     {
+      /* MIDI control ports are created once they
+       * get automated */
+      automation_track_get_port (at, true);
+
       if (idx == -1)
         {
           automation_track_add_region (at, region);
@@ -2636,7 +2646,7 @@ track_update_positions (
  * @param midi_events MidiEvents to fill (from
  *   Piano Roll Port for example).
  */
-void
+bool
 track_fill_events (
   const Track *                       self,
   const EngineProcessTimeInfo * const time_nfo,
@@ -2644,7 +2654,9 @@ track_fill_events (
   StereoPorts *                       stereo_ports)
 {
   if (!track_is_auditioner (self) && !TRANSPORT_IS_ROLLING)
-    return;
+    return false;
+
+  bool filled = false;
 
   const unsigned_frame_t g_end_frames =
     time_nfo->g_start_frame + time_nfo->nframes;
@@ -2673,7 +2685,7 @@ track_fill_events (
       if (tt != TRACK_TYPE_CHORD)
         {
           lane = self->lanes[j];
-          g_return_if_fail (lane);
+          g_return_val_if_fail (lane, true);
         }
 
       /* go through each region */
@@ -2688,7 +2700,7 @@ track_fill_events (
               ? self->chord_regions[i]
               : lane->regions[i];
           ArrangerObject * r_obj = (ArrangerObject *) r;
-          g_return_if_fail (IS_REGION (r));
+          g_return_val_if_fail (IS_REGION (r), true);
 
           /* skip region if muted */
           if (arranger_object_get_muted (r_obj, true))
@@ -2721,6 +2733,7 @@ track_fill_events (
               - (signed_frame_t) time_nfo->g_start_frame,
             (signed_frame_t) time_nfo->nframes);
           nframes_t frames_processed = 0;
+          filled = true;
 
           while (num_frames_to_process > 0)
             {
@@ -2802,13 +2815,15 @@ track_fill_events (
 
   if (midi_events)
     {
-      midi_events_clear_duplicates (midi_events, F_QUEUED);
-
-      /* sort events */
-      midi_events_sort (midi_events, F_QUEUED);
+      /* merge the sorted runs of each region and
+       * clear duplicates */
+      midi_events_sort_and_clear_duplicates (
+        midi_events, F_QUEUED);
 
       zix_sem_post (&midi_events->access_sem);
     }
+
+  return filled;
 }
 
 /**
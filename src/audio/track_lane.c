@@ -8,6 +8,7 @@
 #include "audio/track.h"
 #include "audio/track_lane.h"
 #include "audio/tracklist.h"
+#include "gui/backend/arranger_object_index.h"
 #include "gui/backend/event.h"
 #include "gui/backend/event_manager.h"
 #include "gui/widgets/arranger.h"
@@ -297,6 +298,9 @@ track_lane_insert_region (
   region->id.idx = idx;
   region_update_identifier (region);
 
+  if (self->region_index)
+    arranger_object_index_invalidate (self->region_index);
+
   if (region->id.type == REGION_TYPE_AUDIO)
     {
       AudioClip * clip = audio_region_get_clip (region);
@@ -445,6 +449,9 @@ track_lane_remove_region (TrackLane * self, ZRegion * region)
     self->regions, self->num_regions, region, deleted);
   g_return_if_fail (deleted);
 
+  if (self->region_index)
+    arranger_object_index_invalidate (self->region_index);
+
   for (int i = region->id.idx; i < self->num_regions; i++)
     {
       ZRegion * r = self->regions[i];
@@ -586,6 +593,8 @@ track_lane_free (TrackLane * self)
     }
 
   object_zero_and_free_if_nonnull (self->regions);
+  object_free_w_func_and_null (
+    arranger_object_index_free, self->region_index);
 
   /* FIXME this is bad design - this object should
    * not care about widgets */
@@ -21,6 +21,7 @@
 
 #include "audio/audio_region.h"
 #include "audio/audio_track.h"
+#include "audio/automation_tracklist.h"
 #include "audio/channel.h"
 #include "audio/clip.h"
 #include "audio/control_port.h"
@@ -30,7 +31,9 @@
 #include "audio/midi_event.h"
 #include "audio/midi_mapping.h"
 #include "audio/midi_track.h"
+#include "audio/port_connections_manager.h"
 #include "audio/recording_manager.h"
+#include "audio/router.h"
 #include "audio/track.h"
 #include "project.h"
 #include "settings/settings.h"
@@ -44,34 +47,198 @@
 
 #include <glib/gi18n.h>
 
+/**
+ * Returns whether the track processor has MIDI
+ * control ports (created or not).
+ */
+static bool
+has_midi_controls (const TrackProcessor * self)
+{
+  Track * tr = self->track;
+  return track_type_has_piano_roll (tr->type)
+         && tr->type != TRACK_TYPE_CHORD;
+}
+
+/**
+ * Returns the slot of the MIDI control port at the
+ * given MIDI control index.
+ */
+static inline Port **
+get_midi_control_slot (TrackProcessor * self, int idx)
+{
+  if (idx < TRACK_PROCESSOR_MIDI_PITCH_BEND_OFFSET)
+    return &self->midi_cc[idx];
+  else if (
+    idx < TRACK_PROCESSOR_MIDI_POLY_KEY_PRESSURE_OFFSET)
+    return &self->pitch_bend
+      [idx - TRACK_PROCESSOR_MIDI_PITCH_BEND_OFFSET];
+  else if (idx < TRACK_PROCESSOR_MIDI_CHANNEL_PRESSURE_OFFSET)
+    return &self->poly_key_pressure
+      [idx - TRACK_PROCESSOR_MIDI_POLY_KEY_PRESSURE_OFFSET];
+  else
+    return &self->channel_pressure
+      [idx - TRACK_PROCESSOR_MIDI_CHANNEL_PRESSURE_OFFSET];
+}
+
+/**
+ * Returns the MIDI control port at the given MIDI
+ * control index, if created.
+ *
+ * The ports may be created while the processing
+ * thread reads them, so they are read atomically.
+ */
+static inline Port *
+get_midi_control (const TrackProcessor * self, int idx)
+{
+  Port ** slot =
+    get_midi_control_slot ((TrackProcessor *) self, idx);
+  return (Port *) g_atomic_pointer_get (slot);
+}
+
+/**
+ * Publishes the MIDI control port at the given MIDI
+ * control index.
+ */
+static inline void
+set_midi_control (
+  TrackProcessor * self,
+  int              idx,
+  Port *           port)
+{
+  Port ** slot = get_midi_control_slot (self, idx);
+  g_atomic_pointer_set (slot, port);
+}
+
+/**
+ * Returns the MIDI control index of the given MIDI
+ * control port identifier.
+ */
+static inline int
+get_midi_control_idx (const PortIdentifier * id)
+{
+  if (id->flags2 & PORT_FLAG2_MIDI_PITCH_BEND)
+    return TRACK_PROCESSOR_MIDI_PITCH_BEND_OFFSET
+           + id->port_index;
+  else if (id->flags2 & PORT_FLAG2_MIDI_POLY_KEY_PRESSURE)
+    return TRACK_PROCESSOR_MIDI_POLY_KEY_PRESSURE_OFFSET
+           + id->port_index;
+  else if (id->flags2 & PORT_FLAG2_MIDI_CHANNEL_PRESSURE)
+    return TRACK_PROCESSOR_MIDI_CHANNEL_PRESSURE_OFFSET
+           + id->port_index;
+  else
+    return id->port_index;
+}
+
+/**
+ * Marks the MIDI control matching the given port
+ * identifier as used, if it belongs to the track
+ * with the given name hash.
+ */
+static void
+mark_midi_control_used (
+  bool *                 used,
+  const PortIdentifier * id,
+  unsigned int           track_name_hash)
+{
+  if (
+    !(id->flags & PORT_FLAG_MIDI_AUTOMATABLE)
+    || id->owner_type != PORT_OWNER_TYPE_TRACK_PROCESSOR
+    || id->track_name_hash != track_name_hash)
+    return;
+
+  int idx = get_midi_control_idx (id);
+  if (idx >= 0 && idx < TRACK_PROCESSOR_NUM_MIDI_CONTROLS)
+    used[idx] = true;
+}
+
+/**
+ * Frees the loaded MIDI control ports that are not
+ * automated and not targeted by any MIDI mapping or
+ * port connection.
+ *
+ * Projects and templates saved before these ports
+ * were created on first use contain all of them.
+ */
+static void
+prune_unused_midi_controls (TrackProcessor * self)
+{
+  Track *      track = self->track;
+  unsigned int name_hash = track_get_name_hash (track);
+  bool *       used =
+    object_new_n (TRACK_PROCESSOR_NUM_MIDI_CONTROLS, bool);
+
+  AutomationTracklist * atl =
+    track_get_automation_tracklist (track);
+  for (int i = 0; atl && i < atl->num_ats; i++)
+    {
+      const AutomationTrack * at = atl->ats[i];
+      if (at->created || at->num_regions > 0)
+        {
+          mark_midi_control_used (
+            used, &at->port_id, name_hash);
+        }
+    }
+
+  if (PROJECT && MIDI_MAPPINGS)
+    {
+      for (int i = 0; i < MIDI_MAPPINGS->num_mappings; i++)
+        {
+          mark_midi_control_used (
+            used, &MIDI_MAPPINGS->mappings[i]->dest_id,
+            name_hash);
+        }
+    }
+
+  if (PROJECT && PORT_CONNECTIONS_MGR)
+    {
+      PortConnectionsManager * mgr = PORT_CONNECTIONS_MGR;
+      for (int i = 0; i < mgr->num_connections; i++)
+        {
+          mark_midi_control_used (
+            used, mgr->connections[i]->dest_id, name_hash);
+        }
+    }
+
+  int num_pruned = 0;
+  for (int i = 0; i < TRACK_PROCESSOR_NUM_MIDI_CONTROLS;
+       i++)
+    {
+      Port * port = get_midi_control (self, i);
+      if (!port || used[i])
+        continue;
+
+      set_midi_control (self, i, NULL);
+      port_free (port);
+      num_pruned++;
+    }
+  object_zero_and_free (used);
+
+  if (num_pruned > 0)
+    {
+      g_debug (
+        "%s: pruned %d unused MIDI control ports",
+        track->name, num_pruned);
+    }
+}
+
 static void
 init_common (TrackProcessor * self)
 {
-  if (self->midi_cc[0])
+  if (has_midi_controls (self))
     {
-      self->cc_mappings = midi_mappings_new ();
+      self->midi_controls_changed = object_new_n (
+        TRACK_PROCESSOR_MIDI_CONTROLS_CHANGED_WORDS, guint);
 
-      for (size_t i = 0; i < 16; i++)
+      /* send the values of any loaded controls in
+       * the first cycle */
+      for (int i = 0; i < TRACK_PROCESSOR_NUM_MIDI_CONTROLS;
+           i++)
         {
-          for (size_t j = 0; j < 128; j++)
+          Port * port = get_midi_control (self, i);
+          if (port)
             {
-              Port * cc_port = self->midi_cc[i * 128 + j];
-              g_return_if_fail (cc_port);
-
-              /* set model bytes for CC:
-               * [0] = ctrl change + channel
-               * [1] = controller
-               * [2] (unused) = control */
-              midi_byte_t buf[3];
-              buf[0] =
-                (midi_byte_t) (MIDI_CH1_CTRL_CHANGE | (midi_byte_t) i);
-              buf[1] = (midi_byte_t) j;
-              buf[2] = 0;
-
-              /* bind */
-              midi_mappings_bind_track (
-                self->cc_mappings, buf, cc_port,
-                F_NO_PUBLISH_EVENTS);
+              track_processor_mark_midi_control_changed (
+                self, port);
             }
         }
     }
@@ -88,6 +255,11 @@ track_processor_init_loaded (
   self->magic = TRACK_PROCESSOR_MAGIC;
   self->track = track;
 
+  if (has_midi_controls (self))
+    {
+      prune_unused_midi_controls (self);
+    }
+
   GPtrArray * ports = g_ptr_array_new ();
   track_processor_append_ports (self, ports);
   for (size_t i = 0; i < ports->len; i++)
@@ -136,69 +308,137 @@ init_midi_port (TrackProcessor * self, int in)
     }
 }
 
-static void
-init_midi_cc_ports (TrackProcessor * self, int loading)
+void
+track_processor_init_midi_control_port_id (
+  TrackProcessor * self,
+  PortIdentifier * id,
+  int              idx)
 {
-#define INIT_MIDI_PORT(x, idx) \
-  x->id.flags |= PORT_FLAG_MIDI_AUTOMATABLE; \
-  x->id.flags |= PORT_FLAG_AUTOMATABLE; \
-  x->id.port_index = idx;
-
-  char name[400];
-  for (int i = 0; i < 16; i++)
+  g_return_if_fail (
+    idx >= 0 && idx < TRACK_PROCESSOR_NUM_MIDI_CONTROLS);
+
+  port_identifier_init (id);
+  id->type = TYPE_CONTROL;
+  id->flow = FLOW_INPUT;
+  id->owner_type = PORT_OWNER_TYPE_TRACK_PROCESSOR;
+  id->track_name_hash = track_get_name_hash (self->track);
+  id->flags |= PORT_FLAG_MIDI_AUTOMATABLE;
+  id->flags |= PORT_FLAG_AUTOMATABLE;
+
+  if (idx < TRACK_PROCESSOR_MIDI_PITCH_BEND_OFFSET)
     {
       /* starting from 1 */
-      int channel = i + 1;
+      int channel = idx / 128 + 1;
+      int cc = idx % 128;
+      id->label = g_strdup_printf (
+        "Ch%d %s", channel,
+        midi_get_controller_name ((midi_byte_t) cc));
+      id->sym = g_strdup_printf (
+        "midi_controller_ch%d_%d", channel, cc + 1);
+      id->port_index = idx;
+    }
+  else if (
+    idx < TRACK_PROCESSOR_MIDI_POLY_KEY_PRESSURE_OFFSET)
+    {
+      int i = idx - TRACK_PROCESSOR_MIDI_PITCH_BEND_OFFSET;
+      id->label = g_strdup_printf ("Ch%d Pitch bend", i + 1);
+      id->sym = g_strdup_printf ("ch%d_pitch_bend", i + 1);
+      id->flags2 |= PORT_FLAG2_MIDI_PITCH_BEND;
+      id->port_index = i;
+    }
+  else if (
+    idx < TRACK_PROCESSOR_MIDI_CHANNEL_PRESSURE_OFFSET)
+    {
+      int i =
+        idx - TRACK_PROCESSOR_MIDI_POLY_KEY_PRESSURE_OFFSET;
+      id->label =
+        g_strdup_printf ("Ch%d Poly key pressure", i + 1);
+      id->sym =
+        g_strdup_printf ("ch%d_poly_key_pressure", i + 1);
+      id->flags2 |= PORT_FLAG2_MIDI_POLY_KEY_PRESSURE;
+      id->port_index = i;
+    }
+  else
+    {
+      int i =
+        idx - TRACK_PROCESSOR_MIDI_CHANNEL_PRESSURE_OFFSET;
+      id->label =
+        g_strdup_printf ("Ch%d Channel pressure", i + 1);
+      id->sym =
+        g_strdup_printf ("ch%d_channel_pressure", i + 1);
+      id->flags2 |= PORT_FLAG2_MIDI_CHANNEL_PRESSURE;
+      id->port_index = i;
+    }
+}
 
-      for (int j = 0; j < 128; j++)
-        {
-          sprintf (
-            name, "Ch%d %s", channel,
-            midi_get_controller_name (j));
-          Port * cc = port_new_with_type_and_owner (
-            TYPE_CONTROL, FLOW_INPUT, name,
-            PORT_OWNER_TYPE_TRACK_PROCESSOR, self);
-          INIT_MIDI_PORT (cc, i * 128 + j);
-          cc->id.sym = g_strdup_printf (
-            "midi_controller_ch%d_%d", channel, j + 1);
-          self->midi_cc[i * 128 + j] = cc;
-        }
+/**
+ * Creates the MIDI control port at the given MIDI
+ * control index.
+ */
+static Port *
+create_midi_control_port (TrackProcessor * self, int idx)
+{
+  PortIdentifier id;
+  track_processor_init_midi_control_port_id (
+    self, &id, idx);
 
-      sprintf (name, "Ch%d Pitch bend", i + 1);
-      Port * cc = port_new_with_type_and_owner (
-        TYPE_CONTROL, FLOW_INPUT, name,
-        PORT_OWNER_TYPE_TRACK_PROCESSOR, self);
-      cc->id.sym = g_strdup_printf ("ch%d_pitch_bend", i + 1);
-      INIT_MIDI_PORT (cc, i);
-      cc->maxf = 8191.f;
-      cc->minf = -8192.f;
-      cc->deff = 0.f;
-      cc->zerof = 0.f;
-      cc->id.flags2 |= PORT_FLAG2_MIDI_PITCH_BEND;
-      self->pitch_bend[i] = cc;
-
-      sprintf (name, "Ch%d Poly key pressure", i + 1);
-      cc = port_new_with_type_and_owner (
-        TYPE_CONTROL, FLOW_INPUT, name,
-        PORT_OWNER_TYPE_TRACK_PROCESSOR, self);
-      cc->id.sym =
-        g_strdup_printf ("ch%d_poly_key_pressure", i + 1);
-      INIT_MIDI_PORT (cc, i);
-      cc->id.flags2 |= PORT_FLAG2_MIDI_POLY_KEY_PRESSURE;
-      self->poly_key_pressure[i] = cc;
+  Port * port = port_new_with_type_and_owner (
+    TYPE_CONTROL, FLOW_INPUT, id.label,
+    PORT_OWNER_TYPE_TRACK_PROCESSOR, self);
+  port_identifier_copy (&port->id, &id);
+  port_identifier_free_members (&id);
 
-      sprintf (name, "Ch%d Channel pressure", i + 1);
-      cc = port_new_with_type_and_owner (
-        TYPE_CONTROL, FLOW_INPUT, name,
-        PORT_OWNER_TYPE_TRACK_PROCESSOR, self);
-      cc->id.sym =
-        g_strdup_printf ("ch%d_channel_pressure", i + 1);
-      INIT_MIDI_PORT (cc, i);
-      cc->id.flags2 |= PORT_FLAG2_MIDI_CHANNEL_PRESSURE;
-      self->channel_pressure[i] = cc;
+  if (port->id.flags2 & PORT_FLAG2_MIDI_PITCH_BEND)
+    {
+      port->maxf = 8191.f;
+      port->minf = -8192.f;
+      port->deff = 0.f;
+      port->zerof = 0.f;
     }
 
-#undef INIT_MIDI_PORT
+  return port;
+}
+
+Port *
+track_processor_get_midi_control_port (
+  TrackProcessor *       self,
+  const PortIdentifier * id,
+  bool                   create)
+{
+  g_return_val_if_fail (
+    id->flags & PORT_FLAG_MIDI_AUTOMATABLE
+      && has_midi_controls (self),
+    NULL);
+
+  int idx = get_midi_control_idx (id);
+  g_return_val_if_fail (
+    idx >= 0 && idx < TRACK_PROCESSOR_NUM_MIDI_CONTROLS,
+    NULL);
+
+  Port * port = get_midi_control (self, idx);
+  if (port || !create)
+    return port;
+
+  /* the processing thread may be reading the
+   * slot */
+  port = create_midi_control_port (self, idx);
+  set_midi_control (self, idx, port);
+
+  return port;
+}
+
+void
+track_processor_mark_midi_control_changed (
+  const TrackProcessor * self,
+  const Port *           port)
+{
+  if (G_UNLIKELY (!self->midi_controls_changed))
+    return;
+
+  int idx = get_midi_control_idx (&port->id);
+  g_atomic_int_or (
+    &self->midi_controls_changed[idx / 32],
+    1u << (idx % 32));
 }
 
 /**
@@ -274,10 +514,6 @@ track_processor_new (Track * tr)
           self->piano_roll->id.sym =
             g_strdup ("track_processor_piano_roll");
           self->piano_roll->id.flags = PORT_FLAG_PIANO_ROLL;
-          if (tr->type != TRACK_TYPE_CHORD)
-            {
-              init_midi_cc_ports (self, false);
-            }
         }
       break;
     case TYPE_AUDIO:
@@ -760,64 +996,101 @@ handle_recording (
 /**
  * Adds events to midi out based on any changes in
  * MIDI CC control ports.
+ *
+ * Only the controls marked as changed in
+ * TrackProcessor.midi_controls_changed are
+ * checked.
  */
 static inline void
 add_events_from_midi_cc_control_ports (
   const TrackProcessor * self,
   const nframes_t        local_offset)
 {
-  /* FIXME optimize (use caches) */
-  for (int i = 0; i < 16; i++)
+  for (int i = 0;
+       i < TRACK_PROCESSOR_MIDI_CONTROLS_CHANGED_WORDS; i++)
     {
-      /* starting from 1 */
-      int    channel = i + 1;
-      Port * cc = NULL;
-      int    offset = i * 128;
-      for (int j = 0; j < 128; j++)
+      guint * word = &self->midi_controls_changed[i];
+      if (G_LIKELY (g_atomic_int_get (word) == 0))
+        continue;
+
+      guint bits = g_atomic_int_and (word, 0);
+      for (int bit = g_bit_nth_lsf (bits, -1); bit >= 0;
+           bit = g_bit_nth_lsf (bits, bit))
         {
-          cc = self->midi_cc[offset + j];
-          if (G_LIKELY (math_floats_equal (
-                cc->last_sent_control, cc->control)))
+          int    idx = i * 32 + bit;
+          Port * cc = get_midi_control (self, idx);
+          if (
+            !cc
+            || math_floats_equal (
+              cc->last_sent_control, cc->control))
             continue;
 
-          midi_events_add_control_change (
-            self->midi_out->midi_events, channel,
-            (midi_byte_t) j,
-            (midi_byte_t) math_round_float_to_signed_32 (
-              cc->control * 127.f),
-            local_offset, false);
+          if (idx < TRACK_PROCESSOR_MIDI_PITCH_BEND_OFFSET)
+            {
+              /* starting from 1 */
+              int channel = idx / 128 + 1;
+              midi_events_add_control_change (
+                self->midi_out->midi_events, channel,
+                (midi_byte_t) (idx % 128),
+                (midi_byte_t)
+                  math_round_float_to_signed_32 (
+                    cc->control * 127.f),
+                local_offset, false);
+            }
+          else if (
+            idx
+            < TRACK_PROCESSOR_MIDI_POLY_KEY_PRESSURE_OFFSET)
+            {
+              int channel =
+                idx - TRACK_PROCESSOR_MIDI_PITCH_BEND_OFFSET
+                + 1;
+              midi_events_add_pitchbend (
+                self->midi_out->midi_events, channel,
+                math_round_float_to_signed_32 (cc->control),
+                local_offset, false);
+            }
+          else
+            {
+              /* TODO poly key pressure and channel
+               * pressure */
+              continue;
+            }
           cc->last_sent_control = cc->control;
         }
+    }
+}
 
-      cc = self->pitch_bend[i];
-      if (!math_floats_equal (
-            cc->last_sent_control, cc->control))
-        {
-          midi_events_add_pitchbend (
-            self->midi_out->midi_events, channel,
-            math_round_float_to_signed_32 (cc->control),
-            local_offset, false);
-          cc->last_sent_control = cc->control;
-        }
+/**
+ * Applies the CC events in the MIDI input to the
+ * corresponding MIDI CC control ports.
+ *
+ * Controls that were never used have no port yet
+ * and are skipped.
+ */
+static void
+apply_midi_in_cc_events (const TrackProcessor * self)
+{
+  MidiEvents * events = self->midi_in->midi_events;
+  for (int i = 0; i < events->num_events; i++)
+    {
+      midi_byte_t * buf = events->events[i].raw_buffer;
+      if (!midi_is_controller (buf))
+        continue;
 
-        /* TODO */
-#if 0
-      cc = self->poly_key_pressure[i];
-      midi_events_add_pitchbend (
-        self->midi_out->midi_events,
-        channel,
-        math_round_float_to_int (cc->control),
-        local_offset, false);
-      cc->last_sent_control = cc->control;
+      Port * cc = get_midi_control (
+        self, (buf[0] & 0xf) * 128
+                + midi_get_controller_number (buf));
+      if (!cc)
+        continue;
 
-      cc = self->channel_pressure[i];
-      midi_events_add_pitchbend (
-        self->midi_out->midi_events,
-        channel,
-        math_round_float_to_int (cc->control),
-        local_offset, false);
-      cc->last_sent_control = cc->control;
-#endif
+      /* coalesce bursts of CC messages - only the
+       * last value per cycle is applied */
+      float normalized_val =
+        (float) midi_get_controller_value (buf) / 127.f;
+      router_queue_control_value (
+        ROUTER, cc,
+        cc->minf + normalized_val * (cc->maxf - cc->minf),
+        F_PUBLISH_EVENTS);
     }
 }
 
@@ -859,10 +1132,15 @@ track_processor_process (
       return;
     }
 
+  /* whether anything was written to the stereo
+   * out ports in this range */
+  bool stereo_out_written = false;
+
   /* set the audio clip contents to stereo out */
   if (tr->type == TRACK_TYPE_AUDIO)
     {
-      track_fill_events (tr, time_nfo, NULL, self->stereo_out);
+      stereo_out_written = track_fill_events (
+        tr, time_nfo, NULL, self->stereo_out);
     }
 
   /* set the piano roll contents to midi out */
@@ -980,11 +1258,18 @@ track_processor_process (
   switch (tr->in_signal_type)
     {
     case TYPE_AUDIO:
+      /* skip if the input is known to be silent */
+      if (
+        port_is_silent (self->stereo_in->l)
+        && port_is_silent (self->stereo_in->r))
+        break;
+
       if (tr->type != TRACK_TYPE_AUDIO ||
           (tr->type == TRACK_TYPE_AUDIO &&
              control_port_is_toggled (
                self->monitor_audio)))
         {
+          stereo_out_written = true;
           dsp_mix2 (
             &self->stereo_out->l->buf[local_offset],
             &self->stereo_in->l->buf[local_offset], 1.f,
@@ -1022,12 +1307,10 @@ track_processor_process (
             self->midi_in->midi_events, 0, tr->midi_ch);
         }
 
-      /* process midi bindings */
-      if (self->cc_mappings && TRANSPORT->recording)
+      /* apply incoming CCs to the CC ports */
+      if (self->midi_controls_changed && TRANSPORT->recording)
         {
-          midi_mappings_apply_from_cc_events (
-            self->cc_mappings, self->midi_in->midi_events,
-            F_NOT_QUEUED);
+          apply_midi_in_cc_events (self);
         }
 
       /* if chord track, transform MIDI input to
@@ -1064,12 +1347,12 @@ track_processor_process (
        * input content to the output ports.
        * this will also create automation for MIDI
        * CC, if any (see
-       * midi_mappings_apply_cc_events above) */
+       * apply_midi_in_cc_events() above) */
       handle_recording (self, time_nfo);
     }
 
   /* apply output gain */
-  if (tr->type == TRACK_TYPE_AUDIO)
+  if (tr->type == TRACK_TYPE_AUDIO && stereo_out_written)
     {
       dsp_mul_k2 (
         &self->stereo_out->l->buf[local_offset],
@@ -1079,6 +1362,14 @@ track_processor_process (
         self->output_gain->control, nframes);
     }
 
+  if (self->stereo_out)
+    {
+      port_update_silence (
+        self->stereo_out->l, !stereo_out_written);
+      port_update_silence (
+        self->stereo_out->r, !stereo_out_written);
+    }
+
 #undef g_start_frames
 #undef local_offset
 #undef nframes
@@ -1109,6 +1400,27 @@ track_processor_copy_values (
     {
       dest->mono->control = src->mono->control;
     }
+
+  /* create the MIDI controls used in src */
+  if (
+    src->midi_controls_changed
+    && dest->midi_controls_changed)
+    {
+      for (int i = 0; i < TRACK_PROCESSOR_NUM_MIDI_CONTROLS;
+           i++)
+        {
+          Port * src_port = get_midi_control (src, i);
+          if (!src_port)
+            continue;
+
+          Port * dest_port =
+            track_processor_get_midi_control_port (
+              dest, &src_port->id, true);
+          dest_port->control = src_port->control;
+          track_processor_mark_midi_control_changed (
+            dest, dest_port);
+        }
+    }
 }
 
 /**
@@ -1303,8 +1615,8 @@ track_processor_connect_to_plugin (
 void
 track_processor_free (TrackProcessor * self)
 {
-  object_free_w_func_and_null (
-    midi_mappings_free, self->cc_mappings);
+  object_zero_and_free_if_nonnull (
+    self->midi_controls_changed);
 
   if (IS_PORT_AND_NONNULL (self->mono))
     {
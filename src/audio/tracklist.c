@@ -43,6 +43,7 @@ tracklist_init_loaded (
 {
   self->project = project;
   self->sample_processor = sample_processor;
+  tracklist_mark_solo_caches_dirty (self);
 
   g_message ("initializing loaded Tracklist...");
   for (int i = 0; i < self->num_tracks; i++)
@@ -331,7 +332,16 @@ tracklist_insert_track (
             {
               AutomationTrack * at = atl->ats[i];
               Port *            port =
-                port_find_from_identifier (&at->port_id);
+                automation_track_get_port (at, false);
+
+              /* MIDI control ports are only created
+               * on first use */
+              if (
+                !port
+                && at->port_id.flags
+                     & PORT_FLAG_MIDI_AUTOMATABLE)
+                continue;
+
               g_return_if_fail (IS_PORT_AND_NONNULL (port));
               port->at = at;
             }
@@ -1074,6 +1084,50 @@ tracklist_has_listened (const Tracklist * self)
   return false;
 }
 
+/**
+ * Marks the solo/listen caches as dirty so that
+ * they get refreshed at the start of the next
+ * cycle.
+ */
+void
+tracklist_mark_solo_caches_dirty (Tracklist * self)
+{
+  g_atomic_int_set (&self->solo_caches_dirty, 1);
+}
+
+/**
+ * Refreshes the solo/listen caches if dirty.
+ *
+ * To be called at the start of each cycle.
+ */
+void
+tracklist_update_solo_caches (Tracklist * self)
+{
+  if (!g_atomic_int_compare_and_exchange (
+        &self->solo_caches_dirty, 1, 0))
+    return;
+
+  bool has_soloed = false;
+  bool has_listened = false;
+  for (int i = 0; i < self->num_tracks; i++)
+    {
+      Track * track = self->tracks[i];
+      if (!track->channel)
+        continue;
+
+      Fader * fader = track->channel->fader;
+      fader->soloed = fader_get_soloed (fader);
+      fader->implied_soloed =
+        fader_get_implied_soloed (fader);
+      has_soloed = has_soloed || fader->soloed;
+      has_listened =
+        has_listened || fader_get_listened (fader);
+    }
+
+  self->has_soloed_cached = has_soloed;
+  self->has_listened_cached = has_listened;
+}
+
 int
 tracklist_get_num_muted_tracks (const Tracklist * self)
 {
@@ -1237,6 +1291,11 @@ tracklist_import_files (
 {
   GPtrArray * file_arr = g_ptr_array_new_with_free_func (
     (GDestroyNotify) supported_file_free);
+
+  /* MIDI file tracks of the current file */
+  MidiFileTrack * mf_tracks = NULL;
+  int             num_mf_tracks = 0;
+
   if (orig_file)
     {
       SupportedFile * file = supported_file_clone (orig_file);
@@ -1311,8 +1370,13 @@ tracklist_import_files (
       int num_nonempty_midi_tracks = 0;
       if (track_type == TRACK_TYPE_MIDI)
         {
+          /* parse all tracks once */
+          mf_tracks = midi_file_read_tracks (
+            file->abs_path, transport_get_ppqn (TRANSPORT),
+            &num_mf_tracks);
           num_nonempty_midi_tracks =
-            midi_file_get_num_tracks (file->abs_path, true);
+            midi_file_tracks_get_num_with_data (
+              mf_tracks, num_mf_tracks);
           if (num_nonempty_midi_tracks == 0)
             {
               if (ZRYTHM_HAVE_UI)
@@ -1400,10 +1464,19 @@ tracklist_import_files (
                     lane_pos, idx_in_lane);
                   break;
                 case TRACK_TYPE_MIDI:
-                  region = midi_region_new_from_midi_file (
-                    pos, file->abs_path,
-                    track_get_name_hash (track), lane_pos,
-                    idx_in_lane, 0);
+                  {
+                    const MidiFileTrack * mf_track =
+                      midi_file_tracks_get_nth_with_data (
+                        mf_tracks, num_mf_tracks, 0);
+                    if (!mf_track)
+                      break;
+
+                    region =
+                      midi_region_new_from_midi_file_track (
+                        pos, mf_track,
+                        track_get_name_hash (track),
+                        lane_pos, idx_in_lane);
+                  }
                   break;
                 default:
                   break;
@@ -1461,9 +1534,19 @@ tracklist_import_files (
         {
           g_warning ("operation not supported yet");
         }
+
+      if (mf_tracks)
+        {
+          midi_file_tracks_free (mf_tracks, num_mf_tracks);
+          mf_tracks = NULL;
+        }
     } /* foreach file */
 
 free_file_array_and_return:
+  if (mf_tracks)
+    {
+      midi_file_tracks_free (mf_tracks, num_mf_tracks);
+    }
   g_ptr_array_unref (file_arr);
 
   return;
@@ -1867,6 +1950,7 @@ tracklist_new (
   self->schema_version = TRACKLIST_SCHEMA_VERSION;
   self->project = project;
   self->sample_processor = sample_processor;
+  self->solo_caches_dirty = 1;
 
   if (project)
     {
@@ -12,7 +12,9 @@
 #include "audio/midi_region.h"
 #include "audio/router.h"
 #include "audio/stretcher.h"
+#include "audio/tempo_map.h"
 #include "gui/backend/arranger_object.h"
+#include "gui/backend/arranger_object_index.h"
 #include "gui/backend/automation_selections.h"
 #include "gui/backend/chord_selections.h"
 #include "gui/backend/event.h"
@@ -70,9 +72,27 @@
       func (CHORD_OBJECT, ChordObject, chord_object) func ( \
         AUTOMATION_POINT, AutomationPoint, automation_point)
 
+/**
+ * Returns the version of the current tempo map, or
+ * 0 if there is none.
+ */
+static guint
+get_tempo_map_version (void)
+{
+  if (!PROJECT || !AUDIO_ENGINE)
+    return 0;
+
+  const TempoMap * map =
+    g_atomic_pointer_get (&AUDIO_ENGINE->tempo_map);
+  return map ? map->version : 0;
+}
+
 void
 arranger_object_init (ArrangerObject * self)
 {
+  /* positions are set with the current tempo map */
+  self->frames_tempo_map_version = get_tempo_map_version ();
+
   self->schema_version = ARRANGER_OBJECT_SCHEMA_VERSION;
   self->magic = ARRANGER_OBJECT_MAGIC;
 
@@ -371,38 +391,69 @@ arranger_object_is_selected (ArrangerObject * self)
 }
 
 /**
- * If the object is part of a ZRegion, returns it,
- * otherwise returns NULL.
+ * Returns the identifier of the ZRegion the object
+ * is part of, or NULL if it is not part of one.
  */
-ZRegion *
-arranger_object_get_region (const ArrangerObject * const self)
+static const RegionIdentifier *
+get_region_id (const ArrangerObject * const self)
 {
-  const RegionIdentifier * id = NULL;
   switch (self->type)
     {
     case ARRANGER_OBJECT_TYPE_AUTOMATION_POINT:
     case ARRANGER_OBJECT_TYPE_MIDI_NOTE:
     case ARRANGER_OBJECT_TYPE_CHORD_OBJECT:
-      id = &self->region_id;
-      break;
+      return &self->region_id;
     case ARRANGER_OBJECT_TYPE_VELOCITY:
       {
         Velocity *       vel = (Velocity *) self;
         ArrangerObject * mn_obj =
           (ArrangerObject *) vel->midi_note;
-        id = &mn_obj->region_id;
+        return &mn_obj->region_id;
       }
-      break;
     default:
       return NULL;
-      break;
     }
+}
+
+/**
+ * If the object is part of a ZRegion, returns it,
+ * otherwise returns NULL.
+ */
+ZRegion *
+arranger_object_get_region (const ArrangerObject * const self)
+{
+  const RegionIdentifier * id = get_region_id (self);
+  if (!id)
+    return NULL;
 
   ZRegion * region = region_find (id);
 
   return region;
 }
 
+/**
+ * Marks the contents of the region drawn with the
+ * object as changed (the region itself if @ref self
+ * is a region, otherwise the region it is part of).
+ *
+ * Does nothing if the region does not exist in the
+ * project (eg, if @ref self is a clone).
+ */
+void
+arranger_object_contents_changed (ArrangerObject * self)
+{
+  const RegionIdentifier * id =
+    self->type == ARRANGER_OBJECT_TYPE_REGION
+      ? &((ZRegion *) self)->id
+      : get_region_id (self);
+  if (!id)
+    return;
+
+  ZRegion * region = region_find_if_exists (id);
+  if (region)
+    region_contents_changed (region);
+}
+
 /**
  * Returns whether the given object is hit by the
  * given position or range.
@@ -661,6 +712,40 @@ arranger_object_copy_identifier (
     }
 }
 
+/**
+ * Reports a position change of the given object to
+ * the interval index of the lane it is in, if any.
+ */
+static void
+report_moved_to_lane_index (ArrangerObject * self)
+{
+  if (
+    self->type != ARRANGER_OBJECT_TYPE_REGION || !PROJECT
+    || !TRACKLIST)
+    return;
+
+  ZRegion * region = (ZRegion *) self;
+  if (!region_type_has_lane (region->id.type))
+    return;
+
+  Track * track = tracklist_find_track_by_name_hash (
+    TRACKLIST, region->id.track_name_hash);
+  if (!track || region->id.lane_pos >= track->num_lanes)
+    return;
+
+  /* only objects in the lane are indexed (not
+   * clones) */
+  TrackLane * lane = track->lanes[region->id.lane_pos];
+  if (
+    lane->region_index && region->id.idx >= 0
+    && region->id.idx < lane->num_regions
+    && lane->regions[region->id.idx] == region)
+    {
+      arranger_object_index_object_moved (
+        lane->region_index, self);
+    }
+}
+
 /**
  * Sets the Position  all of the object's linked
  * objects (see ArrangerObjectInfo)
@@ -691,6 +776,19 @@ arranger_object_set_position (
   pos_ptr = get_position_ptr (self, pos_type);
   g_return_if_fail (pos_ptr);
   position_set_to_pos (pos_ptr, pos);
+
+  if (self->type == ARRANGER_OBJECT_TYPE_REGION)
+    {
+      report_moved_to_lane_index (self);
+
+      /* moving or resizing a region does not change
+       * what is drawn inside it */
+      if (
+        pos_type == ARRANGER_OBJECT_POSITION_TYPE_START
+        || pos_type == ARRANGER_OBJECT_POSITION_TYPE_END)
+        return;
+    }
+  arranger_object_contents_changed (self);
 }
 
 /**
@@ -1156,6 +1254,10 @@ arranger_object_update_positions (
     }
 
   position_update (&self->pos, from_ticks, ratio);
+
+  /* the index only uses ticks */
+  if (!from_ticks)
+    report_moved_to_lane_index (self);
   if (arranger_object_type_has_length (self->type))
     {
       position_update (&self->end_pos, from_ticks, ratio);
@@ -1316,6 +1418,76 @@ arranger_object_update_positions (
     }
 }
 
+/**
+ * Recalculates the frames of all the positions of
+ * the object and its children from their ticks.
+ */
+static void
+update_frames_from_ticks (
+  ArrangerObject * self,
+  guint            version)
+{
+  position_update_frames_from_ticks (&self->pos, 0.0);
+  if (arranger_object_type_has_length (self->type))
+    {
+      position_update_frames_from_ticks (
+        &self->end_pos, 0.0);
+    }
+  if (arranger_object_type_can_loop (self->type))
+    {
+      position_update_frames_from_ticks (
+        &self->clip_start_pos, 0.0);
+      position_update_frames_from_ticks (
+        &self->loop_start_pos, 0.0);
+      position_update_frames_from_ticks (
+        &self->loop_end_pos, 0.0);
+    }
+  if (arranger_object_can_fade (self))
+    {
+      position_update_frames_from_ticks (
+        &self->fade_in_pos, 0.0);
+      position_update_frames_from_ticks (
+        &self->fade_out_pos, 0.0);
+    }
+  self->frames_tempo_map_version = version;
+
+  if (self->type != ARRANGER_OBJECT_TYPE_REGION)
+    return;
+
+  ZRegion * r = (ZRegion *) self;
+  for (int i = 0; i < r->num_midi_notes; i++)
+    {
+      update_frames_from_ticks (
+        (ArrangerObject *) r->midi_notes[i], version);
+    }
+  for (int i = 0; i < r->num_unended_notes; i++)
+    {
+      update_frames_from_ticks (
+        (ArrangerObject *) r->unended_notes[i], version);
+    }
+  for (int i = 0; i < r->num_aps; i++)
+    {
+      update_frames_from_ticks (
+        (ArrangerObject *) r->aps[i], version);
+    }
+  for (int i = 0; i < r->num_chord_objects; i++)
+    {
+      update_frames_from_ticks (
+        (ArrangerObject *) r->chord_objects[i], version);
+    }
+}
+
+void
+arranger_object_update_frames_if_stale (
+  ArrangerObject * self)
+{
+  guint version = get_tempo_map_version ();
+  if (G_LIKELY (self->frames_tempo_map_version == version))
+    return;
+
+  update_frames_from_ticks (self, version);
+}
+
 void
 arranger_object_append_children (
   ArrangerObject * self,
@@ -3694,6 +3866,7 @@ free_region (ZRegion * self)
       object_free_w_func_and_null (
         g_object_unref, self->layout);
     }
+  region_free_contents_cache (self);
 
 #undef FREE_R
 
@@ -3756,6 +3929,7 @@ arranger_object_free (ArrangerObject * self)
           gsk_render_node_unref, ap->cairo_node);
         object_free_w_func_and_null (
           gsk_render_node_unref, ap->cairo_node_tl);
+        object_zero_and_free_if_nonnull (ap->curve_samples);
         g_free_and_null (ap->tmp_str);
         object_zero_and_free (ap);
       }
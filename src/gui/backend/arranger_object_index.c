@@ -0,0 +1,291 @@
+// SPDX-FileCopyrightText: © 2022 Alexandros Theodotou <alex@zrythm.org>
+// SPDX-License-Identifier: LicenseRef-ZrythmLicense
+
+#include <float.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "gui/backend/arranger_object.h"
+#include "gui/backend/arranger_object_index.h"
+#include "utils/mem.h"
+#include "utils/objects.h"
+
+ArrangerObjectIndex *
+arranger_object_index_new (void)
+{
+  ArrangerObjectIndex * self =
+    object_new (ArrangerObjectIndex);
+  self->members_dirty = true;
+
+  return self;
+}
+
+void
+arranger_object_index_invalidate (
+  ArrangerObjectIndex * self)
+{
+  self->members_dirty = true;
+  self->num_moved = 0;
+}
+
+void
+arranger_object_index_object_moved (
+  ArrangerObjectIndex * self,
+  ArrangerObject *      obj)
+{
+  /* will be fully rebuilt anyway */
+  if (self->members_dirty)
+    return;
+
+  for (int i = 0; i < self->num_moved; i++)
+    {
+      if (self->moved[i] == obj)
+        return;
+    }
+
+  if (self->num_moved == ARRANGER_OBJECT_INDEX_MAX_MOVED)
+    {
+      arranger_object_index_invalidate (self);
+      return;
+    }
+
+  self->moved[self->num_moved++] = obj;
+}
+
+static int
+cmp_by_start (const void * a, const void * b)
+{
+  const ArrangerObject * obj_a =
+    *(ArrangerObject * const *) a;
+  const ArrangerObject * obj_b =
+    *(ArrangerObject * const *) b;
+  double diff = obj_a->pos.ticks - obj_b->pos.ticks;
+  return (diff > 0) - (diff < 0);
+}
+
+static inline double
+get_end_ticks (const ArrangerObject * obj)
+{
+  return arranger_object_type_has_length (obj->type)
+           ? obj->end_pos.ticks
+           : obj->pos.ticks;
+}
+
+/**
+ * Moves the entries in [from, from + num) to
+ * @p to.
+ */
+static inline void
+move_entries (
+  ArrangerObjectIndex * self,
+  int                   to,
+  int                   from,
+  int                   num)
+{
+  if (num <= 0)
+    return;
+
+  memmove (
+    &self->objs[to], &self->objs[from],
+    (size_t) num * sizeof (ArrangerObject *));
+  memmove (
+    &self->starts[to], &self->starts[from],
+    (size_t) num * sizeof (double));
+  memmove (
+    &self->ends[to], &self->ends[from],
+    (size_t) num * sizeof (double));
+}
+
+/**
+ * Removes the given moved object and inserts it
+ * again at its current start position.
+ *
+ * @return Whether the object was found.
+ */
+static bool
+reinsert (ArrangerObjectIndex * self, ArrangerObject * obj)
+{
+  int old_idx = -1;
+  for (int i = 0; i < self->num_objs; i++)
+    {
+      if (self->objs[i] == obj)
+        {
+          old_idx = i;
+          break;
+        }
+    }
+  if (old_idx < 0)
+    return false;
+
+  move_entries (
+    self, old_idx, old_idx + 1,
+    self->num_objs - old_idx - 1);
+  int num_objs = self->num_objs - 1;
+
+  /* find the first entry that starts after the
+   * object */
+  double start = obj->pos.ticks;
+  int    lo = 0;
+  int    hi = num_objs;
+  while (lo < hi)
+    {
+      int mid = lo + (hi - lo) / 2;
+      if (self->starts[mid] <= start)
+        lo = mid + 1;
+      else
+        hi = mid;
+    }
+
+  move_entries (self, lo + 1, lo, num_objs - lo);
+  self->objs[lo] = obj;
+  self->starts[lo] = start;
+  self->ends[lo] = get_end_ticks (obj);
+
+  return true;
+}
+
+/**
+ * Caches the max end of each subtree in
+ * [lo, hi) and returns the max end of the range.
+ */
+static double
+build_max_ends (ArrangerObjectIndex * self, int lo, int hi)
+{
+  if (lo >= hi)
+    return -DBL_MAX;
+
+  int    mid = lo + (hi - lo) / 2;
+  double max_end = self->ends[mid];
+  double left = build_max_ends (self, lo, mid);
+  double right = build_max_ends (self, mid + 1, hi);
+  max_end = MAX (max_end, MAX (left, right));
+  self->max_ends[mid] = max_end;
+
+  return max_end;
+}
+
+void
+arranger_object_index_update (
+  ArrangerObjectIndex * self,
+  ArrangerObject **     objs,
+  int                   num_objs)
+{
+  if (!self->members_dirty)
+    {
+      if (self->num_moved == 0)
+        return;
+
+      bool found_all = true;
+      for (int i = 0; i < self->num_moved; i++)
+        {
+          if (!reinsert (self, self->moved[i]))
+            {
+              found_all = false;
+              break;
+            }
+        }
+      if (found_all)
+        {
+          self->num_moved = 0;
+          build_max_ends (self, 0, self->num_objs);
+          return;
+        }
+
+      /* a moved object is not indexed, so rebuild
+       * fully */
+    }
+
+  if ((size_t) num_objs > self->objs_size)
+    {
+      size_t new_size = (size_t) num_objs * 2;
+      self->objs = object_realloc_n (
+        self->objs, self->objs_size, new_size,
+        ArrangerObject *);
+      self->starts = object_realloc_n (
+        self->starts, self->objs_size, new_size,
+        double);
+      self->ends = object_realloc_n (
+        self->ends, self->objs_size, new_size, double);
+      self->max_ends = object_realloc_n (
+        self->max_ends, self->objs_size, new_size,
+        double);
+      self->objs_size = new_size;
+    }
+  self->num_objs = num_objs;
+  if (num_objs > 0)
+    {
+      memcpy (
+        self->objs, objs,
+        (size_t) num_objs * sizeof (ArrangerObject *));
+      qsort (
+        self->objs, (size_t) num_objs,
+        sizeof (ArrangerObject *), cmp_by_start);
+    }
+
+  for (int i = 0; i < self->num_objs; i++)
+    {
+      self->starts[i] = self->objs[i]->pos.ticks;
+      self->ends[i] = get_end_ticks (self->objs[i]);
+    }
+  build_max_ends (self, 0, self->num_objs);
+
+  self->members_dirty = false;
+  self->num_moved = 0;
+}
+
+static void
+query_range (
+  ArrangerObjectIndex * self,
+  int                   lo,
+  int                   hi,
+  double                start_ticks,
+  double                end_ticks,
+  GPtrArray *           arr)
+{
+  while (lo < hi)
+    {
+      int mid = lo + (hi - lo) / 2;
+
+      /* nothing in this subtree ends after the
+       * start of the range */
+      if (self->max_ends[mid] < start_ticks)
+        return;
+
+      query_range (
+        self, lo, mid, start_ticks, end_ticks, arr);
+
+      /* everything after mid starts after the
+       * range */
+      if (self->starts[mid] > end_ticks)
+        return;
+
+      if (self->ends[mid] >= start_ticks)
+        g_ptr_array_add (arr, self->objs[mid]);
+
+      lo = mid + 1;
+    }
+}
+
+void
+arranger_object_index_query (
+  ArrangerObjectIndex * self,
+  double                start_ticks,
+  double                end_ticks,
+  GPtrArray *           arr)
+{
+  g_return_if_fail (!self->members_dirty);
+
+  query_range (
+    self, 0, self->num_objs, start_ticks, end_ticks, arr);
+}
+
+void
+arranger_object_index_free (ArrangerObjectIndex * self)
+{
+  object_zero_and_free_if_nonnull (self->objs);
+  object_zero_and_free_if_nonnull (self->starts);
+  object_zero_and_free_if_nonnull (self->ends);
+  object_zero_and_free_if_nonnull (self->max_ends);
+
+  object_zero_and_free (self);
+}
@@ -16,6 +16,8 @@
 #include "audio/router.h"
 #include "audio/stretcher.h"
 #include "audio/track.h"
+#include "gui/backend/arranger_object_index.h"
+#include "gui/backend/arranger_selections.h"
 #include "gui/backend/clip_editor.h"
 #include "gui/backend/event.h"
 #include "gui/backend/event_manager.h"
@@ -59,6 +61,7 @@
 #include "gui/widgets/piano_roll_keys.h"
 #include "gui/widgets/plugin_browser.h"
 #include "gui/widgets/plugin_strip_expander.h"
+#include "gui/widgets/region.h"
 #include "gui/widgets/right_dock_edge.h"
 #include "gui/widgets/route_target_selector.h"
 #include "gui/widgets/ruler_marker.h"
@@ -93,6 +96,13 @@
 
 #include <glib/gi18n.h>
 
+/**
+ * Queues a widget refresh to be done after the
+ * current batch of events.
+ */
+#define QUEUE_REFRESH(flags) \
+  EVENT_MANAGER->queued_refreshes |= (flags)
+
 static void
 on_project_selection_type_changed (void)
 {
@@ -331,7 +341,7 @@ on_plugins_removed (Track * tr)
     }
 
   /* change inspector page */
-  left_dock_edge_widget_refresh (MW_LEFT_DOCK_EDGE);
+  QUEUE_REFRESH (EM_REFRESH_LEFT_DOCK_EDGE);
 
   /* refresh modulator view */
   modulator_view_widget_refresh (
@@ -344,72 +354,39 @@ refresh_for_selections_type (ArrangerSelectionsType type)
   switch (type)
     {
     case ARRANGER_SELECTIONS_TYPE_TIMELINE:
-      event_viewer_widget_refresh (
-        MW_TIMELINE_EVENT_VIEWER, false);
+      QUEUE_REFRESH (EM_REFRESH_TIMELINE_EVENT_VIEWER);
       break;
     case ARRANGER_SELECTIONS_TYPE_MIDI:
-      event_viewer_widget_refresh (
-        MW_MIDI_EVENT_VIEWER, false);
+      QUEUE_REFRESH (EM_REFRESH_MIDI_EVENT_VIEWER);
       break;
     case ARRANGER_SELECTIONS_TYPE_CHORD:
-      event_viewer_widget_refresh (
-        MW_CHORD_EVENT_VIEWER, false);
+      QUEUE_REFRESH (EM_REFRESH_CHORD_EVENT_VIEWER);
       break;
     case ARRANGER_SELECTIONS_TYPE_AUTOMATION:
-      event_viewer_widget_refresh (
-        MW_AUTOMATION_EVENT_VIEWER, false);
+      QUEUE_REFRESH (EM_REFRESH_AUTOMATION_EVENT_VIEWER);
       break;
     case ARRANGER_SELECTIONS_TYPE_AUDIO:
-      event_viewer_widget_refresh (
-        MW_AUDIO_EVENT_VIEWER, false);
+      QUEUE_REFRESH (EM_REFRESH_AUDIO_EVENT_VIEWER);
       break;
     default:
       g_return_if_reached ();
     }
-  bot_dock_edge_widget_update_event_viewer_stack_page (
-    MW_BOT_DOCK_EDGE);
 }
 
 static void
 on_arranger_selections_changed (ArrangerSelections * sel)
 {
   refresh_for_selections_type (sel->type);
-  left_dock_edge_widget_refresh (MW_LEFT_DOCK_EDGE);
+  QUEUE_REFRESH (EM_REFRESH_LEFT_DOCK_EDGE);
 
-  timeline_toolbar_widget_refresh (MW_TIMELINE_TOOLBAR);
+  QUEUE_REFRESH (EM_REFRESH_TIMELINE_TOOLBAR);
 }
 
 static void
 arranger_selections_change_redraw_everything (
   ArrangerSelections * sel)
 {
-  switch (sel->type)
-    {
-    case ARRANGER_SELECTIONS_TYPE_TIMELINE:
-      event_viewer_widget_refresh (
-        MW_TIMELINE_EVENT_VIEWER, false);
-      break;
-    case ARRANGER_SELECTIONS_TYPE_MIDI:
-      event_viewer_widget_refresh (
-        MW_MIDI_EVENT_VIEWER, false);
-      break;
-    case ARRANGER_SELECTIONS_TYPE_CHORD:
-      event_viewer_widget_refresh (
-        MW_CHORD_EVENT_VIEWER, false);
-      break;
-    case ARRANGER_SELECTIONS_TYPE_AUTOMATION:
-      event_viewer_widget_refresh (
-        MW_AUTOMATION_EVENT_VIEWER, false);
-      break;
-    case ARRANGER_SELECTIONS_TYPE_AUDIO:
-      event_viewer_widget_refresh (
-        MW_AUDIO_EVENT_VIEWER, false);
-      break;
-    default:
-      g_return_if_reached ();
-    }
-  bot_dock_edge_widget_update_event_viewer_stack_page (
-    MW_BOT_DOCK_EDGE);
+  refresh_for_selections_type (sel->type);
 }
 
 static void
@@ -434,7 +411,7 @@ on_arranger_selections_removed (ArrangerSelections * sel)
   MW_AUDIO_ARRANGER->hovered_object = NULL;
   MW_CHORD_ARRANGER->hovered_object = NULL;
 
-  timeline_toolbar_widget_refresh (MW_TIMELINE_TOOLBAR);
+  QUEUE_REFRESH (EM_REFRESH_TIMELINE_TOOLBAR);
 }
 
 static void
@@ -453,7 +430,7 @@ on_mixer_selections_changed (void)
             ch->widget->inserts);
         }
     }
-  left_dock_edge_widget_refresh (MW_LEFT_DOCK_EDGE);
+  QUEUE_REFRESH (EM_REFRESH_LEFT_DOCK_EDGE);
 }
 
 static void
@@ -466,7 +443,7 @@ on_track_color_changed (Track * track)
           channel_widget_refresh (track->channel->widget);
         }
     }
-  left_dock_edge_widget_refresh (MW_LEFT_DOCK_EDGE);
+  QUEUE_REFRESH (EM_REFRESH_LEFT_DOCK_EDGE);
 }
 
 static void
@@ -474,8 +451,8 @@ on_track_name_changed (Track * track)
 {
   /* refresh all because tracks routed to/from are
    * also affected */
-  mixer_widget_soft_refresh (MW_MIXER);
-  left_dock_edge_widget_refresh (MW_LEFT_DOCK_EDGE);
+  QUEUE_REFRESH (EM_REFRESH_MIXER);
+  QUEUE_REFRESH (EM_REFRESH_LEFT_DOCK_EDGE);
 }
 
 static void
@@ -492,7 +469,7 @@ on_arranger_object_changed (ArrangerObject * obj)
     case ARRANGER_OBJECT_TYPE_REGION:
       /* redraw editor ruler if region
        * positions were changed */
-      timeline_toolbar_widget_refresh (MW_TIMELINE_TOOLBAR);
+      QUEUE_REFRESH (EM_REFRESH_TIMELINE_TOOLBAR);
       break;
     default:
       break;
@@ -592,7 +569,31 @@ on_plugin_visibility_changed (Plugin * pl)
 /*return FALSE;*/
 /*}*/
 
-static inline void
+static guint
+event_hash (gconstpointer key)
+{
+  const ZEvent * ev = (const ZEvent *) key;
+  return g_direct_hash (ev->arg) * 31u + (guint) ev->type;
+}
+
+static gboolean
+event_equal (gconstpointer a, gconstpointer b)
+{
+  const ZEvent * ev_a = (const ZEvent *) a;
+  const ZEvent * ev_b = (const ZEvent *) b;
+  return ev_a->type == ev_b->type && ev_a->arg == ev_b->arg;
+}
+
+/**
+ * Moves the events deferred in the previous cycle
+ * and the queued events to @p events_arr, dropping
+ * events with the same type and arg as an earlier
+ * one.
+ *
+ * @return The number of deferred events at the
+ *   start of the array.
+ */
+static guint
 clean_duplicates_and_copy (
   EventManager * self,
   GPtrArray *    events_arr)
@@ -602,31 +603,110 @@ clean_duplicates_and_copy (
 
   g_ptr_array_remove_range (events_arr, 0, events_arr->len);
 
+  /* deferred events go first */
+  for (guint i = 0; i < self->deferred_events->len; i++)
+    {
+      event = (ZEvent *) g_ptr_array_index (
+        self->deferred_events, i);
+      g_hash_table_add (self->events_set, event);
+      g_ptr_array_add (events_arr, event);
+    }
+  guint num_deferred = self->deferred_events->len;
+  g_ptr_array_remove_range (
+    self->deferred_events, 0, self->deferred_events->len);
+
   /* only add events once to new array while
    * popping */
   while (event_queue_dequeue_event (q, &event))
     {
-      bool already_exists = false;
-
-      for (guint i = 0; i < events_arr->len; i++)
-        {
-          ZEvent * cur_event =
-            (ZEvent *) g_ptr_array_index (events_arr, i);
-          if (
-            event->type == cur_event->type
-            && event->arg == cur_event->arg)
-            already_exists = true;
-        }
-
-      if (already_exists)
+      if (g_hash_table_contains (self->events_set, event))
         {
           object_pool_return (self->obj_pool, event);
         }
       else
         {
+          g_hash_table_add (self->events_set, event);
           g_ptr_array_add (events_arr, event);
         }
     }
+
+  /* the events are returned to the pool after
+   * processing, so don't keep them around */
+  g_hash_table_remove_all (self->events_set);
+
+  return num_deferred;
+}
+
+/**
+ * Returns whether the event only refreshes values
+ * shown in widgets, so it can be deferred when the
+ * GTK thread is busy.
+ */
+static bool
+event_is_low_priority (EventType type)
+{
+  switch (type)
+    {
+    case ET_AUTOMATION_VALUE_CHANGED:
+    case ET_PLUGIN_STATE_CHANGED:
+    case ET_CONTROL_PORTS_CHANGED:
+    case ET_CHANNEL_FADER_VAL_CHANGED:
+    case ET_CHANNEL_SEND_CHANGED:
+      return true;
+    default:
+      return false;
+    }
+}
+
+static void
+flush_queued_refreshes (EventManager * self)
+{
+  EventManagerRefreshFlags flags = self->queued_refreshes;
+  self->queued_refreshes = 0;
+  if (!flags)
+    return;
+
+  if (flags & EM_REFRESH_MIXER && MW_MIXER)
+    mixer_widget_soft_refresh (MW_MIXER);
+  if (flags & EM_REFRESH_TRACKLIST && MW_TRACKLIST)
+    tracklist_widget_soft_refresh (MW_TRACKLIST);
+  if (flags & EM_REFRESH_TIMELINE_RULER)
+    ruler_widget_refresh (Z_RULER_WIDGET (MW_RULER));
+  if (flags & EM_REFRESH_EDITOR_RULER)
+    ruler_widget_refresh (Z_RULER_WIDGET (EDITOR_RULER));
+  if (flags & EM_REFRESH_TIMELINE_MINIMAP)
+    timeline_minimap_widget_refresh (MW_TIMELINE_MINIMAP);
+  if (flags & EM_REFRESH_TIMELINE_TOOLBAR)
+    timeline_toolbar_widget_refresh (MW_TIMELINE_TOOLBAR);
+  if (flags & EM_REFRESH_LEFT_DOCK_EDGE)
+    left_dock_edge_widget_refresh (MW_LEFT_DOCK_EDGE);
+
+  const EventManagerRefreshFlags viewer_flags =
+    EM_REFRESH_TIMELINE_EVENT_VIEWER
+    | EM_REFRESH_MIDI_EVENT_VIEWER
+    | EM_REFRESH_CHORD_EVENT_VIEWER
+    | EM_REFRESH_AUTOMATION_EVENT_VIEWER
+    | EM_REFRESH_AUDIO_EVENT_VIEWER;
+  if (flags & viewer_flags)
+    {
+      if (flags & EM_REFRESH_TIMELINE_EVENT_VIEWER)
+        event_viewer_widget_refresh (
+          MW_TIMELINE_EVENT_VIEWER, false);
+      if (flags & EM_REFRESH_MIDI_EVENT_VIEWER)
+        event_viewer_widget_refresh (
+          MW_MIDI_EVENT_VIEWER, false);
+      if (flags & EM_REFRESH_CHORD_EVENT_VIEWER)
+        event_viewer_widget_refresh (
+          MW_CHORD_EVENT_VIEWER, false);
+      if (flags & EM_REFRESH_AUTOMATION_EVENT_VIEWER)
+        event_viewer_widget_refresh (
+          MW_AUTOMATION_EVENT_VIEWER, false);
+      if (flags & EM_REFRESH_AUDIO_EVENT_VIEWER)
+        event_viewer_widget_refresh (
+          MW_AUDIO_EVENT_VIEWER, false);
+      bot_dock_edge_widget_update_event_viewer_stack_page (
+        MW_BOT_DOCK_EDGE);
+    }
 }
 
 static int
@@ -642,6 +722,166 @@ soft_recalc_graph_when_paused (void * data)
   return G_SOURCE_CONTINUE;
 }
 
+/**
+ * Marks the contents of the regions drawn with the
+ * objects in the given selections as changed.
+ *
+ * @param include_regions Whether to also mark the
+ *   selected regions themselves (moving regions
+ *   does not change their contents).
+ */
+static void
+mark_region_contents_changed (
+  ArrangerSelections * sel,
+  bool                 include_regions)
+{
+  if (!sel)
+    return;
+
+  GPtrArray * objs = g_ptr_array_new ();
+  arranger_selections_get_all_objects (sel, objs);
+  for (size_t i = 0; i < objs->len; i++)
+    {
+      ArrangerObject * obj =
+        (ArrangerObject *) g_ptr_array_index (objs, i);
+      if (
+        !include_regions
+        && obj->type == ARRANGER_OBJECT_TYPE_REGION)
+        continue;
+
+      arranger_object_contents_changed (obj);
+    }
+  g_ptr_array_unref (objs);
+}
+
+/**
+ * Invalidates the cached contents of the regions
+ * affected by the given event.
+ */
+static void
+invalidate_region_contents (ZEvent * ev)
+{
+  switch (ev->type)
+    {
+    case ET_ARRANGER_OBJECT_CREATED:
+    case ET_ARRANGER_OBJECT_CHANGED:
+      arranger_object_contents_changed (
+        (ArrangerObject *) ev->arg);
+      break;
+    case ET_ARRANGER_SELECTIONS_CREATED:
+    case ET_ARRANGER_SELECTIONS_CHANGED:
+    case ET_ARRANGER_SELECTIONS_REMOVED:
+    case ET_ARRANGER_SELECTIONS_QUANTIZED:
+    case ET_ARRANGER_SELECTIONS_ACTION_FINISHED:
+      mark_region_contents_changed (
+        (ArrangerSelections *) ev->arg, true);
+      break;
+    case ET_ARRANGER_SELECTIONS_MOVED:
+    case ET_ARRANGER_SELECTIONS_IN_TRANSIT:
+      mark_region_contents_changed (
+        (ArrangerSelections *) ev->arg, false);
+      break;
+    case ET_AUDIO_REGION_FADE_IN_CHANGED:
+    case ET_AUDIO_REGION_FADE_OUT_CHANGED:
+    case ET_AUDIO_REGION_GAIN_CHANGED:
+      if (ev->arg)
+        region_contents_changed ((ZRegion *) ev->arg);
+      break;
+    case ET_VELOCITIES_RAMPED:
+    case ET_EDITOR_FUNCTION_APPLIED:
+      {
+        ZRegion * region =
+          clip_editor_get_region (CLIP_EDITOR);
+        if (region)
+          region_contents_changed (region);
+      }
+      break;
+    /* these may affect the contents of any region */
+    case ET_UNDO_REDO_ACTION_DONE:
+    case ET_PROJECT_LOADED:
+    case ET_ARRANGER_SELECTIONS_CHANGED_REDRAW_EVERYTHING:
+    case ET_REFRESH_ARRANGER:
+    case ET_TRACK_COLOR_CHANGED:
+    case ET_TRACK_STATE_CHANGED:
+    case ET_TRACK_FREEZE_CHANGED:
+    case ET_AUTOMATION_TRACK_CHANGED:
+    case ET_CHORD_KEY_CHANGED:
+    case ET_CHORDS_UPDATED:
+    case ET_TIME_SIGNATURE_CHANGED:
+    case ET_TRANSPORT_RECORDING_ON_OFF_CHANGED:
+      region_invalidate_contents_caches ();
+      break;
+    default:
+      break;
+    }
+}
+
+/**
+ * Invalidates the interval index of the lane of
+ * the given region, if any.
+ */
+static void
+invalidate_lane_region_index (const ZRegion * region)
+{
+  if (!region_type_has_lane (region->id.type))
+    return;
+
+  Track * track = tracklist_find_track_by_name_hash (
+    TRACKLIST, region->id.track_name_hash);
+  if (!track || region->id.lane_pos >= track->num_lanes)
+    return;
+
+  TrackLane * lane = track->lanes[region->id.lane_pos];
+  if (lane->region_index)
+    arranger_object_index_invalidate (lane->region_index);
+}
+
+/**
+ * Invalidates the interval indices of the lanes
+ * affected by the given event.
+ *
+ * Object positions may have been changed without
+ * the setters (eg, when undoing), so the lanes of
+ * the regions in the event are rebuilt.
+ */
+static void
+invalidate_lane_region_indices (ZEvent * ev)
+{
+  switch (ev->type)
+    {
+    case ET_ARRANGER_OBJECT_CHANGED:
+      {
+        ArrangerObject * obj = (ArrangerObject *) ev->arg;
+        if (obj && obj->type == ARRANGER_OBJECT_TYPE_REGION)
+          invalidate_lane_region_index ((ZRegion *) obj);
+      }
+      break;
+    case ET_ARRANGER_SELECTIONS_CHANGED:
+    case ET_ARRANGER_SELECTIONS_QUANTIZED:
+    case ET_ARRANGER_SELECTIONS_ACTION_FINISHED:
+      {
+        ArrangerSelections * sel =
+          (ArrangerSelections *) ev->arg;
+        if (!sel)
+          break;
+
+        GPtrArray * objs = g_ptr_array_new ();
+        arranger_selections_get_all_objects (sel, objs);
+        for (size_t i = 0; i < objs->len; i++)
+          {
+            ArrangerObject * obj =
+              (ArrangerObject *) g_ptr_array_index (objs, i);
+            if (obj->type == ARRANGER_OBJECT_TYPE_REGION)
+              invalidate_lane_region_index ((ZRegion *) obj);
+          }
+        g_ptr_array_unref (objs);
+      }
+      break;
+    default:
+      break;
+    }
+}
+
 /**
  * Processes the given event.
  *
@@ -651,6 +891,9 @@ soft_recalc_graph_when_paused (void * data)
 void
 event_manager_process_event (EventManager * self, ZEvent * ev)
 {
+  invalidate_lane_region_indices (ev);
+  invalidate_region_contents (ev);
+
   switch (ev->type)
     {
     case ET_PLUGIN_LATENCY_CHANGED:
@@ -667,7 +910,7 @@ event_manager_process_event (EventManager * self, ZEvent * ev)
         tracklist_widget_hard_refresh (MW_TRACKLIST);
       tracklist_header_widget_refresh_track_count (
         MW_TRACKLIST_HEADER);
-      left_dock_edge_widget_refresh (MW_LEFT_DOCK_EDGE);
+      QUEUE_REFRESH (EM_REFRESH_LEFT_DOCK_EDGE);
       break;
     case ET_CHANNEL_REMOVED:
       mixer_widget_hard_refresh (MW_MIXER);
@@ -708,10 +951,10 @@ event_manager_process_event (EventManager * self, ZEvent * ev)
         || PROJECT->last_selection == SELECTION_TYPE_INSERT
         || PROJECT->last_selection == SELECTION_TYPE_MIDI_FX)
         {
-          left_dock_edge_widget_refresh (MW_LEFT_DOCK_EDGE);
+          QUEUE_REFRESH (EM_REFRESH_LEFT_DOCK_EDGE);
         }
-      mixer_widget_soft_refresh (MW_MIXER);
-      tracklist_widget_soft_refresh (MW_TRACKLIST);
+      QUEUE_REFRESH (EM_REFRESH_MIXER);
+      QUEUE_REFRESH (EM_REFRESH_TRACKLIST);
       break;
     case ET_RULER_SIZE_CHANGED:
       {
@@ -744,16 +987,19 @@ event_manager_process_event (EventManager * self, ZEvent * ev)
           }
       }
       break;
+    case ET_CONTROL_PORTS_CHANGED:
+      router_dispatch_control_notifications (ROUTER);
+      break;
     case ET_TRANSPORT_TOTAL_BARS_CHANGED:
-      ruler_widget_refresh ((RulerWidget *) MW_RULER);
-      ruler_widget_refresh ((RulerWidget *) EDITOR_RULER);
-      timeline_minimap_widget_refresh (MW_TIMELINE_MINIMAP);
+      QUEUE_REFRESH (EM_REFRESH_TIMELINE_RULER);
+      QUEUE_REFRESH (EM_REFRESH_EDITOR_RULER);
+      QUEUE_REFRESH (EM_REFRESH_TIMELINE_MINIMAP);
       break;
     case ET_AUTOMATION_VALUE_CHANGED:
       on_automation_value_changed ((Port *) ev->arg);
       break;
     case ET_RANGE_SELECTION_CHANGED:
-      timeline_toolbar_widget_refresh (MW_TIMELINE_TOOLBAR);
+      QUEUE_REFRESH (EM_REFRESH_TIMELINE_TOOLBAR);
       break;
     case ET_TOOL_CHANGED:
       toolbox_widget_refresh (MW_TOOLBOX);
@@ -773,8 +1019,8 @@ event_manager_process_event (EventManager * self, ZEvent * ev)
           Z_ARRANGER_WIDGET (MW_MIDI_MODIFIER_ARRANGER));
       break;
     case ET_TIME_SIGNATURE_CHANGED:
-      ruler_widget_refresh (Z_RULER_WIDGET (MW_RULER));
-      ruler_widget_refresh (Z_RULER_WIDGET (EDITOR_RULER));
+      QUEUE_REFRESH (EM_REFRESH_TIMELINE_RULER);
+      QUEUE_REFRESH (EM_REFRESH_EDITOR_RULER);
       gtk_widget_queue_draw (GTK_WIDGET (MW_DIGITAL_TIME_SIG));
       break;
     case ET_PLAYHEAD_POS_CHANGED:
@@ -838,8 +1084,13 @@ event_manager_process_event (EventManager * self, ZEvent * ev)
     case ET_REFRESH_ARRANGER:
       break;
     case ET_RULER_VIEWPORT_CHANGED:
-      timeline_minimap_widget_refresh (MW_TIMELINE_MINIMAP);
-      ruler_widget_refresh (Z_RULER_WIDGET (ev->arg));
+      QUEUE_REFRESH (EM_REFRESH_TIMELINE_MINIMAP);
+      if (ev->arg == MW_RULER)
+        QUEUE_REFRESH (EM_REFRESH_TIMELINE_RULER);
+      else if (ev->arg == EDITOR_RULER)
+        QUEUE_REFRESH (EM_REFRESH_EDITOR_RULER);
+      else
+        ruler_widget_refresh (Z_RULER_WIDGET (ev->arg));
       break;
     case ET_TRACK_STATE_CHANGED:
       for (int j = 0; j < TRACKLIST->num_tracks; j++)
@@ -866,7 +1117,7 @@ event_manager_process_event (EventManager * self, ZEvent * ev)
       piano_roll_keys_widget_redraw_full (MW_PIANO_ROLL_KEYS);
       break;
     case ET_RULER_STATE_CHANGED:
-      ruler_widget_refresh ((RulerWidget *) MW_RULER);
+      QUEUE_REFRESH (EM_REFRESH_TIMELINE_RULER);
       break;
     case ET_AUTOMATION_TRACK_ADDED:
     case ET_AUTOMATION_TRACK_REMOVED:
@@ -997,7 +1248,7 @@ event_manager_process_event (EventManager * self, ZEvent * ev)
           Z_ARRANGER_WIDGET (ev->arg);
         event_viewer_widget_refresh_for_arranger (
           arranger, true);
-        timeline_toolbar_widget_refresh (MW_TIMELINE_TOOLBAR);
+        QUEUE_REFRESH (EM_REFRESH_TIMELINE_TOOLBAR);
       }
       break;
     case ET_TRACKS_RESIZED:
@@ -1014,8 +1265,8 @@ event_manager_process_event (EventManager * self, ZEvent * ev)
     case ET_PIANO_ROLL_MIDI_MODIFIER_CHANGED:
       break;
     case ET_BPM_CHANGED:
-      ruler_widget_refresh (MW_RULER);
-      ruler_widget_refresh (EDITOR_RULER);
+      QUEUE_REFRESH (EM_REFRESH_TIMELINE_RULER);
+      QUEUE_REFRESH (EM_REFRESH_EDITOR_RULER);
       gtk_widget_queue_draw (GTK_WIDGET (MW_DIGITAL_BPM));
 
       /* these are only used in the UI so
@@ -1082,7 +1333,7 @@ event_manager_process_event (EventManager * self, ZEvent * ev)
         }
 
       /* refresh inspector */
-      left_dock_edge_widget_refresh (MW_LEFT_DOCK_EDGE);
+      QUEUE_REFRESH (EM_REFRESH_LEFT_DOCK_EDGE);
       on_project_selection_type_changed ();
       main_notebook_widget_refresh (MW_MAIN_NOTEBOOK);
 
@@ -1241,7 +1492,7 @@ event_manager_process_event (EventManager * self, ZEvent * ev)
     case ET_MIXER_CHANNEL_INSERTS_EXPANDED_CHANGED:
     case ET_MIXER_CHANNEL_MIDI_FX_EXPANDED_CHANGED:
     case ET_MIXER_CHANNEL_SENDS_EXPANDED_CHANGED:
-      mixer_widget_soft_refresh (MW_MIXER);
+      QUEUE_REFRESH (EM_REFRESH_MIXER);
       break;
     case ET_REGION_ACTIVATED:
       bot_dock_edge_widget_show_clip_editor (
@@ -1300,56 +1551,98 @@ event_manager_process_event (EventManager * self, ZEvent * ev)
       g_warning ("event %d not implemented yet", ev->type);
       break;
     }
+
+  /* events processed outside a batch (eg, with
+   * EVENTS_PUSH_NOW) refresh immediately */
+  if (!self->processing_batch)
+    flush_queued_refreshes (self);
 }
 
 /**
- * GSourceFunc to be added using idle add.
+ * Processes the queued events.
  *
- * This will loop indefinintely.
+ * @param allow_deferring Whether low-priority events
+ *   may be deferred to the next cycle.
  */
-static int
-process_events (void * data)
+static void
+process_batch (EventManager * self, bool allow_deferring)
 {
-  EventManager * self = (EventManager *) data;
-
-  ZEvent * ev;
-  clean_duplicates_and_copy (self, self->events_arr);
-
-  /*g_message ("starting processing");*/
-  for (guint i = 0; i < self->events_arr->len; i++)
+  gint64 start_time = g_get_monotonic_time ();
+  guint  num_deferred =
+    clean_duplicates_and_copy (self, self->events_arr);
+
+  self->processing_batch = true;
+
+  /* process events in 2 passes: first everything
+   * except low-priority events not deferred
+   * before, then those events until the time
+   * budget is exceeded (the rest are deferred to
+   * the next cycle) */
+  guint num_processed = 0;
+  for (int pass = 0; pass < 2; pass++)
     {
-      if (i > 30)
+      for (guint i = 0; i < self->events_arr->len; i++)
         {
-          g_message (
-            "more than 30 UI events processed "
-            "(%d)!",
-            i);
-        }
+          ZEvent * ev = (ZEvent *) g_ptr_array_index (
+            self->events_arr, i);
+          bool low_priority =
+            i >= num_deferred
+            && event_is_low_priority (ev->type);
+          if (low_priority != (pass == 1))
+            continue;
 
-      ev = (ZEvent *) g_ptr_array_index (self->events_arr, i);
+          if (
+            low_priority
+            && g_get_monotonic_time () - start_time
+                 > EVENT_MANAGER_LOW_PRIORITY_BUDGET_USEC
+            && allow_deferring)
+            {
+              g_ptr_array_add (self->deferred_events, ev);
+              continue;
+            }
 
-      if (!ZRYTHM_HAVE_UI)
-        {
-          g_message ("%s: (%d) No UI, skipping", __func__, i);
-          goto return_to_pool;
-        }
+          if (!ZRYTHM_HAVE_UI)
+            {
+              g_message (
+                "%s: (%u) No UI, skipping", __func__, i);
+            }
+          else
+            {
+              event_manager_process_event (self, ev);
+            }
 
-      /*g_message ("event type %d", ev->type);*/
+          object_pool_return (self->obj_pool, ev);
+          num_processed++;
+        }
+    }
 
-      event_manager_process_event (self, ev);
+  flush_queued_refreshes (self);
+  self->processing_batch = false;
 
-return_to_pool:
-      object_pool_return (self->obj_pool, ev);
+  if (num_processed > 30)
+    {
+      g_message (
+        "more than 30 UI events processed (%u)!",
+        num_processed);
     }
-  /*g_message ("processed %d events", i);*/
-
-  if (self->events_arr->len > 6)
-    g_message (
-      "More than 6 events processed. "
-      "Optimization needed.");
+  if (self->deferred_events->len > 0)
+    {
+      g_debug (
+        "deferred %u low-priority UI events",
+        self->deferred_events->len);
+    }
+}
 
-  /*g_usleep (8000);*/
-  /*project_validate (PROJECT);*/
+/**
+ * GSourceFunc to be added using idle add.
+ *
+ * This will loop indefinintely.
+ */
+static int
+process_events (void * data)
+{
+  EventManager * self = (EventManager *) data;
+  process_batch (self, true);
 
   return G_SOURCE_CONTINUE;
 }
@@ -1395,6 +1688,9 @@ event_manager_new (void)
     (size_t) EVENT_MANAGER_MAX_EVENTS * sizeof (ZEvent *));
 
   self->events_arr = g_ptr_array_sized_new (200);
+  self->events_set =
+    g_hash_table_new (event_hash, event_equal);
+  self->deferred_events = g_ptr_array_sized_new (200);
 
   return self;
 }
@@ -1413,11 +1709,19 @@ event_manager_stop_events (EventManager * self)
 
   /* process any remaining events - clear the
    * queue. */
-  process_events (self);
+  process_batch (self, false);
 
   /* clear the event queue just in case no events
    * were processed */
   ZEvent * event;
+  for (guint i = 0; i < self->deferred_events->len; i++)
+    {
+      event = (ZEvent *) g_ptr_array_index (
+        self->deferred_events, i);
+      object_pool_return (self->obj_pool, event);
+    }
+  g_ptr_array_remove_range (
+    self->deferred_events, 0, self->deferred_events->len);
   while (event_queue_dequeue_event (self->mqueue, &event))
     {
       object_pool_return (self->obj_pool, event);
@@ -1437,7 +1741,7 @@ event_manager_process_now (EventManager * self)
   g_message ("processing events now...");
 
   /* process events now */
-  process_events (self);
+  process_batch (self, false);
 
   g_message ("done");
 }
@@ -1453,6 +1757,18 @@ event_manager_remove_events_for_obj (
   EventManager * self,
   void *         obj)
 {
+  for (guint i = self->deferred_events->len; i > 0; i--)
+    {
+      ZEvent * event = (ZEvent *) g_ptr_array_index (
+        self->deferred_events, i - 1);
+      if (event->arg == obj)
+        {
+          g_ptr_array_remove_index (
+            self->deferred_events, i - 1);
+          object_pool_return (self->obj_pool, event);
+        }
+    }
+
   MPMCQueue * q = self->mqueue;
   ZEvent *    event;
   while (event_queue_dequeue_event (q, &event))
@@ -1480,6 +1796,10 @@ event_manager_free (EventManager * self)
   object_free_w_func_and_null (mpmc_queue_free, self->mqueue);
   object_free_w_func_and_null (
     g_ptr_array_unref, self->events_arr);
+  object_free_w_func_and_null (
+    g_hash_table_unref, self->events_set);
+  object_free_w_func_and_null (
+    g_ptr_array_unref, self->deferred_events);
 
   object_zero_and_free (self);
 
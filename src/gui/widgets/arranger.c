@@ -14,6 +14,7 @@
 #include "audio/midi_region.h"
 #include "audio/track.h"
 #include "audio/transport.h"
+#include "gui/backend/arranger_object_index.h"
 #include "gui/backend/event.h"
 #include "gui/backend/event_manager.h"
 #include "gui/widgets/arranger.h"
@@ -530,6 +531,46 @@ add_object_if_overlap (
   return add;
 }
 
+static int
+region_idx_cmp (const void * a, const void * b)
+{
+  const ZRegion * r1 = *(ZRegion * const *) a;
+  const ZRegion * r2 = *(ZRegion * const *) b;
+  return r1->id.idx - r2->id.idx;
+}
+
+/**
+ * Fills @p arr with the regions in the lane that
+ * may overlap with the range in @p nfo, in lane
+ * order, using the lane's interval index.
+ */
+static void
+get_lane_regions_in_range (
+  ArrangerWidget *    self,
+  TrackLane *         lane,
+  ObjectOverlapInfo * nfo,
+  GPtrArray *         arr)
+{
+  g_ptr_array_remove_range (arr, 0, arr->len);
+
+  if (!lane->region_index)
+    lane->region_index = arranger_object_index_new ();
+  arranger_object_index_update (
+    lane->region_index, (ArrangerObject **) lane->regions,
+    lane->num_regions);
+
+  /* pad by the same amount as
+   * add_object_if_overlap() so that no region it
+   * would accept is skipped */
+  RulerWidget * ruler = arranger_widget_get_ruler (self);
+  double        padding = 12.0 / ruler->px_per_tick;
+  arranger_object_index_query (
+    lane->region_index, nfo->start_pos.ticks - padding,
+    nfo->end_pos.ticks + padding, arr);
+
+  g_ptr_array_sort (arr, region_idx_cmp);
+}
+
 /**
  * Fills in the given array with the
  * ArrangerObject's of the given type that appear
@@ -597,6 +638,8 @@ get_hit_objects (
         type == ARRANGER_OBJECT_TYPE_ALL
         || type == ARRANGER_OBJECT_TYPE_REGION)
         {
+          GPtrArray * lane_regions = g_ptr_array_new ();
+
           /* midi and audio regions */
           for (int i = 0; i < TRACKLIST->num_tracks; i++)
             {
@@ -644,9 +687,13 @@ get_hit_objects (
               for (int j = 0; j < track->num_lanes; j++)
                 {
                   TrackLane * lane = track->lanes[j];
-                  for (int k = 0; k < lane->num_regions; k++)
+                  get_lane_regions_in_range (
+                    self, lane, &nfo, lane_regions);
+                  for (guint k = 0; k < lane_regions->len;
+                       k++)
                     {
-                      ZRegion * r = lane->regions[k];
+                      ZRegion * r = (ZRegion *)
+                        g_ptr_array_index (lane_regions, k);
                       g_warn_if_fail (IS_REGION (r));
                       obj = (ArrangerObject *) r;
                       nfo.obj = obj;
@@ -659,7 +706,7 @@ get_hit_objects (
                             continue;
                           GdkRectangle lane_rect;
                           region_get_lane_full_rect (
-                            lane->regions[k], &lane_rect);
+                            r, &lane_rect);
                           if (
                             ((rect
                               && ui_rectangle_overlap (
@@ -706,6 +753,8 @@ get_hit_objects (
                     }
                 }
             }
+
+          g_ptr_array_unref (lane_regions);
         }
 
       /* add overlapping scales */
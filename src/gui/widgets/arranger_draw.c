@@ -408,16 +408,20 @@ draw_timeline_bg (
                       (float) width, 1.f));
                 }
 
-              float normalized_val =
-                automation_track_get_val_at_pos (
-                  at, PLAYHEAD, true, true);
-              Port * port =
-                port_find_from_identifier (&at->port_id);
+              float             normalized_val;
               AutomationPoint * ap =
                 automation_track_get_ap_before_pos (
                   at, PLAYHEAD, true);
-              if (!ap)
+              if (ap)
                 {
+                  normalized_val =
+                    automation_track_get_val_at_pos (
+                      at, PLAYHEAD, true, true);
+                }
+              else
+                {
+                  Port * port =
+                    port_find_from_identifier (&at->port_id);
                   normalized_val =
                     control_port_real_val_to_normalized (
                       port, control_port_get_val (port));
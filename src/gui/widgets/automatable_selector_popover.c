@@ -28,24 +28,25 @@ on_closed (
   gpointer                           user_data)
 {
   /* if the selected automatable changed */
-  Port * at_port =
-    port_find_from_identifier (&self->owner->port_id);
-  if (self->selected_port && at_port != self->selected_port)
+  if (self->selected_at && self->selected_at != self->owner)
     {
       /* set the previous automation track
        * invisible */
       self->owner->visible = 0;
 
+      AutomationTrack * selected_at = self->selected_at;
       g_message (
-        "selected port: %s", self->selected_port->id.label);
+        "selected port: %s", selected_at->port_id.label);
+
+      /* MIDI control ports are created on first
+       * use */
+      Port * port =
+        automation_track_get_port (selected_at, true);
+      g_return_if_fail (port);
 
       /* swap indices */
       AutomationTracklist * atl =
         automation_track_get_automation_tracklist (self->owner);
-      AutomationTrack * selected_at =
-        automation_tracklist_get_at_from_port (
-          atl, self->selected_port);
-      g_return_if_fail (selected_at);
       automation_tracklist_set_at_index (
         atl, self->owner, selected_at->index, F_NO_PUSH_DOWN);
 
@@ -68,10 +69,18 @@ on_closed (
 static int
 update_info_label (AutomatableSelectorPopoverWidget * self)
 {
-  if (self->selected_port)
+  Port * port =
+    self->selected_at
+      ? automation_track_get_port (self->selected_at, false)
+      : NULL;
+  if (self->selected_at && !port)
+    {
+      /* MIDI control that was not used yet */
+      gtk_label_set_text (
+        self->info, self->selected_at->port_id.label);
+    }
+  else if (port)
     {
-      Port * port = self->selected_port;
-
       char * label = g_strdup_printf (
         "%s\nMin: %f\nMax: %f", port->id.label,
         (double) port->minf, (double) port->maxf);
@@ -120,7 +129,7 @@ select_automatable (AutomatableSelectorPopoverWidget * self)
   gtk_tree_selection_select_iter (sel, &iter);
 
   /* select current automatable */
-  if (self->selected_port)
+  if (self->selected_at)
     {
       sel = gtk_tree_view_get_selection (
         GTK_TREE_VIEW (self->port_treeview));
@@ -131,10 +140,10 @@ select_automatable (AutomatableSelectorPopoverWidget * self)
         self->port_model, &iter);
       while (valid)
         {
-          Port * port;
+          AutomationTrack * at;
           gtk_tree_model_get (
-            self->port_model, &iter, 2, &port, -1);
-          if (port == self->selected_port)
+            self->port_model, &iter, 2, &at, -1);
+          if (at == self->selected_at)
             {
               gtk_tree_selection_select_iter (sel, &iter);
               break;
@@ -171,8 +180,11 @@ create_model_for_ports (
 
       char icon_name[256];
 
-      Port *   port = NULL;
-      Plugin * plugin = NULL;
+      /* MIDI control ports may not be created yet,
+       * so only the identifier is used */
+      const PortIdentifier * id = &at->port_id;
+      bool                   matches = false;
+      Plugin *               plugin = NULL;
       switch (self->selected_type)
         {
         case AS_TYPE_MIDI_CH1:
@@ -192,54 +204,50 @@ create_model_for_ports (
         case AS_TYPE_MIDI_CH15:
         case AS_TYPE_MIDI_CH16:
           /* skip non-channel automation tracks */
-          port = port_find_from_identifier (&at->port_id);
-          if (!(port->id.flags & PORT_FLAG_MIDI_AUTOMATABLE))
+          if (!(id->flags & PORT_FLAG_MIDI_AUTOMATABLE))
             continue;
-          /*g_message (*/
-          /*"port %s is a midi automatable",*/
-          /*port->id.label);*/
 
           if (
-            port->id.flags2 & PORT_FLAG2_MIDI_PITCH_BEND
-            || port->id.flags2 & PORT_FLAG2_MIDI_POLY_KEY_PRESSURE
-            || port->id.flags2
-                 & PORT_FLAG2_MIDI_CHANNEL_PRESSURE)
+            id->flags2 & PORT_FLAG2_MIDI_PITCH_BEND
+            || id->flags2 & PORT_FLAG2_MIDI_POLY_KEY_PRESSURE
+            || id->flags2 & PORT_FLAG2_MIDI_CHANNEL_PRESSURE)
             {
               if (
                 (int) self->selected_type
-                != (AS_TYPE_MIDI_CH1 + port->id.port_index))
+                != (AS_TYPE_MIDI_CH1 + id->port_index))
                 continue;
             }
           else
             {
               if (
                 (int) self->selected_type
-                != (AS_TYPE_MIDI_CH1 + port->id.port_index / 128))
+                != (AS_TYPE_MIDI_CH1 + id->port_index / 128))
                 continue;
             }
 
           strcpy (icon_name, "signal-midi");
+          matches = true;
           break;
         case AS_TYPE_MACRO:
           /* skip non-channel automation tracks */
-          port = port_find_from_identifier (&at->port_id);
-          if (!(port->id.flags & PORT_FLAG_MODULATOR_MACRO))
+          if (!(id->flags & PORT_FLAG_MODULATOR_MACRO))
             continue;
 
           strcpy (icon_name, "code-function");
+          matches = true;
           break;
         case AS_TYPE_CHANNEL:
           /* skip non-channel automation tracks */
-          port = port_find_from_identifier (&at->port_id);
-          if (!(port->id.flags & PORT_FLAG_FADER_MUTE
-                || port->id.flags & PORT_FLAG_CHANNEL_FADER
-                || port->id.flags & PORT_FLAG_STEREO_BALANCE
-                || port->id.flags2 & PORT_FLAG2_CHANNEL_SEND_ENABLED
-                || port->id.flags2
-                     & PORT_FLAG2_CHANNEL_SEND_AMOUNT))
+          if (
+            !(id->flags & PORT_FLAG_FADER_MUTE
+              || id->flags & PORT_FLAG_CHANNEL_FADER
+              || id->flags & PORT_FLAG_STEREO_BALANCE
+              || id->flags2 & PORT_FLAG2_CHANNEL_SEND_ENABLED
+              || id->flags2 & PORT_FLAG2_CHANNEL_SEND_AMOUNT))
             continue;
 
           strcpy (icon_name, "node-type-cusp");
+          matches = true;
           break;
         case AS_TYPE_MIDI_FX:
           plugin =
@@ -256,43 +264,43 @@ create_model_for_ports (
           plugin = track->modulators[self->selected_slot];
           break;
         case AS_TYPE_TEMPO:
-          port = port_find_from_identifier (&at->port_id);
-
           /* skip non-tempo automation tracks */
-          if (!(port->id.flags & PORT_FLAG_BPM
-                || port->id.flags2 & PORT_FLAG2_BEATS_PER_BAR
-                || port->id.flags2 & PORT_FLAG2_BEAT_UNIT))
+          if (!(id->flags & PORT_FLAG_BPM
+                || id->flags2 & PORT_FLAG2_BEATS_PER_BAR
+                || id->flags2 & PORT_FLAG2_BEAT_UNIT))
             continue;
+          matches = true;
           break;
         }
 
       if (plugin)
         {
           /* skip non-plugin automation tracks */
-          port = port_find_from_identifier (&at->port_id);
-          if (port->id.owner_type != PORT_OWNER_TYPE_PLUGIN)
+          if (id->owner_type != PORT_OWNER_TYPE_PLUGIN)
             continue;
 
+          Port * port = port_find_from_identifier (id);
+          g_return_val_if_fail (port, NULL);
           Plugin * port_pl = port_get_plugin (port, true);
           if (port_pl != plugin)
             continue;
 
           strcpy (icon_name, "plugins");
+          matches = true;
         }
 
-      if (!port)
+      if (!matches)
         continue;
 
       /* if this automation track is not
        * already in a visible lane */
       if (!at->created || !at->visible || at == self->owner)
         {
-          /*g_message ("adding %s", port->id.label);*/
           /* add a new row to the model */
           gtk_list_store_append (list_store, &iter);
           gtk_list_store_set (
-            list_store, &iter, 0, icon_name, 1,
-            port->id.label, 2, port, -1);
+            list_store, &iter, 0, icon_name, 1, id->label, 2,
+            at, -1);
         }
     }
 
@@ -453,15 +461,15 @@ on_selection_changed (
             self->port_treeview_box,
             GTK_WIDGET (self->port_treeview));
 
-          self->selected_port = NULL;
+          self->selected_at = NULL;
           update_info_label (self);
         }
       else if (model == self->port_model)
         {
           gtk_tree_model_get_value (model, &iter, 2, &value);
-          Port * port = g_value_get_pointer (&value);
+          AutomationTrack * at = g_value_get_pointer (&value);
 
-          self->selected_port = port;
+          self->selected_at = at;
           update_info_label (self);
         }
     }
@@ -526,9 +534,7 @@ automatable_selector_popover_widget_new (
 
   /* set selected type */
   self->selected_type = AS_TYPE_CHANNEL;
-  Port * port =
-    port_find_from_identifier (&self->owner->port_id);
-  PortIdentifier * id = &port->id;
+  PortIdentifier * id = &self->owner->port_id;
   if (
     id->flags & PORT_FLAG_BPM
     || id->flags2 & PORT_FLAG2_BEATS_PER_BAR
@@ -594,7 +600,7 @@ automatable_selector_popover_widget_new (
     }
 
   /* set selected automatable */
-  self->selected_port = port;
+  self->selected_at = owner;
 
   /* create model/treeview for types */
   self->type_model = create_model_for_types (self);
@@ -29,6 +29,7 @@
 bool
 automation_point_settings_changed (
   const AutomationPoint * self,
+  const AutomationPoint * next_ap,
   const GdkRectangle *    draw_rect,
   bool                    timeline)
 {
@@ -38,7 +39,10 @@ automation_point_settings_changed (
     gdk_rectangle_equal (&last_settings->draw_rect, draw_rect)
     && curve_options_are_equal (
       &last_settings->curve_opts, &self->curve_opts)
-    && math_floats_equal (last_settings->fvalue, self->fvalue);
+    && math_floats_equal (last_settings->fvalue, self->fvalue)
+    && math_floats_equal (
+      last_settings->next_fvalue,
+      next_ap ? next_ap->fvalue : self->fvalue);
 
   return !same;
 }
@@ -89,7 +93,8 @@ automation_point_draw (
 #endif
 
   GskRenderNode * cr_node = NULL;
-  if (automation_point_settings_changed (ap, &draw_rect, false))
+  if (automation_point_settings_changed (
+        ap, next_ap, &draw_rect, false))
     {
       cr_node = gsk_cairo_node_new (&GRAPHENE_RECT_INIT (
         0.f, 0.f, (float) draw_rect.width + 3.f,
@@ -138,84 +143,37 @@ automation_point_draw (
       double draw_offset = draw_rect.x - obj->full_rect.x;
       g_return_if_fail (draw_offset >= 0.0);
 
-      double step = 0.1;
-      double this_y = 0;
-      double draw_until =
-        /* FIXME this will draw all the way
-        * until the end of the automation point,
-        * even if it is off-screen by many
-        * pixels
-        * TODO only draw up to where needed
-        *
-        * it is possible that cairo is smart about
-        * it and doesn't exceed the surface size */
-        width_for_curve - step / 2.0;
-      bool has_drawing = false;
-      for (double l = draw_offset; l <= draw_until; l += step)
+      /* draw the cached curve samples as a
+       * polyline, starting from the first visible
+       * one */
+      int num_samples =
+        automation_point_get_num_curve_samples_for_width (
+          width_for_curve);
+      const double * samples =
+        automation_point_get_curve_samples (
+          ap, next_ap, num_samples);
+      g_return_if_fail (samples);
+      double px_per_sample =
+        MAX (width_for_curve, 0.0) / num_samples;
+      int first_sample =
+        px_per_sample > 0.0
+          ? CLAMP (
+            (int) (draw_offset / px_per_sample), 0,
+            num_samples - 1)
+          : 0;
+      for (int i = first_sample; i <= num_samples; i++)
         {
-          double next_y =
+          double x =
+            i * px_per_sample + AP_WIDGET_POINT_SIZE / 2
+            + obj->full_rect.x;
+          double y =
             /* in pixels, higher values are lower */
-            1.0
-            - automation_point_get_normalized_value_in_curve (
-              ap,
-              CLAMP ((l + step) / width_for_curve, 0.0, 1.0));
-          next_y *= height_for_curve;
-
-          if (G_UNLIKELY (math_doubles_equal (l, 0.0)))
-            {
-              this_y =
-                /* in pixels, higher values are lower */
-                1.0
-                - automation_point_get_normalized_value_in_curve (
-                  ap, 0.0);
-              this_y *= height_for_curve;
-              cairo_move_to (
-                cr,
-                (l + AP_WIDGET_POINT_SIZE / 2
-                 + obj->full_rect.x),
-                (this_y + AP_WIDGET_POINT_SIZE / 2
-                 + obj->full_rect.y));
-            }
+            (1.0 - samples[i]) * height_for_curve
+            + AP_WIDGET_POINT_SIZE / 2 + obj->full_rect.y;
+          if (i == first_sample)
+            cairo_move_to (cr, x, y);
           else
-            {
-              cairo_line_to (
-                cr,
-                (l + step + AP_WIDGET_POINT_SIZE / 2
-                 + obj->full_rect.x),
-                (next_y + AP_WIDGET_POINT_SIZE / 2
-                 + obj->full_rect.y));
-            }
-          this_y = next_y;
-
-          has_drawing = true;
-        }
-
-      /* nothing drawn - just a vertical line
-       * needed */
-      if (G_UNLIKELY (!has_drawing))
-        {
-          this_y =
-            1.0
-            - automation_point_get_normalized_value_in_curve (
-              ap, 0.0);
-          this_y *= height_for_curve;
-          double next_y =
-            1.0
-            - automation_point_get_normalized_value_in_curve (
-              ap, 1.0);
-          next_y *= height_for_curve;
-          cairo_move_to (
-            cr,
-            (draw_offset + AP_WIDGET_POINT_SIZE / 2
-             + obj->full_rect.x),
-            (this_y + AP_WIDGET_POINT_SIZE / 2
-             + obj->full_rect.y));
-          cairo_line_to (
-            cr,
-            (draw_offset + step + AP_WIDGET_POINT_SIZE / 2
-             + obj->full_rect.x),
-            (next_y + AP_WIDGET_POINT_SIZE / 2
-             + obj->full_rect.y));
+            cairo_line_to (cr, x, y);
         }
 
       cairo_stroke (cr);
@@ -287,6 +245,8 @@ automation_point_draw (
   gtk_snapshot_restore (snapshot);
 
   ap->last_settings.fvalue = ap->fvalue;
+  ap->last_settings.next_fvalue =
+    next_ap ? next_ap->fvalue : ap->fvalue;
   ap->last_settings.curve_opts = ap->curve_opts;
   ap->last_settings.draw_rect = draw_rect;
   ap->cairo_node = cr_node;
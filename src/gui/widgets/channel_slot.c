@@ -17,6 +17,7 @@
 #include "gui/widgets/left_dock_edge.h"
 #include "gui/widgets/main_window.h"
 #include "gui/widgets/mixer.h"
+#include "plugins/carla_native_plugin.h"
 #include "plugins/lv2_plugin.h"
 #include "project.h"
 #include "utils/cairo.h"
@@ -660,6 +661,44 @@ show_context_menu (ChannelSlotWidget * self, double x, double y)
         z_gtk_create_menu_item (_ ("Bypass"), NULL, tmp);
       g_menu_append_item (plugin_submenu, menuitem);
 
+      /* add auto-sleep option (with the fraction of
+       * processing skipped so far) */
+      char lbl[200];
+      if (pl->auto_sleep)
+        {
+          sprintf (
+            lbl, _ ("Disable Auto-Sleep (%d%% skipped)"),
+            (int) (plugin_get_auto_sleep_ratio (pl) * 100.f));
+        }
+      else
+        {
+          sprintf (
+            lbl, "%s", _ ("Auto-Sleep When Silent"));
+        }
+      sprintf (tmp, "app.plugin-toggle-auto-sleep::%p", pl);
+      menuitem = z_gtk_create_menu_item (lbl, NULL, tmp);
+      g_menu_append_item (plugin_submenu, menuitem);
+
+#ifdef HAVE_CARLA
+      /* show the CPU load reported by the bridge
+       * process since last checked */
+      if (pl->carla && pl->carla->bridge_pid > 0)
+        {
+          float load =
+            carla_native_plugin_get_bridge_cpu_load (
+              pl->carla);
+          if (load >= 0.f)
+            {
+              sprintf (
+                lbl, _ ("Bridge Process CPU: %.1f%%"),
+                (double) (load * 100.f));
+              menuitem =
+                z_gtk_create_menu_item (lbl, NULL, NULL);
+              g_menu_append_item (plugin_submenu, menuitem);
+            }
+        }
+#endif
+
       /* add inspect option */
       menuitem = z_gtk_create_menu_item (
         _ ("Inspect"), NULL, "app.plugin-inspect");
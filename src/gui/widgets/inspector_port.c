@@ -6,6 +6,7 @@
 #include "actions/midi_mapping_action.h"
 #include "audio/control_port.h"
 #include "audio/engine.h"
+#include "audio/router.h"
 #include "audio/meter.h"
 #include "audio/midi_mapping.h"
 #include "audio/port.h"
@@ -213,7 +214,7 @@ get_port_value (InspectorPortWidget * self)
       break;
     case TYPE_CONTROL:
       return control_port_real_val_to_normalized (
-        port, port->unsnapped_control);
+        port, control_port_get_queued_val (port));
       break;
     default:
       break;
@@ -252,10 +253,10 @@ get_snapped_port_value (InspectorPortWidget * self)
 static void
 set_port_value (InspectorPortWidget * self, float val)
 {
-  port_set_control_value (
-    self->port,
+  router_queue_control_value (
+    ROUTER, self->port,
     control_port_normalized_val_to_real (self->port, val),
-    F_NOT_NORMALIZED, F_PUBLISH_EVENTS);
+    F_PUBLISH_EVENTS);
 }
 
 static void
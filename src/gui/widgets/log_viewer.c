@@ -50,6 +50,25 @@ result_func (
   success =
     gtk_source_file_loader_load_finish (loader, res, NULL);
   g_return_if_fail (success);
+
+  self->loaded = true;
+}
+
+void
+log_viewer_widget_append (
+  LogViewerWidget * self,
+  const char *      str)
+{
+  /* the lines are in the file being loaded */
+  if (!self->loaded)
+    return;
+
+  GtkTextBuffer * buf =
+    gtk_text_view_get_buffer (GTK_TEXT_VIEW (self->src_view));
+  GtkTextIter iter;
+  gtk_text_buffer_get_end_iter (buf, &iter);
+  gtk_text_buffer_insert (buf, &iter, str, -1);
+  gtk_text_buffer_insert (buf, &iter, "\n", -1);
 }
 
 /**
@@ -681,6 +681,8 @@ main_window_widget_init (MainWindowWidget * self)
  /* plugin actions */
     { "plugin-toggle-enabled",                                    activate_plugin_toggle_enabled,
      "s" },
+    { "plugin-toggle-auto-sleep",
+     activate_plugin_toggle_auto_sleep, "s" },
     { "plugin-inspect",       activate_plugin_inspect },
     { "mixer-selections-delete",
      activate_mixer_selections_delete },
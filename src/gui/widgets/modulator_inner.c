@@ -189,8 +189,9 @@ modulator_inner_widget_new (ModulatorWidget * parent)
         continue;
 
       KnobWidget * knob = knob_widget_new_simple (
-        control_port_get_val, control_port_get_default_val,
-        control_port_set_real_val, port, port->minf,
+        control_port_get_queued_val,
+        control_port_get_default_val,
+        control_port_queue_real_val, port, port->minf,
         port->maxf, 24, port->zerof);
       knob->snapped_getter =
         (GenericFloatGetter) get_snapped_control_value;
@@ -215,9 +215,10 @@ modulator_macro_widget_new (int modulator_macro_idx)
   Port * port = macro->macro;
 
   KnobWidget * knob = knob_widget_new_simple (
-    control_port_get_val, control_port_get_default_val,
-    control_port_set_real_val, port, port->minf, port->maxf,
-    48, port->zerof);
+    control_port_get_queued_val,
+    control_port_get_default_val,
+    control_port_queue_real_val, port, port->minf,
+    port->maxf, 48, port->zerof);
   self->knob_with_name = knob_with_name_widget_new (
     macro,
     (GenericStringGetter) modulator_macro_processor_get_name,
@@ -11,6 +11,7 @@
 #include "plugins/plugin_gtk.h"
 #include "project.h"
 #include "settings/settings.h"
+#include "utils/cpu_topology.h"
 #include "utils/flags.h"
 #include "utils/gtk.h"
 #include "utils/io.h"
@@ -584,6 +585,8 @@ make_control (
             "DSP", "Pan", "pan-algorithm", pan_algorithm_str);
           SET_STRV_IF_MATCH (
             "DSP", "Pan", "pan-law", pan_law_str);
+          SET_STRV_IF_MATCH (
+            "DSP", "Threads", "affinity", cpu_affinity_str);
 
 #undef SET_STRV_IF_MATCH
 
@@ -4,14 +4,18 @@
 #include "zrythm-config.h"
 
 #include <math.h>
+#include <string.h>
 
 #include "audio/audio_bus_track.h"
 #include "audio/audio_region.h"
 #include "audio/automation_region.h"
 #include "audio/channel.h"
+#include "audio/engine.h"
 #include "audio/fade.h"
 #include "audio/instrument_track.h"
+#include "audio/tempo_map.h"
 #include "audio/tempo_track.h"
+#include "audio/transport.h"
 #include "audio/track.h"
 #include "gui/widgets/arranger.h"
 #include "gui/widgets/arranger_object.h"
@@ -52,6 +56,15 @@ typedef enum RegionCounterpart
   REGION_COUNTERPART_LANE,
 } RegionCounterpart;
 
+/** Generation of all region contents, bumped
+ * when something affecting every region changes
+ * (eg, track colors, undo/redo). */
+static volatile guint contents_generation = 1;
+
+/** Width of the tiles region contents are cached
+ * in. */
+#define CONTENTS_TILE_WIDTH 1024
+
 /**
  * Recreates the pango layouts for drawing.
  *
@@ -700,7 +713,8 @@ draw_automation_region (
                         (int) (x_start_real + ac_width + 0.1),
                         full_height);
                       if (automation_point_settings_changed (
-                            ap, &ap_draw_rect, true))
+                            ap, next_ap, &ap_draw_rect,
+                            true))
                         {
                           cr_node = gsk_cairo_node_new (
                             &GRAPHENE_RECT_INIT (
@@ -737,59 +751,52 @@ draw_automation_region (
                       cairo_set_line_width (cr, 2.0);
                     }
 
-                  double new_x, ap_y, new_y;
                   double ac_height = fabs (y_end - y_start);
                   ac_height *= full_height;
-                  for (double k = MAX (x_start_real, 0.0);
-                       k < (x_start_real) + ac_width + 0.1;
-                       k += 0.1)
+                  double curve_y =
+                    y_start > y_end
+                      ? y_end_real
+                      : y_start_real;
+
+                  /* draw the cached curve samples as a
+                   * polyline, starting from the first
+                   * visible one */
+                  int num_samples =
+                    automation_point_get_num_curve_samples_for_width (
+                      ac_width);
+                  const double * samples =
+                    automation_point_get_curve_samples (
+                      ap, next_ap, num_samples);
+                  g_return_if_fail (samples);
+                  double px_per_sample =
+                    ac_width / num_samples;
+                  int first_sample = 0;
+                  if (px_per_sample > 0.0)
                     {
-                      if (math_doubles_equal (ac_width, 0.0))
-                        {
-                          ap_y = 0.5;
-                        }
-                      else
-                        {
-                          ap_y =
-                            /* in pixels, higher values
-                             * are lower */
-                            1.0
-                            - automation_point_get_normalized_value_in_curve (
-                              ap,
-                              CLAMP (
-                                (k - x_start_real) / ac_width,
-                                0.0, 1.0));
-                        }
-                      ap_y *= ac_height;
-
-                      new_x = k;
-                      if (y_start > y_end)
-                        new_y = ap_y + y_end_real;
-                      else
-                        new_y = ap_y + y_start_real;
-
+                      first_sample = CLAMP (
+                        (int) (-x_start_real
+                               / px_per_sample),
+                        0, num_samples - 1);
+                    }
+                  for (int k = first_sample; k <= num_samples;
+                       k++)
+                    {
+                      double new_x =
+                        x_start_real + k * px_per_sample;
                       if (new_x >= full_width)
                         break;
 
-                      if (math_doubles_equal (k, 0.0))
-                        {
-                          if (use_cairo)
-                            {
-                              cairo_move_to (cr, new_x, new_y);
-                            }
-                          else
-                            {
-                              gtk_snapshot_append_color (
-                                snapshot, &color,
-                                &GRAPHENE_RECT_INIT (
-                                  (float) new_x,
-                                  (float) new_y, 1, 1));
-                            }
-                        }
+                      /* in pixels, higher values are lower */
+                      double new_y =
+                        (1.0 - samples[k]) * ac_height
+                        + curve_y;
 
                       if (use_cairo)
                         {
-                          cairo_line_to (cr, new_x, new_y);
+                          if (k == first_sample)
+                            cairo_move_to (cr, new_x, new_y);
+                          else
+                            cairo_line_to (cr, new_x, new_y);
                         }
                       else
                         {
@@ -817,6 +824,8 @@ draw_automation_region (
                       gtk_snapshot_restore (snapshot);
 
                       ap->last_settings_tl.fvalue = ap->fvalue;
+                      ap->last_settings_tl.next_fvalue =
+                        next_ap->fvalue;
                       ap->last_settings_tl.curve_opts =
                         ap->curve_opts;
                       ap->last_settings_tl.draw_rect =
@@ -1128,35 +1137,9 @@ draw_audio_part (
           if (loop_frames == 0)
             break;
         }
-      float min = 0.f, max = 0.f;
-      for (signed_frame_t j = prev_frames; j < curr_frames; j++)
-        {
-          for (unsigned int k = 0; k < clip->channels; k++)
-            {
-              signed_frame_t index =
-                j * (signed_frame_t) clip->channels
-                + (signed_frame_t) k;
-
-              /* if outside bounds */
-              if (
-                index < 0
-                || index >= (signed_frame_t) clip->num_frames
-                              * (signed_frame_t) clip->channels)
-                {
-                  /* skip */
-                  continue;
-                }
-              float val = clip->frames[index];
-              if (val > max)
-                {
-                  max = val;
-                }
-              if (val < min)
-                {
-                  min = val;
-                }
-            }
-        }
+      float min, max;
+      audio_clip_get_min_max (
+        clip, prev_frames, curr_frames, &min, &max);
 
       /* normalize */
       min = (min + 1.f) / 2.f;
@@ -1357,6 +1340,184 @@ draw_bottom_right_part (
     }
 }
 
+void
+region_invalidate_contents_caches (void)
+{
+  g_atomic_int_inc (&contents_generation);
+}
+
+/**
+ * Frees the cached content tiles of the given
+ * counterpart.
+ */
+static void
+free_contents_tiles (ZRegion * self, int counterpart)
+{
+  GskRenderNode ** tiles = self->contents_tiles[counterpart];
+  if (!tiles)
+    return;
+
+  for (int i = 0; i < self->num_contents_tiles[counterpart];
+       i++)
+    {
+      object_free_w_func_and_null (
+        gsk_render_node_unref, tiles[i]);
+    }
+  object_zero_and_free (self->contents_tiles[counterpart]);
+  self->num_contents_tiles[counterpart] = 0;
+}
+
+void
+region_free_contents_cache (ZRegion * self)
+{
+  for (int i = 0; i < 2; i++)
+    {
+      free_contents_tiles (self, i);
+    }
+}
+
+/**
+ * Draws the region contents (notes, waveform,
+ * automation curve, chords) inside @ref draw_rect,
+ * relative to the full rect.
+ */
+static void
+draw_contents_uncached (
+  ZRegion *      self,
+  GtkSnapshot *  snapshot,
+  GdkRectangle * full_rect,
+  GdkRectangle * draw_rect)
+{
+  switch (self->id.type)
+    {
+    case REGION_TYPE_MIDI:
+      draw_midi_region (self, snapshot, full_rect, draw_rect);
+      break;
+    case REGION_TYPE_AUTOMATION:
+      draw_automation_region (
+        self, snapshot, full_rect, draw_rect);
+      break;
+    case REGION_TYPE_CHORD:
+      draw_chord_region (
+        self, snapshot, full_rect, draw_rect);
+      break;
+    case REGION_TYPE_AUDIO:
+      draw_audio_region (
+        self, snapshot, full_rect, draw_rect, false,
+        (int) draw_rect->x - full_rect->x,
+        (int) draw_rect->width);
+      break;
+    default:
+      break;
+    }
+}
+
+/**
+ * Draws the region contents, reusing the tiles
+ * rendered in previous frames if nothing that
+ * affects the contents changed.
+ *
+ * The contents are cached in tiles of
+ * CONTENTS_TILE_WIDTH pixels covering the full
+ * rect, relative to it, so the cache stays valid
+ * when the region is scrolled or moved and only
+ * tiles that become visible need to be rendered.
+ */
+static void
+draw_contents (
+  ZRegion *      self,
+  int            counterpart,
+  GtkSnapshot *  snapshot,
+  GdkRectangle * full_rect,
+  GdkRectangle * draw_rect)
+{
+  /* contents change continuously while recording
+   * or stretching, don't bother caching */
+  if (TRANSPORT_IS_RECORDING || self->stretching)
+    {
+      free_contents_tiles (self, counterpart);
+      draw_contents_uncached (
+        self, snapshot, full_rect, draw_rect);
+      return;
+    }
+
+  RegionContentsCacheKey key;
+  memset (&key, 0, sizeof (key));
+  key.full_width = full_rect->width;
+  key.full_height = full_rect->height;
+  key.detail = (int) ui_get_detail_level ();
+  key.generation =
+    (guint) g_atomic_int_get (&contents_generation);
+  key.version =
+    (guint) g_atomic_int_get (&self->contents_version);
+  const TempoMap * map =
+    g_atomic_pointer_get (&AUDIO_ENGINE->tempo_map);
+  key.tempo_map_version = map ? map->version : 0;
+  key.px_per_tick = MW_RULER->px_per_tick;
+  key.frames_per_tick = AUDIO_ENGINE->frames_per_tick;
+  key.bpm =
+    (double) tempo_track_get_current_bpm (P_TEMPO_TRACK);
+
+  int num_tiles =
+    (full_rect->width + CONTENTS_TILE_WIDTH - 1)
+    / CONTENTS_TILE_WIDTH;
+  RegionContentsCacheKey * cached_key =
+    &self->contents_key[counterpart];
+  if (
+    self->num_contents_tiles[counterpart] != num_tiles
+    || memcmp (cached_key, &key, sizeof (key)) != 0)
+    {
+      free_contents_tiles (self, counterpart);
+      self->contents_tiles[counterpart] =
+        object_new_n ((size_t) num_tiles, GskRenderNode *);
+      self->num_contents_tiles[counterpart] = num_tiles;
+      *cached_key = key;
+    }
+
+  GskRenderNode ** tiles = self->contents_tiles[counterpart];
+  int first_tile =
+    (draw_rect->x - full_rect->x) / CONTENTS_TILE_WIDTH;
+  int last_tile =
+    ((draw_rect->x - full_rect->x) + draw_rect->width - 1)
+    / CONTENTS_TILE_WIDTH;
+  first_tile = MAX (first_tile, 0);
+  last_tile = MIN (last_tile, num_tiles - 1);
+  for (int i = first_tile; i <= last_tile; i++)
+    {
+      if (!tiles[i])
+        {
+          int tile_x = i * CONTENTS_TILE_WIDTH;
+          int tile_width = MIN (
+            CONTENTS_TILE_WIDTH, full_rect->width - tile_x);
+          GdkRectangle tile_rect = {
+            .x = full_rect->x + tile_x,
+            .y = full_rect->y,
+            .width = tile_width,
+            .height = full_rect->height,
+          };
+
+          GtkSnapshot * child_snapshot = gtk_snapshot_new ();
+          gtk_snapshot_push_clip (
+            child_snapshot,
+            &GRAPHENE_RECT_INIT (
+              (float) tile_x, 0.f, (float) tile_width,
+              (float) full_rect->height));
+          draw_contents_uncached (
+            self, child_snapshot, full_rect, &tile_rect);
+          gtk_snapshot_pop (child_snapshot);
+          tiles[i] =
+            gtk_snapshot_free_to_node (child_snapshot);
+
+          /* NULL if nothing was drawn, use an empty
+           * node so the tile is not redrawn */
+          if (!tiles[i])
+            tiles[i] = gsk_container_node_new (NULL, 0);
+        }
+
+      gtk_snapshot_append_node (snapshot, tiles[i]);
+    }
+}
+
 /**
  * Draws the ZRegion in the given cairo context in
  * relative coordinates.
@@ -1475,29 +1636,8 @@ region_draw (
           (float) full_rect.x, (float) full_rect.y));
 
       /* draw any remaining parts */
-      switch (self->id.type)
-        {
-        case REGION_TYPE_MIDI:
-          draw_midi_region (
-            self, snapshot, &full_rect, &draw_rect);
-          break;
-        case REGION_TYPE_AUTOMATION:
-          draw_automation_region (
-            self, snapshot, &full_rect, &draw_rect);
-          break;
-        case REGION_TYPE_CHORD:
-          draw_chord_region (
-            self, snapshot, &full_rect, &draw_rect);
-          break;
-        case REGION_TYPE_AUDIO:
-          draw_audio_region (
-            self, snapshot, &full_rect, &draw_rect, false,
-            (int) draw_rect.x - last_full_rect.x,
-            (int) draw_rect.width);
-          break;
-        default:
-          break;
-        }
+      draw_contents (
+        self, i, snapshot, &full_rect, &draw_rect);
 
         /* ---- draw applicable icons ---- */
 
@@ -539,8 +539,9 @@ track_input_expander_widget_refresh (
 
       Port * port = track->processor->input_gain;
       self->gain = knob_widget_new_simple (
-        control_port_get_val, control_port_get_default_val,
-        control_port_set_real_val_w_events, port, port->minf,
+        control_port_get_queued_val,
+        control_port_get_default_val,
+        control_port_queue_real_val, port, port->minf,
         port->maxf, 24, port->zerof);
       gtk_box_append (
         GTK_BOX (self->gain_box), GTK_WIDGET (self->gain));
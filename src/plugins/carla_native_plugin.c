@@ -11,6 +11,7 @@
 
 #  include "audio/engine.h"
 #  include "audio/midi_event.h"
+#  include "audio/router.h"
 #  include "audio/tempo_track.h"
 #  include "audio/transport.h"
 #  include "gui/backend/event.h"
@@ -34,6 +35,7 @@
 #  include "utils/math.h"
 #  include "utils/objects.h"
 #  include "utils/string.h"
+#  include "utils/system.h"
 #  include "zrythm.h"
 #  include "zrythm_app.h"
 
@@ -202,8 +204,11 @@ host_write_midi_event (
     {
       buf[i] = event->data[i];
     }
+  /* event time is relative to the processed block,
+   * make it relative to the cycle */
   midi_events_add_event_from_buf (
-    midi_out_port->midi_events, event->time, buf, event->size,
+    midi_out_port->midi_events,
+    self->local_offset + event->time, buf, event->size,
     false);
 
   return 0;
@@ -232,7 +237,9 @@ host_ui_parameter_changed (
         self->host_handle, 1, index, value);
     }
 
-  port_set_control_value (port, value, false, false);
+  /* the value is already set in carla */
+  router_queue_control_value (
+    ROUTER, port, value, F_NO_PUBLISH_EVENTS);
 }
 
 static void
@@ -858,6 +865,7 @@ carla_native_plugin_process (
 #  endif
     }
 
+  self->local_offset = time_nfo->local_offset;
   self->native_plugin_descriptor->process (
     self->native_plugin_handle, self->inbufs, self->outbufs,
     time_nfo->nframes, events, (uint32_t) num_events_written);
@@ -1476,6 +1484,146 @@ add_internal_plugin_from_descr (
   return ret;
 }
 
+/** Max child processes to consider when looking for
+ * the bridge process. */
+#  define MAX_CHILD_PIDS 512
+
+/**
+ * Returns whether the given process is a Carla
+ * plugin bridge hosting the given plugin.
+ *
+ * Carla starts the bridge binary
+ * (carla-bridge-native, carla-bridge-posix64,
+ * carla-bridge-win64.exe, etc.) with the plugin's
+ * filename and label as arguments.
+ */
+static bool
+is_bridge_process_for (
+  int                      pid,
+  const PluginDescriptor * descr)
+{
+  char ** args = system_get_process_cmdline (pid);
+  if (!args)
+    return false;
+
+  bool is_bridge = false;
+  bool has_plugin = false;
+  for (int i = 0; args[i]; i++)
+    {
+      char * basename = g_path_get_basename (args[i]);
+      /* UI bridges are named carla-bridge-lv2-* */
+      if (
+        g_str_has_prefix (basename, "carla-bridge-")
+        && !g_str_has_prefix (basename, "carla-bridge-lv2"))
+        {
+          is_bridge = true;
+        }
+      g_free (basename);
+
+      if (
+        is_bridge
+        && args[i][0] != '\0'
+        && (string_is_equal (args[i], descr->uri)
+            || string_is_equal (args[i], descr->path)
+            || string_is_equal (args[i], descr->name)))
+        {
+          has_plugin = true;
+          break;
+        }
+    }
+  g_strfreev (args);
+
+  return is_bridge && has_plugin;
+}
+
+/**
+ * Sets the PID of the bridge process to the child
+ * process that did not exist before adding the
+ * plugin and runs the Carla bridge for it.
+ *
+ * Other child processes may be spawned at the same
+ * time (e.g. by g_spawn() elsewhere), so new
+ * processes are only considered if their command
+ * line is a bridge for this plugin.
+ */
+static void
+set_bridge_pid (
+  CarlaNativePlugin * self,
+  const int *         prev_child_pids,
+  int                 num_prev_child_pids)
+{
+  const PluginDescriptor * descr =
+    self->plugin->setting->descr;
+  int pids[MAX_CHILD_PIDS];
+  int num_pids = system_get_child_pids (pids, MAX_CHILD_PIDS);
+  self->bridge_pid = 0;
+  for (int i = 0; i < num_pids; i++)
+    {
+      bool existed = false;
+      for (int j = 0; j < num_prev_child_pids; j++)
+        {
+          if (prev_child_pids[j] == pids[i])
+            {
+              existed = true;
+              break;
+            }
+        }
+      if (!existed && is_bridge_process_for (pids[i], descr))
+        {
+          self->bridge_pid = pids[i];
+          break;
+        }
+    }
+
+  if (self->bridge_pid > 0)
+    {
+      g_message (
+        "plugin bridge process: %d", self->bridge_pid);
+      self->bridge_cpu_time =
+        system_get_process_cpu_time (self->bridge_pid);
+      self->bridge_cpu_time_updated = g_get_monotonic_time ();
+    }
+  else
+    {
+      g_message ("plugin bridge process not found");
+    }
+}
+
+/**
+ * Returns the CPU load (0-1 of one core) of the
+ * bridge process hosting the plugin since the last
+ * call, as reported by the process itself, or a
+ * negative value if the plugin is not fully bridged
+ * or the load is unknown.
+ *
+ * To be called periodically from the GTK thread.
+ */
+float
+carla_native_plugin_get_bridge_cpu_load (
+  CarlaNativePlugin * self)
+{
+  if (self->bridge_pid <= 0)
+    return -1.f;
+
+  int64_t cpu_time =
+    system_get_process_cpu_time (self->bridge_pid);
+  gint64 now = g_get_monotonic_time ();
+  if (cpu_time < 0 || self->bridge_cpu_time < 0)
+    return -1.f;
+
+  gint64 elapsed = now - self->bridge_cpu_time_updated;
+  if (elapsed <= 0)
+    return 0.f;
+
+  float load =
+    (float) (cpu_time - self->bridge_cpu_time)
+    / (float) elapsed;
+  self->bridge_cpu_time = cpu_time;
+  self->bridge_cpu_time_updated = now;
+
+  return load;
+}
+
 /**
  * Instantiates the plugin.
  *
@@ -1781,8 +1929,24 @@ carla_native_plugin_instantiate (
       return -1;
     }
 
+  /* remember the existing child processes to find
+   * the bridge process spawned for this plugin */
+  int prev_child_pids[MAX_CHILD_PIDS];
+  int num_prev_child_pids = 0;
+  if (setting->bridge_mode == CARLA_BRIDGE_FULL)
+    {
+      num_prev_child_pids = system_get_child_pids (
+        prev_child_pids, MAX_CHILD_PIDS);
+    }
+
   int ret = add_internal_plugin_from_descr (self, descr);
 
+  if (setting->bridge_mode == CARLA_BRIDGE_FULL)
+    {
+      set_bridge_pid (
+        self, prev_child_pids, num_prev_child_pids);
+    }
+
   carla_native_plugin_update_buffer_size_and_sample_rate (
     self);
 
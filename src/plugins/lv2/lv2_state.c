@@ -361,10 +361,14 @@ lv2_state_apply_state (Lv2Plugin * plugin, LilvState * state)
   plugin_print (plugin->plugin, pl_str, 800);
 
   /* if plugin does not support thread safe
-   * restore, stop the engine */
+   * restore, stop the engine (not needed if the
+   * plugin is not activated since it will not be
+   * run) */
   EngineState engine_state;
   bool        engine_paused = false;
-  if (!plugin->safe_restore && AUDIO_ENGINE->run)
+  if (
+    !plugin->safe_restore && plugin->plugin->activated
+    && AUDIO_ENGINE->run)
     {
       g_message (
         "plugin '%s' does not support safe "
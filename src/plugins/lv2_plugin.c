@@ -371,6 +371,7 @@ create_port (
         {
           g_return_val_if_fail (
             IS_PORT_AND_NONNULL (port), NULL);
+          port_unalias_buf (port);
           port->buf = g_realloc (
             port->buf,
             (size_t) AUDIO_ENGINE->block_length
@@ -2810,7 +2811,12 @@ lv2_plugin_instantiate (
 
   /* apply loaded state to plugin instance if
    * necessary */
-  if (state)
+  if (state && self->defer_state_restore)
+    {
+      g_message ("deferring applying state");
+      self->deferred_state = state;
+    }
+  else if (state)
     {
       g_message ("applying state");
       lv2_state_apply_state (self, state);
@@ -2849,6 +2855,19 @@ lv2_plugin_instantiate (
   return 0;
 }
 
+void
+lv2_plugin_apply_deferred_state (Lv2Plugin * self)
+{
+  g_return_if_fail (!self->plugin->activated);
+
+  self->defer_state_restore = false;
+  if (!self->deferred_state)
+    return;
+
+  lv2_state_apply_state (self, self->deferred_state);
+  self->deferred_state = NULL;
+}
+
 int
 lv2_plugin_activate (Lv2Plugin * self, bool activate)
 {
@@ -3229,10 +3248,13 @@ lv2_plugin_process (
                         }
                       else
                         {
-                          /* Write MIDI event to port */
+                          /* Write MIDI event to port
+                           * (relative to the cycle, not
+                           * the processed block) */
                           midi_events_add_event_from_buf (
-                            port->midi_events, frames, body,
-                            (int) size, 0);
+                            port->midi_events,
+                            time_nfo->local_offset + frames,
+                            body, (int) size, 0);
                         }
                     }
 
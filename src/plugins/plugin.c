@@ -215,28 +215,12 @@ plugin_init_loaded (
     }
 #endif
 
-  if (plugin_is_in_active_project (self))
+  /* when loading a project, all plugins are
+   * instantiated together afterwards (see
+   * plugin_instantiate_batch()) */
+  if (plugin_is_in_active_project (self) && PROJECT->loaded)
     {
-      bool     was_enabled = plugin_is_enabled (self, false);
-      GError * err = NULL;
-      int      ret = plugin_instantiate (self, NULL, &err);
-      if (ret == 0)
-        {
-          plugin_activate (self, true);
-
-          plugin_set_enabled (
-            self, was_enabled, F_NO_PUBLISH_EVENTS);
-        }
-      else
-        {
-          /* disable plugin, instantiation failed */
-          HANDLE_ERROR (
-            err,
-            _ ("Instantiation failed for "
-               "plugin '%s'. Disabling..."),
-            self->setting->descr->name);
-          self->instantiation_failed = true;
-        }
+      plugin_instantiate_batch (&self, 1, true);
     }
 
   /*Track * track = plugin_get_track (self);*/
@@ -1283,6 +1267,8 @@ plugin_move_automation (
   for (int i = prev_atl->num_ats - 1; i >= 0; i--)
     {
       AutomationTrack * at = prev_atl->ats[i];
+      if (at->port_id.owner_type != PORT_OWNER_TYPE_PLUGIN)
+        continue;
       Port * port = port_find_from_identifier (&at->port_id);
       g_return_if_fail (IS_PORT (port));
       if (!port)
@@ -1497,6 +1483,236 @@ plugin_update_identifier (Plugin * self)
     }
 }
 
+typedef struct PluginInstantiateJob
+{
+  Plugin * pl;
+
+  /** Enabled state before instantiation. */
+  bool was_enabled;
+
+  /** Whether instantiation succeeded. */
+  bool success;
+
+  /** Time taken to instantiate, in microseconds. */
+  gint64 instantiate_time;
+
+  /** Time taken to restore the state, in
+   * microseconds. */
+  gint64 restore_time;
+
+  /** Whether the state must be restored. */
+  bool restore;
+
+  /** Whether the job is the first of its plugin
+   * URI whose state is restored. */
+  bool first_of_uri;
+
+  /** Next job whose state is restored after this
+   * one, for plugins with the same URI. */
+  struct PluginInstantiateJob * next_same_uri;
+} PluginInstantiateJob;
+
+/**
+ * Restores the states of the given job and the
+ * jobs chained after it, one after the other.
+ */
+static void
+restore_state_func (gpointer data, gpointer user_data)
+{
+  for (PluginInstantiateJob * job =
+         (PluginInstantiateJob *) data;
+       job; job = job->next_same_uri)
+    {
+      gint64 start = g_get_monotonic_time ();
+      lv2_plugin_apply_deferred_state (job->pl->lv2);
+      job->restore_time = g_get_monotonic_time () - start;
+    }
+}
+
+static int
+cmp_jobs_by_time_desc (const void * a, const void * b)
+{
+  const PluginInstantiateJob * ja =
+    (const PluginInstantiateJob *) a;
+  const PluginInstantiateJob * jb =
+    (const PluginInstantiateJob *) b;
+  gint64 ta = ja->instantiate_time + ja->restore_time;
+  gint64 tb = jb->instantiate_time + jb->restore_time;
+  return (ta < tb) - (ta > tb);
+}
+
+/**
+ * Instantiates the given plugins.
+ *
+ * The plugins are instantiated one by one since
+ * the LV2 world and Carla are not thread-safe, but
+ * the states of LV2 plugins (usually the slow part,
+ * e.g. for sample-based instruments) are restored
+ * in parallel. States of instances of the same
+ * plugin are restored one after the other, since
+ * not all plugins support restoring concurrently.
+ * The plugins are only activated once all of them
+ * are ready.
+ *
+ * Plugins that are already instantiated or failed
+ * to instantiate are skipped.
+ *
+ * @param activate Whether to activate the plugins
+ *   and restore their enabled state.
+ */
+void
+plugin_instantiate_batch (
+  Plugin ** plugins,
+  int       num_plugins,
+  bool      activate)
+{
+  for (int i = 0; i < num_plugins; i++)
+    {
+      g_return_if_fail (IS_PLUGIN_AND_NONNULL (plugins[i]));
+    }
+
+  gint64 start = g_get_monotonic_time ();
+
+  PluginInstantiateJob * jobs = object_new_n (
+    (size_t) MAX (num_plugins, 1), PluginInstantiateJob);
+  int num_jobs = 0;
+  for (int i = 0; i < num_plugins; i++)
+    {
+      Plugin * pl = plugins[i];
+      if (pl->instantiated || pl->instantiation_failed)
+        continue;
+
+      PluginInstantiateJob * job = &jobs[num_jobs++];
+      job->pl = pl;
+      job->was_enabled = plugin_is_enabled (pl, false);
+
+      /* plugins without a state dir save their
+       * state right after instantiation, so it must
+       * be restored before that */
+      if (
+        pl->lv2 && !pl->setting->open_with_carla
+        && pl->state_dir)
+        {
+          pl->lv2->defer_state_restore = true;
+        }
+
+      g_message (
+        "[%d/%d] instantiating plugin '%s'...", i + 1,
+        num_plugins, pl->setting->descr->name);
+      GError * err = NULL;
+      gint64   pl_start = g_get_monotonic_time ();
+      int      ret = plugin_instantiate (pl, NULL, &err);
+      job->instantiate_time =
+        g_get_monotonic_time () - pl_start;
+      if (ret == 0)
+        {
+          job->success = true;
+        }
+      else
+        {
+          if (pl->lv2)
+            {
+              pl->lv2->defer_state_restore = false;
+              pl->lv2->deferred_state = NULL;
+            }
+
+          /* disable plugin, instantiation failed */
+          HANDLE_ERROR (
+            err,
+            _ ("Instantiation failed for "
+               "plugin '%s'. Disabling..."),
+            pl->setting->descr->name);
+          pl->instantiation_failed = true;
+        }
+    }
+
+  /* restore the states in parallel */
+  GThreadPool * thread_pool = g_thread_pool_new (
+    restore_state_func, NULL, (int) g_get_num_processors (),
+    false, NULL);
+  for (int i = 0; i < num_jobs; i++)
+    {
+      PluginInstantiateJob * job = &jobs[i];
+      if (!job->success || !job->pl->lv2)
+        continue;
+
+      job->pl->lv2->defer_state_restore = false;
+      if (!job->pl->lv2->deferred_state)
+        continue;
+
+      job->restore = true;
+
+      /* chain after the last job of the same plugin,
+       * if any */
+      PluginInstantiateJob * prev = NULL;
+      for (int j = 0; j < i; j++)
+        {
+          PluginInstantiateJob * other = &jobs[j];
+          if (
+            other->restore
+            && string_is_equal (
+              other->pl->setting->descr->uri,
+              job->pl->setting->descr->uri))
+            {
+              prev = other;
+            }
+        }
+      if (prev)
+        prev->next_same_uri = job;
+      else
+        job->first_of_uri = true;
+    }
+
+  /* only start once the chains are complete */
+  for (int i = 0; i < num_jobs; i++)
+    {
+      if (jobs[i].first_of_uri)
+        g_thread_pool_push (thread_pool, &jobs[i], NULL);
+    }
+
+  /* wait for all states to be restored */
+  g_thread_pool_free (thread_pool, false, true);
+
+  for (int i = 0; i < num_jobs && activate; i++)
+    {
+      PluginInstantiateJob * job = &jobs[i];
+      if (!job->success)
+        continue;
+
+      plugin_activate (job->pl, true);
+      plugin_set_enabled (
+        job->pl, job->was_enabled, F_NO_PUBLISH_EVENTS);
+    }
+
+  /* report the slowest plugins first */
+  if (num_jobs > 1)
+    {
+      qsort (
+        jobs, (size_t) num_jobs,
+        sizeof (PluginInstantiateJob),
+        cmp_jobs_by_time_desc);
+    }
+  for (int i = 0; i < num_jobs; i++)
+    {
+      PluginInstantiateJob * job = &jobs[i];
+      g_message (
+        "plugin '%s': %s, instantiated in %" G_GINT64_FORMAT
+        " ms, state restored in %" G_GINT64_FORMAT " ms",
+        job->pl->setting->descr->name,
+        job->success ? "ok" : "failed",
+        job->instantiate_time / 1000,
+        job->restore_time / 1000);
+    }
+  if (num_jobs > 0)
+    {
+      g_message (
+        "%d plugin(s) ready in %" G_GINT64_FORMAT " ms",
+        num_jobs, (g_get_monotonic_time () - start) / 1000);
+    }
+
+  free (jobs);
+}
+
 /**
  * Sets the track name hash on the plugin.
  */
@@ -1649,6 +1865,291 @@ plugin_prepare_process (Plugin * self)
     }
 }
 
+/**
+ * Enables or disables auto-sleep.
+ */
+void
+plugin_set_auto_sleep (Plugin * self, bool auto_sleep)
+{
+  self->auto_sleep = auto_sleep;
+
+  /* the state is owned by the processing thread */
+  g_atomic_int_set (&self->auto_sleep_reset_requested, 1);
+}
+
+/**
+ * Resets the auto-sleep state and statistics.
+ *
+ * To be called from the processing thread.
+ */
+static void
+reset_auto_sleep (Plugin * self)
+{
+  self->sleeping = false;
+  self->silent_input_frames = 0;
+  self->awake_frames = 0;
+  self->sleep_frames = 0;
+  self->num_wakeups = 0;
+}
+
+/**
+ * Returns the fraction of frames (0-1) skipped by
+ * auto-sleep since it was enabled.
+ */
+float
+plugin_get_auto_sleep_ratio (const Plugin * self)
+{
+  uint64_t total = self->awake_frames + self->sleep_frames;
+  if (total == 0)
+    return 0.f;
+
+  return (float) ((double) self->sleep_frames
+                  / (double) total);
+}
+
+/**
+ * Returns whether all audio, CV and MIDI inputs are
+ * silent in this cycle.
+ *
+ * Plugins without such inputs (generators) are never
+ * considered silent.
+ */
+static bool
+inputs_are_silent (const Plugin * self)
+{
+  if (
+    self->audio_in_ports->len == 0
+    && self->cv_in_ports->len == 0
+    && self->midi_in_ports->len == 0)
+    return false;
+
+  for (size_t i = 0; i < self->audio_in_ports->len; i++)
+    {
+      const Port * port =
+        g_ptr_array_index (self->audio_in_ports, i);
+      if (!port_is_silent (port))
+        return false;
+    }
+  for (size_t i = 0; i < self->cv_in_ports->len; i++)
+    {
+      const Port * port =
+        g_ptr_array_index (self->cv_in_ports, i);
+      if (!port_is_silent (port))
+        return false;
+    }
+  for (size_t i = 0; i < self->midi_in_ports->len; i++)
+    {
+      const Port * port =
+        g_ptr_array_index (self->midi_in_ports, i);
+      if (port->midi_events->num_events > 0)
+        return false;
+    }
+
+  return true;
+}
+
+/**
+ * Returns whether the tail of the plugin has
+ * decayed (all audio/CV outputs are below
+ * @ref PLUGIN_AUTO_SLEEP_TAIL_THRESHOLD in the
+ * processed range).
+ */
+static bool
+output_has_decayed (
+  const Plugin *                      self,
+  const EngineProcessTimeInfo * const time_nfo)
+{
+  for (int i = 0; i < self->num_out_ports; i++)
+    {
+      const Port * port = self->out_ports[i];
+      if (
+        port->id.type != TYPE_AUDIO
+        && port->id.type != TYPE_CV)
+        continue;
+
+      if (
+        dsp_abs_max (
+          &port->buf[time_nfo->local_offset],
+          time_nfo->nframes)
+        >= PLUGIN_AUTO_SLEEP_TAIL_THRESHOLD)
+        return false;
+    }
+
+  return true;
+}
+
+/**
+ * Fills the outputs of a sleeping plugin with
+ * silence.
+ */
+static void
+process_sleeping (
+  Plugin *                            self,
+  const EngineProcessTimeInfo * const time_nfo)
+{
+  for (int i = 0; i < self->num_out_ports; i++)
+    {
+      Port * port = self->out_ports[i];
+      if (
+        port->id.type != TYPE_AUDIO
+        && port->id.type != TYPE_CV)
+        continue;
+
+      dsp_fill (
+        &port->buf[time_nfo->local_offset],
+        DENORMAL_PREVENTION_VAL, time_nfo->nframes);
+      port_update_silence (port, true);
+    }
+
+  self->sleep_frames += time_nfo->nframes;
+}
+
+/**
+ * Runs the plugin for the given range.
+ */
+static void
+process_block (
+  Plugin *                            self,
+  const EngineProcessTimeInfo * const time_nfo)
+{
+#ifdef HAVE_CARLA
+  if (self->setting->open_with_carla)
+    {
+      carla_native_plugin_process (self->carla, time_nfo);
+      return;
+    }
+#endif
+
+  switch (self->setting->descr->protocol)
+    {
+    case PROT_LV2:
+      lv2_plugin_process (self->lv2, time_nfo);
+      break;
+    default:
+      break;
+    }
+}
+
+/**
+ * Returns whether the automation of the given
+ * control input port should be re-read inside the
+ * processing cycle.
+ *
+ * Ports with incoming connections (eg, CV) are
+ * skipped since their value is not only set from
+ * automation.
+ */
+static inline bool
+should_read_automation_in_cycle (Port * port)
+{
+  return port->id.flags & PORT_FLAG_AUTOMATABLE
+         && port->at && port->num_srcs == 0;
+}
+
+/**
+ * Returns whether any automated control input of the
+ * plugin changes value inside the given range.
+ *
+ * The values at the start of each sub-block of
+ * @p sub_block_size frames and at the last frame
+ * are compared to the value at the first frame, so
+ * curves that move and come back within the range
+ * are detected too. Changes that do not cross a
+ * sub-block boundary would not be applied anyway.
+ */
+static bool
+automation_changes_in_range (
+  Plugin *                            self,
+  const EngineProcessTimeInfo * const time_nfo,
+  const nframes_t                     sub_block_size)
+{
+  const unsigned_frame_t start = time_nfo->g_start_frame;
+  const nframes_t        last = time_nfo->nframes - 1;
+  for (size_t i = 0; i < self->ctrl_in_ports->len; i++)
+    {
+      Port * port =
+        g_ptr_array_index (self->ctrl_in_ports, i);
+      if (!should_read_automation_in_cycle (port))
+        continue;
+
+      float start_val;
+      if (!port_get_automation_val (port, start, &start_val))
+        continue;
+
+      nframes_t offset = sub_block_size;
+      while (true)
+        {
+          if (offset > last)
+            offset = last;
+
+          float val;
+          if (
+            port_get_automation_val (
+              port, start + offset, &val)
+            && !math_floats_equal (start_val, val))
+            {
+              return true;
+            }
+
+          if (offset == last)
+            break;
+          offset += sub_block_size;
+        }
+    }
+
+  return false;
+}
+
+/**
+ * Splits the given range into sub-blocks of at least
+ * @p sub_block_size frames and runs the plugin for
+ * each sub-block after applying the automation at
+ * its start.
+ *
+ * The automation at the start of the range was
+ * already applied by port_process().
+ */
+static void
+process_in_sub_blocks (
+  Plugin *                            self,
+  const EngineProcessTimeInfo * const time_nfo,
+  const nframes_t                     sub_block_size)
+{
+  EngineProcessTimeInfo sub_nfo = *time_nfo;
+  const nframes_t       end =
+    time_nfo->local_offset + time_nfo->nframes;
+  while (sub_nfo.local_offset < end)
+    {
+      /* merge the remainder into the last sub-block
+       * if it is too small */
+      nframes_t remaining = end - sub_nfo.local_offset;
+      sub_nfo.nframes =
+        remaining < 2 * sub_block_size
+          ? remaining
+          : sub_block_size;
+
+      if (sub_nfo.local_offset != time_nfo->local_offset)
+        {
+          for (size_t i = 0; i < self->ctrl_in_ports->len;
+               i++)
+            {
+              Port * port =
+                g_ptr_array_index (self->ctrl_in_ports, i);
+              if (should_read_automation_in_cycle (port))
+                {
+                  port_read_automation (
+                    port, sub_nfo.g_start_frame);
+                }
+            }
+        }
+
+      process_block (self, &sub_nfo);
+
+      sub_nfo.g_start_frame += sub_nfo.nframes;
+      sub_nfo.local_offset += sub_nfo.nframes;
+    }
+}
+
 /**
  * Process plugin.
  */
@@ -1657,6 +2158,12 @@ plugin_process (
   Plugin *                            plugin,
   const EngineProcessTimeInfo * const time_nfo)
 {
+  if (G_UNLIKELY (g_atomic_int_compare_and_exchange (
+        &plugin->auto_sleep_reset_requested, 1, 0)))
+    {
+      reset_auto_sleep (plugin);
+    }
+
   if (
     !plugin_is_enabled (plugin, true)
     && !plugin->own_enabled_port)
@@ -1670,6 +2177,29 @@ plugin_process (
       return;
     }
 
+  bool inputs_silent = false;
+  if (plugin->auto_sleep)
+    {
+      inputs_silent = inputs_are_silent (plugin);
+      if (plugin->sleeping)
+        {
+          if (inputs_silent)
+            {
+              process_sleeping (plugin, time_nfo);
+              return;
+            }
+
+          /* wake up immediately */
+          plugin->sleeping = false;
+          plugin->num_wakeups++;
+        }
+
+      if (inputs_silent)
+        plugin->silent_input_frames += time_nfo->nframes;
+      else
+        plugin->silent_input_frames = 0;
+    }
+
   /* if has MIDI input port */
   if (plugin->setting->descr->num_midi_ins > 0)
     {
@@ -1681,25 +2211,20 @@ plugin_process (
       /* add midi events to input port */
     }
 
-#ifdef HAVE_CARLA
-  if (plugin->setting->open_with_carla)
+  nframes_t sub_block_size =
+    AUDIO_ENGINE->plugin_sub_block_size;
+  if (
+    sub_block_size > 0 && time_nfo->nframes > sub_block_size
+    && automation_changes_in_range (
+      plugin, time_nfo, sub_block_size))
     {
-      carla_native_plugin_process (plugin->carla, time_nfo);
+      process_in_sub_blocks (
+        plugin, time_nfo, sub_block_size);
     }
   else
     {
-#endif
-      switch (plugin->setting->descr->protocol)
-        {
-        case PROT_LV2:
-          lv2_plugin_process (plugin->lv2, time_nfo);
-          break;
-        default:
-          break;
-        }
-#ifdef HAVE_CARLA
+      process_block (plugin, time_nfo);
     }
-#endif
 
   /* turn off any trigger input controls */
   for (size_t i = 0; i < plugin->ctrl_in_ports->len; i++)
@@ -1742,6 +2267,22 @@ plugin_process (
             }
         }
     }
+
+  if (plugin->auto_sleep)
+    {
+      plugin->awake_frames += time_nfo->nframes;
+
+      /* go to sleep once the tail has decayed */
+      if (
+        inputs_silent
+        && plugin->silent_input_frames
+             >= (uint64_t) PLUGIN_AUTO_SLEEP_SILENT_BLOCKS
+                  * AUDIO_ENGINE->block_length
+        && output_has_decayed (plugin, time_nfo))
+        {
+          plugin->sleeping = true;
+        }
+    }
 }
 
 /**
@@ -2191,6 +2732,7 @@ plugin_clone (Plugin * src, GError ** error)
   plugin_identifier_copy (&self->id, &src->id);
   self->magic = PLUGIN_MAGIC;
   self->visible = src->visible;
+  self->auto_sleep = src->auto_sleep;
 
   /* verify same number of inputs and outputs */
   g_return_val_if_fail (
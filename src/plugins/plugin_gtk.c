@@ -30,6 +30,7 @@
 #include <math.h>
 
 #include "audio/engine.h"
+#include "audio/router.h"
 #include "audio/track.h"
 #include "gui/backend/event.h"
 #include "gui/backend/event_manager.h"
@@ -790,14 +791,14 @@ set_float_control (Plugin * pl, Port * port, float value)
         }
       else if (port->id.flags & PORT_FLAG_GENERIC_PLUGIN_PORT)
         {
-          port_set_control_value (
-            port, value, F_NOT_NORMALIZED, F_PUBLISH_EVENTS);
+          router_queue_control_value (
+            ROUTER, port, value, F_PUBLISH_EVENTS);
         }
     }
   else if (pl->setting->open_with_carla)
     {
-      port_set_control_value (
-        port, value, F_NOT_NORMALIZED, F_PUBLISH_EVENTS);
+      router_queue_control_value (
+        ROUTER, port, value, F_PUBLISH_EVENTS);
     }
 
   PluginGtkController * controller =
@@ -1082,14 +1082,23 @@ load (const char * filename, const int is_template)
   engine_init_loaded (self->audio_engine, self);
   engine_pre_setup (self->audio_engine);
 
-  /* re-load clips because sample rate can change
-   * during engine pre setup */
+  /* load the clips only now because the sample rate
+   * can change during engine pre setup */
   audio_pool_init_loaded (self->audio_engine->pool);
 
   clip_editor_init_loaded (self->clip_editor);
   timeline_init_loaded (self->timeline);
   tracklist_init_loaded (self->tracklist, self, NULL);
 
+  /* instantiate all plugins together (before the
+   * graph is set up) so that their states can be
+   * restored in parallel */
+  GPtrArray * plugins = g_ptr_array_new ();
+  tracklist_get_plugins (self->tracklist, plugins);
+  plugin_instantiate_batch (
+    (Plugin **) plugins->pdata, (int) plugins->len, true);
+  object_free_w_func_and_null (g_ptr_array_unref, plugins);
+
   int beats_per_bar =
     tempo_track_get_beats_per_bar (P_TEMPO_TRACK);
   engine_update_frames_per_tick (
@@ -72,6 +72,9 @@ settings_new (void)
   g_return_val_if_fail (self->preferences_##a##_##b, NULL)
 
   NEW_PREFERENCES_SETTINGS (dsp, pan);
+  NEW_PREFERENCES_SETTINGS (dsp, automation);
+  NEW_PREFERENCES_SETTINGS (dsp, anticipative);
+  NEW_PREFERENCES_SETTINGS (dsp, threads);
   NEW_PREFERENCES_SETTINGS (editing, audio);
   NEW_PREFERENCES_SETTINGS (editing, automation);
   NEW_PREFERENCES_SETTINGS (editing, undo);
@@ -550,6 +553,9 @@ settings_free (Settings * self)
 
   FREE_SETTING (general);
   FREE_SETTING (preferences_dsp_pan);
+  FREE_SETTING (preferences_dsp_automation);
+  FREE_SETTING (preferences_dsp_anticipative);
+  FREE_SETTING (preferences_dsp_threads);
   FREE_SETTING (preferences_editing_audio);
   FREE_SETTING (preferences_editing_automation);
   FREE_SETTING (preferences_editing_undo);
@@ -0,0 +1,324 @@
+// SPDX-FileCopyrightText: © 2022 Alexandros Theodotou <alex@zrythm.org>
+// SPDX-License-Identifier: LicenseRef-ZrythmLicense
+
+/* for sched_getaffinity() */
+#define _GNU_SOURCE
+
+#include "zrythm-config.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#ifdef __linux__
+#  include <sched.h>
+#endif
+
+#include "utils/cpu_topology.h"
+#include "utils/objects.h"
+
+#include <glib.h>
+
+#define SYSFS_CPU_DIR "/sys/devices/system/cpu"
+
+CpuTopology *
+cpu_topology_new (int num_cpus)
+{
+  CpuTopology * self = object_new (CpuTopology);
+
+  num_cpus = CLAMP (num_cpus, 1, CPU_TOPOLOGY_MAX_CPUS);
+  self->cpus =
+    object_new_n ((size_t) num_cpus, CpuTopologyCpu);
+  for (int i = 0; i < num_cpus; i++)
+    {
+      CpuTopologyCpu * cpu = &self->cpus[i];
+      cpu->id = i;
+      cpu->allowed = true;
+    }
+  self->num_cpus = num_cpus;
+
+  return self;
+}
+
+int
+cpu_topology_parse_cpu_list (
+  const char * str,
+  bool *       cpus,
+  int          max_cpus)
+{
+  memset (cpus, 0, (size_t) max_cpus * sizeof (bool));
+
+  int          count = 0;
+  const char * p = str;
+  while (*p && !g_ascii_isspace (*p))
+    {
+      char * end;
+      gint64 first = g_ascii_strtoll (p, &end, 10);
+      if (end == p || first < 0)
+        return -1;
+      p = end;
+
+      gint64 last = first;
+      if (*p == '-')
+        {
+          p++;
+          last = g_ascii_strtoll (p, &end, 10);
+          if (end == p || last < first)
+            return -1;
+          p = end;
+        }
+
+      if (*p == ',')
+        p++;
+      else if (*p && !g_ascii_isspace (*p))
+        return -1;
+
+      for (gint64 i = first; i <= last && i < max_cpus; i++)
+        {
+          if (!cpus[i])
+            {
+              cpus[i] = true;
+              count++;
+            }
+        }
+    }
+
+  return count;
+}
+
+#ifdef __linux__
+/**
+ * Reads a CPU list from the given sysfs file.
+ *
+ * @return The number of CPUs in the list, or -1 if
+ *   the file could not be read.
+ */
+static int
+read_cpu_list (const char * path, bool * cpus)
+{
+  char * contents = NULL;
+  if (!g_file_get_contents (path, &contents, NULL, NULL))
+    {
+      memset (cpus, 0, CPU_TOPOLOGY_MAX_CPUS * sizeof (bool));
+      return -1;
+    }
+
+  int ret = cpu_topology_parse_cpu_list (
+    contents, cpus, CPU_TOPOLOGY_MAX_CPUS);
+  g_free (contents);
+
+  return ret;
+}
+
+/**
+ * Returns the lowest CPU ID sharing the highest
+ * level cache with the given CPU.
+ */
+static int
+get_cache_group (int cpu_id, bool * tmp_cpus)
+{
+  int group = cpu_id;
+  int max_level = 0;
+  for (int i = 0;; i++)
+    {
+      char * dir = g_strdup_printf (
+        SYSFS_CPU_DIR "/cpu%d/cache/index%d", cpu_id, i);
+      char * level_path =
+        g_build_filename (dir, "level", NULL);
+      char * contents = NULL;
+      bool   found = g_file_get_contents (
+        level_path, &contents, NULL, NULL);
+      g_free (level_path);
+      if (!found)
+        {
+          g_free (dir);
+          break;
+        }
+
+      int level = atoi (contents);
+      g_free (contents);
+      if (level > max_level)
+        {
+          char * shared_path =
+            g_build_filename (dir, "shared_cpu_list", NULL);
+          if (read_cpu_list (shared_path, tmp_cpus) > 0)
+            {
+              for (int j = 0; j < CPU_TOPOLOGY_MAX_CPUS; j++)
+                {
+                  if (tmp_cpus[j])
+                    {
+                      group = j;
+                      break;
+                    }
+                }
+              max_level = level;
+            }
+          g_free (shared_path);
+        }
+      g_free (dir);
+    }
+
+  return group;
+}
+
+/**
+ * Returns the NUMA node of the given CPU, or 0 if
+ * unknown.
+ */
+static int
+get_numa_node (int cpu_id)
+{
+  char * path =
+    g_strdup_printf (SYSFS_CPU_DIR "/cpu%d", cpu_id);
+  GDir * dir = g_dir_open (path, 0, NULL);
+  g_free (path);
+  if (!dir)
+    return 0;
+
+  int          node = 0;
+  const char * name;
+  while ((name = g_dir_read_name (dir)))
+    {
+      if (sscanf (name, "node%d", &node) == 1)
+        break;
+    }
+  g_dir_close (dir);
+
+  return node;
+}
+#endif
+
+CpuTopology *
+cpu_topology_new_from_system (void)
+{
+#ifdef __linux__
+  bool * online = object_new_n (CPU_TOPOLOGY_MAX_CPUS, bool);
+  int    num_online =
+    read_cpu_list (SYSFS_CPU_DIR "/online", online);
+  if (num_online <= 0)
+    {
+      g_warning ("failed to read the online CPUs");
+      g_free (online);
+      return cpu_topology_new (
+        (int) g_get_num_processors ());
+    }
+
+  /* empty if isolcpus is not used */
+  bool * isolated =
+    object_new_n (CPU_TOPOLOGY_MAX_CPUS, bool);
+  read_cpu_list (SYSFS_CPU_DIR "/isolated", isolated);
+
+  cpu_set_t allowed;
+  bool      have_allowed =
+    sched_getaffinity (0, sizeof (allowed), &allowed) == 0;
+
+  bool * tmp_cpus =
+    object_new_n (CPU_TOPOLOGY_MAX_CPUS, bool);
+
+  CpuTopology * self = object_new (CpuTopology);
+  self->cpus =
+    object_new_n ((size_t) num_online, CpuTopologyCpu);
+  for (int i = 0; i < CPU_TOPOLOGY_MAX_CPUS; i++)
+    {
+      if (!online[i])
+        continue;
+
+      CpuTopologyCpu * cpu = &self->cpus[self->num_cpus++];
+      cpu->id = i;
+      cpu->cache_group = get_cache_group (i, tmp_cpus);
+      cpu->numa_node = get_numa_node (i);
+      cpu->isolated = isolated[i];
+      cpu->allowed =
+        !have_allowed
+        || (i < CPU_SETSIZE && CPU_ISSET (i, &allowed));
+    }
+
+  g_free (online);
+  g_free (isolated);
+  g_free (tmp_cpus);
+
+  return self;
+#else
+  return cpu_topology_new ((int) g_get_num_processors ());
+#endif
+}
+
+static int
+cmp_by_cache_group (const void * _a, const void * _b)
+{
+  const CpuTopologyCpu * a = *(const CpuTopologyCpu **) _a;
+  const CpuTopologyCpu * b = *(const CpuTopologyCpu **) _b;
+  if (a->numa_node != b->numa_node)
+    return a->numa_node - b->numa_node;
+  if (a->cache_group != b->cache_group)
+    return a->cache_group - b->cache_group;
+  return a->id - b->id;
+}
+
+int
+cpu_topology_get_thread_cpus (
+  const CpuTopology * self,
+  CpuAffinity         affinity,
+  bool                use_isolated,
+  int                 num_threads,
+  int *               cpus)
+{
+  for (int i = 0; i < num_threads; i++)
+    {
+      cpus[i] = -1;
+    }
+
+  if (affinity == CPU_AFFINITY_NONE)
+    return 0;
+
+  bool have_isolated = false;
+  if (use_isolated)
+    {
+      for (int i = 0; i < self->num_cpus; i++)
+        {
+          if (self->cpus[i].isolated)
+            {
+              have_isolated = true;
+              break;
+            }
+        }
+    }
+
+  const CpuTopologyCpu ** candidates = object_new_n (
+    (size_t) self->num_cpus, const CpuTopologyCpu *);
+  int num_candidates = 0;
+  for (int i = 0; i < self->num_cpus; i++)
+    {
+      const CpuTopologyCpu * cpu = &self->cpus[i];
+      if (
+        have_isolated
+          ? cpu->isolated
+          : cpu->allowed && !cpu->isolated)
+        {
+          candidates[num_candidates++] = cpu;
+        }
+    }
+
+  if (affinity == CPU_AFFINITY_CACHE_GROUPS)
+    {
+      qsort (
+        candidates, (size_t) num_candidates,
+        sizeof (CpuTopologyCpu *), cmp_by_cache_group);
+    }
+
+  for (int i = 0; i < num_threads && num_candidates > 0; i++)
+    {
+      cpus[i] = candidates[i % num_candidates]->id;
+    }
+  g_free (candidates);
+
+  return num_candidates;
+}
+
+void
+cpu_topology_free (CpuTopology * self)
+{
+  object_zero_and_free (self->cpus);
+
+  object_zero_and_free (self);
+}
@@ -1,4 +1,4 @@
-// SPDX-FileCopyrightText: © 2020-2021 Alexandros Theodotou <alex@zrythm.org>
+// SPDX-FileCopyrightText: © 2020-2022 Alexandros Theodotou <alex@zrythm.org>
 // SPDX-License-Identifier: LicenseRef-ZrythmLicense
 
 #include "zrythm-config.h"
@@ -6,6 +6,7 @@
 #include <math.h>
 
 #include "utils/dsp.h"
+#include "utils/dsp_simd.h"
 #include "utils/math.h"
 #include "zrythm.h"
 
@@ -15,85 +16,337 @@
 #  include <lsp-plug.in/dsp/dsp.h>
 #endif
 
-/**
- * Fill the buffer with the given value.
- */
-void
-dsp_fill (float * buf, float val, size_t size)
-{
 #ifdef HAVE_LSP_DSP
-  if (ZRYTHM_USE_OPTIMIZED_DSP)
-    {
-      lsp_dsp_fill (buf, val, size);
-    }
-  else
+/* lsp-dsp-lib functions are pointers resolved by
+ * lsp_dsp_init(), so they are wrapped instead of
+ * being put in the table directly */
+
+static void
+lsp_fill (float * buf, float val, size_t size)
+{
+  lsp_dsp_fill (buf, val, size);
+}
+
+static void
+lsp_limit1 (float * buf, float minf, float maxf, size_t size)
+{
+  lsp_dsp_limit1 (buf, minf, maxf, size);
+}
+
+static void
+lsp_copy (float * dest, const float * src, size_t size)
+{
+  lsp_dsp_copy (dest, src, size);
+}
+
+static void
+lsp_mul_k2 (float * dest, float k, size_t size)
+{
+  lsp_dsp_mul_k2 (dest, k, size);
+}
+
+static float
+lsp_abs_max (const float * buf, size_t size)
+{
+  return lsp_dsp_abs_max (buf, size);
+}
+
+static float
+lsp_min (const float * buf, size_t size)
+{
+  return lsp_dsp_min (buf, size);
+}
+
+static float
+lsp_max (const float * buf, size_t size)
+{
+  return lsp_dsp_max (buf, size);
+}
+
+static void
+lsp_add2 (float * dest, const float * src, size_t size)
+{
+  lsp_dsp_add2 (dest, src, size);
+}
+
+static void
+lsp_mix2 (
+  float *       dest,
+  const float * src,
+  float         k1,
+  float         k2,
+  size_t        size)
+{
+  lsp_dsp_mix2 (dest, src, k1, k2, size);
+}
+
+static void
+lsp_mix_add2 (
+  float *       dest,
+  const float * src1,
+  const float * src2,
+  float         k1,
+  float         k2,
+  size_t        size)
+{
+  lsp_dsp_mix_add2 (dest, src1, src2, k1, k2, size);
+}
+
+static void
+lsp_linear_fade_in_from (
+  float * dest,
+  int32_t start_offset,
+  int32_t total_frames_to_fade,
+  size_t  size,
+  float   fade_from_multiplier)
+{
+  lsp_dsp_lin_inter_mul2 (
+    dest, 0, fade_from_multiplier, total_frames_to_fade, 1.f,
+    start_offset, size);
+}
+
+static void
+lsp_linear_fade_out_to (
+  float * dest,
+  int32_t start_offset,
+  int32_t total_frames_to_fade,
+  size_t  size,
+  float   fade_to_multiplier)
+{
+  lsp_dsp_lin_inter_mul2 (
+    dest, 0, 1.f, total_frames_to_fade, fade_to_multiplier,
+    start_offset, size);
+}
+
+static const DspKernels dsp_kernels_lsp = {
+  .name = "lsp-dsp-lib",
+  .fill = lsp_fill,
+  .limit1 = lsp_limit1,
+  .copy = lsp_copy,
+  .mul_k2 = lsp_mul_k2,
+  .abs_max = lsp_abs_max,
+  .min = lsp_min,
+  .max = lsp_max,
+  .add2 = lsp_add2,
+  .mix2 = lsp_mix2,
+  .mix_add2 = lsp_mix_add2,
+  .linear_fade_in_from = lsp_linear_fade_in_from,
+  .linear_fade_out_to = lsp_linear_fade_out_to,
+};
+#endif
+
+/** Currently used kernels. */
+static const DspKernels * kernels = &dsp_kernels_scalar;
+
+/** Currently used backend. */
+static DspBackend cur_backend = DSP_BACKEND_SCALAR;
+
+static const DspKernels *
+get_kernels_for_backend (DspBackend backend)
+{
+  switch (backend)
     {
+    case DSP_BACKEND_SCALAR:
+      return &dsp_kernels_scalar;
+#ifdef DSP_SIMD_HAVE_X86
+    case DSP_BACKEND_SSE2:
+      return &dsp_kernels_sse2;
+    case DSP_BACKEND_AVX2:
+      return &dsp_kernels_avx2;
+    case DSP_BACKEND_AVX512:
+      return &dsp_kernels_avx512;
+#endif
+#ifdef DSP_SIMD_HAVE_NEON
+    case DSP_BACKEND_NEON:
+      return &dsp_kernels_neon;
 #endif
-      for (size_t i = 0; i < size; i++)
-        {
-          buf[i] = val;
-        }
 #ifdef HAVE_LSP_DSP
+    case DSP_BACKEND_LSP:
+      return &dsp_kernels_lsp;
+#endif
+    default:
+      break;
+    }
+
+  return NULL;
+}
+
+/**
+ * Returns whether the given backend can be used on
+ * this machine.
+ */
+bool
+dsp_backend_is_supported (DspBackend backend)
+{
+  if (!get_kernels_for_backend (backend))
+    return false;
+
+#if defined(DSP_SIMD_HAVE_X86) && defined(__GNUC__)
+  __builtin_cpu_init ();
+  switch (backend)
+    {
+    case DSP_BACKEND_SSE2:
+      return __builtin_cpu_supports ("sse2");
+    case DSP_BACKEND_AVX2:
+      return __builtin_cpu_supports ("avx2");
+    case DSP_BACKEND_AVX512:
+      return __builtin_cpu_supports ("avx512f");
+    default:
+      break;
     }
 #endif
+
+  return true;
 }
 
 /**
- * Gets the minimum of the buffer.
+ * Returns a human-readable name for the backend.
  */
-float
-dsp_min (float * buf, size_t size)
+const char *
+dsp_backend_get_name (DspBackend backend)
 {
-  float min = 1000.f;
-#ifdef HAVE_LSP_DSP
-  if (ZRYTHM_USE_OPTIMIZED_DSP)
+  static const char * names[] = {
+    "scalar", "SSE2", "AVX2", "AVX-512", "NEON", "lsp-dsp-lib",
+  };
+  g_return_val_if_fail (backend < NUM_DSP_BACKENDS, NULL);
+  return names[backend];
+}
+
+/**
+ * Returns the backend currently in use.
+ */
+DspBackend
+dsp_get_backend (void)
+{
+  return cur_backend;
+}
+
+/**
+ * Forces the given backend.
+ *
+ * @return Whether the backend was set (false if not
+ *   supported on this machine).
+ */
+bool
+dsp_set_backend (DspBackend backend)
+{
+  if (!dsp_backend_is_supported (backend))
     {
-      min = lsp_dsp_min (buf, size);
+      g_message (
+        "DSP backend %s not supported on this machine",
+        dsp_backend_get_name (backend));
+      return false;
     }
-  else
+
+  kernels = get_kernels_for_backend (backend);
+  cur_backend = backend;
+
+  return true;
+}
+
+/**
+ * Selects the DSP backend to use based on the
+ * features of the running CPU.
+ *
+ * @param optimized Whether to use optimized
+ *   routines. If false, the scalar backend is used.
+ */
+void
+dsp_init (bool optimized)
+{
+  /* in order of preference */
+  static const DspBackend preferred[] = {
+    DSP_BACKEND_LSP,  DSP_BACKEND_AVX512, DSP_BACKEND_AVX2,
+    DSP_BACKEND_SSE2, DSP_BACKEND_NEON,
+  };
+
+  DspBackend backend = DSP_BACKEND_SCALAR;
+  if (optimized)
     {
-#endif
-      for (size_t i = 0; i < size; i++)
+      for (size_t i = 0; i < G_N_ELEMENTS (preferred); i++)
         {
-          if (buf[i] < min)
+          if (dsp_backend_is_supported (preferred[i]))
             {
-              min = buf[i];
+              backend = preferred[i];
+              break;
             }
         }
-#ifdef HAVE_LSP_DSP
     }
-#endif
 
-  return min;
+  dsp_set_backend (backend);
+  g_message (
+    "Using %s DSP backend", dsp_backend_get_name (backend));
 }
 
 /**
- * Gets the maximum of the buffer.
+ * Fill the buffer with the given value.
+ */
+void
+dsp_fill (float * buf, float val, size_t size)
+{
+  kernels->fill (buf, val, size);
+}
+
+/**
+ * Clamp the buffer to min/max.
+ */
+void
+dsp_limit1 (float * buf, float minf, float maxf, size_t size)
+{
+  kernels->limit1 (buf, minf, maxf, size);
+}
+
+/**
+ * Gets the maximum absolute value of the buffer (as
+ * amplitude).
  */
 float
-dsp_max (float * buf, size_t size)
+dsp_abs_max (float * buf, size_t size)
 {
-  float max = -1000.f;
-#ifdef HAVE_LSP_DSP
-  if (ZRYTHM_USE_OPTIMIZED_DSP)
-    {
-      max = lsp_dsp_max (buf, size);
-    }
-  else
+  float ret = kernels->abs_max (buf, size);
+  return ret > 1e-20f ? ret : 1e-20f;
+}
+
+/**
+ * Gets the absolute max of the buffer.
+ *
+ * @return Whether the peak changed.
+ */
+bool
+dsp_abs_max_with_existing_peak (
+  float * buf,
+  float * cur_peak,
+  size_t  size)
+{
+  float new_peak = *cur_peak;
+  float buf_peak = kernels->abs_max (buf, size);
+  if (buf_peak > new_peak)
     {
-#endif
-      for (size_t i = 0; i < size; i++)
-        {
-          if (buf[i] > max)
-            {
-              max = buf[i];
-            }
-        }
-#ifdef HAVE_LSP_DSP
+      new_peak = buf_peak;
     }
-#endif
 
-  return max;
+  bool changed = !math_floats_equal (new_peak, *cur_peak);
+  *cur_peak = new_peak;
+
+  return changed;
+}
+
+/**
+ * Gets the minimum of the buffer.
+ */
+float
+dsp_min (float * buf, size_t size)
+{
+  return kernels->min (buf, size);
+}
+
+/**
+ * Gets the maximum of the buffer.
+ */
+float
+dsp_max (float * buf, size_t size)
+{
+  return kernels->max (buf, size);
 }
 
 /**
@@ -102,21 +355,7 @@ dsp_max (float * buf, size_t size)
 void
 dsp_copy (float * dest, const float * src, size_t size)
 {
-#ifdef HAVE_LSP_DSP
-  if (ZRYTHM_USE_OPTIMIZED_DSP)
-    {
-      lsp_dsp_copy (dest, src, size);
-    }
-  else
-    {
-#endif
-      for (size_t i = 0; i < size; i++)
-        {
-          dest[i] = src[i];
-        }
-#ifdef HAVE_LSP_DSP
-    }
-#endif
+  kernels->copy (dest, src, size);
 }
 
 /**
@@ -125,21 +364,7 @@ dsp_copy (float * dest, const float * src, size_t size)
 void
 dsp_add2 (float * dest, const float * src, size_t size)
 {
-#ifdef HAVE_LSP_DSP
-  if (ZRYTHM_USE_OPTIMIZED_DSP)
-    {
-      lsp_dsp_add2 (dest, src, size);
-    }
-  else
-    {
-#endif
-      for (size_t i = 0; i < size; i++)
-        {
-          dest[i] = dest[i] + src[i];
-        }
-#ifdef HAVE_LSP_DSP
-    }
-#endif
+  kernels->add2 (dest, src, size);
 }
 
 /**
@@ -148,21 +373,21 @@ dsp_add2 (float * dest, const float * src, size_t size)
 void
 dsp_mul_k2 (float * dest, float k, size_t size)
 {
-#ifdef HAVE_LSP_DSP
-  if (ZRYTHM_USE_OPTIMIZED_DSP)
-    {
-      lsp_dsp_mul_k2 (dest, k, size);
-    }
-  else
-    {
-#endif
-      for (size_t i = 0; i < size; i++)
-        {
-          dest[i] *= k;
-        }
-#ifdef HAVE_LSP_DSP
-    }
-#endif
+  kernels->mul_k2 (dest, k, size);
+}
+
+/**
+ * Calculate dest[i] = dest[i] * k1 + src[i] * k2.
+ */
+void
+dsp_mix2 (
+  float *       dest,
+  const float * src,
+  float         k1,
+  float         k2,
+  size_t        size)
+{
+  kernels->mix2 (dest, src, k1, k2, size);
 }
 
 /**
@@ -178,21 +403,7 @@ dsp_mix_add2 (
   float         k2,
   size_t        size)
 {
-#ifdef HAVE_LSP_DSP
-  if (ZRYTHM_USE_OPTIMIZED_DSP)
-    {
-      lsp_dsp_mix_add2 (dest, src1, src2, k1, k2, size);
-    }
-  else
-    {
-#endif
-      for (size_t i = 0; i < size; i++)
-        {
-          dest[i] = dest[i] + src1[i] * k1 + src2[i] * k2;
-        }
-#ifdef HAVE_LSP_DSP
-    }
-#endif
+  kernels->mix_add2 (dest, src1, src2, k1, k2, size);
 }
 
 /**
@@ -217,28 +428,9 @@ dsp_linear_fade_in_from (
   size_t  size,
   float   fade_from_multiplier)
 {
-#ifdef HAVE_LSP_DSP
-  if (ZRYTHM_USE_OPTIMIZED_DSP)
-    {
-      lsp_dsp_lin_inter_mul2 (
-        dest, 0, fade_from_multiplier, total_frames_to_fade,
-        1.f, start_offset, size);
-    }
-  else
-    {
-#endif
-      for (size_t i = 0; i < size; i++)
-        {
-          float k =
-            (float) (i + (size_t) start_offset)
-            / (float) total_frames_to_fade;
-          k = fade_from_multiplier
-              + (1.f - fade_from_multiplier) * k;
-          dest[i] *= k;
-        }
-#ifdef HAVE_LSP_DSP
-    }
-#endif
+  kernels->linear_fade_in_from (
+    dest, start_offset, total_frames_to_fade, size,
+    fade_from_multiplier);
 }
 
 /**
@@ -252,7 +444,6 @@ dsp_linear_fade_in_from (
  * @param fade_to_multiplier Multiplier to fade to (0 to fade
  *   to silence.)
  */
-NONNULL
 void
 dsp_linear_fade_out_to (
   float * dest,
@@ -261,28 +452,9 @@ dsp_linear_fade_out_to (
   size_t  size,
   float   fade_to_multiplier)
 {
-#ifdef HAVE_LSP_DSP
-  if (ZRYTHM_USE_OPTIMIZED_DSP)
-    {
-      lsp_dsp_lin_inter_mul2 (
-        dest, 0, 1.f, total_frames_to_fade,
-        fade_to_multiplier, start_offset, size);
-    }
-  else
-    {
-#endif
-      for (size_t i = 0; i < size; i++)
-        {
-          float k =
-            (float) ((size_t) total_frames_to_fade - (i + (size_t) start_offset))
-            / (float) total_frames_to_fade;
-          k = fade_to_multiplier
-              + (1.f - fade_to_multiplier) * k;
-          dest[i] *= k;
-        }
-#ifdef HAVE_LSP_DSP
-    }
-#endif
+  kernels->linear_fade_out_to (
+    dest, start_offset, total_frames_to_fade, size,
+    fade_to_multiplier);
 }
 
 /**
@@ -0,0 +1,1176 @@
+// SPDX-FileCopyrightText: © 2022 Alexandros Theodotou <alex@zrythm.org>
+// SPDX-License-Identifier: LicenseRef-ZrythmLicense
+
+/**
+ * @file
+ *
+ * In-tree SIMD implementations of the DSP kernels.
+ *
+ * The x86 kernels are compiled with per-function
+ * target attributes so that a single binary can carry
+ * SSE2, AVX2 and AVX-512 code paths. The one to use
+ * is selected at runtime by dsp_init().
+ *
+ * All loads and stores are unaligned and the
+ * remainder of each buffer is processed by the scalar
+ * loop, so buffers of any size and alignment are
+ * accepted.
+ */
+
+#include <math.h>
+
+#include "utils/dsp_simd.h"
+
+#if defined(DSP_SIMD_HAVE_X86)
+#  include <immintrin.h>
+#endif
+#if defined(DSP_SIMD_HAVE_NEON)
+#  include <arm_neon.h>
+#endif
+
+/* ---- scalar ---- */
+
+static void
+scalar_fill (float * buf, float val, size_t size)
+{
+  for (size_t i = 0; i < size; i++)
+    {
+      buf[i] = val;
+    }
+}
+
+static void
+scalar_limit1 (float * buf, float minf, float maxf, size_t size)
+{
+  for (size_t i = 0; i < size; i++)
+    {
+      if (buf[i] > maxf)
+        buf[i] = maxf;
+      else if (buf[i] < minf)
+        buf[i] = minf;
+    }
+}
+
+static void
+scalar_copy (float * dest, const float * src, size_t size)
+{
+  for (size_t i = 0; i < size; i++)
+    {
+      dest[i] = src[i];
+    }
+}
+
+static void
+scalar_mul_k2 (float * dest, float k, size_t size)
+{
+  for (size_t i = 0; i < size; i++)
+    {
+      dest[i] *= k;
+    }
+}
+
+static float
+scalar_abs_max (const float * buf, size_t size)
+{
+  float ret = 0.f;
+  for (size_t i = 0; i < size; i++)
+    {
+      if (fabsf (buf[i]) > ret)
+        {
+          ret = fabsf (buf[i]);
+        }
+    }
+  return ret;
+}
+
+static float
+scalar_min (const float * buf, size_t size)
+{
+  float min = 1000.f;
+  for (size_t i = 0; i < size; i++)
+    {
+      if (buf[i] < min)
+        {
+          min = buf[i];
+        }
+    }
+  return min;
+}
+
+static float
+scalar_max (const float * buf, size_t size)
+{
+  float max = -1000.f;
+  for (size_t i = 0; i < size; i++)
+    {
+      if (buf[i] > max)
+        {
+          max = buf[i];
+        }
+    }
+  return max;
+}
+
+static void
+scalar_add2 (float * dest, const float * src, size_t size)
+{
+  for (size_t i = 0; i < size; i++)
+    {
+      dest[i] = dest[i] + src[i];
+    }
+}
+
+static void
+scalar_mix2 (
+  float *       dest,
+  const float * src,
+  float         k1,
+  float         k2,
+  size_t        size)
+{
+  for (size_t i = 0; i < size; i++)
+    {
+      dest[i] = dest[i] * k1 + src[i] * k2;
+    }
+}
+
+static void
+scalar_mix_add2 (
+  float *       dest,
+  const float * src1,
+  const float * src2,
+  float         k1,
+  float         k2,
+  size_t        size)
+{
+  for (size_t i = 0; i < size; i++)
+    {
+      dest[i] = dest[i] + src1[i] * k1 + src2[i] * k2;
+    }
+}
+
+static void
+scalar_linear_fade_in_from (
+  float * dest,
+  int32_t start_offset,
+  int32_t total_frames_to_fade,
+  size_t  size,
+  float   fade_from_multiplier)
+{
+  for (size_t i = 0; i < size; i++)
+    {
+      float k =
+        (float) (i + (size_t) start_offset)
+        / (float) total_frames_to_fade;
+      k = fade_from_multiplier + (1.f - fade_from_multiplier) * k;
+      dest[i] *= k;
+    }
+}
+
+static void
+scalar_linear_fade_out_to (
+  float * dest,
+  int32_t start_offset,
+  int32_t total_frames_to_fade,
+  size_t  size,
+  float   fade_to_multiplier)
+{
+  for (size_t i = 0; i < size; i++)
+    {
+      float k =
+        (float) ((size_t) total_frames_to_fade - (i + (size_t) start_offset))
+        / (float) total_frames_to_fade;
+      k = fade_to_multiplier + (1.f - fade_to_multiplier) * k;
+      dest[i] *= k;
+    }
+}
+
+const DspKernels dsp_kernels_scalar = {
+  .name = "scalar",
+  .fill = scalar_fill,
+  .limit1 = scalar_limit1,
+  .copy = scalar_copy,
+  .mul_k2 = scalar_mul_k2,
+  .abs_max = scalar_abs_max,
+  .min = scalar_min,
+  .max = scalar_max,
+  .add2 = scalar_add2,
+  .mix2 = scalar_mix2,
+  .mix_add2 = scalar_mix_add2,
+  .linear_fade_in_from = scalar_linear_fade_in_from,
+  .linear_fade_out_to = scalar_linear_fade_out_to,
+};
+
+#if defined(DSP_SIMD_HAVE_X86)
+
+/* ---- SSE2 ---- */
+
+#  define SSE2 __attribute__ ((target ("sse2")))
+
+SSE2 static inline float
+sse2_hmin (__m128 v)
+{
+  v = _mm_min_ps (
+    v, _mm_shuffle_ps (v, v, _MM_SHUFFLE (1, 0, 3, 2)));
+  v = _mm_min_ps (
+    v, _mm_shuffle_ps (v, v, _MM_SHUFFLE (2, 3, 0, 1)));
+  return _mm_cvtss_f32 (v);
+}
+
+SSE2 static inline float
+sse2_hmax (__m128 v)
+{
+  v = _mm_max_ps (
+    v, _mm_shuffle_ps (v, v, _MM_SHUFFLE (1, 0, 3, 2)));
+  v = _mm_max_ps (
+    v, _mm_shuffle_ps (v, v, _MM_SHUFFLE (2, 3, 0, 1)));
+  return _mm_cvtss_f32 (v);
+}
+
+SSE2 static void
+sse2_fill (float * buf, float val, size_t size)
+{
+  const __m128 v = _mm_set1_ps (val);
+  size_t       i = 0;
+  for (; i + 4 <= size; i += 4)
+    {
+      _mm_storeu_ps (&buf[i], v);
+    }
+  scalar_fill (&buf[i], val, size - i);
+}
+
+SSE2 static void
+sse2_limit1 (float * buf, float minf, float maxf, size_t size)
+{
+  const __m128 vmin = _mm_set1_ps (minf);
+  const __m128 vmax = _mm_set1_ps (maxf);
+  size_t       i = 0;
+  for (; i + 4 <= size; i += 4)
+    {
+      __m128 v = _mm_loadu_ps (&buf[i]);
+      v = _mm_min_ps (_mm_max_ps (v, vmin), vmax);
+      _mm_storeu_ps (&buf[i], v);
+    }
+  scalar_limit1 (&buf[i], minf, maxf, size - i);
+}
+
+SSE2 static void
+sse2_copy (float * dest, const float * src, size_t size)
+{
+  size_t i = 0;
+  for (; i + 8 <= size; i += 8)
+    {
+      __m128 a = _mm_loadu_ps (&src[i]);
+      __m128 b = _mm_loadu_ps (&src[i + 4]);
+      _mm_storeu_ps (&dest[i], a);
+      _mm_storeu_ps (&dest[i + 4], b);
+    }
+  scalar_copy (&dest[i], &src[i], size - i);
+}
+
+SSE2 static void
+sse2_mul_k2 (float * dest, float k, size_t size)
+{
+  const __m128 vk = _mm_set1_ps (k);
+  size_t       i = 0;
+  for (; i + 4 <= size; i += 4)
+    {
+      _mm_storeu_ps (
+        &dest[i], _mm_mul_ps (_mm_loadu_ps (&dest[i]), vk));
+    }
+  scalar_mul_k2 (&dest[i], k, size - i);
+}
+
+SSE2 static float
+sse2_abs_max (const float * buf, size_t size)
+{
+  const __m128 mask =
+    _mm_castsi128_ps (_mm_set1_epi32 (0x7fffffff));
+  __m128 vmax = _mm_setzero_ps ();
+  size_t i = 0;
+  for (; i + 4 <= size; i += 4)
+    {
+      vmax = _mm_max_ps (
+        vmax, _mm_and_ps (_mm_loadu_ps (&buf[i]), mask));
+    }
+  float ret = sse2_hmax (vmax);
+  float rest = scalar_abs_max (&buf[i], size - i);
+  return rest > ret ? rest : ret;
+}
+
+SSE2 static float
+sse2_min (const float * buf, size_t size)
+{
+  __m128 vmin = _mm_set1_ps (1000.f);
+  size_t i = 0;
+  for (; i + 4 <= size; i += 4)
+    {
+      vmin = _mm_min_ps (vmin, _mm_loadu_ps (&buf[i]));
+    }
+  float ret = sse2_hmin (vmin);
+  float rest = scalar_min (&buf[i], size - i);
+  return rest < ret ? rest : ret;
+}
+
+SSE2 static float
+sse2_max (const float * buf, size_t size)
+{
+  __m128 vmax = _mm_set1_ps (-1000.f);
+  size_t i = 0;
+  for (; i + 4 <= size; i += 4)
+    {
+      vmax = _mm_max_ps (vmax, _mm_loadu_ps (&buf[i]));
+    }
+  float ret = sse2_hmax (vmax);
+  float rest = scalar_max (&buf[i], size - i);
+  return rest > ret ? rest : ret;
+}
+
+SSE2 static void
+sse2_add2 (float * dest, const float * src, size_t size)
+{
+  size_t i = 0;
+  for (; i + 4 <= size; i += 4)
+    {
+      _mm_storeu_ps (
+        &dest[i],
+        _mm_add_ps (
+          _mm_loadu_ps (&dest[i]), _mm_loadu_ps (&src[i])));
+    }
+  scalar_add2 (&dest[i], &src[i], size - i);
+}
+
+SSE2 static void
+sse2_mix2 (
+  float *       dest,
+  const float * src,
+  float         k1,
+  float         k2,
+  size_t        size)
+{
+  const __m128 vk1 = _mm_set1_ps (k1);
+  const __m128 vk2 = _mm_set1_ps (k2);
+  size_t       i = 0;
+  for (; i + 4 <= size; i += 4)
+    {
+      __m128 d = _mm_mul_ps (_mm_loadu_ps (&dest[i]), vk1);
+      __m128 s = _mm_mul_ps (_mm_loadu_ps (&src[i]), vk2);
+      _mm_storeu_ps (&dest[i], _mm_add_ps (d, s));
+    }
+  scalar_mix2 (&dest[i], &src[i], k1, k2, size - i);
+}
+
+SSE2 static void
+sse2_mix_add2 (
+  float *       dest,
+  const float * src1,
+  const float * src2,
+  float         k1,
+  float         k2,
+  size_t        size)
+{
+  const __m128 vk1 = _mm_set1_ps (k1);
+  const __m128 vk2 = _mm_set1_ps (k2);
+  size_t       i = 0;
+  for (; i + 4 <= size; i += 4)
+    {
+      __m128 d = _mm_loadu_ps (&dest[i]);
+      __m128 s1 = _mm_mul_ps (_mm_loadu_ps (&src1[i]), vk1);
+      __m128 s2 = _mm_mul_ps (_mm_loadu_ps (&src2[i]), vk2);
+      _mm_storeu_ps (&dest[i], _mm_add_ps (_mm_add_ps (d, s1), s2));
+    }
+  scalar_mix_add2 (
+    &dest[i], &src1[i], &src2[i], k1, k2, size - i);
+}
+
+SSE2 static void
+sse2_linear_fade_in_from (
+  float * dest,
+  int32_t start_offset,
+  int32_t total_frames_to_fade,
+  size_t  size,
+  float   fade_from_multiplier)
+{
+  const __m128 iota = _mm_set_ps (3.f, 2.f, 1.f, 0.f);
+  const __m128 vtotal = _mm_set1_ps ((float) total_frames_to_fade);
+  const __m128 vfrom = _mm_set1_ps (fade_from_multiplier);
+  const __m128 vrange = _mm_set1_ps (1.f - fade_from_multiplier);
+  size_t       i = 0;
+  for (; i + 4 <= size; i += 4)
+    {
+      __m128 idx = _mm_add_ps (
+        _mm_set1_ps ((float) (i + (size_t) start_offset)), iota);
+      __m128 k = _mm_div_ps (idx, vtotal);
+      k = _mm_add_ps (vfrom, _mm_mul_ps (vrange, k));
+      _mm_storeu_ps (
+        &dest[i], _mm_mul_ps (_mm_loadu_ps (&dest[i]), k));
+    }
+  scalar_linear_fade_in_from (
+    &dest[i], start_offset + (int32_t) i, total_frames_to_fade,
+    size - i, fade_from_multiplier);
+}
+
+SSE2 static void
+sse2_linear_fade_out_to (
+  float * dest,
+  int32_t start_offset,
+  int32_t total_frames_to_fade,
+  size_t  size,
+  float   fade_to_multiplier)
+{
+  const __m128 iota = _mm_set_ps (3.f, 2.f, 1.f, 0.f);
+  const __m128 vtotal = _mm_set1_ps ((float) total_frames_to_fade);
+  const __m128 vto = _mm_set1_ps (fade_to_multiplier);
+  const __m128 vrange = _mm_set1_ps (1.f - fade_to_multiplier);
+  size_t       i = 0;
+  for (; i + 4 <= size; i += 4)
+    {
+      __m128 remaining = _mm_sub_ps (
+        _mm_set1_ps ((float) (total_frames_to_fade - start_offset - (int32_t) i)),
+        iota);
+      __m128 k = _mm_div_ps (remaining, vtotal);
+      k = _mm_add_ps (vto, _mm_mul_ps (vrange, k));
+      _mm_storeu_ps (
+        &dest[i], _mm_mul_ps (_mm_loadu_ps (&dest[i]), k));
+    }
+  scalar_linear_fade_out_to (
+    &dest[i], start_offset + (int32_t) i, total_frames_to_fade,
+    size - i, fade_to_multiplier);
+}
+
+const DspKernels dsp_kernels_sse2 = {
+  .name = "SSE2",
+  .fill = sse2_fill,
+  .limit1 = sse2_limit1,
+  .copy = sse2_copy,
+  .mul_k2 = sse2_mul_k2,
+  .abs_max = sse2_abs_max,
+  .min = sse2_min,
+  .max = sse2_max,
+  .add2 = sse2_add2,
+  .mix2 = sse2_mix2,
+  .mix_add2 = sse2_mix_add2,
+  .linear_fade_in_from = sse2_linear_fade_in_from,
+  .linear_fade_out_to = sse2_linear_fade_out_to,
+};
+
+/* ---- AVX2 ---- */
+
+#  define AVX2 __attribute__ ((target ("avx2")))
+
+AVX2 static inline float
+avx2_hmin (__m256 v)
+{
+  __m128 lo = _mm256_castps256_ps128 (v);
+  __m128 hi = _mm256_extractf128_ps (v, 1);
+  return sse2_hmin (_mm_min_ps (lo, hi));
+}
+
+AVX2 static inline float
+avx2_hmax (__m256 v)
+{
+  __m128 lo = _mm256_castps256_ps128 (v);
+  __m128 hi = _mm256_extractf128_ps (v, 1);
+  return sse2_hmax (_mm_max_ps (lo, hi));
+}
+
+AVX2 static void
+avx2_fill (float * buf, float val, size_t size)
+{
+  const __m256 v = _mm256_set1_ps (val);
+  size_t       i = 0;
+  for (; i + 8 <= size; i += 8)
+    {
+      _mm256_storeu_ps (&buf[i], v);
+    }
+  scalar_fill (&buf[i], val, size - i);
+}
+
+AVX2 static void
+avx2_limit1 (float * buf, float minf, float maxf, size_t size)
+{
+  const __m256 vmin = _mm256_set1_ps (minf);
+  const __m256 vmax = _mm256_set1_ps (maxf);
+  size_t       i = 0;
+  for (; i + 8 <= size; i += 8)
+    {
+      __m256 v = _mm256_loadu_ps (&buf[i]);
+      v = _mm256_min_ps (_mm256_max_ps (v, vmin), vmax);
+      _mm256_storeu_ps (&buf[i], v);
+    }
+  scalar_limit1 (&buf[i], minf, maxf, size - i);
+}
+
+AVX2 static void
+avx2_copy (float * dest, const float * src, size_t size)
+{
+  size_t i = 0;
+  for (; i + 16 <= size; i += 16)
+    {
+      __m256 a = _mm256_loadu_ps (&src[i]);
+      __m256 b = _mm256_loadu_ps (&src[i + 8]);
+      _mm256_storeu_ps (&dest[i], a);
+      _mm256_storeu_ps (&dest[i + 8], b);
+    }
+  scalar_copy (&dest[i], &src[i], size - i);
+}
+
+AVX2 static void
+avx2_mul_k2 (float * dest, float k, size_t size)
+{
+  const __m256 vk = _mm256_set1_ps (k);
+  size_t       i = 0;
+  for (; i + 8 <= size; i += 8)
+    {
+      _mm256_storeu_ps (
+        &dest[i], _mm256_mul_ps (_mm256_loadu_ps (&dest[i]), vk));
+    }
+  scalar_mul_k2 (&dest[i], k, size - i);
+}
+
+AVX2 static float
+avx2_abs_max (const float * buf, size_t size)
+{
+  const __m256 mask =
+    _mm256_castsi256_ps (_mm256_set1_epi32 (0x7fffffff));
+  __m256 vmax = _mm256_setzero_ps ();
+  size_t i = 0;
+  for (; i + 8 <= size; i += 8)
+    {
+      vmax = _mm256_max_ps (
+        vmax, _mm256_and_ps (_mm256_loadu_ps (&buf[i]), mask));
+    }
+  float ret = avx2_hmax (vmax);
+  float rest = scalar_abs_max (&buf[i], size - i);
+  return rest > ret ? rest : ret;
+}
+
+AVX2 static float
+avx2_min (const float * buf, size_t size)
+{
+  __m256 vmin = _mm256_set1_ps (1000.f);
+  size_t i = 0;
+  for (; i + 8 <= size; i += 8)
+    {
+      vmin = _mm256_min_ps (vmin, _mm256_loadu_ps (&buf[i]));
+    }
+  float ret = avx2_hmin (vmin);
+  float rest = scalar_min (&buf[i], size - i);
+  return rest < ret ? rest : ret;
+}
+
+AVX2 static float
+avx2_max (const float * buf, size_t size)
+{
+  __m256 vmax = _mm256_set1_ps (-1000.f);
+  size_t i = 0;
+  for (; i + 8 <= size; i += 8)
+    {
+      vmax = _mm256_max_ps (vmax, _mm256_loadu_ps (&buf[i]));
+    }
+  float ret = avx2_hmax (vmax);
+  float rest = scalar_max (&buf[i], size - i);
+  return rest > ret ? rest : ret;
+}
+
+AVX2 static void
+avx2_add2 (float * dest, const float * src, size_t size)
+{
+  size_t i = 0;
+  for (; i + 8 <= size; i += 8)
+    {
+      _mm256_storeu_ps (
+        &dest[i],
+        _mm256_add_ps (
+          _mm256_loadu_ps (&dest[i]), _mm256_loadu_ps (&src[i])));
+    }
+  scalar_add2 (&dest[i], &src[i], size - i);
+}
+
+AVX2 static void
+avx2_mix2 (
+  float *       dest,
+  const float * src,
+  float         k1,
+  float         k2,
+  size_t        size)
+{
+  const __m256 vk1 = _mm256_set1_ps (k1);
+  const __m256 vk2 = _mm256_set1_ps (k2);
+  size_t       i = 0;
+  for (; i + 8 <= size; i += 8)
+    {
+      __m256 d = _mm256_mul_ps (_mm256_loadu_ps (&dest[i]), vk1);
+      __m256 s = _mm256_mul_ps (_mm256_loadu_ps (&src[i]), vk2);
+      _mm256_storeu_ps (&dest[i], _mm256_add_ps (d, s));
+    }
+  scalar_mix2 (&dest[i], &src[i], k1, k2, size - i);
+}
+
+AVX2 static void
+avx2_mix_add2 (
+  float *       dest,
+  const float * src1,
+  const float * src2,
+  float         k1,
+  float         k2,
+  size_t        size)
+{
+  const __m256 vk1 = _mm256_set1_ps (k1);
+  const __m256 vk2 = _mm256_set1_ps (k2);
+  size_t       i = 0;
+  for (; i + 8 <= size; i += 8)
+    {
+      __m256 d = _mm256_loadu_ps (&dest[i]);
+      __m256 s1 = _mm256_mul_ps (_mm256_loadu_ps (&src1[i]), vk1);
+      __m256 s2 = _mm256_mul_ps (_mm256_loadu_ps (&src2[i]), vk2);
+      _mm256_storeu_ps (
+        &dest[i], _mm256_add_ps (_mm256_add_ps (d, s1), s2));
+    }
+  scalar_mix_add2 (
+    &dest[i], &src1[i], &src2[i], k1, k2, size - i);
+}
+
+AVX2 static void
+avx2_linear_fade_in_from (
+  float * dest,
+  int32_t start_offset,
+  int32_t total_frames_to_fade,
+  size_t  size,
+  float   fade_from_multiplier)
+{
+  const __m256 iota =
+    _mm256_set_ps (7.f, 6.f, 5.f, 4.f, 3.f, 2.f, 1.f, 0.f);
+  const __m256 vtotal =
+    _mm256_set1_ps ((float) total_frames_to_fade);
+  const __m256 vfrom = _mm256_set1_ps (fade_from_multiplier);
+  const __m256 vrange =
+    _mm256_set1_ps (1.f - fade_from_multiplier);
+  size_t i = 0;
+  for (; i + 8 <= size; i += 8)
+    {
+      __m256 idx = _mm256_add_ps (
+        _mm256_set1_ps ((float) (i + (size_t) start_offset)),
+        iota);
+      __m256 k = _mm256_div_ps (idx, vtotal);
+      k = _mm256_add_ps (vfrom, _mm256_mul_ps (vrange, k));
+      _mm256_storeu_ps (
+        &dest[i], _mm256_mul_ps (_mm256_loadu_ps (&dest[i]), k));
+    }
+  scalar_linear_fade_in_from (
+    &dest[i], start_offset + (int32_t) i, total_frames_to_fade,
+    size - i, fade_from_multiplier);
+}
+
+AVX2 static void
+avx2_linear_fade_out_to (
+  float * dest,
+  int32_t start_offset,
+  int32_t total_frames_to_fade,
+  size_t  size,
+  float   fade_to_multiplier)
+{
+  const __m256 iota =
+    _mm256_set_ps (7.f, 6.f, 5.f, 4.f, 3.f, 2.f, 1.f, 0.f);
+  const __m256 vtotal =
+    _mm256_set1_ps ((float) total_frames_to_fade);
+  const __m256 vto = _mm256_set1_ps (fade_to_multiplier);
+  const __m256 vrange = _mm256_set1_ps (1.f - fade_to_multiplier);
+  size_t       i = 0;
+  for (; i + 8 <= size; i += 8)
+    {
+      __m256 remaining = _mm256_sub_ps (
+        _mm256_set1_ps ((float) (total_frames_to_fade - start_offset - (int32_t) i)),
+        iota);
+      __m256 k = _mm256_div_ps (remaining, vtotal);
+      k = _mm256_add_ps (vto, _mm256_mul_ps (vrange, k));
+      _mm256_storeu_ps (
+        &dest[i], _mm256_mul_ps (_mm256_loadu_ps (&dest[i]), k));
+    }
+  scalar_linear_fade_out_to (
+    &dest[i], start_offset + (int32_t) i, total_frames_to_fade,
+    size - i, fade_to_multiplier);
+}
+
+const DspKernels dsp_kernels_avx2 = {
+  .name = "AVX2",
+  .fill = avx2_fill,
+  .limit1 = avx2_limit1,
+  .copy = avx2_copy,
+  .mul_k2 = avx2_mul_k2,
+  .abs_max = avx2_abs_max,
+  .min = avx2_min,
+  .max = avx2_max,
+  .add2 = avx2_add2,
+  .mix2 = avx2_mix2,
+  .mix_add2 = avx2_mix_add2,
+  .linear_fade_in_from = avx2_linear_fade_in_from,
+  .linear_fade_out_to = avx2_linear_fade_out_to,
+};
+
+/* ---- AVX-512 ---- */
+
+#  define AVX512 __attribute__ ((target ("avx512f")))
+
+AVX512 static void
+avx512_fill (float * buf, float val, size_t size)
+{
+  const __m512 v = _mm512_set1_ps (val);
+  size_t       i = 0;
+  for (; i + 16 <= size; i += 16)
+    {
+      _mm512_storeu_ps (&buf[i], v);
+    }
+  scalar_fill (&buf[i], val, size - i);
+}
+
+AVX512 static void
+avx512_limit1 (float * buf, float minf, float maxf, size_t size)
+{
+  const __m512 vmin = _mm512_set1_ps (minf);
+  const __m512 vmax = _mm512_set1_ps (maxf);
+  size_t       i = 0;
+  for (; i + 16 <= size; i += 16)
+    {
+      __m512 v = _mm512_loadu_ps (&buf[i]);
+      v = _mm512_min_ps (_mm512_max_ps (v, vmin), vmax);
+      _mm512_storeu_ps (&buf[i], v);
+    }
+  scalar_limit1 (&buf[i], minf, maxf, size - i);
+}
+
+AVX512 static void
+avx512_copy (float * dest, const float * src, size_t size)
+{
+  size_t i = 0;
+  for (; i + 32 <= size; i += 32)
+    {
+      __m512 a = _mm512_loadu_ps (&src[i]);
+      __m512 b = _mm512_loadu_ps (&src[i + 16]);
+      _mm512_storeu_ps (&dest[i], a);
+      _mm512_storeu_ps (&dest[i + 16], b);
+    }
+  scalar_copy (&dest[i], &src[i], size - i);
+}
+
+AVX512 static void
+avx512_mul_k2 (float * dest, float k, size_t size)
+{
+  const __m512 vk = _mm512_set1_ps (k);
+  size_t       i = 0;
+  for (; i + 16 <= size; i += 16)
+    {
+      _mm512_storeu_ps (
+        &dest[i], _mm512_mul_ps (_mm512_loadu_ps (&dest[i]), vk));
+    }
+  scalar_mul_k2 (&dest[i], k, size - i);
+}
+
+AVX512 static float
+avx512_abs_max (const float * buf, size_t size)
+{
+  __m512 vmax = _mm512_setzero_ps ();
+  size_t i = 0;
+  for (; i + 16 <= size; i += 16)
+    {
+      vmax = _mm512_max_ps (
+        vmax, _mm512_abs_ps (_mm512_loadu_ps (&buf[i])));
+    }
+  float ret = _mm512_reduce_max_ps (vmax);
+  float rest = scalar_abs_max (&buf[i], size - i);
+  return rest > ret ? rest : ret;
+}
+
+AVX512 static float
+avx512_min (const float * buf, size_t size)
+{
+  __m512 vmin = _mm512_set1_ps (1000.f);
+  size_t i = 0;
+  for (; i + 16 <= size; i += 16)
+    {
+      vmin = _mm512_min_ps (vmin, _mm512_loadu_ps (&buf[i]));
+    }
+  float ret = _mm512_reduce_min_ps (vmin);
+  float rest = scalar_min (&buf[i], size - i);
+  return rest < ret ? rest : ret;
+}
+
+AVX512 static float
+avx512_max (const float * buf, size_t size)
+{
+  __m512 vmax = _mm512_set1_ps (-1000.f);
+  size_t i = 0;
+  for (; i + 16 <= size; i += 16)
+    {
+      vmax = _mm512_max_ps (vmax, _mm512_loadu_ps (&buf[i]));
+    }
+  float ret = _mm512_reduce_max_ps (vmax);
+  float rest = scalar_max (&buf[i], size - i);
+  return rest > ret ? rest : ret;
+}
+
+AVX512 static void
+avx512_add2 (float * dest, const float * src, size_t size)
+{
+  size_t i = 0;
+  for (; i + 16 <= size; i += 16)
+    {
+      _mm512_storeu_ps (
+        &dest[i],
+        _mm512_add_ps (
+          _mm512_loadu_ps (&dest[i]), _mm512_loadu_ps (&src[i])));
+    }
+  scalar_add2 (&dest[i], &src[i], size - i);
+}
+
+AVX512 static void
+avx512_mix2 (
+  float *       dest,
+  const float * src,
+  float         k1,
+  float         k2,
+  size_t        size)
+{
+  const __m512 vk1 = _mm512_set1_ps (k1);
+  const __m512 vk2 = _mm512_set1_ps (k2);
+  size_t       i = 0;
+  for (; i + 16 <= size; i += 16)
+    {
+      __m512 d = _mm512_mul_ps (_mm512_loadu_ps (&dest[i]), vk1);
+      __m512 s = _mm512_mul_ps (_mm512_loadu_ps (&src[i]), vk2);
+      _mm512_storeu_ps (&dest[i], _mm512_add_ps (d, s));
+    }
+  scalar_mix2 (&dest[i], &src[i], k1, k2, size - i);
+}
+
+AVX512 static void
+avx512_mix_add2 (
+  float *       dest,
+  const float * src1,
+  const float * src2,
+  float         k1,
+  float         k2,
+  size_t        size)
+{
+  const __m512 vk1 = _mm512_set1_ps (k1);
+  const __m512 vk2 = _mm512_set1_ps (k2);
+  size_t       i = 0;
+  for (; i + 16 <= size; i += 16)
+    {
+      __m512 d = _mm512_loadu_ps (&dest[i]);
+      __m512 s1 = _mm512_mul_ps (_mm512_loadu_ps (&src1[i]), vk1);
+      __m512 s2 = _mm512_mul_ps (_mm512_loadu_ps (&src2[i]), vk2);
+      _mm512_storeu_ps (
+        &dest[i], _mm512_add_ps (_mm512_add_ps (d, s1), s2));
+    }
+  scalar_mix_add2 (
+    &dest[i], &src1[i], &src2[i], k1, k2, size - i);
+}
+
+AVX512 static void
+avx512_linear_fade_in_from (
+  float * dest,
+  int32_t start_offset,
+  int32_t total_frames_to_fade,
+  size_t  size,
+  float   fade_from_multiplier)
+{
+  const __m512 iota = _mm512_set_ps (
+    15.f, 14.f, 13.f, 12.f, 11.f, 10.f, 9.f, 8.f, 7.f, 6.f, 5.f,
+    4.f, 3.f, 2.f, 1.f, 0.f);
+  const __m512 vtotal =
+    _mm512_set1_ps ((float) total_frames_to_fade);
+  const __m512 vfrom = _mm512_set1_ps (fade_from_multiplier);
+  const __m512 vrange =
+    _mm512_set1_ps (1.f - fade_from_multiplier);
+  size_t i = 0;
+  for (; i + 16 <= size; i += 16)
+    {
+      __m512 idx = _mm512_add_ps (
+        _mm512_set1_ps ((float) (i + (size_t) start_offset)),
+        iota);
+      __m512 k = _mm512_div_ps (idx, vtotal);
+      k = _mm512_add_ps (vfrom, _mm512_mul_ps (vrange, k));
+      _mm512_storeu_ps (
+        &dest[i], _mm512_mul_ps (_mm512_loadu_ps (&dest[i]), k));
+    }
+  scalar_linear_fade_in_from (
+    &dest[i], start_offset + (int32_t) i, total_frames_to_fade,
+    size - i, fade_from_multiplier);
+}
+
+AVX512 static void
+avx512_linear_fade_out_to (
+  float * dest,
+  int32_t start_offset,
+  int32_t total_frames_to_fade,
+  size_t  size,
+  float   fade_to_multiplier)
+{
+  const __m512 iota = _mm512_set_ps (
+    15.f, 14.f, 13.f, 12.f, 11.f, 10.f, 9.f, 8.f, 7.f, 6.f, 5.f,
+    4.f, 3.f, 2.f, 1.f, 0.f);
+  const __m512 vtotal =
+    _mm512_set1_ps ((float) total_frames_to_fade);
+  const __m512 vto = _mm512_set1_ps (fade_to_multiplier);
+  const __m512 vrange = _mm512_set1_ps (1.f - fade_to_multiplier);
+  size_t       i = 0;
+  for (; i + 16 <= size; i += 16)
+    {
+      __m512 remaining = _mm512_sub_ps (
+        _mm512_set1_ps ((float) (total_frames_to_fade - start_offset - (int32_t) i)),
+        iota);
+      __m512 k = _mm512_div_ps (remaining, vtotal);
+      k = _mm512_add_ps (vto, _mm512_mul_ps (vrange, k));
+      _mm512_storeu_ps (
+        &dest[i], _mm512_mul_ps (_mm512_loadu_ps (&dest[i]), k));
+    }
+  scalar_linear_fade_out_to (
+    &dest[i], start_offset + (int32_t) i, total_frames_to_fade,
+    size - i, fade_to_multiplier);
+}
+
+const DspKernels dsp_kernels_avx512 = {
+  .name = "AVX-512",
+  .fill = avx512_fill,
+  .limit1 = avx512_limit1,
+  .copy = avx512_copy,
+  .mul_k2 = avx512_mul_k2,
+  .abs_max = avx512_abs_max,
+  .min = avx512_min,
+  .max = avx512_max,
+  .add2 = avx512_add2,
+  .mix2 = avx512_mix2,
+  .mix_add2 = avx512_mix_add2,
+  .linear_fade_in_from = avx512_linear_fade_in_from,
+  .linear_fade_out_to = avx512_linear_fade_out_to,
+};
+
+#endif /* DSP_SIMD_HAVE_X86 */
+
+#if defined(DSP_SIMD_HAVE_NEON)
+
+/* ---- NEON ---- */
+
+static void
+neon_fill (float * buf, float val, size_t size)
+{
+  const float32x4_t v = vdupq_n_f32 (val);
+  size_t            i = 0;
+  for (; i + 4 <= size; i += 4)
+    {
+      vst1q_f32 (&buf[i], v);
+    }
+  scalar_fill (&buf[i], val, size - i);
+}
+
+static void
+neon_limit1 (float * buf, float minf, float maxf, size_t size)
+{
+  const float32x4_t vmin = vdupq_n_f32 (minf);
+  const float32x4_t vmax = vdupq_n_f32 (maxf);
+  size_t            i = 0;
+  for (; i + 4 <= size; i += 4)
+    {
+      float32x4_t v = vld1q_f32 (&buf[i]);
+      v = vminq_f32 (vmaxq_f32 (v, vmin), vmax);
+      vst1q_f32 (&buf[i], v);
+    }
+  scalar_limit1 (&buf[i], minf, maxf, size - i);
+}
+
+static void
+neon_copy (float * dest, const float * src, size_t size)
+{
+  size_t i = 0;
+  for (; i + 8 <= size; i += 8)
+    {
+      float32x4_t a = vld1q_f32 (&src[i]);
+      float32x4_t b = vld1q_f32 (&src[i + 4]);
+      vst1q_f32 (&dest[i], a);
+      vst1q_f32 (&dest[i + 4], b);
+    }
+  scalar_copy (&dest[i], &src[i], size - i);
+}
+
+static void
+neon_mul_k2 (float * dest, float k, size_t size)
+{
+  size_t i = 0;
+  for (; i + 4 <= size; i += 4)
+    {
+      vst1q_f32 (&dest[i], vmulq_n_f32 (vld1q_f32 (&dest[i]), k));
+    }
+  scalar_mul_k2 (&dest[i], k, size - i);
+}
+
+static float
+neon_abs_max (const float * buf, size_t size)
+{
+  float32x4_t vmax = vdupq_n_f32 (0.f);
+  size_t      i = 0;
+  for (; i + 4 <= size; i += 4)
+    {
+      vmax = vmaxq_f32 (vmax, vabsq_f32 (vld1q_f32 (&buf[i])));
+    }
+  float ret = vmaxvq_f32 (vmax);
+  float rest = scalar_abs_max (&buf[i], size - i);
+  return rest > ret ? rest : ret;
+}
+
+static float
+neon_min (const float * buf, size_t size)
+{
+  float32x4_t vmin = vdupq_n_f32 (1000.f);
+  size_t      i = 0;
+  for (; i + 4 <= size; i += 4)
+    {
+      vmin = vminq_f32 (vmin, vld1q_f32 (&buf[i]));
+    }
+  float ret = vminvq_f32 (vmin);
+  float rest = scalar_min (&buf[i], size - i);
+  return rest < ret ? rest : ret;
+}
+
+static float
+neon_max (const float * buf, size_t size)
+{
+  float32x4_t vmax = vdupq_n_f32 (-1000.f);
+  size_t      i = 0;
+  for (; i + 4 <= size; i += 4)
+    {
+      vmax = vmaxq_f32 (vmax, vld1q_f32 (&buf[i]));
+    }
+  float ret = vmaxvq_f32 (vmax);
+  float rest = scalar_max (&buf[i], size - i);
+  return rest > ret ? rest : ret;
+}
+
+static void
+neon_add2 (float * dest, const float * src, size_t size)
+{
+  size_t i = 0;
+  for (; i + 4 <= size; i += 4)
+    {
+      vst1q_f32 (
+        &dest[i],
+        vaddq_f32 (vld1q_f32 (&dest[i]), vld1q_f32 (&src[i])));
+    }
+  scalar_add2 (&dest[i], &src[i], size - i);
+}
+
+static void
+neon_mix2 (
+  float *       dest,
+  const float * src,
+  float         k1,
+  float         k2,
+  size_t        size)
+{
+  size_t i = 0;
+  for (; i + 4 <= size; i += 4)
+    {
+      float32x4_t d = vmulq_n_f32 (vld1q_f32 (&dest[i]), k1);
+      float32x4_t s = vmulq_n_f32 (vld1q_f32 (&src[i]), k2);
+      vst1q_f32 (&dest[i], vaddq_f32 (d, s));
+    }
+  scalar_mix2 (&dest[i], &src[i], k1, k2, size - i);
+}
+
+static void
+neon_mix_add2 (
+  float *       dest,
+  const float * src1,
+  const float * src2,
+  float         k1,
+  float         k2,
+  size_t        size)
+{
+  size_t i = 0;
+  for (; i + 4 <= size; i += 4)
+    {
+      float32x4_t d = vld1q_f32 (&dest[i]);
+      float32x4_t s1 = vmulq_n_f32 (vld1q_f32 (&src1[i]), k1);
+      float32x4_t s2 = vmulq_n_f32 (vld1q_f32 (&src2[i]), k2);
+      vst1q_f32 (&dest[i], vaddq_f32 (vaddq_f32 (d, s1), s2));
+    }
+  scalar_mix_add2 (
+    &dest[i], &src1[i], &src2[i], k1, k2, size - i);
+}
+
+static void
+neon_linear_fade_in_from (
+  float * dest,
+  int32_t start_offset,
+  int32_t total_frames_to_fade,
+  size_t  size,
+  float   fade_from_multiplier)
+{
+  const float       iota_arr[4] = { 0.f, 1.f, 2.f, 3.f };
+  const float32x4_t iota = vld1q_f32 (iota_arr);
+  const float32x4_t vtotal =
+    vdupq_n_f32 ((float) total_frames_to_fade);
+  const float32x4_t vfrom = vdupq_n_f32 (fade_from_multiplier);
+  const float32x4_t vrange =
+    vdupq_n_f32 (1.f - fade_from_multiplier);
+  size_t i = 0;
+  for (; i + 4 <= size; i += 4)
+    {
+      float32x4_t idx = vaddq_f32 (
+        vdupq_n_f32 ((float) (i + (size_t) start_offset)), iota);
+      float32x4_t k = vdivq_f32 (idx, vtotal);
+      k = vaddq_f32 (vfrom, vmulq_f32 (vrange, k));
+      vst1q_f32 (&dest[i], vmulq_f32 (vld1q_f32 (&dest[i]), k));
+    }
+  scalar_linear_fade_in_from (
+    &dest[i], start_offset + (int32_t) i, total_frames_to_fade,
+    size - i, fade_from_multiplier);
+}
+
+static void
+neon_linear_fade_out_to (
+  float * dest,
+  int32_t start_offset,
+  int32_t total_frames_to_fade,
+  size_t  size,
+  float   fade_to_multiplier)
+{
+  const float       iota_arr[4] = { 0.f, 1.f, 2.f, 3.f };
+  const float32x4_t iota = vld1q_f32 (iota_arr);
+  const float32x4_t vtotal =
+    vdupq_n_f32 ((float) total_frames_to_fade);
+  const float32x4_t vto = vdupq_n_f32 (fade_to_multiplier);
+  const float32x4_t vrange =
+    vdupq_n_f32 (1.f - fade_to_multiplier);
+  size_t i = 0;
+  for (; i + 4 <= size; i += 4)
+    {
+      float32x4_t remaining = vsubq_f32 (
+        vdupq_n_f32 ((float) (total_frames_to_fade - start_offset - (int32_t) i)),
+        iota);
+      float32x4_t k = vdivq_f32 (remaining, vtotal);
+      k = vaddq_f32 (vto, vmulq_f32 (vrange, k));
+      vst1q_f32 (&dest[i], vmulq_f32 (vld1q_f32 (&dest[i]), k));
+    }
+  scalar_linear_fade_out_to (
+    &dest[i], start_offset + (int32_t) i, total_frames_to_fade,
+    size - i, fade_to_multiplier);
+}
+
+const DspKernels dsp_kernels_neon = {
+  .name = "NEON",
+  .fill = neon_fill,
+  .limit1 = neon_limit1,
+  .copy = neon_copy,
+  .mul_k2 = neon_mul_k2,
+  .abs_max = neon_abs_max,
+  .min = neon_min,
+  .max = neon_max,
+  .add2 = neon_add2,
+  .mix2 = neon_mix2,
+  .mix_add2 = neon_mix_add2,
+  .linear_fade_in_from = neon_linear_fade_in_from,
+  .linear_fade_out_to = neon_linear_fade_out_to,
+};
+
+#endif /* DSP_SIMD_HAVE_NEON */
@@ -48,6 +48,7 @@
 
 #include "utils/file.h"
 
+#include <gio/gio.h>
 #include <glib.h>
 #include <glib/gstdio.h>
 
@@ -136,14 +137,71 @@ int
 file_reflink (const char * dest, const char * src)
 {
 #ifdef __linux__
-  int src_fd = g_open (src, O_RDONLY);
-  if (src_fd)
-    return src_fd;
-  int dest_fd = g_open (dest, O_RDWR | O_CREAT, 0644);
-  if (dest_fd)
-    return src_fd;
-  return ioctl (dest_fd, FICLONE, src_fd);
+  int src_fd = g_open (src, O_RDONLY, 0);
+  if (src_fd < 0)
+    return -1;
+  int dest_fd =
+    g_open (dest, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+  if (dest_fd < 0)
+    {
+      close (src_fd);
+      return -1;
+    }
+  int ret = ioctl (dest_fd, FICLONE, src_fd);
+  close (dest_fd);
+  close (src_fd);
+  if (ret != 0)
+    {
+      g_unlink (dest);
+    }
+  return ret;
 #else
   return -1;
 #endif
 }
+
+/**
+ * Makes \ref dest a file with the same contents as
+ * \ref src, sharing the data on disk if possible.
+ *
+ * Tries a hard link first, then a reflink and falls
+ * back to copying.
+ *
+ * @note Hard-linked files share their data, so the
+ *   files must never be modified in place (remove
+ *   them before writing to the path instead).
+ *
+ * @return Whether successful.
+ */
+bool
+file_link_or_copy (
+  const char * dest,
+  const char * src,
+  GError **    error)
+{
+  if (g_file_test (dest, G_FILE_TEST_EXISTS))
+    {
+      g_unlink (dest);
+    }
+
+#ifdef _WOE32
+  if (CreateHardLink (dest, src, 0))
+    return true;
+#else
+  if (link (src, dest) == 0)
+    return true;
+#endif
+
+  if (file_reflink (dest, src) == 0)
+    return true;
+
+  GFile * src_file = g_file_new_for_path (src);
+  GFile * dest_file = g_file_new_for_path (dest);
+  bool    ret = g_file_copy (
+    src_file, dest_file, G_FILE_COPY_OVERWRITE, NULL, NULL,
+    NULL, error);
+  g_object_unref (src_file);
+  g_object_unref (dest_file);
+
+  return ret;
+}
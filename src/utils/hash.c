@@ -188,3 +188,20 @@ hash_get_for_struct (const void * const obj, size_t size)
 
   return hash;
 }
+
+/**
+ * Returns a 64-bit hash of the given data (XXH3 if
+ * available).
+ */
+uint64_t
+hash_get_for_data_64 (
+  const void * data,
+  size_t       size,
+  uint64_t     seed)
+{
+#if XXH_VERSION_NUMBER >= 800
+  return XXH3_64bits_withSeed (data, size, seed);
+#else
+  return XXH64 (data, size, seed);
+#endif
+}
@@ -33,6 +33,7 @@
 #include "zrythm-config.h"
 
 #include <stdio.h>
+#include <string.h>
 
 #ifdef _WOE32
 #  include <process.h>
@@ -43,6 +44,7 @@
 #include "gui/backend/event_manager.h"
 #include "gui/widgets/dialogs/bug_report_dialog.h"
 #include "gui/widgets/header.h"
+#include "gui/widgets/log_viewer.h"
 #include "gui/widgets/main_window.h"
 #include "project.h"
 #include "utils/backtrace.h"
@@ -54,6 +56,7 @@
 #include "utils/mpmc_queue.h"
 #include "utils/object_pool.h"
 #include "utils/objects.h"
+#include "utils/rt_audit.h"
 #include "utils/string.h"
 #include "zrythm.h"
 #include "zrythm_app.h"
@@ -146,6 +149,114 @@ typedef struct LogEvent
   bool is_zrythm_domain;
 } LogEvent;
 
+/** Argument types in a log record. */
+typedef enum LogRecordArgType
+{
+  LOG_RECORD_ARG_SIGNED,
+  LOG_RECORD_ARG_UNSIGNED,
+  LOG_RECORD_ARG_DOUBLE,
+  LOG_RECORD_ARG_CHAR,
+  LOG_RECORD_ARG_STRING,
+  LOG_RECORD_ARG_POINTER,
+  LOG_RECORD_ARG_INVALID,
+} LogRecordArgType;
+
+/** Length modifier of a conversion. */
+typedef enum LogRecordArgLength
+{
+  LOG_RECORD_ARG_LENGTH_NONE,
+  LOG_RECORD_ARG_LENGTH_LONG,
+  LOG_RECORD_ARG_LENGTH_LONG_LONG,
+  LOG_RECORD_ARG_LENGTH_LONG_DOUBLE,
+  LOG_RECORD_ARG_LENGTH_SIZE,
+  LOG_RECORD_ARG_LENGTH_INTMAX,
+  LOG_RECORD_ARG_LENGTH_PTRDIFF,
+} LogRecordArgLength;
+
+/** A parsed conversion in a format string. */
+typedef struct LogRecordConversion
+{
+  LogRecordArgType   type;
+  LogRecordArgLength length;
+
+  /** Start of the length modifier. */
+  const char * length_start;
+
+  /** The conversion character. */
+  const char * conv;
+} LogRecordConversion;
+
+typedef union LogRecordArg
+{
+  gint64       i;
+  guint64      u;
+  double       d;
+  const void * p;
+
+  /** Offset in LogRecord.strs. */
+  size_t str_offset;
+} LogRecordArg;
+
+/**
+ * A message queued by log_record(), formatted
+ * later in the record thread.
+ */
+typedef struct LogRecord
+{
+  gint64         real_time;
+  GLogLevelFlags log_level;
+  const char *   func;
+  int            line;
+
+  /** Format string (must be static). */
+  const char * format;
+
+  /** Number of arguments, or -1 if the format is
+   * not supported (the format is then written
+   * as-is). */
+  int          num_args;
+  LogRecordArg args[LOG_RECORD_MAX_ARGS];
+  char         strs[LOG_RECORD_STRS_SIZE];
+} LogRecord;
+
+/**
+ * Single-producer single-consumer ring of records,
+ * owned by one thread at a time.
+ */
+typedef struct LogRecordRing
+{
+  LogRecord records[LOG_RECORD_RING_SIZE];
+
+  /** Number of records written (only modified by
+   * the owner thread). */
+  volatile guint write_pos;
+
+  /** Number of records read (only modified by the
+   * record thread). */
+  volatile guint read_pos;
+
+  /** Whether a thread owns this ring. */
+  volatile gint in_use;
+} LogRecordRing;
+
+/** Record rings, static so that they outlive the
+ * Log and the threads that use them. */
+static LogRecordRing record_rings[LOG_MAX_RECORD_RINGS];
+
+/** Ring owned by the current thread. */
+static __thread LogRecordRing * thread_ring = NULL;
+
+/** Number of records dropped. */
+static volatile gint num_dropped_records = 0;
+
+static void
+release_record_ring (LogRecordRing * ring);
+
+/** Used to release the ring of a thread when it
+ * exits. */
+static GPrivate record_ring_key =
+  G_PRIVATE_INIT ((GDestroyNotify) release_record_ring);
+
 static void
 _log_abort (gboolean breakpoint)
 {
@@ -485,13 +596,18 @@ strdup_convert (const gchar * string, const gchar * charset)
 
 /**
  * @note from GLib.
+ *
+ * @param real_time Time of the message (from
+ *   g_get_real_time()), or 0 to use the current
+ *   time.
  */
 static gchar *
 log_writer_format_fields (
   GLogLevelFlags    log_level,
   const GLogField * fields,
   gsize             n_fields,
-  gboolean          use_color)
+  gboolean          use_color,
+  gint64            real_time)
 {
   gsize         i;
   const gchar * message = NULL;
@@ -563,7 +679,7 @@ log_writer_format_fields (
   g_string_append (gstring, ": ");
 
   /* Timestamp */
-  now = g_get_real_time ();
+  now = real_time > 0 ? real_time : g_get_real_time ();
   now_secs = (time_t) (now / 1000000);
   now_tm = localtime (&now_secs);
   strftime (time_buf, sizeof (time_buf), "%H:%M:%S", now_tm);
@@ -632,7 +748,7 @@ log_writer_standard_streams (
 
   out = log_writer_format_fields (
     log_level, fields, n_fields,
-    g_log_writer_supports_color (fileno (stream)));
+    g_log_writer_supports_color (fileno (stream)), 0);
   g_fprintf (stream, "%s\n", out);
   fflush (stream);
   g_free (out);
@@ -794,6 +910,505 @@ write_str (Log * self, GLogLevelFlags log_level, char * str)
   return 0;
 }
 
+/**
+ * Parses the conversion following a '%'.
+ *
+ * @param c The character after the '%'.
+ *
+ * @return The character after the conversion.
+ */
+static const char *
+parse_conversion (const char * c, LogRecordConversion * conv)
+{
+  /* skip flags, width and precision */
+  while (*c && strchr ("-+ #0123456789.", *c))
+    c++;
+
+  conv->length_start = c;
+  conv->length = LOG_RECORD_ARG_LENGTH_NONE;
+  switch (*c)
+    {
+    case 'h':
+      /* promoted to int */
+      c++;
+      if (*c == 'h')
+        c++;
+      break;
+    case 'l':
+      c++;
+      if (*c == 'l')
+        {
+          c++;
+          conv->length = LOG_RECORD_ARG_LENGTH_LONG_LONG;
+        }
+      else
+        {
+          conv->length = LOG_RECORD_ARG_LENGTH_LONG;
+        }
+      break;
+    case 'L':
+      c++;
+      conv->length = LOG_RECORD_ARG_LENGTH_LONG_DOUBLE;
+      break;
+    case 'z':
+      c++;
+      conv->length = LOG_RECORD_ARG_LENGTH_SIZE;
+      break;
+    case 'j':
+      c++;
+      conv->length = LOG_RECORD_ARG_LENGTH_INTMAX;
+      break;
+    case 't':
+      c++;
+      conv->length = LOG_RECORD_ARG_LENGTH_PTRDIFF;
+      break;
+    default:
+      break;
+    }
+
+  conv->conv = c;
+  switch (*c)
+    {
+    case 'd':
+    case 'i':
+      conv->type = LOG_RECORD_ARG_SIGNED;
+      break;
+    case 'u':
+    case 'o':
+    case 'x':
+    case 'X':
+      conv->type = LOG_RECORD_ARG_UNSIGNED;
+      break;
+    case 'f':
+    case 'F':
+    case 'e':
+    case 'E':
+    case 'g':
+    case 'G':
+    case 'a':
+    case 'A':
+      conv->type = LOG_RECORD_ARG_DOUBLE;
+      break;
+    case 'c':
+      conv->type = LOG_RECORD_ARG_CHAR;
+      break;
+    case 's':
+      conv->type = LOG_RECORD_ARG_STRING;
+      break;
+    case 'p':
+      conv->type = LOG_RECORD_ARG_POINTER;
+      break;
+    default:
+      conv->type = LOG_RECORD_ARG_INVALID;
+      return c;
+    }
+
+  return c + 1;
+}
+
+static gint64
+get_signed_arg (LogRecordArgLength length, va_list * args)
+{
+  switch (length)
+    {
+    case LOG_RECORD_ARG_LENGTH_LONG:
+      return va_arg (*args, long);
+    case LOG_RECORD_ARG_LENGTH_LONG_LONG:
+      return va_arg (*args, long long);
+    case LOG_RECORD_ARG_LENGTH_SIZE:
+      return va_arg (*args, gssize);
+    case LOG_RECORD_ARG_LENGTH_INTMAX:
+      return va_arg (*args, intmax_t);
+    case LOG_RECORD_ARG_LENGTH_PTRDIFF:
+      return va_arg (*args, ptrdiff_t);
+    default:
+      return va_arg (*args, int);
+    }
+}
+
+static guint64
+get_unsigned_arg (LogRecordArgLength length, va_list * args)
+{
+  switch (length)
+    {
+    case LOG_RECORD_ARG_LENGTH_LONG:
+      return va_arg (*args, unsigned long);
+    case LOG_RECORD_ARG_LENGTH_LONG_LONG:
+      return va_arg (*args, unsigned long long);
+    case LOG_RECORD_ARG_LENGTH_SIZE:
+      return va_arg (*args, size_t);
+    case LOG_RECORD_ARG_LENGTH_INTMAX:
+      return va_arg (*args, uintmax_t);
+    case LOG_RECORD_ARG_LENGTH_PTRDIFF:
+      return (guint64) va_arg (*args, ptrdiff_t);
+    default:
+      return va_arg (*args, unsigned int);
+    }
+}
+
+/**
+ * Stores the arguments of the given format in the
+ * record.
+ */
+static void
+fill_record_args (
+  LogRecord *  rec,
+  const char * format,
+  va_list *    args)
+{
+  rec->num_args = 0;
+  size_t strs_len = 0;
+  for (const char * c = format; *c; c++)
+    {
+      if (*c != '%')
+        continue;
+      if (c[1] == '%')
+        {
+          c++;
+          continue;
+        }
+
+      LogRecordConversion conv;
+      const char * end = parse_conversion (c + 1, &conv);
+      if (
+        conv.type == LOG_RECORD_ARG_INVALID
+        || rec->num_args == LOG_RECORD_MAX_ARGS)
+        {
+          rec->num_args = -1;
+          return;
+        }
+
+      LogRecordArg * arg = &rec->args[rec->num_args++];
+      switch (conv.type)
+        {
+        case LOG_RECORD_ARG_SIGNED:
+          arg->i = get_signed_arg (conv.length, args);
+          break;
+        case LOG_RECORD_ARG_UNSIGNED:
+          arg->u = get_unsigned_arg (conv.length, args);
+          break;
+        case LOG_RECORD_ARG_DOUBLE:
+          if (
+            conv.length
+            == LOG_RECORD_ARG_LENGTH_LONG_DOUBLE)
+            arg->d = (double) va_arg (*args, long double);
+          else
+            arg->d = va_arg (*args, double);
+          break;
+        case LOG_RECORD_ARG_CHAR:
+          arg->i = va_arg (*args, int);
+          break;
+        case LOG_RECORD_ARG_STRING:
+          {
+            /* copy the string, truncating it if there
+             * is no more space */
+            const char * str = va_arg (*args, const char *);
+            if (!str)
+              str = "(null)";
+            arg->str_offset =
+              MIN (strs_len, LOG_RECORD_STRS_SIZE - 1);
+            for (size_t i = 0;
+                 str[i]
+                 && strs_len + 1 < LOG_RECORD_STRS_SIZE;
+                 i++)
+              {
+                rec->strs[strs_len++] = str[i];
+              }
+            rec->strs[strs_len] = '\0';
+            if (strs_len + 1 < LOG_RECORD_STRS_SIZE)
+              strs_len++;
+          }
+          break;
+        case LOG_RECORD_ARG_POINTER:
+          arg->p = va_arg (*args, void *);
+          break;
+        default:
+          break;
+        }
+
+      c = end - 1;
+    }
+}
+
+static void
+release_record_ring (LogRecordRing * ring)
+{
+  g_atomic_int_set (&ring->in_use, 0);
+}
+
+/**
+ * Returns the ring of the current thread, claiming
+ * a free one on first use, or NULL if all rings are
+ * in use.
+ */
+static LogRecordRing *
+get_thread_ring (void)
+{
+  if (G_LIKELY (thread_ring))
+    return thread_ring;
+
+  for (int i = 0; i < LOG_MAX_RECORD_RINGS; i++)
+    {
+      LogRecordRing * ring = &record_rings[i];
+      if (g_atomic_int_compare_and_exchange (
+            &ring->in_use, 0, 1))
+        {
+          thread_ring = ring;
+          g_private_set (&record_ring_key, ring);
+          return ring;
+        }
+    }
+
+  return NULL;
+}
+
+void
+log_record (
+  Log *          self,
+  GLogLevelFlags log_level,
+  const char *   func,
+  int            line,
+  const char *   format,
+  ...)
+{
+  va_list args;
+  va_start (args, format);
+
+  if (G_UNLIKELY (
+        !self || !self->initialized || !self->record_thread))
+    {
+      g_logv (G_LOG_DOMAIN, log_level, format, args);
+      va_end (args);
+      return;
+    }
+
+  LogRecordRing * ring = get_thread_ring ();
+  guint           write_pos = ring ? ring->write_pos : 0;
+  if (
+    G_UNLIKELY (!ring)
+    || write_pos - (guint) g_atomic_int_get (&ring->read_pos)
+         >= LOG_RECORD_RING_SIZE)
+    {
+      g_atomic_int_inc (&num_dropped_records);
+      va_end (args);
+      return;
+    }
+
+  LogRecord * rec =
+    &ring->records[write_pos % LOG_RECORD_RING_SIZE];
+  rec->real_time = g_get_real_time ();
+  rec->log_level = log_level;
+  rec->func = func;
+  rec->line = line;
+  rec->format = format;
+  fill_record_args (rec, format, &args);
+  va_end (args);
+
+  /* publish the record */
+  g_atomic_int_set (&ring->write_pos, write_pos + 1);
+}
+
+int
+log_get_num_dropped_records (void)
+{
+  return g_atomic_int_get (&num_dropped_records);
+}
+
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wformat-nonliteral"
+/**
+ * Returns the message of the given record as a
+ * newly allocated string.
+ */
+static char *
+format_record (const LogRecord * rec)
+{
+  if (rec->num_args < 0)
+    return g_strdup (rec->format);
+
+  GString *    gstr = g_string_new (NULL);
+  int          arg_idx = 0;
+  const char * c = rec->format;
+  while (*c)
+    {
+      if (*c != '%')
+        {
+          g_string_append_c (gstr, *c++);
+          continue;
+        }
+      if (c[1] == '%')
+        {
+          g_string_append_c (gstr, '%');
+          c += 2;
+          continue;
+        }
+
+      LogRecordConversion conv;
+      const char * end = parse_conversion (c + 1, &conv);
+      const LogRecordArg * arg = &rec->args[arg_idx++];
+
+      /* keep the flags, width and precision and use
+       * a length modifier matching the stored
+       * type */
+      char spec[32];
+      int  spec_len = MIN ((int) (conv.length_start - c), 24);
+      bool is_int =
+        conv.type == LOG_RECORD_ARG_SIGNED
+        || conv.type == LOG_RECORD_ARG_UNSIGNED;
+      sprintf (
+        spec, "%.*s%s%c", spec_len, c, is_int ? "ll" : "",
+        *conv.conv);
+
+      switch (conv.type)
+        {
+        case LOG_RECORD_ARG_SIGNED:
+          g_string_append_printf (
+            gstr, spec, (long long) arg->i);
+          break;
+        case LOG_RECORD_ARG_UNSIGNED:
+          g_string_append_printf (
+            gstr, spec, (unsigned long long) arg->u);
+          break;
+        case LOG_RECORD_ARG_DOUBLE:
+          g_string_append_printf (gstr, spec, arg->d);
+          break;
+        case LOG_RECORD_ARG_CHAR:
+          g_string_append_printf (gstr, spec, (int) arg->i);
+          break;
+        case LOG_RECORD_ARG_STRING:
+          g_string_append_printf (
+            gstr, spec, &rec->strs[arg->str_offset]);
+          break;
+        case LOG_RECORD_ARG_POINTER:
+          g_string_append_printf (gstr, spec, arg->p);
+          break;
+        default:
+          break;
+        }
+
+      c = end;
+    }
+
+  return g_string_free (gstr, false);
+}
+#pragma GCC diagnostic pop
+
+/**
+ * Formats the given record and writes it to the
+ * log file, the log viewer queue and the console
+ * (when testing).
+ */
+static void
+write_record (Log * self, const LogRecord * rec)
+{
+  char * msg = format_record (rec);
+  char   line_str[16];
+  sprintf (line_str, "%d", rec->line);
+  const GLogField fields[] = {
+    {"MESSAGE",      msg,          -1},
+    { "GLIB_DOMAIN", G_LOG_DOMAIN, -1},
+    { "CODE_FUNC",   rec->func,    -1},
+    { "CODE_LINE",   line_str,     -1},
+  };
+
+  char * str = log_writer_format_fields (
+    rec->log_level, fields, G_N_ELEMENTS (fields),
+    F_NO_USE_COLOR, rec->real_time);
+  write_str (self, rec->log_level, str);
+
+  if (
+    ZRYTHM && ZRYTHM_TESTING
+    && self->use_structured_for_console)
+    {
+      g_log_writer_default (
+        rec->log_level, fields, G_N_ELEMENTS (fields), NULL);
+    }
+
+  if (
+    g_atomic_pointer_get (&self->viewer)
+    && mpmc_queue_push_back (self->viewer_queue, str))
+    {
+      /* owned by the queue */
+      str = NULL;
+    }
+
+  g_free (str);
+  g_free (msg);
+}
+
+/**
+ * Writes all pending records in time order.
+ */
+static void
+write_records (Log * self)
+{
+  guint ends[LOG_MAX_RECORD_RINGS];
+  for (int i = 0; i < LOG_MAX_RECORD_RINGS; i++)
+    {
+      ends[i] =
+        (guint) g_atomic_int_get (&record_rings[i].write_pos);
+    }
+
+  for (;;)
+    {
+      LogRecordRing *   next_ring = NULL;
+      const LogRecord * next_rec = NULL;
+      for (int i = 0; i < LOG_MAX_RECORD_RINGS; i++)
+        {
+          LogRecordRing * ring = &record_rings[i];
+          if (ring->read_pos == ends[i])
+            continue;
+
+          const LogRecord * rec =
+            &ring->records
+               [ring->read_pos % LOG_RECORD_RING_SIZE];
+          if (
+            !next_rec
+            || rec->real_time < next_rec->real_time)
+            {
+              next_ring = ring;
+              next_rec = rec;
+            }
+        }
+      if (!next_ring)
+        break;
+
+      write_record (self, next_rec);
+      g_atomic_int_set (
+        &next_ring->read_pos, next_ring->read_pos + 1);
+    }
+}
+
+/** Interval the record thread writes pending
+ * records in, in microseconds. */
+#define RECORD_THREAD_INTERVAL (20 * 1000)
+
+static gpointer
+record_thread_func (Log * self)
+{
+  int last_num_dropped = log_get_num_dropped_records ();
+  while (g_atomic_int_get (&self->record_thread_running))
+    {
+      write_records (self);
+
+      int num_dropped = log_get_num_dropped_records ();
+      if (num_dropped != last_num_dropped)
+        {
+          g_message (
+            "%d log records dropped",
+            num_dropped - last_num_dropped);
+          last_num_dropped = num_dropped;
+        }
+
+      g_usleep (RECORD_THREAD_INTERVAL);
+    }
+
+  /* write what is left */
+  write_records (self);
+
+  return NULL;
+}
+
 /**
  * Idle callback.
  */
@@ -808,6 +1423,11 @@ log_idle_cb (Log * self)
   while (mpmc_queue_dequeue (self->mqueue, (void *) &ev))
     {
       write_str (self, ev->log_level, ev->message);
+      if (self->viewer)
+        {
+          log_viewer_widget_append (
+            self->viewer, ev->message);
+        }
 
       if (ev->backtrace)
         {
@@ -855,6 +1475,19 @@ log_idle_cb (Log * self)
       object_pool_return (LOG->obj_pool, ev);
     }
 
+  /* show messages written by the record thread */
+  char * str;
+  while (
+    self->viewer_queue
+    && mpmc_queue_dequeue (self->viewer_queue, (void *) &str))
+    {
+      if (self->viewer)
+        {
+          log_viewer_widget_append (self->viewer, str);
+        }
+      g_free (str);
+    }
+
   return G_SOURCE_CONTINUE;
 }
 
@@ -969,31 +1602,17 @@ handled:
 }
 
 /**
- * Log writer.
- *
- * If a message is logged from the GTK thread,
- * the message is written immediately, otherwise it
- * is saved to the queue.
- *
- * The queue is only popped when there is a new
- * message in the GTK thread, so the messages will
- * stay in the queue until then.
+ * Formats the message and writes or queues it.
  */
 static GLogWriterOutput
-log_writer (
+log_writer_queue (
   GLogLevelFlags    log_level,
   const GLogField * fields,
   gsize             n_fields,
   Log *             self)
 {
-  if (use_default_log_writer)
-    {
-      return g_log_writer_default (
-        log_level, fields, n_fields, NULL);
-    }
-
   char * str = log_writer_format_fields (
-    log_level, fields, n_fields, F_NO_USE_COLOR);
+    log_level, fields, n_fields, F_NO_USE_COLOR, 0);
 
   if (self->initialized)
     {
@@ -1087,6 +1706,41 @@ log_writer (
     }
 }
 
+/**
+ * Log writer.
+ *
+ * If a message is logged from the GTK thread,
+ * the message is written immediately, otherwise it
+ * is saved to the queue.
+ *
+ * The queue is only popped when there is a new
+ * message in the GTK thread, so the messages will
+ * stay in the queue until then.
+ */
+static GLogWriterOutput
+log_writer (
+  GLogLevelFlags    log_level,
+  const GLogField * fields,
+  gsize             n_fields,
+  Log *             self)
+{
+  rt_audit_violation_begin (RT_AUDIT_VIOLATION_LOG);
+  GLogWriterOutput ret;
+  if (use_default_log_writer)
+    {
+      ret = g_log_writer_default (
+        log_level, fields, n_fields, NULL);
+    }
+  else
+    {
+      ret = log_writer_queue (
+        log_level, fields, n_fields, self);
+    }
+  rt_audit_violation_end ();
+
+  return ret;
+}
+
 /**
  * Initializes logging to a file.
  *
@@ -1245,6 +1899,19 @@ log_init_with_file (Log * self, const char * filepath)
     self->mqueue, (size_t) MESSAGES_MAX * sizeof (char *));
 
   self->initialized = true;
+
+  /* start writing records from realtime threads
+   * (getting the key first so that claiming a ring
+   * later does not allocate it) */
+  g_private_get (&record_ring_key);
+  self->viewer_queue = mpmc_queue_new ();
+  mpmc_queue_reserve (
+    self->viewer_queue,
+    (size_t) LOG_MAX_RECORD_RINGS * LOG_RECORD_RING_SIZE
+      * sizeof (char *));
+  g_atomic_int_set (&self->record_thread_running, 1);
+  self->record_thread = g_thread_new (
+    "log records", (GThreadFunc) record_thread_func, self);
 }
 
 static guint
@@ -1408,6 +2075,14 @@ log_free (Log * self)
       g_source_remove (self->writer_source_id);
     }
 
+  /* write the remaining records */
+  if (self->record_thread)
+    {
+      g_atomic_int_set (&self->record_thread_running, 0);
+      g_thread_join (self->record_thread);
+      self->record_thread = NULL;
+    }
+
   /* clear the queue */
   log_idle_cb (self);
 
@@ -1425,6 +2100,8 @@ log_free (Log * self)
   object_free_w_func_and_null (
     object_pool_free, self->obj_pool);
   object_free_w_func_and_null (mpmc_queue_free, self->mqueue);
+  object_free_w_func_and_null (
+    mpmc_queue_free, self->viewer_queue);
   /*g_object_unref_and_null (self->messages_buf);*/
 
   g_free_and_null (self->log_domains);
@@ -0,0 +1,301 @@
+// SPDX-FileCopyrightText: © 2022 Alexandros Theodotou <alex@zrythm.org>
+// SPDX-License-Identifier: LicenseRef-ZrythmLicense
+
+/* for RTLD_NEXT */
+#define _GNU_SOURCE
+
+#include "zrythm-config.h"
+
+#ifdef HAVE_RT_AUDIT
+
+#  include <dlfcn.h>
+#  include <execinfo.h>
+#  include <pthread.h>
+#  include <stdlib.h>
+#  include <string.h>
+
+#  include "utils/rt_audit.h"
+
+#  include <glib.h>
+
+typedef struct RtAuditViolation
+{
+  RtAuditViolationType type;
+  int                  num_frames;
+  void *               frames[RT_AUDIT_MAX_FRAMES];
+} RtAuditViolation;
+
+/** A call site in the report. */
+typedef struct RtAuditCallSite
+{
+  /** Index of the first violation. */
+  int idx;
+  int count;
+} RtAuditCallSite;
+
+static const char * violation_type_strings[] = {
+  "allocation",
+  "free",
+  "blocking lock",
+  "logging",
+};
+
+static RtAuditViolation violations[RT_AUDIT_MAX_VIOLATIONS];
+
+/** Number of violations (may be larger than the
+ * number of violations kept). */
+static volatile gint num_violations = 0;
+
+/** Depth of audited sections in this thread. */
+static __thread int section_depth = 0;
+
+/** Depth of offending calls in this thread. */
+static __thread int violation_depth = 0;
+
+extern void * __libc_malloc (size_t size);
+extern void * __libc_calloc (size_t nmemb, size_t size);
+extern void * __libc_realloc (void * ptr, size_t size);
+extern void   __libc_free (void * ptr);
+
+typedef int (*PthreadMutexLockFunc) (pthread_mutex_t *);
+typedef void (*GMutexLockFunc) (GMutex *);
+
+static PthreadMutexLockFunc real_pthread_mutex_lock = NULL;
+static GMutexLockFunc       real_g_mutex_lock = NULL;
+
+/**
+ * Resolves the wrapped functions and loads libgcc
+ * (used by backtrace()) before any processing
+ * thread runs.
+ */
+__attribute__ ((constructor)) static void
+rt_audit_init (void)
+{
+  violation_depth++;
+  real_pthread_mutex_lock = (PthreadMutexLockFunc) dlsym (
+    RTLD_NEXT, "pthread_mutex_lock");
+  real_g_mutex_lock =
+    (GMutexLockFunc) dlsym (RTLD_NEXT, "g_mutex_lock");
+  void * frames[2];
+  backtrace (frames, 2);
+  violation_depth--;
+}
+
+void
+rt_audit_enter (void)
+{
+  section_depth++;
+}
+
+void
+rt_audit_leave (void)
+{
+  g_return_if_fail (section_depth > 0);
+  section_depth--;
+}
+
+static void
+record_violation (RtAuditViolationType type)
+{
+  int idx = g_atomic_int_add (&num_violations, 1);
+  if (idx >= RT_AUDIT_MAX_VIOLATIONS)
+    return;
+
+  RtAuditViolation * v = &violations[idx];
+  v->type = type;
+  v->num_frames = backtrace (v->frames, RT_AUDIT_MAX_FRAMES);
+}
+
+void
+rt_audit_violation_begin (RtAuditViolationType type)
+{
+  bool should_record =
+    section_depth > 0 && violation_depth == 0;
+  violation_depth++;
+  if (G_UNLIKELY (should_record))
+    record_violation (type);
+}
+
+void
+rt_audit_violation_end (void)
+{
+  violation_depth--;
+}
+
+void *
+malloc (size_t size)
+{
+  rt_audit_violation_begin (RT_AUDIT_VIOLATION_ALLOC);
+  void * ptr = __libc_malloc (size);
+  rt_audit_violation_end ();
+  return ptr;
+}
+
+void *
+calloc (size_t nmemb, size_t size)
+{
+  rt_audit_violation_begin (RT_AUDIT_VIOLATION_ALLOC);
+  void * ptr = __libc_calloc (nmemb, size);
+  rt_audit_violation_end ();
+  return ptr;
+}
+
+void *
+realloc (void * ptr, size_t size)
+{
+  rt_audit_violation_begin (RT_AUDIT_VIOLATION_ALLOC);
+  void * new_ptr = __libc_realloc (ptr, size);
+  rt_audit_violation_end ();
+  return new_ptr;
+}
+
+void
+free (void * ptr)
+{
+  if (!ptr)
+    return;
+
+  rt_audit_violation_begin (RT_AUDIT_VIOLATION_FREE);
+  __libc_free (ptr);
+  rt_audit_violation_end ();
+}
+
+int
+pthread_mutex_lock (pthread_mutex_t * mutex)
+{
+  /* may be called by other constructors before
+   * rt_audit_init() */
+  if (G_UNLIKELY (!real_pthread_mutex_lock))
+    {
+      real_pthread_mutex_lock = (PthreadMutexLockFunc)
+        dlsym (RTLD_NEXT, "pthread_mutex_lock");
+    }
+
+  rt_audit_violation_begin (RT_AUDIT_VIOLATION_LOCK);
+  int ret = real_pthread_mutex_lock (mutex);
+  rt_audit_violation_end ();
+  return ret;
+}
+
+void
+g_mutex_lock (GMutex * mutex)
+{
+  if (G_UNLIKELY (!real_g_mutex_lock))
+    {
+      real_g_mutex_lock =
+        (GMutexLockFunc) dlsym (RTLD_NEXT, "g_mutex_lock");
+    }
+
+  rt_audit_violation_begin (RT_AUDIT_VIOLATION_LOCK);
+  real_g_mutex_lock (mutex);
+  rt_audit_violation_end ();
+}
+
+int
+rt_audit_get_num_violations (void)
+{
+  return g_atomic_int_get (&num_violations);
+}
+
+static bool
+violations_equal (
+  const RtAuditViolation * a,
+  const RtAuditViolation * b)
+{
+  return a->type == b->type && a->num_frames == b->num_frames
+         && memcmp (
+              a->frames, b->frames,
+              (size_t) a->num_frames * sizeof (void *))
+              == 0;
+}
+
+static int
+cmp_call_sites (const void * _a, const void * _b)
+{
+  const RtAuditCallSite * a = (const RtAuditCallSite *) _a;
+  const RtAuditCallSite * b = (const RtAuditCallSite *) _b;
+  return b->count - a->count;
+}
+
+char *
+rt_audit_get_report (void)
+{
+  int num = rt_audit_get_num_violations ();
+  int num_kept = MIN (num, RT_AUDIT_MAX_VIOLATIONS);
+
+  /* group the violations by call site */
+  RtAuditCallSite * sites =
+    g_new0 (RtAuditCallSite, (size_t) MAX (num_kept, 1));
+  int num_sites = 0;
+  for (int i = 0; i < num_kept; i++)
+    {
+      bool found = false;
+      for (int j = 0; j < num_sites; j++)
+        {
+          if (violations_equal (
+                &violations[sites[j].idx], &violations[i]))
+            {
+              sites[j].count++;
+              found = true;
+              break;
+            }
+        }
+      if (!found)
+        {
+          sites[num_sites].idx = i;
+          sites[num_sites].count = 1;
+          num_sites++;
+        }
+    }
+  qsort (
+    sites, (size_t) num_sites, sizeof (RtAuditCallSite),
+    cmp_call_sites);
+
+  GString * gstr = g_string_new (NULL);
+  g_string_append_printf (
+    gstr,
+    "RT audit: %d violations (%d kept) at %d call "
+    "sites\n",
+    num, num_kept, num_sites);
+  for (int i = 0; i < num_sites; i++)
+    {
+      const RtAuditViolation * v =
+        &violations[sites[i].idx];
+      g_string_append_printf (
+        gstr, "\n#%d: %s (%d times)\n", i + 1,
+        violation_type_strings[v->type], sites[i].count);
+
+      char ** symbols =
+        backtrace_symbols (v->frames, v->num_frames);
+      for (int j = 0; j < v->num_frames; j++)
+        {
+          g_string_append_printf (
+            gstr, "  %s\n", symbols ? symbols[j] : "??");
+        }
+      free (symbols);
+    }
+  g_free (sites);
+
+  return g_string_free (gstr, false);
+}
+
+bool
+rt_audit_write_report (
+  const char * filepath,
+  GError **    error)
+{
+  char * report = rt_audit_get_report ();
+  bool   ret =
+    g_file_set_contents (filepath, report, -1, error);
+  g_free (report);
+
+  return ret;
+}
+
+void
+rt_audit_reset (void)
+{
+  g_atomic_int_set (&num_violations, 0);
+}
+
+#endif /* HAVE_RT_AUDIT */
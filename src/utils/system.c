@@ -24,6 +24,12 @@
 #include <stdbool.h>
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
+
+#ifdef __linux__
+#  include <dirent.h>
+#  include <unistd.h>
+#endif
 
 #include "utils/system.h"
 
@@ -270,3 +276,159 @@ system_get_cmd_output (
   return g_string_free (str, false);
 #endif
 }
+
+#ifdef __linux__
+/**
+ * Reads the contents of /proc/<pid>/stat after the
+ * process name (which may contain spaces) into
+ * @p buf.
+ *
+ * @return A pointer to the field after the name
+ *   (the state), or NULL on failure.
+ */
+static const char *
+read_proc_stat (int pid, char * buf, size_t buf_sz)
+{
+  char path[64];
+  snprintf (path, sizeof (path), "/proc/%d/stat", pid);
+  FILE * f = fopen (path, "r");
+  if (!f)
+    return NULL;
+
+  size_t len = fread (buf, 1, buf_sz - 1, f);
+  fclose (f);
+  buf[len] = '\0';
+
+  const char * name_end = strrchr (buf, ')');
+  if (!name_end || name_end[1] != ' ')
+    return NULL;
+
+  return name_end + 2;
+}
+#endif
+
+/**
+ * Fills in the PIDs of the direct child processes
+ * of this process.
+ *
+ * @note Only implemented on Linux (returns 0
+ *   elsewhere).
+ *
+ * @return The number of PIDs written.
+ */
+int
+system_get_child_pids (int * pids, int max_pids)
+{
+  int num_pids = 0;
+#ifdef __linux__
+  DIR * dir = opendir ("/proc");
+  if (!dir)
+    return 0;
+
+  int             self_pid = (int) getpid ();
+  struct dirent * entry;
+  while ((entry = readdir (dir)) && num_pids < max_pids)
+    {
+      int pid = atoi (entry->d_name);
+      if (pid <= 0)
+        continue;
+
+      char         buf[1024];
+      const char * fields =
+        read_proc_stat (pid, buf, sizeof (buf));
+      char state;
+      int  ppid;
+      if (
+        fields && sscanf (fields, "%c %d", &state, &ppid) == 2
+        && ppid == self_pid)
+        {
+          pids[num_pids++] = pid;
+        }
+    }
+  closedir (dir);
+#endif
+
+  return num_pids;
+}
+
+/**
+ * Returns the command line arguments of the given
+ * process as a NULL-terminated array, or NULL if
+ * unknown.
+ *
+ * @note Only implemented on Linux.
+ *
+ * @return A newly allocated array to be freed with
+ *   g_strfreev().
+ */
+char **
+system_get_process_cmdline (int pid)
+{
+#ifdef __linux__
+  char * path = g_strdup_printf ("/proc/%d/cmdline", pid);
+  char * contents = NULL;
+  gsize  len = 0;
+  bool   read =
+    g_file_get_contents (path, &contents, &len, NULL);
+  g_free (path);
+  if (!read || len == 0)
+    {
+      g_free (contents);
+      return NULL;
+    }
+
+  /* the arguments are separated (and terminated)
+   * by NUL characters */
+  GPtrArray * args = g_ptr_array_new ();
+  for (gsize i = 0; i < len; i += strlen (&contents[i]) + 1)
+    {
+      g_ptr_array_add (args, g_strdup (&contents[i]));
+    }
+  g_ptr_array_add (args, NULL);
+  g_free (contents);
+
+  return (char **) g_ptr_array_free (args, false);
+#else
+  return NULL;
+#endif
+}
+
+/**
+ * Returns the CPU time (user + system) used so far
+ * by the given process in microseconds, or -1 if
+ * unknown (e.g., the process exited).
+ *
+ * @note Only implemented on Linux.
+ */
+int64_t
+system_get_process_cpu_time (int pid)
+{
+#ifdef __linux__
+  char         buf[1024];
+  const char * fields =
+    read_proc_stat (pid, buf, sizeof (buf));
+  if (!fields)
+    return -1;
+
+  /* utime and stime are the 12th and 13th fields
+   * after the process name */
+  unsigned long long utime, stime;
+  if (
+    sscanf (
+      fields,
+      "%*c %*d %*d %*d %*d %*d %*u %*u %*u %*u %*u "
+      "%llu %llu",
+      &utime, &stime)
+    != 2)
+    return -1;
+
+  long ticks_per_sec = sysconf (_SC_CLK_TCK);
+  if (ticks_per_sec <= 0)
+    return -1;
+
+  return (int64_t) ((utime + stime) * 1000000ull
+                    / (unsigned long long) ticks_per_sec);
+#else
+  return -1;
+#endif
+}
@@ -29,6 +29,7 @@
 #include "utils/arrays.h"
 #include "utils/cairo.h"
 #include "utils/curl.h"
+#include "utils/dsp.h"
 #include "utils/env.h"
 #include "utils/gtk.h"
 #include "utils/io.h"
@@ -614,6 +615,10 @@ zrythm_get_dir (ZrythmDirType type)
           res =
             g_build_filename (user_dir, "backtraces", NULL);
           break;
+        case ZRYTHM_DIR_USER_CLIP_CACHE:
+          res = g_build_filename (
+            user_dir, "cache", "clips", NULL);
+          break;
         default:
           break;
         }
@@ -741,6 +746,7 @@ zrythm_new (
   self->have_ui = have_ui;
   self->testing = testing;
   self->use_optimized_dsp = optimized_dsp;
+  dsp_init (optimized_dsp);
   self->settings = settings_new ();
   self->object_utils = object_utils_new ();
   self->recording_manager = recording_manager_new ();
@@ -0,0 +1,173 @@
+// SPDX-FileCopyrightText: © 2022 Alexandros Theodotou <alex@zrythm.org>
+// SPDX-License-Identifier: LicenseRef-ZrythmLicense
+
+#include "zrythm-test-config.h"
+
+#include "audio/anticipative_renderer.h"
+#include "audio/fader.h"
+#include "audio/router.h"
+#include "audio/transport.h"
+#include "project.h"
+#include "utils/flags.h"
+#include "zrythm.h"
+
+#include <string.h>
+
+#include <glib.h>
+
+#include "tests/helpers/project.h"
+#include "tests/helpers/zrythm.h"
+
+#define NUM_CYCLES 32
+
+/**
+ * Waits until the renderer is at least a cycle
+ * ahead.
+ */
+static void
+wait_for_renderer (AnticipativeTrack * at)
+{
+  for (int i = 0; i < 10000; i++)
+    {
+      if (
+        anticipative_track_get_num_frames_ahead (at)
+        >= AUDIO_ENGINE->block_length)
+        return;
+
+      g_usleep (100);
+    }
+  g_assert_not_reached ();
+}
+
+/**
+ * Runs cycles until the given track is processed
+ * by the realtime graph again.
+ */
+static void
+wait_for_reclaim (AnticipativeTrack * at)
+{
+  for (int i = 0; i < 1000 && at->anticipated; i++)
+    {
+      g_usleep (1000);
+      engine_process (
+        AUDIO_ENGINE, AUDIO_ENGINE->block_length);
+    }
+  g_assert_false (at->anticipated);
+}
+
+/**
+ * Plays from the start and collects the fader
+ * input of the given track for the given number of
+ * cycles.
+ */
+static void
+play_and_collect (
+  Track * track,
+  float * frames,
+  int     num_cycles)
+{
+  Position start;
+  position_init (&start);
+  transport_set_playhead_pos (TRANSPORT, &start);
+  transport_request_roll (TRANSPORT, true);
+
+  nframes_t block_length = AUDIO_ENGINE->block_length;
+  for (int i = 0; i < num_cycles; i++)
+    {
+      if (track->anticipative && i > 0)
+        wait_for_renderer (track->anticipative);
+
+      engine_process (AUDIO_ENGINE, block_length);
+      memcpy (
+        &frames[(size_t) i * block_length],
+        track->channel->fader->stereo_in->l->buf,
+        block_length * sizeof (float));
+    }
+
+  transport_request_pause (TRANSPORT, true);
+  engine_process (AUDIO_ENGINE, block_length);
+}
+
+static void
+test_render_ahead (void)
+{
+  test_helper_zrythm_init ();
+
+  char * filepath =
+    g_build_filename (TESTS_SRCDIR, "test.wav", NULL);
+  SupportedFile * file =
+    supported_file_new_from_path (filepath);
+  Position start;
+  position_init (&start);
+  Track * track = track_create_with_action (
+    TRACK_TYPE_AUDIO, NULL, file, &start,
+    TRACKLIST->num_tracks, 1, NULL);
+  g_free (filepath);
+  supported_file_free (file);
+
+  test_project_stop_dummy_engine ();
+
+  /* play the track in the realtime graph */
+  nframes_t block_length = AUDIO_ENGINE->block_length;
+  g_assert_null (track->anticipative);
+  float * rt_frames =
+    g_new0 (float, (size_t) NUM_CYCLES * block_length);
+  play_and_collect (track, rt_frames, NUM_CYCLES);
+
+  /* play it again rendered ahead */
+  AnticipativeRenderer * renderer = ANTICIPATIVE_RENDERER;
+  renderer->enabled = true;
+  router_recalc_graph (ROUTER, F_NOT_SOFT);
+  AnticipativeTrack * at = track->anticipative;
+  g_assert_nonnull (at);
+
+  /* playback is delayed by the priming frames */
+  nframes_t prime_frames = renderer->prime_frames;
+  int num_cycles =
+    NUM_CYCLES
+    + (int) ((prime_frames + block_length - 1)
+             / block_length);
+  float * frames =
+    g_new0 (float, (size_t) num_cycles * block_length);
+  play_and_collect (track, frames, num_cycles);
+
+  for (size_t i = 0; i < (size_t) NUM_CYCLES * block_length;
+       i++)
+    {
+      g_assert_cmpfloat_with_epsilon (
+        frames[prime_frames + i], rt_frames[i], 0.000001f);
+    }
+  g_assert_cmpint (
+    g_atomic_int_get (&at->num_underruns), ==, 0);
+
+  /* the track is reclaimed when playback stops */
+  wait_for_reclaim (at);
+
+  /* and when the playhead is moved */
+  Position pos;
+  position_set_to_bar (&pos, 2);
+  transport_request_roll (TRANSPORT, true);
+  engine_process (AUDIO_ENGINE, block_length);
+  g_assert_true (at->anticipated);
+  transport_set_playhead_pos (TRANSPORT, &pos);
+  wait_for_reclaim (at);
+
+  g_free (rt_frames);
+  g_free (frames);
+
+  test_helper_zrythm_cleanup ();
+}
+
+int
+main (int argc, char * argv[])
+{
+  g_test_init (&argc, &argv, NULL);
+
+#define TEST_PREFIX "/audio/anticipative_renderer/"
+
+  g_test_add_func (
+    TEST_PREFIX "test render ahead",
+    (GTestFunc) test_render_ahead);
+
+  return g_test_run ();
+}
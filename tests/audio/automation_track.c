@@ -4,6 +4,7 @@
 #include "zrythm-test-config.h"
 
 #include "actions/arranger_selections.h"
+#include "audio/automation_point.h"
 #include "audio/automation_region.h"
 #include "audio/automation_track.h"
 #include "audio/channel.h"
@@ -132,6 +133,80 @@ test_region_in_2nd_automation_track_get_muted (void)
   test_helper_zrythm_cleanup ();
 }
 
+static void
+test_curve_samples (void)
+{
+  test_helper_zrythm_init ();
+
+  Track * master = P_MASTER_TRACK;
+  AutomationTracklist * atl =
+    track_get_automation_tracklist (master);
+  AutomationTrack * at =
+    automation_tracklist_get_first_invisible_at (atl);
+  at->created = true;
+
+  Position start, end;
+  position_set_to_bar (&start, 1);
+  position_set_to_bar (&end, 4);
+  ZRegion * region = automation_region_new (
+    &start, &end, track_get_name_hash (master), at->index,
+    0);
+  track_add_region (
+    master, region, at, -1, F_GEN_NAME,
+    F_NO_PUBLISH_EVENTS);
+
+  Position pos;
+  position_set_to_bar (&pos, 1);
+  AutomationPoint * ap =
+    automation_point_new_float (0.2f, 0.2f, &pos);
+  automation_region_add_ap (
+    region, ap, F_NO_PUBLISH_EVENTS);
+  position_set_to_bar (&pos, 2);
+  AutomationPoint * next_ap =
+    automation_point_new_float (0.8f, 0.8f, &pos);
+  automation_region_add_ap (
+    region, next_ap, F_NO_PUBLISH_EVENTS);
+  automation_point_set_curviness (ap, 0.6);
+
+  for (int i = 0; i < 2; i++)
+    {
+      const int      num_samples = 16;
+      const double * samples =
+        automation_point_get_curve_samples (
+          ap, next_ap, num_samples);
+      g_assert_nonnull (samples);
+      for (int j = 0; j <= num_samples; j++)
+        {
+          g_assert_cmpfloat_with_epsilon (
+            samples[j],
+            automation_point_get_normalized_value_in_curve (
+              ap, (double) j / num_samples),
+            0.00001);
+        }
+
+      /* reverse the curve direction by editing
+       * the next point */
+      automation_point_set_fvalue (
+        next_ap, 0.1f, F_NORMALIZED,
+        F_NO_PUBLISH_EVENTS);
+    }
+
+  g_assert_cmpint (
+    automation_point_get_num_curve_samples_for_width (
+      0.0),
+    ==, 1);
+  g_assert_cmpint (
+    automation_point_get_num_curve_samples_for_width (
+      100.5),
+    ==, 128);
+  g_assert_cmpint (
+    automation_point_get_num_curve_samples_for_width (
+      1000000.0),
+    ==, 4096);
+
+  test_helper_zrythm_cleanup ();
+}
+
 int
 main (int argc, char * argv[])
 {
@@ -146,6 +221,9 @@ main (int argc, char * argv[])
     TEST_PREFIX
     "test region in 2nd automation track get muted",
     (GTestFunc) test_region_in_2nd_automation_track_get_muted);
+  g_test_add_func (
+    TEST_PREFIX "test curve samples",
+    (GTestFunc) test_curve_samples);
 
   return g_test_run ();
 }
@@ -202,6 +202,58 @@ test_solo (void)
   test_helper_zrythm_cleanup ();
 }
 
+static void
+test_silence_tracking (void)
+{
+  test_helper_zrythm_init ();
+
+  /* create audio track */
+  char * filepath =
+    g_build_filename (TESTS_SRCDIR, "test.wav", NULL);
+  SupportedFile * file =
+    supported_file_new_from_path (filepath);
+  Track * audio_track = track_create_with_action (
+    TRACK_TYPE_AUDIO, NULL, file, PLAYHEAD,
+    TRACKLIST->num_tracks, 1, NULL);
+
+  /* stop dummy audio engine processing so we can
+   * process manually */
+  AUDIO_ENGINE->stop_dummy_audio_thread = true;
+  g_usleep (1000000);
+
+  /* not rolling: the whole chain is silent */
+  engine_process (AUDIO_ENGINE, AUDIO_ENGINE->block_length);
+  Fader * fader = audio_track->channel->fader;
+  g_assert_true (
+    port_is_silent (audio_track->processor->stereo_out->l));
+  g_assert_true (port_is_silent (fader->stereo_in->l));
+  g_assert_true (port_is_silent (fader->stereo_out->l));
+  g_assert_true (port_is_silent (fader->stereo_out->r));
+  g_assert_true (
+    port_is_silent (P_MASTER_TRACK->processor->stereo_in->l));
+  g_assert_false (track_has_sound (audio_track));
+  g_assert_false (port_has_sound (fader->stereo_out->l));
+
+  /* rolling over the region: not silent */
+  Position pos;
+  position_set_to_bar (&pos, 1);
+  transport_set_playhead_pos (TRANSPORT, &pos);
+  transport_request_roll (TRANSPORT, true);
+  engine_process (AUDIO_ENGINE, AUDIO_ENGINE->block_length);
+  engine_process (AUDIO_ENGINE, AUDIO_ENGINE->block_length);
+  g_assert_false (
+    port_is_silent (audio_track->processor->stereo_out->l));
+  g_assert_false (port_is_silent (fader->stereo_out->l));
+  g_assert_false (
+    port_is_silent (P_MASTER_TRACK->processor->stereo_in->l));
+  g_assert_true (track_has_sound (audio_track));
+
+  transport_request_pause (TRANSPORT, true);
+  engine_process (AUDIO_ENGINE, AUDIO_ENGINE->block_length);
+
+  test_helper_zrythm_cleanup ();
+}
+
 int
 main (int argc, char * argv[])
 {
@@ -214,6 +266,9 @@ main (int argc, char * argv[])
     (GTestFunc) test_fader_process);
   g_test_add_func (
     TEST_PREFIX "test solo", (GTestFunc) test_solo);
+  g_test_add_func (
+    TEST_PREFIX "test silence tracking",
+    (GTestFunc) test_silence_tracking);
 
   return g_test_run ();
 }
@@ -5,10 +5,15 @@
 
 #include <stdlib.h>
 
+#include "audio/engine.h"
 #include "audio/midi_event.h"
+#include "audio/port.h"
+#include "project.h"
+#include "utils/flags.h"
 
 #include <glib.h>
 
+#include "tests/helpers/project.h"
 #include "tests/helpers/zrythm.h"
 
 static void
@@ -37,6 +42,170 @@ test_add_note_ons (void)
   test_helper_zrythm_cleanup ();
 }
 
+static void
+test_grow (void)
+{
+  test_helper_zrythm_init ();
+
+  MidiEvents * events = midi_events_new ();
+  g_assert_cmpint (
+    events->events_size, ==, MIDI_EVENTS_INITIAL_SIZE);
+
+  /* add more events than the initial size */
+  const int num_events = MIDI_EVENTS_INITIAL_SIZE * 3 + 1;
+  for (int i = 0; i < num_events; i++)
+    {
+      midi_events_add_note_on (
+        events, 1, (midi_byte_t) (i % 128), 90,
+        (midi_time_t) i, F_QUEUED);
+    }
+  g_assert_cmpint (events->num_queued_events, ==, num_events);
+  g_assert_cmpint (events->num_dropped, ==, 0);
+
+  midi_events_dequeue (events);
+  g_assert_cmpint (events->num_events, ==, num_events);
+  g_assert_cmpint (events->num_queued_events, ==, 0);
+  for (int i = 0; i < num_events; i++)
+    {
+      MidiEvent * ev = &events->events[i];
+      g_assert_cmpuint (ev->time, ==, i);
+      g_assert_cmpuint (ev->raw_buffer_sz, ==, 3);
+      g_assert_cmpuint (
+        midi_get_note_number (ev->raw_buffer), ==, i % 128);
+    }
+
+  /* new buffers should fit the peak usage */
+  MidiEvents * new_events =
+    midi_events_new_with_size_of (events);
+  g_assert_cmpint (new_events->events_size, >=, num_events);
+  g_assert_cmpint (
+    new_events->queued_events_size, >=, num_events);
+
+  /* buffers are never reallocated while their lock
+   * is taken (eg, while being dequeued) */
+  MidiEvents * locked = midi_events_new ();
+  zix_sem_wait (&locked->access_sem);
+  for (int i = 0; i < MIDI_EVENTS_INITIAL_SIZE + 1; i++)
+    {
+      midi_events_add_note_on (
+        locked, 1, 60, 90, (midi_time_t) i, F_QUEUED);
+    }
+  zix_sem_post (&locked->access_sem);
+  g_assert_cmpint (
+    locked->queued_events_size, ==,
+    MIDI_EVENTS_INITIAL_SIZE);
+  g_assert_cmpint (
+    locked->num_queued_events, ==, MIDI_EVENTS_INITIAL_SIZE);
+  g_assert_cmpint (locked->num_dropped, ==, 1);
+
+  midi_events_free (events);
+  midi_events_free (new_events);
+  midi_events_free (locked);
+
+  test_helper_zrythm_cleanup ();
+}
+
+static void
+test_sort_and_clear_duplicates (void)
+{
+  test_helper_zrythm_init ();
+
+  MidiEvents * events = midi_events_new ();
+
+  /* 3 sorted runs, like the events of 3 regions,
+   * with the last run duplicating the first */
+  const int num_runs = 3;
+  const int run_len = 40;
+  for (int i = 0; i < num_runs; i++)
+    {
+      for (int j = 0; j < run_len; j++)
+        {
+          int         k = i % 2;
+          midi_byte_t note = (midi_byte_t) (k * 40 + j);
+          midi_events_add_note_on (
+            events, 1, note, 90, (midi_time_t) (j * 2 + k),
+            F_NOT_QUEUED);
+        }
+    }
+  g_assert_cmpint (
+    events->num_events, ==, num_runs * run_len);
+
+  /* add another duplicate of the first event */
+  midi_events_add_note_on (
+    events, 1, 0, 90, 0, F_NOT_QUEUED);
+
+  midi_events_sort_and_clear_duplicates (
+    events, F_NOT_QUEUED);
+  g_assert_cmpint (events->num_events, ==, 2 * run_len);
+  for (int i = 1; i < events->num_events; i++)
+    {
+      g_assert_cmpuint (
+        events->events[i - 1].time, <=,
+        events->events[i].time);
+    }
+
+  /* sorting again keeps everything */
+  midi_events_sort (events, F_NOT_QUEUED);
+  g_assert_cmpint (events->num_events, ==, 2 * run_len);
+
+  midi_events_free (events);
+
+  test_helper_zrythm_cleanup ();
+}
+
+/**
+ * Queues the given number of note ons.
+ */
+static void
+queue_note_ons (MidiEvents * events, int num_events)
+{
+  for (int i = 0; i < num_events; i++)
+    {
+      midi_events_add_note_on (
+        events, 1, (midi_byte_t) (i % 128), 90, 0,
+        F_QUEUED);
+    }
+}
+
+static void
+test_grow_after_processing_drop (void)
+{
+  test_helper_zrythm_init ();
+
+  test_project_stop_dummy_engine ();
+
+  /* queue more events than the main buffer fits
+   * (the queued buffer grows since this is not a
+   * processing thread yet) */
+  MidiEvents * events =
+    AUDIO_ENGINE->midi_editor_manual_press->midi_events;
+  const int num_events = MIDI_EVENTS_INITIAL_SIZE * 2;
+  queue_note_ons (events, num_events);
+  g_assert_cmpint (events->num_queued_events, ==, num_events);
+  g_assert_cmpint (
+    events->events_size, ==, MIDI_EVENTS_INITIAL_SIZE);
+
+  /* the main buffer cannot grow while processing,
+   * so the rest is dropped */
+  engine_process (AUDIO_ENGINE, AUDIO_ENGINE->block_length);
+  g_assert_cmpint (
+    events->num_dropped, ==,
+    num_events - MIDI_EVENTS_INITIAL_SIZE);
+
+  /* the engine grows the buffers outside the
+   * processing threads */
+  engine_process_events (AUDIO_ENGINE);
+  g_assert_cmpint (events->num_dropped, ==, 0);
+  g_assert_cmpint (events->events_size, >=, num_events);
+
+  /* and the next cycle gets all the events */
+  queue_note_ons (events, num_events);
+  engine_process (AUDIO_ENGINE, AUDIO_ENGINE->block_length);
+  g_assert_cmpint (events->num_dropped, ==, 0);
+
+  test_helper_zrythm_cleanup ();
+}
+
 int
 main (int argc, char * argv[])
 {
@@ -47,6 +216,14 @@ main (int argc, char * argv[])
   g_test_add_func (
     TEST_PREFIX "test add note ons",
     (GTestFunc) test_add_note_ons);
+  g_test_add_func (
+    TEST_PREFIX "test grow", (GTestFunc) test_grow);
+  g_test_add_func (
+    TEST_PREFIX "test grow after processing drop",
+    (GTestFunc) test_grow_after_processing_drop);
+  g_test_add_func (
+    TEST_PREFIX "test sort and clear duplicates",
+    (GTestFunc) test_sort_and_clear_duplicates);
 
   return g_test_run ();
 }
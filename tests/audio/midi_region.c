@@ -5,6 +5,7 @@
 #include "zrythm-test-config.h"
 
 #include "actions/tracklist_selections.h"
+#include "audio/midi_file.h"
 #include "audio/midi_region.h"
 #include "audio/region.h"
 #include "audio/transport.h"
@@ -216,6 +217,126 @@ test_full_export (void)
   g_free (base_midi_file);
 }
 
+/**
+ * Checks that tracks read in parallel match the
+ * per-track queries.
+ */
+static void
+test_read_tracks (void)
+{
+  const int max_files = 20;
+
+  char ** midi_files = io_get_files_in_dir_ending_in (
+    MIDILIB_TEST_MIDI_FILES_PATH, F_RECURSIVE, ".MID", false);
+  g_assert_nonnull (midi_files);
+  char * midi_file;
+  int    iter = 0;
+  while ((midi_file = midi_files[iter++]))
+    {
+      int             num_tracks = 0;
+      MidiFileTrack * tracks = midi_file_read_tracks (
+        midi_file, 960.0, &num_tracks);
+      g_assert_nonnull (tracks);
+      g_assert_cmpint (
+        num_tracks, ==,
+        midi_file_get_num_tracks (midi_file, false));
+
+      int num_with_data = 0;
+      for (int i = 0; i < num_tracks; i++)
+        {
+          MidiFileTrack * mf_track = &tracks[i];
+          g_assert_true (
+            mf_track->has_data
+            == midi_file_track_has_data (midi_file, i));
+          if (mf_track->has_data)
+            num_with_data++;
+
+          for (size_t j = 0; j < mf_track->num_notes; j++)
+            {
+              MidiFileNote * note = &mf_track->notes[j];
+              g_assert_cmpfloat (
+                note->end_ticks, >=, note->start_ticks);
+              if (j > 0)
+                {
+                  g_assert_cmpfloat (
+                    note->start_ticks, >=,
+                    mf_track->notes[j - 1].start_ticks);
+                }
+            }
+        }
+      g_assert_cmpint (
+        num_with_data, ==,
+        midi_file_get_num_tracks (midi_file, true));
+      g_assert_cmpint (
+        num_with_data, ==,
+        midi_file_tracks_get_num_with_data (
+          tracks, num_tracks));
+      if (num_with_data > 0)
+        {
+          g_assert_true (
+            midi_file_tracks_get_nth_with_data (
+              tracks, num_tracks, num_with_data - 1)
+            ->has_data);
+        }
+      g_assert_null (midi_file_tracks_get_nth_with_data (
+        tracks, num_tracks, num_with_data));
+
+      midi_file_tracks_free (tracks, num_tracks);
+
+      if (iter == max_files)
+        break;
+    }
+  g_strfreev (midi_files);
+}
+
+/**
+ * Tests that a track without an end of track event
+ * still creates a region covering all its notes.
+ */
+static void
+test_new_from_track_without_end (void)
+{
+  test_helper_zrythm_init ();
+
+  MidiFileNote notes[] = {
+    { .start_ticks = 0.0,
+     .end_ticks = 480.0,
+     .pitch = 60,
+     .velocity = 90 },
+    { .start_ticks = 960.0,
+     .end_ticks = 1920.0,
+     .pitch = 64,
+     .velocity = 90 },
+  };
+  MidiFileTrack mf_track = {
+    .notes = notes,
+    .num_notes = G_N_ELEMENTS (notes),
+    .notes_size = G_N_ELEMENTS (notes),
+    .end_ticks = 0.0,
+    .has_data = true,
+  };
+
+  Position start_pos;
+  position_set_to_bar (&start_pos, 2);
+  ZRegion * r = midi_region_new_from_midi_file_track (
+    &start_pos, &mf_track, 0, 0, 0);
+  g_assert_nonnull (r);
+  g_assert_cmpint (r->num_midi_notes, ==, 2);
+  ArrangerObject * r_obj = (ArrangerObject *) r;
+  g_assert_cmpfloat_with_epsilon (
+    r_obj->end_pos.ticks, start_pos.ticks + 1920.0,
+    0.0001);
+  arranger_object_free (r_obj);
+
+  /* a track without notes is empty */
+  mf_track.num_notes = 0;
+  mf_track.end_ticks = 1920.0;
+  g_assert_null (midi_region_new_from_midi_file_track (
+    &start_pos, &mf_track, 0, 0, 0));
+
+  test_helper_zrythm_cleanup ();
+}
+
 int
 main (int argc, char * argv[])
 {
@@ -228,6 +349,12 @@ main (int argc, char * argv[])
     (GTestFunc) test_full_export);
   g_test_add_func (
     TEST_PREFIX "test export", (GTestFunc) test_export);
+  g_test_add_func (
+    TEST_PREFIX "test read tracks",
+    (GTestFunc) test_read_tracks);
+  g_test_add_func (
+    TEST_PREFIX "test new from track without end",
+    (GTestFunc) test_new_from_track_without_end);
 
   return g_test_run ();
 }
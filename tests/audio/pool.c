@@ -3,13 +3,18 @@
 
 #include "zrythm-test-config.h"
 
+#include "audio/clip.h"
+#include "audio/clip_cache.h"
+#include "audio/pool.h"
 #include "audio/tempo_track.h"
 #include "audio/track.h"
 #include "project.h"
 #include "utils/flags.h"
+#include "utils/hash.h"
 #include "zrythm.h"
 
 #include <glib.h>
+#include <glib/gstdio.h>
 
 #include "helpers/plugin_manager.h"
 #include "helpers/project.h"
@@ -158,6 +163,170 @@ test_remove_unused (void)
     }
 }
 
+static void
+test_import_async (void)
+{
+  test_helper_zrythm_init ();
+
+  char * filepath = g_build_filename (
+    TESTS_SRCDIR, "test_start_with_signal.mp3", NULL);
+  AudioClip * sync_clip = audio_clip_new_from_file (filepath);
+
+  GError *    err = NULL;
+  AudioClip * clip =
+    audio_clip_new_placeholder_from_file (filepath, &err);
+  g_assert_no_error (err);
+  g_assert_nonnull (clip);
+  g_assert_cmpuint (clip->channels, ==, sync_clip->channels);
+
+  audio_pool_add_clip (AUDIO_POOL, clip);
+  audio_clip_import_async (clip, filepath);
+  g_assert_nonnull (clip->import_job);
+  audio_clip_wait_for_import (clip);
+  g_assert_null (clip->import_job);
+
+  /* the clip may only be longer than the decoded
+   * file (padded to the estimated length) */
+  g_assert_cmpuint (
+    clip->num_frames, >=, sync_clip->num_frames);
+  for (size_t i = 0;
+       i < sync_clip->num_frames * sync_clip->channels; i++)
+    {
+      g_assert_cmpfloat_with_epsilon (
+        clip->frames[i], sync_clip->frames[i], 0.0001f);
+    }
+
+  /* check that the clip was written to the pool */
+  char * pool_path =
+    audio_clip_get_path_in_pool (clip, F_NOT_BACKUP);
+  g_assert_true (g_file_test (pool_path, G_FILE_TEST_EXISTS));
+  char * hash =
+    hash_get_from_file (pool_path, HASH_ALGORITHM_XXH3_64);
+  g_assert_cmpstr (hash, ==, clip->file_hash);
+  g_free (hash);
+  g_free (pool_path);
+
+  /* check that the peaks match the frames */
+  signed_frame_t start = 17;
+  signed_frame_t end = (signed_frame_t) clip->num_frames - 3;
+  float          min, max;
+  audio_clip_get_min_max (clip, start, end, &min, &max);
+  float expected_min = 0.f, expected_max = 0.f;
+  for (signed_frame_t i = start; i < end; i++)
+    {
+      for (channels_t j = 0; j < clip->channels; j++)
+        {
+          float val = clip->ch_frames[j][i];
+          expected_min = MIN (expected_min, val);
+          expected_max = MAX (expected_max, val);
+        }
+    }
+  g_assert_cmpfloat_with_epsilon (min, expected_min, 0.0001f);
+  g_assert_cmpfloat_with_epsilon (max, expected_max, 0.0001f);
+
+  /* let the job get free'd */
+  while (g_main_context_iteration (NULL, false))
+    ;
+
+  audio_clip_free (sync_clip);
+  g_free (filepath);
+
+  test_helper_zrythm_cleanup ();
+}
+
+static void
+test_duplicate_shares_file (void)
+{
+  test_helper_zrythm_init ();
+
+  char * filepath = g_build_filename (
+    TESTS_SRCDIR, "test_start_with_signal.mp3", NULL);
+  SupportedFile * file =
+    supported_file_new_from_path (filepath);
+  track_create_with_action (
+    TRACK_TYPE_AUDIO, NULL, file, PLAYHEAD,
+    TRACKLIST->num_tracks, 1, NULL);
+
+  AudioClip * clip = AUDIO_POOL->clips[0];
+  g_assert_true (audio_clip_pool_file_is_in_sync (clip, 0));
+
+  int new_id = audio_pool_duplicate_clip (
+    AUDIO_POOL, clip->pool_id, F_WRITE_FILE);
+  AudioClip * new_clip =
+    audio_pool_get_clip (AUDIO_POOL, new_id);
+  g_assert_cmpuint (
+    audio_clip_get_content_hash (new_clip), ==,
+    audio_clip_get_content_hash (clip));
+  g_assert_true (
+    audio_clip_pool_file_is_in_sync (new_clip, 0));
+  g_assert_cmpstr (new_clip->file_hash, ==, clip->file_hash);
+
+  /* check that the data on disk is shared */
+  char * path =
+    audio_clip_get_path_in_pool (clip, F_NOT_BACKUP);
+  char * new_path =
+    audio_clip_get_path_in_pool (new_clip, F_NOT_BACKUP);
+  g_assert_cmpstr (path, !=, new_path);
+#ifdef __linux__
+  GStatBuf st;
+  g_assert_cmpint (g_stat (new_path, &st), ==, 0);
+  g_assert_cmpuint (st.st_nlink, ==, 2);
+#endif
+
+  /* check that removing one of the files keeps the
+   * other intact */
+  audio_pool_remove_clip (
+    AUDIO_POOL, new_id, F_FREE, F_NOT_BACKUP);
+  g_assert_false (g_file_test (new_path, G_FILE_TEST_EXISTS));
+  g_assert_true (audio_clip_pool_file_is_in_sync (clip, 0));
+
+  g_free (path);
+  g_free (new_path);
+  g_free (filepath);
+
+  test_helper_zrythm_cleanup ();
+}
+
+static void
+test_load_from_cache (void)
+{
+  test_helper_zrythm_init ();
+
+  char * filepath = g_build_filename (
+    TESTS_SRCDIR, "test_start_with_signal.mp3", NULL);
+  SupportedFile * file =
+    supported_file_new_from_path (filepath);
+  track_create_with_action (
+    TRACK_TYPE_AUDIO, NULL, file, PLAYHEAD,
+    TRACKLIST->num_tracks, 1, NULL);
+
+  /* first load decodes the file and fills in the
+   * cache */
+  test_project_save_and_reload ();
+  AudioClip * clip = AUDIO_POOL->clips[0];
+  char *      cache_path =
+    clip_cache_get_path (clip, AUDIO_ENGINE->sample_rate);
+  g_assert_nonnull (cache_path);
+  g_assert_true (
+    g_file_test (cache_path, G_FILE_TEST_EXISTS));
+  unsigned_frame_t num_frames = clip->num_frames;
+  uint64_t         content_hash =
+    audio_clip_get_content_hash (clip);
+
+  /* second load uses the cache */
+  test_project_save_and_reload ();
+  clip = AUDIO_POOL->clips[0];
+  g_assert_cmpuint (clip->num_frames, ==, num_frames);
+  g_assert_cmpuint (
+    audio_clip_get_content_hash (clip), ==, content_hash);
+  g_assert_true (audio_clip_pool_file_is_in_sync (clip, 0));
+
+  g_free (cache_path);
+  g_free (filepath);
+
+  test_helper_zrythm_cleanup ();
+}
+
 int
 main (int argc, char * argv[])
 {
@@ -168,6 +337,15 @@ main (int argc, char * argv[])
   g_test_add_func (
     TEST_PREFIX "test remove unused",
     (GTestFunc) test_remove_unused);
+  g_test_add_func (
+    TEST_PREFIX "test import async",
+    (GTestFunc) test_import_async);
+  g_test_add_func (
+    TEST_PREFIX "test duplicate shares file",
+    (GTestFunc) test_duplicate_shares_file);
+  g_test_add_func (
+    TEST_PREFIX "test load from cache",
+    (GTestFunc) test_load_from_cache);
 
   return g_test_run ();
 }
@@ -4,10 +4,16 @@
 #include "zrythm-test-config.h"
 
 #include "actions/tracklist_selections.h"
+#include "audio/control_port.h"
+#include "audio/fader.h"
+#include "audio/master_track.h"
 #include "audio/midi_region.h"
+#include "audio/port_connection.h"
 #include "audio/region.h"
+#include "audio/router.h"
 #include "audio/transport.h"
 #include "project.h"
+#include "utils/dsp.h"
 #include "utils/flags.h"
 #include "utils/io.h"
 #include "zrythm.h"
@@ -184,6 +190,120 @@ test_get_hash (void)
   test_helper_zrythm_cleanup ();
 }
 
+static void
+test_queue_control_value (void)
+{
+  test_helper_zrythm_init ();
+
+  Port * port = P_MASTER_TRACK->channel->fader->amp;
+  float  orig_val = port->control;
+  g_assert_true (engine_get_run (AUDIO_ENGINE));
+
+  /* block cycles so that all values are queued
+   * before the next one */
+  zix_sem_wait (&ROUTER->graph_access);
+  router_queue_control_value (
+    ROUTER, port, 0.5f, F_NO_PUBLISH_EVENTS);
+  router_queue_control_value (
+    ROUTER, port, 0.25f, F_NO_PUBLISH_EVENTS);
+  router_queue_control_value (
+    ROUTER, port, 1.5f, F_NO_PUBLISH_EVENTS);
+
+  /* queued once, not applied yet */
+  g_assert_true (g_atomic_int_get (&port->control_queued));
+  g_assert_cmpfloat_with_epsilon (
+    port->control, orig_val, 0.0001f);
+  g_assert_cmpfloat_with_epsilon (
+    control_port_get_queued_val (port), 1.5f, 0.0001f);
+  zix_sem_post (&ROUTER->graph_access);
+
+  /* last value wins */
+  engine_wait_n_cycles (AUDIO_ENGINE, 3);
+  g_assert_false (g_atomic_int_get (&port->control_queued));
+  g_assert_cmpfloat_with_epsilon (
+    port->control, 1.5f, 0.0001f);
+
+  test_helper_zrythm_cleanup ();
+}
+
+static void
+test_buffer_aliasing (void)
+{
+  test_helper_zrythm_init ();
+
+  char * filepath =
+    g_build_filename (TESTS_SRCDIR, "test.wav", NULL);
+  SupportedFile * file =
+    supported_file_new_from_path (filepath);
+  Position start;
+  position_init (&start);
+  Track * track = track_create_with_action (
+    TRACK_TYPE_AUDIO, NULL, file, &start,
+    TRACKLIST->num_tracks, 1, NULL);
+  supported_file_free (file);
+  g_free (filepath);
+
+  test_project_stop_dummy_engine ();
+
+  /* the fader input only has the pre-fader output
+   * as a unity source, so it uses its buffer */
+  Port * src = track->channel->prefader->stereo_out->l;
+  Port * dest = track->channel->fader->stereo_in->l;
+  g_assert_cmpint (dest->num_srcs, ==, 1);
+  g_assert_true (dest->srcs[0] == src);
+  float * own_buf = dest->buf;
+  transport_request_roll (TRANSPORT, true);
+  engine_process (AUDIO_ENGINE, AUDIO_ENGINE->block_length);
+  g_assert_true (dest->buf == src->buf);
+  g_assert_true (dest->own_buf == own_buf);
+
+  /* a non-unity connection is mixed into the own
+   * buffer */
+  PortConnection * conn =
+    (PortConnection *) dest->src_connections[0];
+  port_connection_update (
+    conn, 0.5f, conn->locked, conn->enabled);
+  engine_process (AUDIO_ENGINE, AUDIO_ENGINE->block_length);
+  g_assert_true (dest->buf == own_buf);
+  g_assert_null (dest->own_buf);
+  for (nframes_t i = 0; i < AUDIO_ENGINE->block_length; i++)
+    {
+      g_assert_cmpfloat_with_epsilon (
+        dest->buf[i], src->buf[i] * 0.5f, 0.00001f);
+    }
+
+  /* once the own buffer is used in a cycle, it is
+   * kept for the rest of the cycle */
+  nframes_t block_length = AUDIO_ENGINE->block_length;
+  nframes_t half = block_length / 2;
+  dsp_fill (src->buf, 1.f, block_length);
+  src->silent = false;
+  port_clear_audio_cv_buffer (dest);
+  EngineProcessTimeInfo time_nfo = {
+    .g_start_frame = 0,
+    .local_offset = 0,
+    .nframes = half,
+  };
+  port_process (dest, time_nfo, false);
+  port_connection_update (
+    conn, 1.f, conn->locked, conn->enabled);
+  time_nfo.g_start_frame = half;
+  time_nfo.local_offset = half;
+  time_nfo.nframes = block_length - half;
+  port_process (dest, time_nfo, false);
+  g_assert_true (dest->buf == own_buf);
+  g_assert_cmpfloat_with_epsilon (
+    dest->buf[0], 0.5f, 0.00001f);
+  g_assert_cmpfloat_with_epsilon (
+    dest->buf[half], 1.f, 0.00001f);
+
+  /* and it aliases again in the next cycle */
+  engine_process (AUDIO_ENGINE, block_length);
+  g_assert_true (dest->buf == src->buf);
+
+  test_helper_zrythm_cleanup ();
+}
+
 int
 main (int argc, char * argv[])
 {
@@ -193,6 +313,12 @@ main (int argc, char * argv[])
 
   g_test_add_func (
     TEST_PREFIX "test get hash", (GTestFunc) test_get_hash);
+  g_test_add_func (
+    TEST_PREFIX "test queue control value",
+    (GTestFunc) test_queue_control_value);
+  g_test_add_func (
+    TEST_PREFIX "test buffer aliasing",
+    (GTestFunc) test_buffer_aliasing);
 #if 0
   g_test_add_func (
     TEST_PREFIX "test port disconnect",
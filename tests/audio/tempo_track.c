@@ -3,6 +3,12 @@
 
 #include "zrythm-test-config.h"
 
+#include <math.h>
+
+#include "audio/automation_region.h"
+#include "audio/control_port.h"
+#include "audio/midi_region.h"
+#include "audio/tempo_map.h"
 #include "audio/transport.h"
 #include "project.h"
 #include "utils/flags.h"
@@ -37,6 +43,152 @@ test_load_project_bpm (void)
   test_helper_zrythm_cleanup ();
 }
 
+static AutomationPoint *
+add_bpm_point (ZRegion * r, int bar, float bpm)
+{
+  Port *   port = P_TEMPO_TRACK->bpm_port;
+  Position pos;
+  position_set_to_bar (&pos, bar);
+  AutomationPoint * ap = automation_point_new_float (
+    bpm, control_port_real_val_to_normalized (port, bpm),
+    &pos);
+  automation_region_add_ap (r, ap, F_NO_PUBLISH_EVENTS);
+  return ap;
+}
+
+static void
+test_tempo_map (void)
+{
+  test_helper_zrythm_init ();
+
+  TempoMap * map = AUDIO_ENGINE->tempo_map;
+  g_assert_nonnull (map);
+  g_assert_false (map->has_automation);
+  g_assert_cmpint (map->num_segments, ==, 1);
+
+  /* a constant map must match frames per tick */
+  double ticks = 12345.6;
+  g_assert_cmpfloat_with_epsilon (
+    tempo_map_ticks_to_frames (map, ticks),
+    ticks * AUDIO_ENGINE->frames_per_tick, 0.00001);
+
+  /* a MIDI region created before the tempo change */
+  Track * midi_track =
+    track_create_empty_with_action (TRACK_TYPE_MIDI, NULL);
+  Position start_pos, end_pos;
+  position_set_to_bar (&start_pos, 7);
+  position_set_to_bar (&end_pos, 8);
+  ZRegion * midi_r = midi_region_new (
+    &start_pos, &end_pos, midi_track->name_hash, 0, 0);
+  track_add_region (
+    midi_track, midi_r, NULL, 0, F_GEN_NAME,
+    F_NO_PUBLISH_EVENTS);
+  ArrangerObject * midi_r_obj = (ArrangerObject *) midi_r;
+  g_assert_cmpuint (
+    midi_r_obj->frames_tempo_map_version, ==, map->version);
+
+  /* ramp from 120 BPM at bar 1 to 240 BPM at bar 5 */
+  AutomationTracklist * atl =
+    track_get_automation_tracklist (P_TEMPO_TRACK);
+  AutomationTrack * at =
+    automation_tracklist_get_at_from_port (
+      atl, P_TEMPO_TRACK->bpm_port);
+  g_assert_nonnull (at);
+  position_set_to_bar (&start_pos, 1);
+  position_set_to_bar (&end_pos, 9);
+  ZRegion * r = automation_region_new (
+    &start_pos, &end_pos, track_get_name_hash (P_TEMPO_TRACK),
+    at->index, at->num_regions);
+  track_add_region (
+    P_TEMPO_TRACK, r, at, -1, F_GEN_NAME,
+    F_NO_PUBLISH_EVENTS);
+  add_bpm_point (r, 1, 120.f);
+  add_bpm_point (r, 5, 240.f);
+
+  /* the map is replaced, not modified in place */
+  guint version = map->version;
+  engine_update_tempo_map (AUDIO_ENGINE);
+  g_assert_true (AUDIO_ENGINE->tempo_map != map);
+  map = AUDIO_ENGINE->tempo_map;
+  g_assert_true (map->has_automation);
+  g_assert_cmpint (map->num_segments, ==, 2);
+  g_assert_cmpuint (map->version, ==, version + 1);
+
+  double bar_ticks = TRANSPORT->ticks_per_bar;
+  g_assert_cmpfloat_with_epsilon (
+    tempo_map_get_bpm_at_ticks (map, 0.0), 120.0, 0.0001);
+  g_assert_cmpfloat_with_epsilon (
+    tempo_map_get_bpm_at_ticks (map, bar_ticks * 2), 180.0,
+    0.0001);
+  g_assert_cmpfloat_with_epsilon (
+    tempo_map_get_bpm_at_ticks (map, bar_ticks * 6), 240.0,
+    0.0001);
+
+  /* frames of a linear ramp that doubles the
+   * tempo */
+  double fpt_120 =
+    ((double) AUDIO_ENGINE->sample_rate * 60.0
+     * (double) tempo_track_get_beats_per_bar (
+       P_TEMPO_TRACK))
+    / (120.0 * bar_ticks);
+  double ramp_frames = fpt_120 * bar_ticks * 4 * log (2.0);
+  g_assert_cmpfloat_with_epsilon (
+    tempo_map_ticks_to_frames (map, bar_ticks * 4),
+    ramp_frames, 0.001);
+  g_assert_cmpfloat_with_epsilon (
+    tempo_map_ticks_to_frames (map, bar_ticks * 5),
+    ramp_frames + fpt_120 / 2.0 * bar_ticks, 0.001);
+
+  /* round trip */
+  for (int i = 0; i < 20; i++)
+    {
+      ticks = bar_ticks * 0.37 * i;
+      double frames = tempo_map_ticks_to_frames (map, ticks);
+      g_assert_cmpfloat_with_epsilon (
+        tempo_map_frames_to_ticks (map, frames), ticks,
+        0.0001);
+    }
+
+  /* global positions follow the map */
+  Position pos;
+  position_set_to_bar (&pos, 7);
+  g_assert_cmpint (
+    pos.frames, ==,
+    math_round_double_to_signed_frame_t (
+      tempo_map_ticks_to_frames (map, pos.ticks)));
+
+  /* arranger object frames are refreshed when read */
+  g_assert_cmpuint (
+    midi_r_obj->frames_tempo_map_version, <, map->version);
+  region_is_hit (midi_r, midi_r_obj->pos.frames, false);
+  g_assert_cmpuint (
+    midi_r_obj->frames_tempo_map_version, ==, map->version);
+  g_assert_cmpint (
+    midi_r_obj->pos.frames, ==,
+    math_round_double_to_signed_frame_t (
+      tempo_map_ticks_to_frames (
+        map, midi_r_obj->pos.ticks)));
+  g_assert_cmpint (
+    midi_r_obj->end_pos.frames, ==,
+    math_round_double_to_signed_frame_t (
+      tempo_map_ticks_to_frames (
+        map, midi_r_obj->end_pos.ticks)));
+
+  Position bpm_pos;
+  position_from_ticks (&bpm_pos, bar_ticks * 2);
+  g_assert_cmpfloat_with_epsilon (
+    tempo_track_get_bpm_at_pos (P_TEMPO_TRACK, &bpm_pos),
+    180.f, 0.001f);
+
+  /* unchanged automation doesn't bump the version */
+  version = map->version;
+  engine_update_tempo_map (AUDIO_ENGINE);
+  g_assert_true (AUDIO_ENGINE->tempo_map == map);
+  g_assert_cmpuint (map->version, ==, version);
+
+  test_helper_zrythm_cleanup ();
+}
+
 int
 main (int argc, char * argv[])
 {
@@ -47,6 +199,8 @@ main (int argc, char * argv[])
   g_test_add_func (
     TEST_PREFIX "test load project bpm",
     (GTestFunc) test_load_project_bpm);
+  g_test_add_func (
+    TEST_PREFIX "test tempo map", (GTestFunc) test_tempo_map);
 
   return g_test_run ();
 }
@@ -5,7 +5,10 @@
 
 #include <math.h>
 
+#include "audio/automation_track.h"
+#include "audio/automation_tracklist.h"
 #include "audio/master_track.h"
+#include "audio/midi_event.h"
 #include "audio/track_processor.h"
 #include "project.h"
 #include "utils/flags.h"
@@ -64,6 +67,129 @@ test_process_master (void)
   test_helper_zrythm_cleanup ();
 }
 
+/**
+ * Checks that MIDI control ports are only created
+ * on first use and that only changed controls are
+ * sent.
+ */
+static void
+test_midi_controls (void)
+{
+  test_helper_zrythm_init ();
+
+  AUDIO_ENGINE->stop_dummy_audio_thread = true;
+  g_usleep (1000000);
+
+  Track * track =
+    track_create_empty_with_action (TRACK_TYPE_MIDI, NULL);
+  TrackProcessor * tp = track->processor;
+  for (int i = 0; i < 128 * 16; i++)
+    {
+      g_assert_null (tp->midi_cc[i]);
+    }
+  for (int i = 0; i < 16; i++)
+    {
+      g_assert_null (tp->pitch_bend[i]);
+    }
+
+  /* find the automation track of ch2 CC 7 */
+  AutomationTracklist * atl =
+    track_get_automation_tracklist (track);
+  AutomationTrack * at = NULL;
+  for (int i = 0; i < atl->num_ats; i++)
+    {
+      PortIdentifier * id = &atl->ats[i]->port_id;
+      if (
+        id->flags & PORT_FLAG_MIDI_AUTOMATABLE
+        && id->flags2 == 0 && id->port_index == 128 + 7)
+        {
+          at = atl->ats[i];
+          break;
+        }
+    }
+  g_assert_nonnull (at);
+  g_assert_null (automation_track_get_port (at, false));
+  g_assert_true (automation_track_validate (at));
+
+  Port * port = automation_track_get_port (at, true);
+  g_assert_nonnull (port);
+  g_assert_true (tp->midi_cc[128 + 7] == port);
+  g_assert_true (port->at == at);
+  g_assert_true (
+    port_find_from_identifier (&at->port_id) == port);
+
+  EngineProcessTimeInfo time_nfo = {
+    .g_start_frame = 0,
+    .local_offset = 0,
+    .nframes = AUDIO_ENGINE->block_length,
+  };
+  MidiEvents * events = tp->midi_out->midi_events;
+
+  /* change the value and check that it is sent
+   * once */
+  port_set_control_value (
+    port, 1.f, F_NORMALIZED, F_NO_PUBLISH_EVENTS);
+  midi_events_clear (events, false);
+  track_processor_process (tp, &time_nfo);
+  g_assert_cmpint (events->num_events, ==, 1);
+  g_assert_cmpuint (
+    events->events[0].raw_buffer[0], ==,
+    MIDI_CH1_CTRL_CHANGE | 1);
+  g_assert_cmpuint (events->events[0].raw_buffer[1], ==, 7);
+  g_assert_cmpuint (events->events[0].raw_buffer[2], ==, 127);
+
+  midi_events_clear (events, false);
+  track_processor_process (tp, &time_nfo);
+  g_assert_cmpint (events->num_events, ==, 0);
+
+  test_helper_zrythm_cleanup ();
+}
+
+/**
+ * Checks that MIDI control ports that are not
+ * automated are not kept when loading a project.
+ */
+static void
+test_prune_midi_controls_on_load (void)
+{
+  test_helper_zrythm_init ();
+
+  Track * track =
+    track_create_empty_with_action (TRACK_TYPE_MIDI, NULL);
+  int              track_pos = track->pos;
+  TrackProcessor * tp = track->processor;
+
+  /* create ch1 CC 1 without automating it */
+  PortIdentifier id;
+  track_processor_init_midi_control_port_id (tp, &id, 1);
+  g_assert_nonnull (
+    track_processor_get_midi_control_port (tp, &id, true));
+  port_identifier_free_members (&id);
+
+  /* create ch1 CC 7 and show its automation
+   * track */
+  track_processor_init_midi_control_port_id (tp, &id, 7);
+  Port * port =
+    track_processor_get_midi_control_port (tp, &id, true);
+  port_identifier_free_members (&id);
+  g_assert_nonnull (port);
+  AutomationTracklist * atl =
+    track_get_automation_tracklist (track);
+  AutomationTrack * at =
+    automation_tracklist_get_at_from_port (atl, port);
+  g_assert_nonnull (at);
+  at->created = true;
+
+  test_project_save_and_reload ();
+
+  track = TRACKLIST->tracks[track_pos];
+  tp = track->processor;
+  g_assert_null (tp->midi_cc[1]);
+  g_assert_nonnull (tp->midi_cc[7]);
+
+  test_helper_zrythm_cleanup ();
+}
+
 int
 main (int argc, char * argv[])
 {
@@ -76,6 +202,12 @@ main (int argc, char * argv[])
   g_test_add_func (
     TEST_PREFIX "test process master",
     (GTestFunc) test_process_master);
+  g_test_add_func (
+    TEST_PREFIX "test midi controls",
+    (GTestFunc) test_midi_controls);
+  g_test_add_func (
+    TEST_PREFIX "test prune midi controls on load",
+    (GTestFunc) test_prune_midi_controls_on_load);
 
   return g_test_run ();
 }
@@ -37,26 +37,42 @@
 #define NUM_ITERATIONS_ENGINE 1000
 #define NUM_ITERATIONS_MANY 30000
 
-#define F_OPTIMIZED 1
-#define F_NOT_OPTIMIZED 0
-
 #define F_LARGE_BUF 1
 #define F_NOT_LARGE_BUF 0
 
 #define NUM_TRACKS 100
 
+/**
+ * DSP paths benchmarked side by side.
+ */
+typedef enum DspBenchmarkPath
+{
+  DSP_BENCHMARK_PATH_SCALAR,
+  DSP_BENCHMARK_PATH_SIMD,
+  DSP_BENCHMARK_PATH_LSP,
+  NUM_DSP_BENCHMARK_PATHS,
+} DspBenchmarkPath;
+
+static const char * path_names[] = {
+  "scalar",
+  "in-tree SIMD",
+  "lsp-dsp-lib",
+};
+
 typedef struct DspBenchmark
 {
   /* function called */
   const char * func_name;
-  /* microseconds taken */
-  long unoptimized_usec;
-  long optimized_usec;
+  /* microseconds taken per path (-1 if not run) */
+  long usec[NUM_DSP_BENCHMARK_PATHS];
 } DspBenchmark;
 
 static DspBenchmark benchmarks[400];
 static int          num_benchmarks = 0;
 
+/** In-tree SIMD backend picked for this machine. */
+static DspBackend simd_backend = DSP_BACKEND_SCALAR;
+
 static DspBenchmark *
 benchmark_find (const char * func_name)
 {
@@ -71,34 +87,44 @@ benchmark_find (const char * func_name)
   return NULL;
 }
 
-static void
-_test_dsp_fill (bool optimized, bool large_buff)
+/**
+ * Initializes Zrythm and selects the DSP backend for
+ * the given path.
+ *
+ * @return Whether the path is available.
+ */
+static bool
+init_for_path (DspBenchmarkPath path)
 {
-  if (optimized)
-    {
-      test_helper_zrythm_init_optimized ();
-    }
-  else
+  switch (path)
     {
+    case DSP_BENCHMARK_PATH_SCALAR:
       test_helper_zrythm_init ();
+      return dsp_set_backend (DSP_BACKEND_SCALAR);
+    case DSP_BENCHMARK_PATH_SIMD:
+      if (simd_backend == DSP_BACKEND_SCALAR)
+        return false;
+      test_helper_zrythm_init ();
+      return dsp_set_backend (simd_backend);
+    case DSP_BENCHMARK_PATH_LSP:
+#ifdef HAVE_LSP_DSP
+      test_helper_zrythm_init_optimized ();
+      return dsp_set_backend (DSP_BACKEND_LSP);
+#else
+      return false;
+#endif
+    default:
+      break;
     }
-
-  gint64  start, end;
-  float * buf = object_new_n (LARGE_BUFFER_SIZE, float);
-  float * src = object_new_n (LARGE_BUFFER_SIZE, float);
-  float   val = 0.3f;
-
-  size_t buf_size =
-    large_buff ? LARGE_BUFFER_SIZE : BUFFER_SIZE;
-
-  DspBenchmark * benchmark;
+  g_return_val_if_reached (false);
+}
 
 #define LOOP_START \
   start = g_get_monotonic_time (); \
   for (int i = 0; i < NUM_ITERATIONS_MANY; i++) \
     {
 
-#define LOOP_END(fname, is_optimized) \
+#define LOOP_END(fname, bench_path) \
   } \
   end = g_get_monotonic_time (); \
   benchmark = benchmark_find (fname); \
@@ -106,57 +132,80 @@ _test_dsp_fill (bool optimized, bool large_buff)
     { \
       benchmark = &benchmarks[num_benchmarks]; \
       num_benchmarks++; \
+      for (int j = 0; j < NUM_DSP_BENCHMARK_PATHS; j++) \
+        benchmark->usec[j] = -1; \
     } \
   benchmark->func_name = fname; \
-  if (is_optimized) \
-    { \
-      benchmark->optimized_usec = end - start; \
-    } \
-  else \
-    { \
-      benchmark->unoptimized_usec = end - start; \
+  benchmark->usec[bench_path] = end - start;
+
+static void
+_test_dsp_fill (DspBenchmarkPath path, bool large_buff)
+{
+  if (!init_for_path (path))
+    {
+      return;
     }
 
+  gint64  start, end;
+  float * buf = object_new_n (LARGE_BUFFER_SIZE, float);
+  float * src = object_new_n (LARGE_BUFFER_SIZE, float);
+  float   val = 0.3f;
+
+  size_t buf_size =
+    large_buff ? LARGE_BUFFER_SIZE : BUFFER_SIZE;
+
+  DspBenchmark * benchmark;
+
   LOOP_START
   dsp_fill (buf, val, buf_size);
-  LOOP_END ("fill", optimized);
+  LOOP_END ("fill", path);
 
   LOOP_START
   dsp_limit1 (buf, -1.0f, 1.1f, buf_size);
-  LOOP_END ("limit1", optimized);
+  LOOP_END ("limit1", path);
 
   LOOP_START
   dsp_add2 (buf, src, buf_size);
-  LOOP_END ("add2", optimized);
+  LOOP_END ("add2", path);
 
   LOOP_START
   float abs_max = dsp_abs_max (buf, buf_size);
   (void) abs_max;
-  LOOP_END ("abs_max", optimized);
+  LOOP_END ("abs_max", path);
 
   LOOP_START
   dsp_min (buf, buf_size);
-  LOOP_END ("min", optimized);
+  LOOP_END ("min", path);
 
   LOOP_START
   dsp_max (buf, buf_size);
-  LOOP_END ("max", optimized);
+  LOOP_END ("max", path);
 
   LOOP_START
   dsp_mul_k2 (buf, 0.99f, buf_size);
-  LOOP_END ("mul_k2", optimized);
+  LOOP_END ("mul_k2", path);
 
   LOOP_START
   dsp_copy (buf, src, buf_size);
-  LOOP_END ("copy", optimized);
+  LOOP_END ("copy", path);
 
   LOOP_START
   dsp_mix2 (buf, src, 0.1f, 0.2f, buf_size);
-  LOOP_END ("mix2", optimized);
+  LOOP_END ("mix2", path);
 
   LOOP_START
   dsp_mix_add2 (buf, src, src, 0.1f, 0.2f, buf_size);
-  LOOP_END ("mix_add2", optimized);
+  LOOP_END ("mix_add2", path);
+
+  LOOP_START
+  dsp_linear_fade_in_from (
+    buf, 0, (int32_t) buf_size, buf_size, 0.f);
+  LOOP_END ("linear_fade_in_from", path);
+
+  LOOP_START
+  dsp_linear_fade_out_to (
+    buf, 0, (int32_t) buf_size, buf_size, 0.f);
+  LOOP_END ("linear_fade_out_to", path);
 
   free (buf);
   free (src);
@@ -167,22 +216,18 @@ _test_dsp_fill (bool optimized, bool large_buff)
 static void
 test_dsp_fill (void)
 {
-  _test_dsp_fill (F_NOT_OPTIMIZED, F_LARGE_BUF);
-#ifdef HAVE_LSP_DSP
-  _test_dsp_fill (F_OPTIMIZED, F_LARGE_BUF);
-#endif
+  for (int i = 0; i < NUM_DSP_BENCHMARK_PATHS; i++)
+    {
+      _test_dsp_fill ((DspBenchmarkPath) i, F_LARGE_BUF);
+    }
 }
 
 static void
-_test_run_engine (bool optimized)
+_test_run_engine (DspBenchmarkPath path)
 {
-  if (optimized)
-    {
-      test_helper_zrythm_init_optimized ();
-    }
-  else
+  if (!init_for_path (path))
     {
-      test_helper_zrythm_init ();
+      return;
     }
 
   AUDIO_ENGINE->stop_dummy_audio_thread = true;
@@ -190,13 +235,13 @@ _test_run_engine (bool optimized)
 
 #ifdef HAVE_LSP_DSP
   lsp_dsp_context_t ctx;
-  if (optimized)
+  if (path == DSP_BENCHMARK_PATH_LSP)
     {
       lsp_dsp_start (&ctx);
     }
 #endif
 
-    /* create a few tracks with plugins */
+  /* create a few tracks with plugins */
 #ifdef HAVE_LSP_COMPRESSOR
   test_plugin_manager_create_tracks_from_plugin (
     LSP_COMPRESSOR_BUNDLE, LSP_COMPRESSOR_URI, false, false,
@@ -209,67 +254,91 @@ _test_run_engine (bool optimized)
   start = g_get_monotonic_time ();
   for (int i = 0; i < NUM_ITERATIONS_ENGINE; i++)
     {
-      engine_process (
-        AUDIO_ENGINE, AUDIO_ENGINE->block_length);
-      LOOP_END ("engine cycles", optimized);
+      engine_process (AUDIO_ENGINE, AUDIO_ENGINE->block_length);
+      LOOP_END ("engine cycles", path);
 
-      g_message (
-        "%soptimized time: %ld", optimized ? "" : "un",
-        end - start);
-      /*g_warn_if_reached ();*/
+  g_message ("%s time: %ld", path_names[path], end - start);
 
 #ifdef HAVE_LSP_DSP
-      if (optimized)
-        {
-          lsp_dsp_finish (&ctx);
-        }
+  if (path == DSP_BENCHMARK_PATH_LSP)
+    {
+      lsp_dsp_finish (&ctx);
+    }
 #endif
 
-      test_helper_zrythm_cleanup ();
+  test_helper_zrythm_cleanup ();
+}
+
+static void
+test_run_engine (void)
+{
+  for (int i = 0; i < NUM_DSP_BENCHMARK_PATHS; i++)
+    {
+      _test_run_engine ((DspBenchmarkPath) i);
     }
+}
 
-  static void test_run_engine (void)
-  {
-#ifdef HAVE_LSP_DSP
-    _test_run_engine (F_OPTIMIZED);
-#endif
-    _test_run_engine (F_NOT_OPTIMIZED);
-  }
-
-  static void print_benchmark_results (void)
-  {
-    for (int i = 0; i < num_benchmarks; i++)
-      {
-        DspBenchmark * benchmark = &benchmarks[i];
-        fprintf (
-          stderr,
-          "---- %s ----\n"
-          "unoptimized: %ldms\n"
-          "optimized: %ldms\n",
-          benchmark->func_name,
-          benchmark->unoptimized_usec / 1000,
-          benchmark->optimized_usec / 1000);
-      }
-  }
-
-  int main (int argc, char * argv[])
-  {
-    g_test_init (&argc, &argv, NULL);
+static void
+print_benchmark_results (void)
+{
+  fprintf (
+    stderr, "%-22s %14s %14s %14s\n", "function",
+    path_names[DSP_BENCHMARK_PATH_SCALAR],
+    path_names[DSP_BENCHMARK_PATH_SIMD],
+    path_names[DSP_BENCHMARK_PATH_LSP]);
+  fprintf (
+    stderr, "(in-tree SIMD backend: %s)\n",
+    dsp_backend_get_name (simd_backend));
+  for (int i = 0; i < num_benchmarks; i++)
+    {
+      DspBenchmark * benchmark = &benchmarks[i];
+      fprintf (stderr, "%-22s", benchmark->func_name);
+      for (int j = 0; j < NUM_DSP_BENCHMARK_PATHS; j++)
+        {
+          if (benchmark->usec[j] < 0)
+            fprintf (stderr, " %14s", "n/a");
+          else
+            fprintf (
+              stderr, " %12ldms", benchmark->usec[j] / 1000);
+        }
+      fprintf (stderr, "\n");
+    }
+}
+
+int
+main (int argc, char * argv[])
+{
+  g_test_init (&argc, &argv, NULL);
 
 #ifdef HAVE_LSP_DSP
-    lsp_dsp_init ();
+  lsp_dsp_init ();
 #endif
 
+  /* find the best in-tree SIMD backend */
+  static const DspBackend simd_backends[] = {
+    DSP_BACKEND_AVX512,
+    DSP_BACKEND_AVX2,
+    DSP_BACKEND_SSE2,
+    DSP_BACKEND_NEON,
+  };
+  for (size_t i = 0; i < G_N_ELEMENTS (simd_backends); i++)
+    {
+      if (dsp_backend_is_supported (simd_backends[i]))
+        {
+          simd_backend = simd_backends[i];
+          break;
+        }
+    }
+
 #define TEST_PREFIX "/benchmarks/dsp/"
 
-    g_test_add_func (
-      TEST_PREFIX "test dsp fill", (GTestFunc) test_dsp_fill);
-    g_test_add_func (
-      TEST_PREFIX "test run engine",
-      (GTestFunc) test_run_engine);
-    g_test_add_func (
-      TEST_PREFIX "print benchmark results",
-      (GTestFunc) print_benchmark_results);
-
-    return g_test_run ();
-  }
+  g_test_add_func (
+    TEST_PREFIX "test dsp fill", (GTestFunc) test_dsp_fill);
+  g_test_add_func (
+    TEST_PREFIX "test run engine", (GTestFunc) test_run_engine);
+  g_test_add_func (
+    TEST_PREFIX "print benchmark results",
+    (GTestFunc) print_benchmark_results);
+
+  return g_test_run ();
+}
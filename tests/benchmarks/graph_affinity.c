@@ -0,0 +1,144 @@
+// SPDX-FileCopyrightText: © 2022 Alexandros Theodotou <alex@zrythm.org>
+// SPDX-License-Identifier: LicenseRef-ZrythmLicense
+
+#include "zrythm-test-config.h"
+
+#include "audio/graph.h"
+#include "audio/graph_thread.h"
+#include "audio/router.h"
+#include "audio/transport.h"
+#include "project.h"
+#include "utils/cpu_topology.h"
+#include "utils/flags.h"
+#include "zrythm.h"
+
+#include <glib.h>
+
+#include "tests/helpers/plugin_manager.h"
+#include "tests/helpers/project.h"
+#include "tests/helpers/zrythm.h"
+
+#define NUM_TRACKS 64
+#define NUM_CYCLES 2000
+
+static const char * affinity_names[] = {
+  "unpinned",
+  "pinned to cores",
+  "pinned to cache groups",
+};
+
+/**
+ * Recreates the graph threads with the given
+ * affinity.
+ */
+static void
+restart_graph (CpuAffinity affinity)
+{
+  char * str = g_strdup_printf ("%d", affinity);
+  g_setenv ("ZRYTHM_DSP_THREAD_AFFINITY", str, true);
+  g_free (str);
+
+  graph_destroy (ROUTER->graph);
+  ROUTER->graph = NULL;
+  router_recalc_graph (ROUTER, F_NOT_SOFT);
+  g_assert_cmpint (ROUTER->graph->affinity, ==, affinity);
+}
+
+static void
+test_cycle_time (void)
+{
+  test_helper_zrythm_init ();
+
+  test_project_stop_dummy_engine ();
+
+  /* create tracks with a few processing steps each */
+#ifdef HAVE_LSP_COMPRESSOR
+  test_plugin_manager_create_tracks_from_plugin (
+    LSP_COMPRESSOR_BUNDLE, LSP_COMPRESSOR_URI, false, false,
+    NUM_TRACKS);
+#else
+  char * filepath =
+    g_build_filename (TESTS_SRCDIR, "test.wav", NULL);
+  SupportedFile * file =
+    supported_file_new_from_path (filepath);
+  Position start;
+  position_init (&start);
+  for (int i = 0; i < NUM_TRACKS; i++)
+    {
+      track_create_with_action (
+        TRACK_TYPE_AUDIO, NULL, file, &start,
+        TRACKLIST->num_tracks, 1, NULL);
+    }
+  supported_file_free (file);
+  g_free (filepath);
+#endif
+
+  nframes_t block_length = AUDIO_ENGINE->block_length;
+  gint64    avg_usec[G_N_ELEMENTS (affinity_names)];
+  for (int i = 0; i < (int) G_N_ELEMENTS (affinity_names);
+       i++)
+    {
+      CpuAffinity affinity = (CpuAffinity) i;
+      restart_graph (affinity);
+
+      Position pos;
+      position_init (&pos);
+      transport_set_playhead_pos (TRANSPORT, &pos);
+      transport_request_roll (TRANSPORT, true);
+
+      /* warm up */
+      for (int j = 0; j < 100; j++)
+        {
+          engine_process (AUDIO_ENGINE, block_length);
+        }
+
+      gint64 total = 0;
+      gint64 max = 0;
+      for (int j = 0; j < NUM_CYCLES; j++)
+        {
+          gint64 cycle_start = g_get_monotonic_time ();
+          engine_process (AUDIO_ENGINE, block_length);
+          gint64 cycle_time =
+            g_get_monotonic_time () - cycle_start;
+          total += cycle_time;
+          max = MAX (max, cycle_time);
+        }
+      avg_usec[i] = total / NUM_CYCLES;
+
+      transport_request_pause (TRANSPORT, true);
+      engine_process (AUDIO_ENGINE, block_length);
+
+      g_message (
+        "%s (%d threads, main thread on CPU %d): "
+        "avg cycle %" G_GINT64_FORMAT
+        " us, max cycle %" G_GINT64_FORMAT " us",
+        affinity_names[i], ROUTER->graph->num_threads + 1,
+        ROUTER->graph->main_thread->cpu, avg_usec[i], max);
+    }
+
+  for (int i = 1; i < (int) G_N_ELEMENTS (affinity_names);
+       i++)
+    {
+      g_message (
+        "%s vs unpinned: %.2fx", affinity_names[i],
+        (double) avg_usec[0] / (double) MAX (avg_usec[i], 1));
+    }
+
+  g_unsetenv ("ZRYTHM_DSP_THREAD_AFFINITY");
+
+  test_helper_zrythm_cleanup ();
+}
+
+int
+main (int argc, char * argv[])
+{
+  g_test_init (&argc, &argv, NULL);
+
+#define TEST_PREFIX "/benchmarks/graph_affinity/"
+
+  g_test_add_func (
+    TEST_PREFIX "test cycle time",
+    (GTestFunc) test_cycle_time);
+
+  return g_test_run ();
+}
@@ -0,0 +1,146 @@
+// SPDX-FileCopyrightText: © 2022 Alexandros Theodotou <alex@zrythm.org>
+// SPDX-License-Identifier: LicenseRef-ZrythmLicense
+
+#include "zrythm-test-config.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "audio/midi_event.h"
+#include "utils/midi.h"
+
+#include <glib.h>
+
+#include "tests/helpers/zrythm.h"
+
+#define NUM_ITERATIONS 2000
+
+/** Number of sorted runs (eg, regions or source
+ * ports). */
+#define NUM_RUNS 16
+
+/** Events per run. */
+#define RUN_LEN 48
+
+#define BLOCK_LENGTH 256
+
+/**
+ * Comparator for the qsort path, ordering by time
+ * and then status byte.
+ */
+static int
+cmp_by_time (const void * _a, const void * _b)
+{
+  const MidiEvent * a = (const MidiEvent *) _a;
+  const MidiEvent * b = (const MidiEvent *) _b;
+  if (a->time == b->time)
+    return (int) a->raw_buffer[0] - (int) b->raw_buffer[0];
+  return (int) a->time - (int) b->time;
+}
+
+/**
+ * Fills @p events with NUM_RUNS sorted runs of dense
+ * note/CC events, where every 4th run duplicates the
+ * previous one.
+ */
+static void
+fill_runs (MidiEvents * events)
+{
+  midi_events_clear (events, F_NOT_QUEUED);
+  for (int i = 0; i < NUM_RUNS; i++)
+    {
+      int src = i % 4 == 3 ? i - 1 : i;
+      for (int j = 0; j < RUN_LEN; j++)
+        {
+          midi_time_t time = (midi_time_t) (
+            (j * BLOCK_LENGTH) / RUN_LEN + src % 3);
+          if (j % 3 == 0)
+            {
+              midi_events_add_control_change (
+                events, 1, (midi_byte_t) (src % 120),
+                (midi_byte_t) j, time, F_NOT_QUEUED);
+            }
+          else
+            {
+              midi_byte_t note =
+                (midi_byte_t) ((src * 7 + j) % 128);
+              midi_events_add_note_on (
+                events, 1, note, 90, time, F_NOT_QUEUED);
+            }
+        }
+    }
+}
+
+static void
+test_sort_dense_events (void)
+{
+  test_helper_zrythm_init ();
+
+  MidiEvents * tmpl = midi_events_new ();
+  fill_runs (tmpl);
+  g_assert_cmpint (tmpl->num_events, ==, NUM_RUNS * RUN_LEN);
+  g_assert_cmpint (tmpl->num_dropped, ==, 0);
+
+  MidiEvents * events = midi_events_new_with_size_of (tmpl);
+  size_t       bytes =
+    (size_t) tmpl->num_events * sizeof (MidiEvent);
+
+  /* qsort followed by the quadratic duplicate
+   * removal */
+  gint64 start = g_get_monotonic_time ();
+  for (int i = 0; i < NUM_ITERATIONS; i++)
+    {
+      memcpy (events->events, tmpl->events, bytes);
+      events->num_events = tmpl->num_events;
+      qsort (
+        events->events, (size_t) events->num_events,
+        sizeof (MidiEvent), cmp_by_time);
+      midi_events_clear_duplicates (events, F_NOT_QUEUED);
+    }
+  gint64 end = g_get_monotonic_time ();
+  int    qsort_num_events = events->num_events;
+  g_message (
+    "qsort + clear duplicates time: %" G_GINT64_FORMAT,
+    end - start);
+
+  /* merge of the sorted runs with duplicate
+   * removal */
+  start = g_get_monotonic_time ();
+  for (int i = 0; i < NUM_ITERATIONS; i++)
+    {
+      memcpy (events->events, tmpl->events, bytes);
+      events->num_events = tmpl->num_events;
+      midi_events_sort_and_clear_duplicates (
+        events, F_NOT_QUEUED);
+    }
+  end = g_get_monotonic_time ();
+  g_message (
+    "run merge time: %" G_GINT64_FORMAT, end - start);
+
+  g_assert_cmpint (events->num_events, ==, qsort_num_events);
+  for (int i = 1; i < events->num_events; i++)
+    {
+      g_assert_cmpuint (
+        events->events[i - 1].time, <=,
+        events->events[i].time);
+    }
+
+  midi_events_free (events);
+  midi_events_free (tmpl);
+
+  test_helper_zrythm_cleanup ();
+}
+
+int
+main (int argc, char * argv[])
+{
+  g_test_init (&argc, &argv, NULL);
+
+#define TEST_PREFIX "/benchmarks/midi_events/"
+
+  g_test_add_func (
+    TEST_PREFIX "test sort dense events",
+    (GTestFunc) test_sort_dense_events);
+
+  return g_test_run ();
+}
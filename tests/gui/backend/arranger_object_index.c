@@ -0,0 +1,150 @@
+// SPDX-FileCopyrightText: © 2022 Alexandros Theodotou <alex@zrythm.org>
+// SPDX-License-Identifier: LicenseRef-ZrythmLicense
+
+#include "zrythm-test-config.h"
+
+#include "gui/backend/arranger_object.h"
+#include "gui/backend/arranger_object_index.h"
+#include "utils/objects.h"
+
+#include <glib.h>
+
+#include "tests/helpers/zrythm.h"
+
+#define NUM_OBJS 600
+
+static bool
+objs_overlap (
+  const ArrangerObject * obj,
+  double                 start_ticks,
+  double                 end_ticks)
+{
+  return obj->end_pos.ticks >= start_ticks
+         && obj->pos.ticks <= end_ticks;
+}
+
+/**
+ * Checks that the index returns the same objects
+ * as a linear scan.
+ */
+static void
+check_queries (
+  ArrangerObjectIndex * index,
+  ArrangerObject **     objs,
+  int                   num_objs)
+{
+  arranger_object_index_update (index, objs, num_objs);
+
+  GPtrArray * arr = g_ptr_array_new ();
+  for (int i = 0; i < 200; i++)
+    {
+      double start = g_random_double_range (-100.0, 12000.0);
+      double end =
+        start + g_random_double_range (0.0, 600.0);
+
+      g_ptr_array_remove_range (arr, 0, arr->len);
+      arranger_object_index_query (index, start, end, arr);
+
+      int expected = 0;
+      for (int j = 0; j < num_objs; j++)
+        {
+          bool overlaps = objs_overlap (objs[j], start, end);
+          if (overlaps)
+            expected++;
+          g_assert_true (
+            overlaps
+            == g_ptr_array_find (arr, objs[j], NULL));
+        }
+      g_assert_cmpint ((int) arr->len, ==, expected);
+    }
+  g_ptr_array_unref (arr);
+}
+
+static void
+test_query (void)
+{
+  ArrangerObject * objs[NUM_OBJS];
+  int              num_objs = NUM_OBJS / 2;
+  for (int i = 0; i < NUM_OBJS; i++)
+    {
+      objs[i] = object_new (ArrangerObject);
+      objs[i]->type = ARRANGER_OBJECT_TYPE_REGION;
+      objs[i]->pos.ticks =
+        g_random_double_range (0.0, 10000.0);
+
+      /* mix of short and very long objects */
+      objs[i]->end_pos.ticks =
+        objs[i]->pos.ticks
+        + (i % 50 == 0
+             ? g_random_double_range (0.0, 8000.0)
+             : g_random_double_range (0.0, 200.0));
+    }
+
+  ArrangerObjectIndex * index = arranger_object_index_new ();
+  check_queries (index, objs, num_objs);
+
+  /* move a few objects (some more than once) and
+   * check that they are reinserted */
+  for (int i = 0; i < 10; i++)
+    {
+      ArrangerObject * obj =
+        objs[g_random_int_range (0, num_objs)];
+      double ticks = g_random_double_range (-500.0, 500.0);
+      obj->pos.ticks += ticks;
+      obj->end_pos.ticks += ticks;
+      arranger_object_index_object_moved (index, obj);
+    }
+  g_assert_false (index->members_dirty);
+  check_queries (index, objs, num_objs);
+  g_assert_cmpint (index->num_moved, ==, 0);
+
+  /* resize an object */
+  objs[0]->end_pos.ticks += 3000.0;
+  arranger_object_index_object_moved (index, objs[0]);
+  check_queries (index, objs, num_objs);
+
+  /* moving too many objects rebuilds the index */
+  for (int i = 0; i < ARRANGER_OBJECT_INDEX_MAX_MOVED + 1;
+       i++)
+    {
+      ArrangerObject * obj = objs[i];
+      obj->pos.ticks += 100.0;
+      obj->end_pos.ticks += 100.0;
+      arranger_object_index_object_moved (index, obj);
+    }
+  g_assert_true (index->members_dirty);
+  check_queries (index, objs, num_objs);
+
+  /* an object that is not indexed rebuilds the
+   * index */
+  arranger_object_index_object_moved (
+    index, objs[NUM_OBJS - 1]);
+  check_queries (index, objs, num_objs);
+
+  /* add and remove objects */
+  num_objs = NUM_OBJS;
+  arranger_object_index_invalidate (index);
+  check_queries (index, objs, num_objs);
+  num_objs = NUM_OBJS / 3;
+  arranger_object_index_invalidate (index);
+  check_queries (index, objs, num_objs);
+
+  arranger_object_index_free (index);
+  for (int i = 0; i < NUM_OBJS; i++)
+    {
+      object_zero_and_free (objs[i]);
+    }
+}
+
+int
+main (int argc, char * argv[])
+{
+  g_test_init (&argc, &argv, NULL);
+
+#define TEST_PREFIX "/gui/backend/arranger object index/"
+
+  g_test_add_func (
+    TEST_PREFIX "test query", (GTestFunc) test_query);
+
+  return g_test_run ();
+}
@@ -42,6 +42,7 @@
 #include "utils/io.h"
 #include "utils/log.h"
 #include "utils/objects.h"
+#include "utils/rt_audit.h"
 #include "utils/ui.h"
 #include "zrythm.h"
 #include "zrythm_app.h"
@@ -51,6 +52,10 @@
 
 #include <project.h>
 
+#ifdef HAVE_RT_AUDIT
+#  include <unistd.h>
+#endif
+
 /**
  * @addtogroup tests
  *
@@ -224,6 +229,40 @@ test_helper_zrythm_cleanup ()
   io_rmdir (ZRYTHM->testing_dir, true);
   object_free_w_func_and_null (zrythm_free, ZRYTHM);
   object_free_w_func_and_null (log_free, LOG);
+
+#ifdef HAVE_RT_AUDIT
+  /* fail if anything not realtime-safe ran in the
+   * processing threads */
+  int num_violations = rt_audit_get_num_violations ();
+  if (num_violations > 0)
+    {
+      char * report = rt_audit_get_report ();
+      g_printerr ("%s", report);
+      g_free (report);
+
+      const char * report_dir =
+        g_getenv ("ZRYTHM_RT_AUDIT_REPORT_DIR");
+      if (report_dir)
+        {
+          char * filename = g_strdup_printf (
+            "rt_audit_%d.txt", (int) getpid ());
+          char * filepath = g_build_filename (
+            report_dir, filename, NULL);
+          GError * err = NULL;
+          if (!rt_audit_write_report (filepath, &err))
+            {
+              g_printerr (
+                "failed to write RT audit report: %s\n",
+                err->message);
+              g_error_free (err);
+            }
+          g_free (filepath);
+          g_free (filename);
+        }
+      rt_audit_reset ();
+    }
+  g_assert_cmpint (num_violations, ==, 0);
+#endif
 }
 
 /**
@@ -8,9 +8,14 @@
 #include "plugins/carla/carla_discovery.h"
 #include "plugins/carla_native_plugin.h"
 #include "utils/math.h"
+#include "utils/system.h"
 
 #include <glib.h>
 
+#ifdef __linux__
+#  include <unistd.h>
+#endif
+
 #include "tests/helpers/plugin_manager.h"
 #include "tests/helpers/zrythm.h"
 
@@ -150,6 +155,79 @@ test_crash_handling (void)
 #endif
 }
 
+static void
+test_bridge_process (void)
+{
+#ifdef HAVE_CARLA
+  test_helper_zrythm_init ();
+
+  /* stop dummy audio engine processing so we can
+   * process manually */
+  AUDIO_ENGINE->stop_dummy_audio_thread = true;
+  g_usleep (1000000);
+
+  PluginSetting * setting =
+    test_plugin_manager_get_plugin_setting (
+      EG_AMP_BUNDLE_URI, EG_AMP_URI, true);
+  g_return_if_fail (setting);
+  setting->bridge_mode = CARLA_BRIDGE_FULL;
+
+  track_create_for_plugin_at_idx_w_action (
+    TRACK_TYPE_AUDIO_BUS, setting, TRACKLIST->num_tracks,
+    NULL);
+
+  Plugin * pl =
+    TRACKLIST->tracks[TRACKLIST->num_tracks - 1]
+      ->channel->inserts[0];
+  g_assert_true (IS_PLUGIN_AND_NONNULL (pl));
+  g_assert_nonnull (pl->carla);
+
+#  ifdef __linux__
+  /* the plugin runs in its own process */
+  g_assert_cmpint (pl->carla->bridge_pid, >, 0);
+  g_assert_cmpint (
+    pl->carla->bridge_pid, !=, (int) getpid ());
+
+  /* and it is the bridge for this plugin */
+  char ** args =
+    system_get_process_cmdline (pl->carla->bridge_pid);
+  g_assert_nonnull (args);
+  char * basename = g_path_get_basename (args[0]);
+  g_assert_true (
+    g_str_has_prefix (basename, "carla-bridge-"));
+  g_free (basename);
+  g_assert_true (g_strv_contains (
+    (const char * const *) args, EG_AMP_URI));
+  g_strfreev (args);
+  int64_t start_cpu_time =
+    system_get_process_cpu_time (pl->carla->bridge_pid);
+  g_assert_cmpint (start_cpu_time, >=, 0);
+#  endif
+
+  for (int i = 0; i < 8; i++)
+    {
+      engine_process (
+        AUDIO_ENGINE, AUDIO_ENGINE->block_length);
+    }
+
+#  ifdef __linux__
+  float load =
+    carla_native_plugin_get_bridge_cpu_load (pl->carla);
+  g_assert_cmpfloat (load, >=, 0.f);
+  g_assert_cmpfloat (
+    load, <=, (float) g_get_num_processors ());
+
+  /* the bridge is still alive (CPU time is counted
+   * in clock ticks so it may not have increased) */
+  g_assert_cmpint (
+    system_get_process_cpu_time (pl->carla->bridge_pid), >=,
+    start_cpu_time);
+#  endif
+
+  test_helper_zrythm_cleanup ();
+#endif
+}
+
 /**
  * Test process.
  */
@@ -209,6 +287,9 @@ main (int argc, char * argv[])
     (GTestFunc) test_mono_plugin);
   g_test_add_func (
     TEST_PREFIX "test process", (GTestFunc) test_process);
+  g_test_add_func (
+    TEST_PREFIX "test bridge process",
+    (GTestFunc) test_bridge_process);
 #if 0
   g_test_add_func (
     TEST_PREFIX "test has custom UI",
@@ -19,9 +19,14 @@
 
 #include "zrythm-test-config.h"
 
+#include "audio/automation_point.h"
+#include "audio/automation_region.h"
+#include "audio/automation_tracklist.h"
+#include "audio/control_port.h"
 #include "audio/fader.h"
 #include "audio/midi_event.h"
 #include "audio/router.h"
+#include "utils/dsp.h"
 #include "utils/math.h"
 
 #include <glib.h>
@@ -199,6 +204,225 @@ test_bypass_state_after_project_load (void)
 #endif
 }
 
+static void
+test_auto_sleep (void)
+{
+  test_helper_zrythm_init ();
+
+  /* create fx track (without any input) */
+  test_plugin_manager_create_tracks_from_plugin (
+    EG_AMP_BUNDLE_URI, EG_AMP_URI, false, false, 1);
+  Track * track =
+    TRACKLIST->tracks[TRACKLIST->num_tracks - 1];
+  Plugin * pl = track->channel->inserts[0];
+  g_assert_true (IS_PLUGIN_AND_NONNULL (pl));
+
+  /* not sleeping by default */
+  engine_wait_n_cycles (
+    AUDIO_ENGINE, PLUGIN_AUTO_SLEEP_SILENT_BLOCKS + 4);
+  g_assert_false (pl->sleeping);
+  g_assert_cmpuint (pl->sleep_frames, ==, 0);
+
+  /* enable and expect the plugin to sleep since its
+   * input is silent */
+  plugin_set_auto_sleep (pl, true);
+  engine_wait_n_cycles (
+    AUDIO_ENGINE, PLUGIN_AUTO_SLEEP_SILENT_BLOCKS + 4);
+  g_assert_true (pl->sleeping);
+  g_assert_cmpuint (pl->sleep_frames, >, 0);
+  g_assert_cmpfloat (
+    plugin_get_auto_sleep_ratio (pl), >, 0.f);
+
+  /* disabling wakes it up and resets the stats on
+   * the next cycle */
+  plugin_set_auto_sleep (pl, false);
+  engine_wait_n_cycles (AUDIO_ENGINE, 2);
+  g_assert_false (pl->sleeping);
+  g_assert_cmpuint (pl->sleep_frames, ==, 0);
+
+  /* check that the setting is saved */
+  plugin_set_auto_sleep (pl, true);
+  test_project_save_and_reload ();
+  track = TRACKLIST->tracks[TRACKLIST->num_tracks - 1];
+  pl = track->channel->inserts[0];
+  g_assert_true (pl->auto_sleep);
+
+  test_helper_zrythm_cleanup ();
+}
+
+static void
+test_auto_sleep_wake_on_input (void)
+{
+  test_helper_zrythm_init ();
+
+  /* create fx track (without any input) */
+  test_plugin_manager_create_tracks_from_plugin (
+    EG_AMP_BUNDLE_URI, EG_AMP_URI, false, false, 1);
+  Track * track =
+    TRACKLIST->tracks[TRACKLIST->num_tracks - 1];
+  Plugin * pl = track->channel->inserts[0];
+  g_assert_true (IS_PLUGIN_AND_NONNULL (pl));
+  g_assert_cmpuint (pl->audio_in_ports->len, >, 0);
+
+  plugin_set_auto_sleep (pl, true);
+  engine_wait_n_cycles (
+    AUDIO_ENGINE, PLUGIN_AUTO_SLEEP_SILENT_BLOCKS + 4);
+  g_assert_true (pl->sleeping);
+  g_assert_cmpuint (pl->num_wakeups, ==, 0);
+
+  /* stop dummy audio engine processing so we can
+   * process manually */
+  AUDIO_ENGINE->stop_dummy_audio_thread = true;
+  g_usleep (1000000);
+
+  /* feed non-silent input and expect the plugin to
+   * wake up and produce output */
+  const nframes_t block_length =
+    AUDIO_ENGINE->block_length;
+  Port * in_port = g_ptr_array_index (pl->audio_in_ports, 0);
+  dsp_fill (in_port->buf, 0.5f, block_length);
+  port_update_silence (in_port, false);
+  EngineProcessTimeInfo time_nfo = {
+    .g_start_frame = 0,
+    .local_offset = 0,
+    .nframes = block_length,
+  };
+  uint64_t awake_frames = pl->awake_frames;
+  plugin_process (pl, &time_nfo);
+  g_assert_false (pl->sleeping);
+  g_assert_cmpuint (pl->num_wakeups, ==, 1);
+  g_assert_cmpuint (
+    pl->awake_frames, ==, awake_frames + block_length);
+  g_assert_cmpuint (pl->silent_input_frames, ==, 0);
+
+  test_helper_zrythm_cleanup ();
+}
+
+static void
+test_automation_sub_blocks (void)
+{
+  test_helper_zrythm_init ();
+
+  /* create fx track */
+  test_plugin_manager_create_tracks_from_plugin (
+    EG_AMP_BUNDLE_URI, EG_AMP_URI, false, false, 1);
+  Track * track =
+    TRACKLIST->tracks[TRACKLIST->num_tracks - 1];
+  Plugin * pl = track->channel->inserts[0];
+  g_assert_true (IS_PLUGIN_AND_NONNULL (pl));
+  Port * port = NULL;
+  for (size_t i = 0; i < pl->ctrl_in_ports->len; i++)
+    {
+      Port * cur_port =
+        g_ptr_array_index (pl->ctrl_in_ports, i);
+      if (string_is_equal (cur_port->id.label, "Gain"))
+        {
+          port = cur_port;
+          break;
+        }
+    }
+  g_assert_nonnull (port);
+
+  /* automate a ramp over the first bar */
+  AutomationTrack * at =
+    automation_tracklist_get_at_from_port (
+      track_get_automation_tracklist (track), port);
+  g_assert_nonnull (at);
+  Position start, end;
+  position_set_to_bar (&start, 1);
+  position_set_to_bar (&end, 3);
+  ZRegion * region = automation_region_new (
+    &start, &end, track_get_name_hash (track), at->index,
+    0);
+  track_add_region (
+    track, region, at, -1, F_GEN_NAME,
+    F_NO_PUBLISH_EVENTS);
+  AutomationPoint * ap =
+    automation_point_new_float (0.f, 0.f, &start);
+  automation_region_add_ap (
+    region, ap, F_NO_PUBLISH_EVENTS);
+  Position pos;
+  position_set_to_bar (&pos, 2);
+  ap = automation_point_new_float (1.f, 1.f, &pos);
+  automation_region_add_ap (
+    region, ap, F_NO_PUBLISH_EVENTS);
+
+  /* stop dummy audio engine processing so we can
+   * process manually */
+  AUDIO_ENGINE->stop_dummy_audio_thread = true;
+  g_usleep (1000000);
+
+  transport_set_playhead_pos (TRANSPORT, &start);
+  transport_request_roll (TRANSPORT, true);
+  engine_process (AUDIO_ENGINE, AUDIO_ENGINE->block_length);
+
+  /* without sub-blocks the value from the start of
+   * the cycle is used */
+  const nframes_t block_length =
+    AUDIO_ENGINE->block_length;
+  unsigned_frame_t g_start =
+    (unsigned_frame_t) PLAYHEAD->frames;
+  float expected;
+  g_assert_true (
+    port_get_automation_val (port, g_start, &expected));
+  engine_process (AUDIO_ENGINE, block_length);
+  g_assert_cmpfloat_with_epsilon (
+    control_port_get_normalized_val (port), expected,
+    0.0001f);
+
+  /* with sub-blocks the value at the start of the
+   * last sub-block is used */
+  const nframes_t sub_block_size = block_length / 4;
+  AUDIO_ENGINE->plugin_sub_block_size = sub_block_size;
+  g_start = (unsigned_frame_t) PLAYHEAD->frames;
+  g_assert_true (port_get_automation_val (
+    port, g_start + block_length - sub_block_size,
+    &expected));
+  engine_process (AUDIO_ENGINE, block_length);
+  g_assert_cmpfloat_with_epsilon (
+    control_port_get_normalized_val (port), expected,
+    0.0001f);
+
+  /* a curve that goes up and back down within the
+   * cycle is split too */
+  position_set_to_bar (&pos, 5);
+  transport_set_playhead_pos (TRANSPORT, &pos);
+  engine_process (AUDIO_ENGINE, block_length);
+  g_start = (unsigned_frame_t) PLAYHEAD->frames;
+  position_set_to_bar (&start, 4);
+  position_set_to_bar (&end, 8);
+  region = automation_region_new (
+    &start, &end, track_get_name_hash (track), at->index,
+    1);
+  track_add_region (
+    track, region, at, -1, F_GEN_NAME,
+    F_NO_PUBLISH_EVENTS);
+  for (int i = 0; i < 3; i++)
+    {
+      signed_frame_t frame =
+        (signed_frame_t) g_start
+        + i * (signed_frame_t) block_length / 2;
+      position_from_frames (&pos, frame - start.frames);
+      ap = automation_point_new_float (
+        (float) (i % 2), (float) (i % 2), &pos);
+      automation_region_add_ap (
+        region, ap, F_NO_PUBLISH_EVENTS);
+    }
+  g_assert_true (
+    port_get_automation_val (port, g_start, &expected));
+  g_assert_cmpfloat_with_epsilon (expected, 0.f, 0.0001f);
+  g_assert_true (port_get_automation_val (
+    port, g_start + block_length - sub_block_size,
+    &expected));
+  g_assert_cmpfloat (expected, >, 0.0001f);
+  engine_process (AUDIO_ENGINE, block_length);
+  g_assert_cmpfloat_with_epsilon (
+    control_port_get_normalized_val (port), expected,
+    0.0001f);
+
+  test_helper_zrythm_cleanup ();
+}
+
 int
 main (int argc, char * argv[])
 {
@@ -208,6 +432,16 @@ main (int argc, char * argv[])
 
 #define TEST_PREFIX "/plugins/plugin/"
 
+  g_test_add_func (
+    TEST_PREFIX "test automation sub-blocks",
+    (GTestFunc) test_automation_sub_blocks);
+  g_test_add_func (
+    TEST_PREFIX "test auto sleep",
+    (GTestFunc) test_auto_sleep);
+  g_test_add_func (
+    TEST_PREFIX "test auto sleep wake on input",
+    (GTestFunc) test_auto_sleep_wake_on_input);
+
   g_test_add_func (
     TEST_PREFIX "test bypass state after project load",
     (GTestFunc) test_bypass_state_after_project_load);
@@ -0,0 +1,123 @@
+// SPDX-FileCopyrightText: © 2022 Alexandros Theodotou <alex@zrythm.org>
+// SPDX-License-Identifier: LicenseRef-ZrythmLicense
+
+#include "zrythm-test-config.h"
+
+#include "utils/cpu_topology.h"
+
+#include <glib.h>
+
+#define MAX_CPUS 16
+
+static void
+test_parse_cpu_list (void)
+{
+  bool cpus[MAX_CPUS];
+  int  ret = cpu_topology_parse_cpu_list (
+    "0-3,8,10-11\n", cpus, MAX_CPUS);
+  g_assert_cmpint (ret, ==, 7);
+  for (int i = 0; i < MAX_CPUS; i++)
+    {
+      bool expected = i <= 3 || i == 8 || i == 10 || i == 11;
+      g_assert_true (cpus[i] == expected);
+    }
+
+  /* empty list (eg, no isolated CPUs) */
+  ret = cpu_topology_parse_cpu_list ("\n", cpus, MAX_CPUS);
+  g_assert_cmpint (ret, ==, 0);
+  for (int i = 0; i < MAX_CPUS; i++)
+    {
+      g_assert_false (cpus[i]);
+    }
+
+  /* CPUs past the max are ignored */
+  ret = cpu_topology_parse_cpu_list ("14-20", cpus, MAX_CPUS);
+  g_assert_cmpint (ret, ==, 2);
+
+  g_assert_cmpint (
+    cpu_topology_parse_cpu_list ("3-1", cpus, MAX_CPUS), ==,
+    -1);
+  g_assert_cmpint (
+    cpu_topology_parse_cpu_list ("0,a", cpus, MAX_CPUS), ==,
+    -1);
+  g_assert_cmpint (
+    cpu_topology_parse_cpu_list ("-1", cpus, MAX_CPUS), ==,
+    -1);
+}
+
+static void
+test_get_thread_cpus (void)
+{
+  /* 2 sockets with interleaved CPU IDs, the last 2
+   * CPUs isolated */
+  CpuTopology * topology = cpu_topology_new (8);
+  for (int i = 0; i < topology->num_cpus; i++)
+    {
+      CpuTopologyCpu * cpu = &topology->cpus[i];
+      cpu->cache_group = i % 2;
+      cpu->numa_node = i % 2;
+      cpu->isolated = i >= 6;
+    }
+
+  int cpus[8];
+  int ret = cpu_topology_get_thread_cpus (
+    topology, CPU_AFFINITY_NONE, false, 4, cpus);
+  g_assert_cmpint (ret, ==, 0);
+  for (int i = 0; i < 4; i++)
+    {
+      g_assert_cmpint (cpus[i], ==, -1);
+    }
+
+  ret = cpu_topology_get_thread_cpus (
+    topology, CPU_AFFINITY_CORES, false, 4, cpus);
+  g_assert_cmpint (ret, ==, 6);
+  for (int i = 0; i < 4; i++)
+    {
+      g_assert_cmpint (cpus[i], ==, i);
+    }
+
+  /* the first socket is filled first */
+  ret = cpu_topology_get_thread_cpus (
+    topology, CPU_AFFINITY_CACHE_GROUPS, false, 5, cpus);
+  g_assert_cmpint (ret, ==, 6);
+  g_assert_cmpint (cpus[0], ==, 0);
+  g_assert_cmpint (cpus[1], ==, 2);
+  g_assert_cmpint (cpus[2], ==, 4);
+  g_assert_cmpint (cpus[3], ==, 1);
+  g_assert_cmpint (cpus[4], ==, 3);
+
+  /* only the isolated CPUs, wrapping around */
+  ret = cpu_topology_get_thread_cpus (
+    topology, CPU_AFFINITY_CACHE_GROUPS, true, 3, cpus);
+  g_assert_cmpint (ret, ==, 2);
+  g_assert_cmpint (cpus[0], ==, 6);
+  g_assert_cmpint (cpus[1], ==, 7);
+  g_assert_cmpint (cpus[2], ==, 6);
+
+  /* CPUs the process may not run on are skipped */
+  topology->cpus[0].allowed = false;
+  ret = cpu_topology_get_thread_cpus (
+    topology, CPU_AFFINITY_CORES, false, 2, cpus);
+  g_assert_cmpint (ret, ==, 5);
+  g_assert_cmpint (cpus[0], ==, 1);
+  g_assert_cmpint (cpus[1], ==, 2);
+
+  cpu_topology_free (topology);
+}
+
+int
+main (int argc, char * argv[])
+{
+  g_test_init (&argc, &argv, NULL);
+
+#define TEST_PREFIX "/utils/cpu_topology/"
+
+  g_test_add_func (
+    TEST_PREFIX "test parse cpu list",
+    (GTestFunc) test_parse_cpu_list);
+  g_test_add_func (
+    TEST_PREFIX "test get thread cpus",
+    (GTestFunc) test_get_thread_cpus);
+
+  return g_test_run ();
+}
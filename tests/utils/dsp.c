@@ -0,0 +1,228 @@
+// SPDX-FileCopyrightText: © 2022 Alexandros Theodotou <alex@zrythm.org>
+// SPDX-License-Identifier: LicenseRef-ZrythmLicense
+
+#include "zrythm-test-config.h"
+
+#include <math.h>
+
+#include "utils/dsp.h"
+#include "utils/dsp_simd.h"
+#include "utils/objects.h"
+
+#include <glib.h>
+
+/* big enough to exercise the vector loops of every
+ * backend plus the scalar remainder */
+#define MAX_BUF_SIZE 133
+
+#define EPSILON 0.0001f
+
+typedef struct DspTestBuffers
+{
+  float * expected;
+  float * actual;
+  float * src1;
+  float * src2;
+} DspTestBuffers;
+
+static void
+fill_random (float * buf, size_t size, float amp)
+{
+  for (size_t i = 0; i < size; i++)
+    {
+      buf[i] =
+        (float) g_test_rand_double_range (-amp, amp);
+    }
+}
+
+static void
+assert_bufs_equal (
+  const char *  func,
+  const float * expected,
+  const float * actual,
+  size_t        size)
+{
+  for (size_t i = 0; i < size; i++)
+    {
+      if (fabsf (expected[i] - actual[i]) > EPSILON)
+        {
+          g_error (
+            "%s (%s): mismatch at %zu/%zu: expected %f, "
+            "got %f",
+            func, dsp_backend_get_name (dsp_get_backend ()),
+            i, size, (double) expected[i],
+            (double) actual[i]);
+        }
+    }
+}
+
+static void
+reset_bufs (DspTestBuffers * bufs, size_t size)
+{
+  fill_random (bufs->expected, size, 2.f);
+  dsp_kernels_scalar.copy (
+    bufs->actual, bufs->expected, size);
+  fill_random (bufs->src1, size, 1.f);
+  fill_random (bufs->src2, size, 1.f);
+}
+
+static void
+check_kernels_for_size (DspTestBuffers * bufs, size_t size)
+{
+  const DspKernels * ref = &dsp_kernels_scalar;
+
+  reset_bufs (bufs, size);
+  ref->fill (bufs->expected, 0.42f, size);
+  dsp_fill (bufs->actual, 0.42f, size);
+  assert_bufs_equal ("fill", bufs->expected, bufs->actual, size);
+
+  reset_bufs (bufs, size);
+  ref->limit1 (bufs->expected, -1.f, 1.1f, size);
+  dsp_limit1 (bufs->actual, -1.f, 1.1f, size);
+  assert_bufs_equal (
+    "limit1", bufs->expected, bufs->actual, size);
+
+  reset_bufs (bufs, size);
+  ref->copy (bufs->expected, bufs->src1, size);
+  dsp_copy (bufs->actual, bufs->src1, size);
+  assert_bufs_equal ("copy", bufs->expected, bufs->actual, size);
+
+  reset_bufs (bufs, size);
+  ref->mul_k2 (bufs->expected, 0.77f, size);
+  dsp_mul_k2 (bufs->actual, 0.77f, size);
+  assert_bufs_equal (
+    "mul_k2", bufs->expected, bufs->actual, size);
+
+  reset_bufs (bufs, size);
+  ref->add2 (bufs->expected, bufs->src1, size);
+  dsp_add2 (bufs->actual, bufs->src1, size);
+  assert_bufs_equal ("add2", bufs->expected, bufs->actual, size);
+
+  reset_bufs (bufs, size);
+  ref->mix2 (bufs->expected, bufs->src1, 0.3f, 0.6f, size);
+  dsp_mix2 (bufs->actual, bufs->src1, 0.3f, 0.6f, size);
+  assert_bufs_equal ("mix2", bufs->expected, bufs->actual, size);
+
+  reset_bufs (bufs, size);
+  ref->mix_add2 (
+    bufs->expected, bufs->src1, bufs->src2, 0.3f, 0.6f, size);
+  dsp_mix_add2 (
+    bufs->actual, bufs->src1, bufs->src2, 0.3f, 0.6f, size);
+  assert_bufs_equal (
+    "mix_add2", bufs->expected, bufs->actual, size);
+
+  reset_bufs (bufs, size);
+  ref->linear_fade_in_from (
+    bufs->expected, 7, MAX_BUF_SIZE + 7, size, 0.2f);
+  dsp_linear_fade_in_from (
+    bufs->actual, 7, MAX_BUF_SIZE + 7, size, 0.2f);
+  assert_bufs_equal (
+    "linear_fade_in_from", bufs->expected, bufs->actual, size);
+
+  reset_bufs (bufs, size);
+  ref->linear_fade_out_to (
+    bufs->expected, 7, MAX_BUF_SIZE + 7, size, 0.2f);
+  dsp_linear_fade_out_to (
+    bufs->actual, 7, MAX_BUF_SIZE + 7, size, 0.2f);
+  assert_bufs_equal (
+    "linear_fade_out_to", bufs->expected, bufs->actual, size);
+
+  reset_bufs (bufs, size);
+  float expected_abs_max = ref->abs_max (bufs->expected, size);
+  if (expected_abs_max < 1e-20f)
+    expected_abs_max = 1e-20f;
+  g_assert_cmpfloat_with_epsilon (
+    expected_abs_max, dsp_abs_max (bufs->actual, size),
+    EPSILON);
+  g_assert_cmpfloat_with_epsilon (
+    ref->min (bufs->expected, size),
+    dsp_min (bufs->actual, size), EPSILON);
+  g_assert_cmpfloat_with_epsilon (
+    ref->max (bufs->expected, size),
+    dsp_max (bufs->actual, size), EPSILON);
+
+  float peak = 0.5f;
+  bool  changed = dsp_abs_max_with_existing_peak (
+    bufs->actual, &peak, size);
+  float expected_peak = MAX (0.5f, expected_abs_max);
+  g_assert_cmpfloat_with_epsilon (peak, expected_peak, EPSILON);
+  g_assert_true (
+    changed == !math_floats_equal (expected_peak, 0.5f));
+}
+
+/**
+ * Compares every kernel of every in-tree backend
+ * supported on this machine against the scalar
+ * reference.
+ */
+static void
+test_backends_match_scalar (void)
+{
+  DspTestBuffers bufs = {
+    .expected = object_new_n (MAX_BUF_SIZE, float),
+    .actual = object_new_n (MAX_BUF_SIZE, float),
+    .src1 = object_new_n (MAX_BUF_SIZE, float),
+    .src2 = object_new_n (MAX_BUF_SIZE, float),
+  };
+
+  DspBackend prev_backend = dsp_get_backend ();
+  for (DspBackend backend = DSP_BACKEND_SCALAR;
+       backend < DSP_BACKEND_LSP; backend++)
+    {
+      if (!dsp_set_backend (backend))
+        {
+          g_message (
+            "skipping unsupported backend %s",
+            dsp_backend_get_name (backend));
+          continue;
+        }
+
+      g_message (
+        "testing backend %s", dsp_backend_get_name (backend));
+      for (size_t size = 0; size <= MAX_BUF_SIZE; size++)
+        {
+          check_kernels_for_size (&bufs, size);
+        }
+    }
+  dsp_set_backend (prev_backend);
+
+  free (bufs.expected);
+  free (bufs.actual);
+  free (bufs.src1);
+  free (bufs.src2);
+}
+
+static void
+test_init_picks_supported_backend (void)
+{
+  DspBackend prev_backend = dsp_get_backend ();
+
+  dsp_init (false);
+  g_assert_cmpint (dsp_get_backend (), ==, DSP_BACKEND_SCALAR);
+
+  dsp_init (true);
+  g_assert_true (dsp_backend_is_supported (dsp_get_backend ()));
+#if defined(__x86_64__)
+  /* SSE2 is part of the x86_64 baseline */
+  g_assert_cmpint (dsp_get_backend (), !=, DSP_BACKEND_SCALAR);
+#endif
+
+  dsp_set_backend (prev_backend);
+}
+
+int
+main (int argc, char * argv[])
+{
+  g_test_init (&argc, &argv, NULL);
+
+#define TEST_PREFIX "/utils/dsp/"
+
+  g_test_add_func (
+    TEST_PREFIX "test backends match scalar",
+    (GTestFunc) test_backends_match_scalar);
+  g_test_add_func (
+    TEST_PREFIX "test init picks supported backend",
+    (GTestFunc) test_init_picks_supported_backend);
+
+  return g_test_run ();
+}
@@ -0,0 +1,61 @@
+// SPDX-FileCopyrightText: © 2022 Alexandros Theodotou <alex@zrythm.org>
+// SPDX-License-Identifier: LicenseRef-ZrythmLicense
+
+#include "zrythm-test-config.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "utils/log.h"
+
+#include <glib.h>
+
+#include "tests/helpers/zrythm.h"
+
+static void
+test_records (void)
+{
+  test_helper_zrythm_init ();
+
+  char * filepath = g_strdup (LOG->log_filepath);
+
+  size_t   size = 18;
+  gint64   big = -5000000000;
+  guint64  max = G_MAXUINT64;
+  char *   str = g_strdup ("temporary string");
+  z_rt_message (
+    "record %d %5.2f %s %zu %" G_GINT64_FORMAT
+    " %" G_GUINT64_FORMAT " %c 100%%",
+    42, 0.5, str, size, big, max, 'x');
+  g_free (str);
+
+  /* unsupported formats are written as-is */
+  z_rt_message ("width %*d", 4, 2);
+
+  /* writes the remaining records */
+  test_helper_zrythm_cleanup ();
+
+  char * contents = NULL;
+  g_assert_true (
+    g_file_get_contents (filepath, &contents, NULL, NULL));
+  g_assert_nonnull (strstr (
+    contents,
+    "record 42  0.50 temporary string 18 -5000000000 "
+    "18446744073709551615 x 100%"));
+  g_assert_nonnull (strstr (contents, "width %*d"));
+  g_free (contents);
+  g_free (filepath);
+}
+
+int
+main (int argc, char * argv[])
+{
+  g_test_init (&argc, &argv, NULL);
+
+#define TEST_PREFIX "/utils/log/"
+
+  g_test_add_func (
+    TEST_PREFIX "test records", (GTestFunc) test_records);
+
+  return g_test_run ();
+}
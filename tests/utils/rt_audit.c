@@ -0,0 +1,64 @@
+// SPDX-FileCopyrightText: © 2022 Alexandros Theodotou <alex@zrythm.org>
+// SPDX-License-Identifier: LicenseRef-ZrythmLicense
+
+#include "zrythm-test-config.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "utils/rt_audit.h"
+
+#include <glib.h>
+
+static void
+test_record_violations (void)
+{
+#ifdef HAVE_RT_AUDIT
+  rt_audit_reset ();
+
+  /* outside an audited section */
+  void * volatile ptr = malloc (16);
+  free (ptr);
+  g_assert_cmpint (rt_audit_get_num_violations (), ==, 0);
+
+  /* inside an audited section */
+  rt_audit_enter ();
+  ptr = malloc (16);
+  rt_audit_leave ();
+  free (ptr);
+  g_assert_cmpint (rt_audit_get_num_violations (), ==, 1);
+
+  /* nested calls are only counted once */
+  rt_audit_enter ();
+  rt_audit_violation_begin (RT_AUDIT_VIOLATION_LOG);
+  ptr = malloc (16);
+  free (ptr);
+  rt_audit_violation_end ();
+  rt_audit_leave ();
+  g_assert_cmpint (rt_audit_get_num_violations (), ==, 2);
+
+  char * report = rt_audit_get_report ();
+  g_assert_nonnull (strstr (report, "allocation"));
+  g_assert_nonnull (strstr (report, "logging"));
+  g_free (report);
+
+  rt_audit_reset ();
+  g_assert_cmpint (rt_audit_get_num_violations (), ==, 0);
+#else
+  g_test_skip ("built without rt_audit");
+#endif
+}
+
+int
+main (int argc, char * argv[])
+{
+  g_test_init (&argc, &argv, NULL);
+
+#define TEST_PREFIX "/utils/rt_audit/"
+
+  g_test_add_func (
+    TEST_PREFIX "test record violations",
+    (GTestFunc) test_record_violations);
+
+  return g_test_run ();
+}